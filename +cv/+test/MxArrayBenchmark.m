@@ -0,0 +1,85 @@
+function results = MxArrayBenchmark(varargin)
+    %MXARRAYBENCHMARK  Measure MxArray::toMat conversion time per frame size and type
+    %
+    %     results = cv.test.MxArrayBenchmark()
+    %     results = cv.test.MxArrayBenchmark('OptionName',optionValue, ...)
+    %
+    % ## Output
+    % * __results__ struct array, one element per configuration, with the
+    %   following fields:
+    %   * __Size__ frame size `[rows,cols]`.
+    %   * __Class__ class of the input array.
+    %   * __Channels__ number of channels.
+    %   * __Depth__ class the array is converted to.
+    %   * __Current__ average time (msec) of the current `MxArray::toMat`.
+    %   * __Reference__ average time (msec) of the former
+    %     split/convert/transpose/merge implementation.
+    %   * __Speedup__ ratio `Reference/Current`.
+    %
+    % ## Options
+    % * __Sizes__ cell array of frame sizes `[rows,cols]`.
+    %   default `{[480 640], [720 1280], [1080 1920]}`
+    % * __Classes__ cell array of input classes.
+    %   default `{'uint8', 'single', 'double'}`
+    % * __Channels__ vector of channel counts. default `[1 3]`
+    % * __Depth__ cell array of output classes, an empty string keeps the
+    %   input class. default `{'', 'single'}`
+    % * __Repeat__ number of timed conversions per configuration. default 10
+    % * __Verbose__ print a summary table. default true
+    %
+    % Conversions are checked to produce identical results in both
+    % implementations before timings are reported.
+    %
+    % See also: cv.test.MxArrayTest, timeit
+    %
+
+    % default options
+    opts = struct('Sizes',{{[480 640], [720 1280], [1080 1920]}}, ...
+        'Classes',{{'uint8', 'single', 'double'}}, 'Channels',[1 3], ...
+        'Depth',{{'', 'single'}}, 'Repeat',10, 'Verbose',true);
+    nargs = numel(varargin);
+    if mod(nargs,2) ~= 0
+        error('mexopencv:error', 'Wrong number of arguments');
+    end
+    for i=1:2:nargs
+        if ~isfield(opts, varargin{i})
+            error('mexopencv:error', 'Unrecognized option %s', varargin{i});
+        end
+        opts.(varargin{i}) = varargin{i+1};
+    end
+
+    % run all configurations
+    results = struct('Size',{}, 'Class',{}, 'Channels',{}, 'Depth',{}, ...
+        'Current',{}, 'Reference',{}, 'Speedup',{});
+    for i=1:numel(opts.Sizes)
+        for j=1:numel(opts.Classes)
+            for k=1:numel(opts.Channels)
+                sz = [opts.Sizes{i}, opts.Channels(k)];
+                img = cast(randi([0 255], sz), opts.Classes{j});
+                for l=1:numel(opts.Depth)
+                    depth = opts.Depth{l};
+                    if isempty(depth), depth = opts.Classes{j}; end
+                    t = benchMxArray_('toMat', img, ...
+                        'Depth',depth, 'Repeat',opts.Repeat);
+                    results(end+1) = struct('Size',opts.Sizes{i}, ...
+                        'Class',opts.Classes{j}, 'Channels',opts.Channels(k), ...
+                        'Depth',depth, 'Current',t.Current, ...
+                        'Reference',t.Reference, ...
+                        'Speedup',t.Reference/t.Current); %#ok<AGROW>
+                end
+            end
+        end
+    end
+
+    % summary
+    if opts.Verbose
+        fprintf('%-11s %-7s %2s %-7s %10s %10s %7s\n', 'Size', 'Class', ...
+            'cn', 'Depth', 'Cur (ms)', 'Ref (ms)', 'Speedup');
+        for i=1:numel(results)
+            r = results(i);
+            fprintf('%-11s %-7s %2d %-7s %10.3f %10.3f %6.2fx\n', ...
+                sprintf('%dx%d', r.Size), r.Class, r.Channels, r.Depth, ...
+                r.Current, r.Reference, r.Speedup);
+        end
+    end
+end
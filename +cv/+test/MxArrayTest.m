@@ -30,6 +30,40 @@ function toMat_col_vector(t)
             success = testMxArray1_('toMat_col_vector', t.vec');
             t.verifyTrue(success);
         end
+
+        function toMat_multi_channel(t)
+            img = uint8(randi([0 255], [7 5 3]));
+            out = testMxArray1_('toMat_multi_channel', img, 'uint8');
+            t.verifyEqual(out, img);
+        end
+
+        function toMat_multi_channel_cast(t)
+            img = randn([7 5 3]) * 100;
+            out = testMxArray1_('toMat_multi_channel', img, 'int16');
+            t.verifyEqual(out, int16(img));
+            out = testMxArray1_('toMat_multi_channel', uint8(img), 'single');
+            t.verifyEqual(out, single(uint8(img)));
+        end
+    end
+
+    %% MxArray::toMatND
+    methods (Test)  % TestTags = {'toMatND'}
+        function toMatND_4d(t)
+            blob = rand([2 3 4 5]);
+            out = testMxArray1_('toMatND_roundtrip', blob);
+            t.verifyEqual(out, blob);
+        end
+    end
+
+    %% MxArray::toMatView
+    methods (Test)  % TestTags = {'toMatView'}
+        function toMatView_copy(t)
+            img = randi([0 255], [7 5], 'uint8');
+            out = testMxArray1_('toMatView_copy', img);
+            t.verifyEqual(out, img);
+            out = testMxArray1_('toMatView_copy', single(img));
+            t.verifyEqual(out, single(img));
+        end
     end
 
     %% MxArray::MxArray(cv::Mat)
@@ -32,6 +32,13 @@
 %   * **AGAST_7_12d**
 %   * **AGAST_7_12s**
 %   * **OAST_9_16** (default)
+% * __OutputFormat__ Format of the returned keypoints, one of:
+%   * __AoS__ a 1-by-N structure array, as described above.
+%   * __SoA__ a scalar structure of column vectors, where `pt` is
+%     an N-by-2 matrix and the other fields are N-by-1 vectors.
+%     It is much faster to create for large sets of keypoints,
+%     and is accepted as input wherever keypoints are expected.
+%   default 'AoS'
 %
 % Detects corners using the AGAST algorithm by [mair2010].
 %
@@ -27,6 +27,10 @@
 % `0.4*thresh` is used for the lower threshold. See
 % [Canny edge detector](https://en.wikipedia.org/wiki/Canny_edge_detector).
 %
+% `image` can also be a batch of images, either a cell array of images or an
+% `M-by-N-by-C-by-F` stack of `F` frames. Edges are then detected in parallel,
+% and `edges` is a batch of the same kind.
+%
 % ## References
 % [Canny86]:
 % > John Canny. A computational approach to edge detection.
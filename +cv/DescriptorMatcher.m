@@ -446,6 +446,14 @@ function matches = match(this, queryDescriptors, varargin)
             %   `trainDescCollection{i}`. Cell array of length
             %   `length(trainDescriptors)`, each a matrix of size
             %   `[size(queryDescriptors,1),size(trainDescriptors{i},1)]`.
+            % * __OutputFormat__ Format of the returned matches, one of:
+            %   * __AoS__ a 1-by-N structure array, as described above.
+            %   * __SoA__ a scalar structure with fields `queryIdx`,
+            %     `trainIdx`, `imgIdx`, and `distance`, each an N-by-1
+            %     vector. It is much faster to create for large sets of
+            %     matches, and is accepted as input wherever matches are
+            %     expected.
+            %   default 'AoS'
             %
             % In the first variant of this method, the train descriptors are
             % passed as an input argument. In the second variant of the
@@ -504,6 +512,15 @@ function matches = knnMatch(this, queryDescriptors, varargin)
             %   has the same size as `queryDescriptors` rows. If
             %   `CompactResult` is true, the matches vector does not contain
             %   matches for fully masked-out query descriptors. default false
+            % * __OutputFormat__ Format of the returned matches, one of:
+            %   * __AoS__ a cell array of 1-by-K structure arrays, as
+            %     described above.
+            %   * __SoA__ a cell array of scalar structures with fields
+            %     `queryIdx`, `trainIdx`, `imgIdx`, and `distance`, each a
+            %     K-by-1 vector. It is much faster to create for large sets
+            %     of matches, and is accepted as input wherever matches are
+            %     expected.
+            %   default 'AoS'
             %
             % This extended variant of cv.DescriptorMatcher.match method finds
             % several best matches for each query descriptor. The matches are
@@ -561,6 +578,15 @@ function matches = radiusMatch(this, queryDescriptors, varargin)
             %   has the same size as `queryDescriptors` rows. If
             %   `CompactResult` is true, the matches vector does not contain
             %   matches for fully masked-out query descriptors. default false
+            % * __OutputFormat__ Format of the returned matches, one of:
+            %   * __AoS__ a cell array of 1-by-K structure arrays, as
+            %     described above.
+            %   * __SoA__ a cell array of scalar structures with fields
+            %     `queryIdx`, `trainIdx`, `imgIdx`, and `distance`, each a
+            %     K-by-1 vector. It is much faster to create for large sets
+            %     of matches, and is accepted as input wherever matches are
+            %     expected.
+            %   default 'AoS'
             %
             % For each query descriptor, the methods find such training
             % descriptors that the distance between the query descriptor and
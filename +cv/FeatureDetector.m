@@ -208,6 +208,13 @@ function keypoints = detect(this, img, varargin)
             %   non-zero values in the region of interest. In the second
             %   variant, it is a cell-array of masks for each input image,
             %   `masks{i}` is a mask for `imgs{i}`. Not set by default.
+            % * __OutputFormat__ Format of the returned keypoints, one of:
+            %   * __AoS__ a 1-by-N structure array, as described above.
+            %   * __SoA__ a scalar structure of column vectors, where `pt` is
+            %     an N-by-2 matrix and the other fields are N-by-1 vectors.
+            %     It is much faster to create for large sets of keypoints,
+            %     and is accepted as input wherever keypoints are expected.
+            %   default 'AoS'
             %
             % See also: cv.FeatureDetector.FeatureDetector
             %
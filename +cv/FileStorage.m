@@ -154,6 +154,6 @@
 % }
 % ```
 %
-% See also: load, save, xmlread, xmlwrite, jsonencode, jsondecode,
-%  netcdf, h5info, hdfinfo, hdftool, cdflib
+% See also: cv.FileStorageStream, load, save, xmlread, xmlwrite, jsonencode,
+%  jsondecode, netcdf, h5info, hdfinfo, hdftool, cdflib
 %
@@ -0,0 +1,195 @@
+classdef FileStorageStream < handle
+    %FILESTORAGESTREAM  Incremental reading from or writing to a file storage
+    %
+    % A file storage stream is an object-style alternative to
+    % cv.FileStorage for large XML/YAML/JSON files. Rather than converting
+    % the whole document to a MATLAB struct at once:
+    %
+    % * when reading, nodes are navigated by path and only the requested
+    %   ones are converted to MATLAB values.
+    % * when writing, top-level nodes are appended one at a time, so that
+    %   large variables need not be gathered in a single struct.
+    %
+    % Dense numeric matrices are converted directly between the file nodes
+    % and the memory of MATLAB arrays, by bands of rows, without full
+    % intermediate copies. Use the `Base64` option (or a `?base64` suffix
+    % in the file name) to store them as compact Base64 binary blocks
+    % instead of text.
+    %
+    % Note that OpenCV parses the whole document when it is opened for
+    % reading; it is the conversion to MATLAB values that is done lazily.
+    %
+    % ## Example
+    %
+    %     % write variables one at a time
+    %     fs = cv.FileStorageStream('features.yml', 'w', 'Base64',true);
+    %     fs.write('descriptors', rand(100000,128,'single'));
+    %     fs.write('params', struct('nfeatures',500, 'name','ORB'));
+    %     fs.release();
+    %
+    %     % read back a single node
+    %     fs = cv.FileStorageStream('features.yml');
+    %     fs.keys()              % {'descriptors', 'params'}
+    %     fs.type('descriptors') % 'matrix'
+    %     D = fs.read('descriptors');
+    %     n = fs.read({'params', 'nfeatures'});
+    %
+    % See also: cv.FileStorage, cv.FileStorageStream.FileStorageStream
+    %
+
+    properties (SetAccess = private)
+        % Object ID
+        id
+    end
+
+    methods
+        function this = FileStorageStream(source, mode, varargin)
+            %FILESTORAGESTREAM  Opens a file storage
+            %
+            %     fs = cv.FileStorageStream(source)
+            %     fs = cv.FileStorageStream(source, mode)
+            %     fs = cv.FileStorageStream(..., 'OptionName',optionValue, ...)
+            %
+            % ## Input
+            % * __source__ Name of the file (its extension determines the
+            %   format, see cv.FileStorage), or the text to read from with
+            %   the `Memory` option.
+            % * __mode__ One of:
+            %   * __r__ open for reading (default).
+            %   * __w__ open for writing, replacing the file.
+            %   * __a__ open for appending top-level nodes to the file.
+            %
+            % ## Options
+            % * __Memory__ When reading, `source` is the text to read from.
+            %   When writing, the text is returned when the storage is
+            %   released instead of written to disk (`source` then only
+            %   gives the format, e.g. `'.yml'`). default false
+            % * __Base64__ When writing, store matrices as Base64 binary
+            %   blocks. default false
+            %
+            % See also: cv.FileStorageStream.read, cv.FileStorageStream.write
+            %
+            if nargin < 2, mode = 'r'; end
+            this.id = FileStorageStream_(0, 'new', source, mode, varargin{:});
+        end
+
+        function delete(this)
+            %DELETE  Destructor
+            %
+            %     fs.delete()
+            %
+            % The file is closed if it was not released already.
+            %
+            % See also: cv.FileStorageStream.release
+            %
+            if isempty(this.id), return; end
+            FileStorageStream_(this.id, 'delete');
+        end
+
+        function str = release(this)
+            %RELEASE  Closes the file storage
+            %
+            %     fs.release()
+            %     str = fs.release()
+            %
+            % ## Output
+            % * __str__ text of the storage, when writing with the `Memory`
+            %   option.
+            %
+            % See also: cv.FileStorageStream.write
+            %
+            if nargout > 0
+                str = FileStorageStream_(this.id, 'release');
+            else
+                FileStorageStream_(this.id, 'release');
+            end
+        end
+
+        function names = keys(this, varargin)
+            %KEYS  Names of the elements of a map node
+            %
+            %     names = fs.keys()
+            %     names = fs.keys(path)
+            %
+            % ## Input
+            % * __path__ Path of the node, either a cell array or a list of
+            %   arguments, where each element is the name of a map element
+            %   or the 1-based index of a sequence element (e.g.
+            %   `{'params', 'layers', 2}`). By default the top-level node.
+            %
+            % ## Output
+            % * __names__ cell array of names, empty if the node is not a
+            %   map.
+            %
+            % See also: cv.FileStorageStream.read
+            %
+            names = FileStorageStream_(this.id, 'keys', varargin{:});
+        end
+
+        function t = type(this, varargin)
+            %TYPE  Type of a node
+            %
+            %     t = fs.type(path)
+            %
+            % ## Input
+            % * __path__ Path of the node, see cv.FileStorageStream.keys.
+            %
+            % ## Output
+            % * __t__ one of 'none', 'int', 'real', 'str', 'seq', 'map',
+            %   'matrix', 'nd-matrix', or 'sparse-matrix'.
+            %
+            % See also: cv.FileStorageStream.count
+            %
+            t = FileStorageStream_(this.id, 'type', varargin{:});
+        end
+
+        function n = count(this, varargin)
+            %COUNT  Number of elements of a node
+            %
+            %     n = fs.count(path)
+            %
+            % ## Input
+            % * __path__ Path of the node, see cv.FileStorageStream.keys.
+            %
+            % ## Output
+            % * __n__ number of elements of a sequence or a map, 1 for
+            %   scalars.
+            %
+            % See also: cv.FileStorageStream.type
+            %
+            n = FileStorageStream_(this.id, 'count', varargin{:});
+        end
+
+        function x = read(this, varargin)
+            %READ  Reads a node
+            %
+            %     x = fs.read(path)
+            %
+            % ## Input
+            % * __path__ Path of the node, see cv.FileStorageStream.keys.
+            %
+            % ## Output
+            % * __x__ value of the node, converted as in cv.FileStorage.
+            %   Only this node and its children are converted.
+            %
+            % See also: cv.FileStorageStream.keys
+            %
+            x = FileStorageStream_(this.id, 'read', varargin{:});
+        end
+
+        function write(this, name, x)
+            %WRITE  Appends a top-level node
+            %
+            %     fs.write(name, x)
+            %
+            % ## Input
+            % * __name__ Name of the node.
+            % * __x__ Value, converted as in cv.FileStorage.
+            %
+            % See also: cv.FileStorageStream.release
+            %
+            FileStorageStream_(this.id, 'write', name, x);
+        end
+    end
+
+end
@@ -27,6 +27,10 @@
 %
 % The function convolves the source image with the specified Gaussian kernel.
 %
+% `src` can also be a batch of images, either a cell array of images or an
+% `M-by-N-by-C-by-F` stack of `F` frames. The images are then smoothed in
+% parallel, and `dst` is a batch of the same kind.
+%
 % See also: cv.sepFilter2D, cv.filter2D, cv.blur, cv.boxFilter,
 %  cv.bilateralFilter, cv.medianBlur, imfilter, fspecial, imgaussfilt
 %
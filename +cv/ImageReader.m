@@ -0,0 +1,187 @@
+classdef ImageReader < handle
+    %IMAGEREADER  Tiled reading of regions and pyramid levels of huge images
+    %
+    % An image reader opens a file once, and serves arbitrary rectangular
+    % regions of it, at full resolution or at a reduced resolution (pyramid
+    % level), without ever decoding the whole image in memory. This allows
+    % tile-based analysis of images much larger than the available memory,
+    % with a working set proportional to the tile size.
+    %
+    % Regions are assembled from tiles of a fixed size, kept in a cache of
+    % bounded memory (least recently used tiles are dropped first):
+    %
+    % * For TIFF files (including BigTIFF), only the strips or tiles of the
+    %   file covering the requested tiles are read and decoded. Any
+    %   compression supported by OpenCV's TIFF codec can be used.
+    %   Uncompressed images stored as a few tall strips are read by bands
+    %   of rows. Only the first page of a multipage file is read.
+    % * Other formats cannot be decoded partially, so the whole image is
+    %   decoded once and tiles are cut from it. For JPEG files, levels 1 to
+    %   3 are decoded directly at reduced resolution by the codec.
+    %
+    % Level `L` of the pyramid is the image downsampled `L` times by a
+    % factor of 2 (sizes rounded up), each tile being computed by area
+    % interpolation from the 4 tiles of the previous level it covers. The
+    % last level fits in a single tile.
+    %
+    % ## Example
+    %
+    %     r = cv.ImageReader('aerial.tif', 'CacheSize',512*2^20);
+    %     thumb = r.read('Level',r.NumLevels-1);
+    %     roi = r.read([10000 20000 1024 1024]);
+    %
+    % See also: cv.ImageReader.ImageReader, cv.ImageReader.read, cv.imread
+    %
+
+    properties (SetAccess = private)
+        % Object ID
+        id
+    end
+
+    properties (Dependent, SetAccess = private)
+        % Width of the image at full resolution
+        Width
+        % Height of the image at full resolution
+        Height
+        % Number of pyramid levels
+        NumLevels
+        % Size of tiles `[w,h]`
+        TileSize
+        % Granularity of access to the file, one of:
+        %
+        % * __tiles__ tiles of a tiled TIFF file.
+        % * __strips__ strips of a TIFF file.
+        % * __rows__ bands of rows of an uncompressed TIFF file.
+        % * __image__ whole image (other formats).
+        Layout
+        % Memory in bytes currently taken by cached tiles
+        CacheUsage
+    end
+
+    properties (Dependent)
+        % Maximum memory in bytes taken by cached tiles. default 256MB
+        CacheSize
+    end
+
+    methods
+        function this = ImageReader(filename, varargin)
+            %IMAGEREADER  Opens an image file
+            %
+            %     r = cv.ImageReader(filename)
+            %     r = cv.ImageReader(filename, 'OptionName',optionValue, ...)
+            %
+            % ## Input
+            % * __filename__ Name of the file to be read.
+            %
+            % ## Options
+            % * __TileSize__ Size of tiles `[w,h]`. By default, the size of
+            %   the tiles of a tiled TIFF file, otherwise `[256,256]`.
+            % * __CacheSize__ Maximum memory in bytes taken by cached tiles.
+            %   default 256MB
+            %
+            % Other options are the same as cv.imread, except `ReduceScale`
+            % (use pyramid levels instead).
+            %
+            % The file is parsed, but no image data is decoded for TIFF
+            % files until regions are read.
+            %
+            % See also: cv.ImageReader.read
+            %
+            this.id = ImageReader_(0, 'new', filename, varargin{:});
+        end
+
+        function delete(this)
+            %DELETE  Destructor
+            %
+            %     r.delete()
+            %
+            % See also: cv.ImageReader
+            %
+            if isempty(this.id), return; end
+            ImageReader_(this.id, 'delete');
+        end
+
+        function img = read(this, varargin)
+            %READ  Reads a region of the image
+            %
+            %     img = r.read()
+            %     img = r.read(rect)
+            %     img = r.read(..., 'OptionName',optionValue, ...)
+            %
+            % ## Input
+            % * __rect__ Region to read `[x,y,w,h]` (0-based), in
+            %   coordinates of the pyramid level. It must lie within the
+            %   image. By default the whole level.
+            %
+            % ## Output
+            % * __img__ Image of the region.
+            %
+            % ## Options
+            % * __Level__ Pyramid level, 0 for full resolution. default 0
+            %
+            % See also: cv.ImageReader.levelSize
+            %
+            img = ImageReader_(this.id, 'read', varargin{:});
+        end
+
+        function sz = levelSize(this, level)
+            %LEVELSIZE  Size of a pyramid level
+            %
+            %     sz = r.levelSize(level)
+            %
+            % ## Input
+            % * __level__ Pyramid level, 0 for full resolution.
+            %
+            % ## Output
+            % * __sz__ Size of the image at this level `[w,h]`.
+            %
+            % See also: cv.ImageReader.read
+            %
+            sz = ImageReader_(this.id, 'levelSize', level);
+        end
+
+        function clearCache(this)
+            %CLEARCACHE  Drops all cached tiles
+            %
+            %     r.clearCache()
+            %
+            % See also: cv.ImageReader.CacheSize
+            %
+            ImageReader_(this.id, 'clearCache');
+        end
+    end
+
+    methods
+        function value = get.Width(this)
+            value = ImageReader_(this.id, 'get', 'Width');
+        end
+
+        function value = get.Height(this)
+            value = ImageReader_(this.id, 'get', 'Height');
+        end
+
+        function value = get.NumLevels(this)
+            value = ImageReader_(this.id, 'get', 'NumLevels');
+        end
+
+        function value = get.TileSize(this)
+            value = ImageReader_(this.id, 'get', 'TileSize');
+        end
+
+        function value = get.Layout(this)
+            value = ImageReader_(this.id, 'get', 'Layout');
+        end
+
+        function value = get.CacheUsage(this)
+            value = ImageReader_(this.id, 'get', 'CacheUsage');
+        end
+
+        function value = get.CacheSize(this)
+            value = ImageReader_(this.id, 'get', 'CacheSize');
+        end
+        function set.CacheSize(this, value)
+            ImageReader_(this.id, 'set', 'CacheSize', value);
+        end
+    end
+
+end
@@ -0,0 +1,139 @@
+classdef MatHandle < handle
+    %MATHANDLE  Image or matrix kept resident in C++ memory
+    %
+    % A cv.MatHandle holds a `cv::Mat` in C++ memory. The data is converted
+    % once from MATLAB memory layout (column-major, planar channels) to
+    % OpenCV layout (row-major, interleaved channels) when the handle is
+    % created, and only converted back when requested by cv.MatHandle.toMat.
+    %
+    % Other functions of the package do not accept a cv.MatHandle. Each of
+    % them is a separately built MEX-file that cannot read the matrix held
+    % here, and copying it through MATLAB on every call would cost more
+    % than passing a MATLAB array. To apply several processing stages
+    % without converting between them, use cv.Pipeline.
+    %
+    % ## Example
+    %
+    %     h = cv.MatHandle(imread('fruits.jpg'));
+    %     sz = h.Size;
+    %     img = h.toMat();
+    %
+    % Note that channels are stored in the order they were given (i.e RGB
+    % for images coming from MATLAB).
+    %
+    % See also: cv.MatHandle.MatHandle, cv.MatHandle.toMat
+    %
+
+    properties (SetAccess = private)
+        % Object ID
+        id
+    end
+
+    properties (Dependent, SetAccess = private)
+        % Size of the matrix `[rows, cols, ...]`, not including channels
+        Size
+        % Number of channels
+        Channels
+        % Class of the elements, e.g. `uint8`
+        Class
+        % Whether the matrix has no elements
+        Empty
+    end
+
+    methods
+        function this = MatHandle(X)
+            %MATHANDLE  Constructor
+            %
+            %     h = cv.MatHandle(X)
+            %     h = cv.MatHandle()
+            %
+            % ## Input
+            % * __X__ numeric array, converted once to a `cv::Mat` kept in
+            %   C++ memory. An `M-by-N-by-C` array is stored as an `M-by-N`
+            %   matrix of `C` channels. Can also be another cv.MatHandle, in
+            %   which case its data is copied. default empty
+            %
+            % See also: cv.MatHandle.toMat, cv.MatHandle.clone
+            %
+            if nargin < 1, X = []; end
+            this.id = MatHandle_(0, 'new', X);
+        end
+
+        function delete(this)
+            %DELETE  Destructor
+            %
+            %     h.delete()
+            %
+            % See also: cv.MatHandle
+            %
+            if isempty(this.id), return; end
+            MatHandle_(this.id, 'delete');
+        end
+
+        function X = toMat(this)
+            %TOMAT  Converts the resident matrix to a MATLAB array
+            %
+            %     X = h.toMat()
+            %
+            % ## Output
+            % * __X__ output array, `M-by-N-by-C` for a matrix of `C`
+            %   channels.
+            %
+            % See also: cv.MatHandle.MatHandle
+            %
+            X = MatHandle_(this.id, 'toMat');
+        end
+
+        function h = clone(this)
+            %CLONE  Creates a deep copy of the handle
+            %
+            %     h2 = h.clone()
+            %
+            % ## Output
+            % * __h2__ new cv.MatHandle holding a copy of the data.
+            %
+            % See also: cv.MatHandle.MatHandle
+            %
+            h = cv.MatHandle(this);
+        end
+    end
+
+    methods
+        function value = get.Size(this)
+            value = MatHandle_(this.id, 'get', 'Size');
+        end
+
+        function value = get.Channels(this)
+            value = MatHandle_(this.id, 'get', 'Channels');
+        end
+
+        function value = get.Class(this)
+            value = MatHandle_(this.id, 'get', 'Class');
+        end
+
+        function value = get.Empty(this)
+            value = MatHandle_(this.id, 'get', 'Empty');
+        end
+    end
+
+    methods (Static)
+        function h = fromMat(X)
+            %FROMMAT  Creates a handle from a MATLAB array
+            %
+            %     h = cv.MatHandle.fromMat(X)
+            %
+            % ## Input
+            % * __X__ numeric array.
+            %
+            % ## Output
+            % * __h__ new cv.MatHandle.
+            %
+            % Same as the cv.MatHandle constructor.
+            %
+            % See also: cv.MatHandle.toMat
+            %
+            h = cv.MatHandle(X);
+        end
+    end
+
+end
@@ -0,0 +1,117 @@
+classdef MultiPageReader < handle
+    %MULTIPAGEREADER  Lazy access to the pages of a multi-page image file
+    %
+    % Unlike cv.imreadmulti which decodes every page of a file, a
+    % multi-page reader parses the file once, and only decodes the pages
+    % that are requested, so memory scales with the number of requested
+    % pages rather than the size of the file.
+    %
+    % For TIFF files (including BigTIFF), the compressed data of each
+    % requested page is copied into a single-page TIFF file in memory which
+    % is decoded by OpenCV; a range of pages is decoded in parallel. These
+    % buffers and the parsed page directories are reused across calls.
+    % Files in other formats are read as a single page.
+    %
+    % ## Example
+    %
+    %     r = cv.MultiPageReader('stack.tif', 'AnyDepth',true);
+    %     n = r.count();
+    %     img = r.read(1503);
+    %     frames = r.readRange(1, 100, 'Stack',true);
+    %
+    % See also: cv.MultiPageReader.MultiPageReader, cv.imreadmulti,
+    %  cv.ImageReader
+    %
+
+    properties (SetAccess = private)
+        % Object ID
+        id
+    end
+
+    methods
+        function this = MultiPageReader(filename, varargin)
+            %MULTIPAGEREADER  Opens a multi-page image file
+            %
+            %     r = cv.MultiPageReader(filename)
+            %     r = cv.MultiPageReader(filename, 'OptionName',value, ...)
+            %
+            % ## Input
+            % * __filename__ Name of the file to be read.
+            %
+            % ## Options
+            % The options are the same as cv.imreadmulti (except `GDAL`),
+            % with the same defaults. `ReduceScale` is also accepted.
+            %
+            % See also: cv.MultiPageReader.read
+            %
+            this.id = MultiPageReader_(0, 'new', filename, varargin{:});
+        end
+
+        function delete(this)
+            %DELETE  Destructor
+            %
+            %     r.delete()
+            %
+            % See also: cv.MultiPageReader
+            %
+            if isempty(this.id), return; end
+            MultiPageReader_(this.id, 'delete');
+        end
+
+        function n = count(this)
+            %COUNT  Number of pages of the file
+            %
+            %     n = r.count()
+            %
+            % ## Output
+            % * __n__ number of pages, without decoding any of them.
+            %
+            % See also: cv.MultiPageReader.read
+            %
+            n = MultiPageReader_(this.id, 'count');
+        end
+
+        function img = read(this, k)
+            %READ  Decodes a single page
+            %
+            %     img = r.read(k)
+            %
+            % ## Input
+            % * __k__ 1-based page index.
+            %
+            % ## Output
+            % * __img__ Decoded page.
+            %
+            % See also: cv.MultiPageReader.readRange
+            %
+            img = MultiPageReader_(this.id, 'read', k);
+        end
+
+        function imgs = readRange(this, a, b, varargin)
+            %READRANGE  Decodes a range of pages in parallel
+            %
+            %     imgs = r.readRange(a, b)
+            %     imgs = r.readRange(a, b, 'OptionName',optionValue, ...)
+            %
+            % ## Input
+            % * __a__ 1-based index of the first page.
+            % * __b__ 1-based index of the last page (inclusive).
+            %
+            % ## Output
+            % * __imgs__ `1-by-(b-a+1)` cell array of decoded pages, or a
+            %   `M-by-N-by-C-by-(b-a+1)` array with the `Stack` option.
+            %
+            % ## Options
+            % * __Stack__ If set, return the pages stacked along the 4th
+            %   dimension, all pages must then have the same size and type.
+            %   default false
+            %
+            % An error is raised if any page cannot be decoded.
+            %
+            % See also: cv.MultiPageReader.read
+            %
+            imgs = MultiPageReader_(this.id, 'readRange', a, b, varargin{:});
+        end
+    end
+
+end
@@ -93,6 +93,9 @@ function this = Net(varargin)
             % The importers first create a net, add loaded layers into it, and
             % set connections between them.
             %
+            % When the model cache is enabled, networks created from the same
+            % files share their weights (see cv.Net.setUseModelCache).
+            %
             % ### Notes for Torch
             %
             % NOTE: ASCII mode of Torch serializer is more preferable, because
@@ -167,6 +170,37 @@ function setInput(this, blob, name)
             end
         end
 
+        function setInputFromImages(this, img, varargin)
+            %SETINPUTFROMIMAGES  Sets the network input from image or series of images
+            %
+            %     net.setInputFromImages(img)
+            %     net.setInputFromImages(imgs)
+            %     net.setInputFromImages(..., 'OptionName',optionValue, ...)
+            %
+            % ## Input
+            % * __img__ input image (with 1-, 3- or 4-channels).
+            % * __imgs__ input images (all with 1-, 3- or 4-channels).
+            %
+            % ## Options
+            % * __Name__ descriptor of the updating layer output blob. See
+            %   cv.Net.connect to know format of the descriptor. default ''
+            % * __Size__, __Mean__, __ScaleFactor__, __SwapRB__, __Crop__
+            %   See cv.Net.blobFromImages.
+            %
+            % Equivalent to:
+            %
+            %     net.setInput(cv.Net.blobFromImages(imgs, ...), name)
+            %
+            % except that the blob is built directly as the network input,
+            % without being returned to MATLAB. With `uint8` images, the
+            % whole preprocessing is done in a single pass (see
+            % cv.Net.blobFromImages).
+            %
+            % See also: cv.Net.setInput, cv.Net.blobFromImages
+            %
+            Net_(this.id, 'setInputFromImages', img, varargin{:});
+        end
+
         function setParam(this, layerId, numParam, blob)
             %SETPARAM  Sets the new value for the learned param of the layer
             %
@@ -296,6 +330,368 @@ function [timings, total] = getPerfProfile(this)
         end
     end
 
+    %% Net (network complexity)
+    methods
+        function [inShapes, outShapes] = getLayerShapes(this, netInputShapes, layerId)
+            %GETLAYERSHAPES  Returns input and output shapes for a layer
+            %
+            %     [inShapes, outShapes] = net.getLayerShapes(netInputShapes, layerId)
+            %
+            % ## Input
+            % * __netInputShapes__ shapes of all net inputs. Either a numeric
+            %   vector for a single input (e.g `[1 3 224 224]`), or a cell
+            %   array of such vectors.
+            % * __layerId__ name or id of the layer.
+            %
+            % ## Output
+            % * __inShapes__ shapes of the layer inputs (cell array).
+            % * __outShapes__ shapes of the layer outputs (cell array).
+            %
+            % Shapes are computed from the network architecture alone, no
+            % forward pass is run.
+            %
+            % See also: cv.Net.getLayersShapes
+            %
+            [inShapes, outShapes] = Net_(this.id, 'getLayerShapes', ...
+                netInputShapes, layerId);
+        end
+
+        function [layersIds, inShapes, outShapes] = getLayersShapes(this, netInputShapes)
+            %GETLAYERSSHAPES  Returns input and output shapes for all layers in loaded model
+            %
+            %     [layersIds, inShapes, outShapes] = net.getLayersShapes(netInputShapes)
+            %
+            % ## Input
+            % * __netInputShapes__ shapes of all net inputs. Either a numeric
+            %   vector for a single input, or a cell array of such vectors.
+            %
+            % ## Output
+            % * __layersIds__ ids of the layers, including the network input
+            %   layer (id 0).
+            % * __inShapes__ shapes of the inputs of each layer (cell array of
+            %   cell arrays).
+            % * __outShapes__ shapes of the outputs of each layer (cell array
+            %   of cell arrays).
+            %
+            % See also: cv.Net.getLayerShapes
+            %
+            [layersIds, inShapes, outShapes] = Net_(this.id, ...
+                'getLayersShapes', netInputShapes);
+        end
+
+        function flops = getFLOPS(this, netInputShapes, varargin)
+            %GETFLOPS  Computes FLOP for whole loaded model with specified input shapes
+            %
+            %     flops = net.getFLOPS(netInputShapes)
+            %     flops = net.getFLOPS(netInputShapes, 'OptionName',optionValue, ...)
+            %
+            % ## Input
+            % * __netInputShapes__ shapes of all net inputs. Either a numeric
+            %   vector for a single input, or a cell array of such vectors.
+            %
+            % ## Output
+            % * __flops__ computed FLOP (int64).
+            %
+            % ## Options
+            % * __LayerId__ name or id of a layer, to only count the FLOP of
+            %   that layer. By default the whole model is counted.
+            %
+            % See also: cv.Net.getMemoryConsumption, cv.Net.profile
+            %
+            flops = Net_(this.id, 'getFLOPS', netInputShapes, varargin{:});
+        end
+
+        function [weights, blobs] = getMemoryConsumption(this, netInputShapes, varargin)
+            %GETMEMORYCONSUMPTION  Computes bytes number which are required to store all weights and intermediate blobs for model
+            %
+            %     [weights, blobs] = net.getMemoryConsumption(netInputShapes)
+            %     [...] = net.getMemoryConsumption(netInputShapes, 'OptionName',optionValue, ...)
+            %
+            % ## Input
+            % * __netInputShapes__ shapes of all net inputs. Either a numeric
+            %   vector for a single input, or a cell array of such vectors.
+            %
+            % ## Output
+            % * __weights__ bytes required to store the weights.
+            % * __blobs__ bytes required to store the intermediate blobs.
+            %
+            % ## Options
+            % * __LayerId__ name or id of a layer, to only count the memory
+            %   of that layer. By default the whole model is counted.
+            %
+            % See also: cv.Net.getFLOPS, cv.Net.profile
+            %
+            [weights, blobs] = Net_(this.id, 'getMemoryConsumption', ...
+                netInputShapes, varargin{:});
+        end
+
+        function [layers, totals] = profile(this, blob, varargin)
+            %PROFILE  Measures and estimates the cost of each layer of the network
+            %
+            %     [layers, totals] = net.profile(blob)
+            %     [...] = net.profile(blob, 'OptionName',optionValue, ...)
+            %
+            % ## Input
+            % * __blob__ input blob, a 4-D array `[N C H W]` as returned by
+            %   cv.Net.blobFromImages.
+            %
+            % ## Output
+            % * __layers__ struct-array with one element per layer (the
+            %   network input excluded), with the following fields:
+            %   * __id__ layer id.
+            %   * __name__ layer name.
+            %   * __type__ layer type.
+            %   * __outputShapes__ shapes of the layer outputs (cell array).
+            %   * __flops__ estimated FLOP of the layer.
+            %   * __weights__ bytes required to store the layer weights.
+            %   * __blobs__ bytes required to store the layer output blobs.
+            %   * __time__ measured time of the layer in milliseconds,
+            %     averaged over all runs. Layers fused with others report 0.
+            % * __totals__ struct with the totals of the network, with the
+            %   fields `layers` (number of layers), `flops`, `weights`,
+            %   `blobs`, `time` (overall inference time in milliseconds,
+            %   averaged over all runs) and `runs`.
+            %
+            % ## Options
+            % * __Runs__ number of timed forward passes. default 10
+            % * __Name__ name of the input layer. default empty
+            % * __OutputName__ name or names of the layers which outputs are
+            %   computed. By default the whole network is run.
+            %
+            % The blob is set as the network input, then an untimed warm-up
+            % forward pass is run before the timed ones. Estimates (FLOP and
+            % memory) are computed for the shape of the blob.
+            %
+            % ## Example
+            %
+            %     [layers, totals] = net.profile(blob, 'Runs',20);
+            %     [~,idx] = sort([layers.time], 'descend');
+            %     struct2table(layers(idx))
+            %
+            % See also: cv.Net.getPerfProfile, cv.Net.getFLOPS,
+            %  cv.Net.getMemoryConsumption
+            %
+            [layers, totals] = Net_(this.id, 'profile', blob, varargin{:});
+        end
+    end
+
+    %% Net (asynchronous forward pass)
+    methods
+        function startAsync(this, varargin)
+            %STARTASYNC  Starts the pool of workers used for asynchronous forward passes
+            %
+            %     net.startAsync()
+            %     net.startAsync('OptionName',optionValue, ...)
+            %
+            % ## Options
+            % * __Workers__ number of worker threads, each running forward
+            %   passes on its own copy of the network. default 2
+            % * __QueueDepth__ maximum number of requests waiting for a
+            %   worker. cv.Net.forwardAsync blocks while the queue is full.
+            %   default twice the number of workers
+            % * __ShareWeights__ whether the copies of the network share the
+            %   layers parameters. Layers fusion (see cv.Net.enableFusion)
+            %   modifies parameters in place, and is disabled in copies
+            %   sharing them. default true
+            % * __MaxBatchSize__ maximum number of samples (images) run in a
+            %   single forward pass. Values greater than 1 enable
+            %   micro-batching, see below. default 1
+            % * __MaxWait__ maximum time in milliseconds a request waits for
+            %   others to be batched with. default 0 (only requests already
+            %   queued are batched)
+            % * __QueueDepth__ (see above) defaults to
+            %   `2*Workers*MaxBatchSize`.
+            %
+            % Copies are read again from the model files passed to the
+            % constructor, with the preferable backend, target, and fusion
+            % settings of this object, so only networks imported from files
+            % can run asynchronously. Changes made to this object afterwards
+            % (e.g layers added or parameters set) are not seen by the
+            % copies.
+            %
+            % With micro-batching, a worker taking a request also takes the
+            % queued requests having the same input shape, input name, and
+            % output names, waiting for more of them until the batch is full
+            % or `MaxWait` has elapsed since the first one was queued. They are
+            % run as a single N-sized blob, and the outputs are split back to
+            % the requests along their first dimension. Networks whose outputs
+            % are not indexed by sample (e.g detection outputs gathering the
+            % detections of all images) run the requests one by one instead.
+            % This improves the throughput of services submitting one image
+            % at a time, at the cost of some latency.
+            %
+            % A running pool is stopped first, discarding its queued requests
+            % and its results not yet retrieved. The pool is started with
+            % default options on the first call to cv.Net.forwardAsync if
+            % needed.
+            %
+            % Each forward pass is itself parallelized, consider lowering the
+            % number of threads (cv.Utils.setNumThreads) when running many
+            % workers.
+            %
+            % See also: cv.Net.forwardAsync, cv.Net.stopAsync
+            %
+            Net_(this.id, 'startAsync', varargin{:});
+        end
+
+        function stopAsync(this)
+            %STOPASYNC  Stops the pool of workers used for asynchronous forward passes
+            %
+            %     net.stopAsync()
+            %
+            % Waits for the running forward passes to finish, and discards
+            % queued requests and results not yet retrieved.
+            %
+            % See also: cv.Net.startAsync
+            %
+            Net_(this.id, 'stopAsync');
+        end
+
+        function reqId = forwardAsync(this, blob, varargin)
+            %FORWARDASYNC  Queues a forward pass to run in the background
+            %
+            %     reqId = net.forwardAsync(blob)
+            %     reqId = net.forwardAsync(imgs)
+            %     reqId = net.forwardAsync(..., 'OptionName',optionValue, ...)
+            %
+            % ## Input
+            % * __blob__ input blob (see cv.Net.setInput).
+            % * __imgs__ cell array of input images, converted to a blob by
+            %   the worker (see cv.Net.blobFromImages).
+            %
+            % ## Output
+            % * __reqId__ identifier of the request, found in the results
+            %   returned by cv.Net.poll and cv.Net.waitAll.
+            %
+            % ## Options
+            % * __OutputName__ name of the layer whose output is needed, or
+            %   cell array of names of layers. The output of the whole
+            %   network by default.
+            % * __Name__ name of the input blob to set. default ''
+            % * __Size__, __Mean__, __ScaleFactor__, __SwapRB__, __Crop__
+            %   options of the conversion of images to a blob. See
+            %   cv.Net.blobFromImages.
+            %
+            % The input is copied and the call returns as soon as the request
+            % is queued, so MATLAB can decode and prepare the next inputs
+            % while workers run the forward passes. Blocks while the queue is
+            % full.
+            %
+            % ## Example
+            %
+            %     net = cv.Net('Caffe', prototxt, caffeModel);
+            %     net.startAsync('Workers',4);
+            %     for i=1:numel(files)
+            %         img = cv.imread(files{i}, 'FlipChannels',false);
+            %         net.forwardAsync({img}, 'Size',[224 224]);
+            %         res = net.poll();  % results finished so far
+            %     end
+            %     res = [res, net.waitAll()];  % remaining results
+            %
+            % See also: cv.Net.poll, cv.Net.waitAll, cv.Net.startAsync
+            %
+            reqId = Net_(this.id, 'forwardAsync', blob, varargin{:});
+        end
+
+        function [results, pending] = poll(this)
+            %POLL  Returns results of asynchronous forward passes finished so far
+            %
+            %     [results, pending] = net.poll()
+            %
+            % ## Output
+            % * __results__ struct array of finished requests not returned
+            %   yet, in order of completion, with the following fields:
+            %   * __id__ request identifier returned by cv.Net.forwardAsync.
+            %   * __output__ output blob, or cell array of blobs if a cell
+            %     array of names was requested. Empty on failure.
+            %   * __error__ error message, empty on success.
+            %   * __batchSize__ number of requests run in the same forward
+            %     pass.
+            %   * __latency__ time from queueing to completion, in msec.
+            %   * __queueTime__ time spent waiting for a worker, in msec.
+            %   * __computeTime__ time of the image conversion and forward
+            %     pass, in msec.
+            % * __pending__ number of requests queued or running.
+            %
+            % Does not wait.
+            %
+            % See also: cv.Net.waitAll, cv.Net.wait, cv.Net.forwardAsync
+            %
+            [results, pending] = Net_(this.id, 'poll');
+        end
+
+        function results = wait(this, reqIds)
+            %WAIT  Waits for given asynchronous forward passes and returns their results
+            %
+            %     results = net.wait(reqIds)
+            %
+            % ## Input
+            % * __reqIds__ identifiers of requests returned by
+            %   cv.Net.forwardAsync, not retrieved yet.
+            %
+            % ## Output
+            % * __results__ struct array of the requests, in the order of
+            %   `reqIds`. See cv.Net.poll.
+            %
+            % Results of other requests are kept for later calls.
+            %
+            % See also: cv.Net.poll, cv.Net.forwardAsync
+            %
+            results = Net_(this.id, 'wait', reqIds);
+        end
+
+        function s = getAsyncStats(this)
+            %GETASYNCSTATS  Returns counters of the asynchronous forward passes
+            %
+            %     s = net.getAsyncStats()
+            %
+            % ## Output
+            % * __s__ a structure with the following fields:
+            %   * __completed__ number of finished requests.
+            %   * __failed__ number of requests finished with an error.
+            %   * __batches__ number of forward passes run.
+            %   * __meanBatchSize__ mean number of requests per forward pass.
+            %   * __meanLatency__ mean time from queueing to completion, in
+            %     msec.
+            %   * __maxLatency__ longest time from queueing to completion, in
+            %     msec.
+            %   * __meanQueueTime__ mean time spent waiting for a worker, in
+            %     msec (including the wait for a batch to fill).
+            %   * __meanComputeTime__ mean time of the image conversion and
+            %     forward pass, in msec.
+            %   * __throughput__ finished requests per second since the pool
+            %     was started or the counters were reset.
+            %
+            % See also: cv.Net.resetAsyncStats, cv.Net.startAsync
+            %
+            s = Net_(this.id, 'getAsyncStats');
+        end
+
+        function resetAsyncStats(this)
+            %RESETASYNCSTATS  Resets counters of the asynchronous forward passes
+            %
+            %     net.resetAsyncStats()
+            %
+            % See also: cv.Net.getAsyncStats
+            %
+            Net_(this.id, 'resetAsyncStats');
+        end
+
+        function results = waitAll(this)
+            %WAITALL  Waits for all asynchronous forward passes and returns their results
+            %
+            %     results = net.waitAll()
+            %
+            % ## Output
+            % * __results__ struct array of finished requests not returned
+            %   yet. See cv.Net.poll.
+            %
+            % See also: cv.Net.poll, cv.Net.forwardAsync
+            %
+            results = Net_(this.id, 'waitAll');
+        end
+    end
+
     %% Net (network architecture)
     methods
         function b = empty(this)
@@ -573,6 +969,9 @@ function enableFusion(this, fusion)
             % * __fusion__ true to enable the fusion, false to disable. The
             %   fusion is enabled by default.
             %
+            % The fusion is disabled in networks sharing the weights of the
+            % model cache, and cannot be enabled (see cv.Net.setUseModelCache).
+            %
             % See also: cv.Net.connect
             %
             Net_(this.id, 'enableFusion', fusion);
@@ -697,7 +1096,14 @@ function blob = blobFromImages(img, varargin)
             % A blob is a 4-dimensional matrix (so-called batch) with the
             % following shape: `[num, cn, rows, cols]`.
             %
-            % See also: cv.Net.setInput
+            % Images of class `uint8` are read in place and converted in a
+            % single parallel pass that resizes, crops, subtracts the mean,
+            % scales, swaps channels, and writes directly into the output
+            % array, avoiding the intermediate floating-point copies of the
+            % images. The result matches the general path up to
+            % floating-point rounding.
+            %
+            % See also: cv.Net.setInput, cv.Net.setInputFromImages
             %
             blob = Net_(0, 'blobFromImages', img, varargin{:});
         end
@@ -778,4 +1184,112 @@ function indices = NMSBoxes(bboxes, scores, score_threshold, nms_threshold, vara
             indices = Net_(0, 'NMSBoxes', bboxes, scores, score_threshold, nms_threshold, varargin{:});
         end
     end
+
+    %% Model cache
+    methods (Static)
+        function tf = useModelCache()
+            %USEMODELCACHE  Returns whether networks are read through the shared model cache
+            %
+            %     tf = cv.Net.useModelCache()
+            %
+            % ## Output
+            % * __tf__ status of the model cache. default false
+            %
+            % See also: cv.Net.setUseModelCache
+            %
+            tf = Net_(0, 'useModelCache');
+        end
+
+        function setUseModelCache(flag, varargin)
+            %SETUSEMODELCACHE  Enables or disables the process-wide model cache
+            %
+            %     cv.Net.setUseModelCache(flag)
+            %     cv.Net.setUseModelCache(flag, 'OptionName',optionValue, ...)
+            %
+            % ## Input
+            % * __flag__ whether networks created from model files (see
+            %   cv.Net.Net) go through the cache.
+            %
+            % ## Options
+            % * __MemoryMap__ whether model files are memory-mapped instead of
+            %   read into memory. Only supported on POSIX systems (Linux,
+            %   macOS), files are read otherwise. It applies to models read
+            %   after the call. default false
+            %
+            % With the cache enabled, model files are read once and kept in
+            % memory, keyed by network type and canonical file paths. All
+            % networks created from the same files share the same immutable
+            % layer weights, which reduces both the startup time and the
+            % memory used by several instances of the same model.
+            %
+            % Sharing is limited to the weights the layers read when the
+            % network runs. Layers that make their own copy of the weights
+            % when they are created still keep one per network: in OpenCV
+            % 3.4, fully connected (InnerProduct) and batch normalization
+            % layers. The saving thus depends on the model, it is largest
+            % for convolutional networks.
+            %
+            % Files are checked for changes (time of last modification and
+            % size) each time a network is created, and read again if
+            % needed. Networks created before keep the weights they share.
+            % When memory-mapped, model files should be replaced rather than
+            % modified in place.
+            %
+            % Caffe and TensorFlow models are parsed from the cached
+            % contents, Torch and Darknet models are parsed from the files
+            % again. In both cases the parsed layer weights are replaced by
+            % the shared ones.
+            %
+            % Layers fusion modifies weights in place, so it is disabled in
+            % networks sharing cached weights, and cannot be enabled with
+            % cv.Net.enableFusion.
+            %
+            % ## Example
+            %
+            %     cv.Net.setUseModelCache(true, 'MemoryMap',true);
+            %     nets = cell(1,8);
+            %     for i=1:numel(nets)
+            %         nets{i} = cv.Net('Caffe', modelTxt, modelBin);
+            %     end
+            %
+            % See also: cv.Net.useModelCache, cv.Net.getModelCache,
+            %  cv.Net.clearModelCache
+            %
+            Net_(0, 'setUseModelCache', flag, varargin{:});
+        end
+
+        function models = getModelCache()
+            %GETMODELCACHE  Returns information about the cached models
+            %
+            %     models = cv.Net.getModelCache()
+            %
+            % ## Output
+            % * __models__ struct-array with one element per cached model,
+            %   with the following fields:
+            %   * __type__ type of network.
+            %   * __files__ paths of the model files (cell array).
+            %   * __bytes__ total size of the model files.
+            %   * __mapped__ whether the files are memory-mapped.
+            %   * __weights__ bytes used by the shared weights, not counting
+            %     the copies kept by some layers of each network.
+            %   * __instances__ number of networks sharing the weights.
+            %
+            % See also: cv.Net.setUseModelCache, cv.Net.clearModelCache
+            %
+            models = Net_(0, 'getModelCache');
+        end
+
+        function clearModelCache()
+            %CLEARMODELCACHE  Removes all models from the cache
+            %
+            %     cv.Net.clearModelCache()
+            %
+            % Existing networks keep the weights they share, which are
+            % released along with the last of them.
+            %
+            % See also: cv.Net.setUseModelCache, cv.Net.getModelCache
+            %
+            Net_(0, 'clearModelCache');
+        end
+    end
 end
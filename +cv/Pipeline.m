@@ -0,0 +1,191 @@
+classdef Pipeline < handle
+    %PIPELINE  Fused multi-stage image processing pipeline
+    %
+    % A pipeline holds a chain of image processing operations, and runs all
+    % of them on an image in a single call. Compared to calling the
+    % functions one after the other, this avoids converting intermediate
+    % results between MATLAB and OpenCV memory layouts, and improves cache
+    % usage:
+    %
+    % * Consecutive stages that only need a few neighboring rows to compute
+    %   an output row (color conversions, linear and median filters, fixed
+    %   thresholds, morphological operations) are fused. The image is split
+    %   in bands of rows small enough to stay in cache, each band goes
+    %   through all the fused stages (along with the extra rows of context
+    %   it needs), and bands are processed in parallel.
+    % * Other stages (resizing, edge detection, automatic thresholds,
+    %   demosaicing) run on the whole image.
+    % * Intermediate images are kept between calls, and reused when the
+    %   next image has the same size.
+    % * A batch of frames (a cell array, or a 4-D stack) is processed in a
+    %   single call, frames being processed in parallel.
+    %
+    % Results are identical to calling the corresponding functions in
+    % sequence.
+    %
+    % ## Stages
+    % Each stage is an operation name followed by the arguments of the
+    % corresponding function (without the input image), with the same
+    % defaults:
+    %
+    % * __cvtColor__ `{'cvtColor', code, 'DstCn',dcn}`, see cv.cvtColor
+    % * __resize__ `{'resize', dsize, 'Interpolation',interp}` or
+    %   `{'resize', fx, fy, ...}`, see cv.resize
+    % * __GaussianBlur__ `{'GaussianBlur', 'KSize',ksize, 'SigmaX',sx,
+    %   'SigmaY',sy, 'BorderType',bt}`, see cv.GaussianBlur
+    % * __blur__ `{'blur', 'KSize',ksize, 'Anchor',a, 'BorderType',bt}`,
+    %   see cv.blur
+    % * __medianBlur__ `{'medianBlur', 'KSize',ksize}`, see cv.medianBlur
+    % * __threshold__ `{'threshold', thresh, 'MaxValue',mv, 'Type',t}`,
+    %   see cv.threshold
+    % * __morphologyEx__ `{'morphologyEx', op, 'Element',e, 'Anchor',a,
+    %   'Iterations',n, 'BorderType',bt, 'BorderValue',bv}`, see
+    %   cv.morphologyEx
+    % * __erode__, __dilate__ `{'erode', 'Element',e, ...}`, see cv.erode
+    %   and cv.dilate
+    % * __Canny__ `{'Canny', thresh, 'ApertureSize',as, 'L2Gradient',l2}`,
+    %   see cv.Canny
+    %
+    % ## Example
+    %
+    %     p = cv.Pipeline({
+    %         {'cvtColor', 'RGB2GRAY'}
+    %         {'GaussianBlur', 'KSize',[5 5]}
+    %         {'threshold', 128, 'Type','Binary'}
+    %         {'morphologyEx', 'Open'}
+    %     });
+    %     bw = p.apply(imread('fruits.jpg'));
+    %
+    % See also: cv.Pipeline.Pipeline, cv.Pipeline.apply
+    %
+
+    properties (SetAccess = private)
+        % Object ID
+        id
+    end
+
+    properties (Dependent)
+        % Number of rows processed at once by fused stages. The default 0
+        % chooses it from the image width, so that a band of rows takes
+        % about 256KB. It is never less than twice the extra rows of context
+        % the fused stages need.
+        TileRows
+    end
+
+    properties (Dependent, SetAccess = private)
+        % Number of stages
+        NumStages
+    end
+
+    methods
+        function this = Pipeline(stages)
+            %PIPELINE  Constructor
+            %
+            %     p = cv.Pipeline()
+            %     p = cv.Pipeline(stages)
+            %
+            % ## Input
+            % * __stages__ cell array of stages, each a cell array
+            %   `{op, arg1, arg2, ...}` of the operation name followed by its
+            %   arguments. See cv.Pipeline for the supported operations.
+            %   default empty
+            %
+            % See also: cv.Pipeline.add, cv.Pipeline.apply
+            %
+            this.id = Pipeline_(0, 'new');
+            if nargin > 0
+                for i=1:numel(stages)
+                    this.add(stages{i}{:});
+                end
+            end
+        end
+
+        function delete(this)
+            %DELETE  Destructor
+            %
+            %     p.delete()
+            %
+            % See also: cv.Pipeline
+            %
+            if isempty(this.id), return; end
+            Pipeline_(this.id, 'delete');
+        end
+
+        function add(this, op, varargin)
+            %ADD  Appends a stage to the pipeline
+            %
+            %     p.add(op, arg1, arg2, ...)
+            %
+            % ## Input
+            % * __op__ name of the operation, e.g. 'GaussianBlur'.
+            % * __arg1__, __arg2__, ... arguments of the corresponding
+            %   function, without the input image.
+            %
+            % The arguments are checked immediately.
+            %
+            % See also: cv.Pipeline.clear, cv.Pipeline.stages
+            %
+            Pipeline_(this.id, 'add', op, varargin{:});
+        end
+
+        function clear(this)
+            %CLEAR  Removes all stages
+            %
+            %     p.clear()
+            %
+            % See also: cv.Pipeline.add
+            %
+            Pipeline_(this.id, 'clear');
+        end
+
+        function ops = stages(this)
+            %STAGES  Returns the operations of the pipeline
+            %
+            %     ops = p.stages()
+            %
+            % ## Output
+            % * __ops__ cell array of operation names, in order.
+            %
+            % See also: cv.Pipeline.add
+            %
+            ops = Pipeline_(this.id, 'stages');
+        end
+
+        function dst = apply(this, src)
+            %APPLY  Runs all stages on an image or a batch of frames
+            %
+            %     dst = p.apply(src)
+            %
+            % ## Input
+            % * __src__ input, one of:
+            %   * an image (`M-by-N-by-C` numeric array).
+            %   * a cell array of images, possibly of different sizes.
+            %   * a stack of frames, an `M-by-N-by-C-by-F` numeric array of
+            %     `F` images (use `C=1` for grayscale frames).
+            %
+            % ## Output
+            % * __dst__ output of the last stage, of the same kind as the
+            %   input (an image, a cell array of the same size, or a 4-D
+            %   stack of frames). An empty pipeline returns a copy of the
+            %   input.
+            %
+            % See also: cv.Pipeline.add
+            %
+            dst = Pipeline_(this.id, 'apply', src);
+        end
+    end
+
+    methods
+        function value = get.TileRows(this)
+            value = Pipeline_(this.id, 'get', 'TileRows');
+        end
+        function set.TileRows(this, value)
+            Pipeline_(this.id, 'set', 'TileRows', value);
+        end
+
+        function value = get.NumStages(this)
+            value = Pipeline_(this.id, 'get', 'NumStages');
+        end
+    end
+
+end
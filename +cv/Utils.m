@@ -808,4 +808,251 @@ function setUseTegra(tf)
         end
     end
 
+    % Buffer pool
+    methods (Static)
+        function tf = useBufferPool()
+            %USEBUFFERPOOL  Check if the Mat buffer pool is enabled
+            %
+            %     tf = cv.Utils.useBufferPool()
+            %
+            % ## Output
+            % * __tf__ status flag
+            %
+            % See also: cv.Utils.setUseBufferPool
+            %
+            tf = Utils_('useBufferPool');
+        end
+
+        function setUseBufferPool(tf)
+            %SETUSEBUFFERPOOL  Enable/disable the Mat buffer pool
+            %
+            %     cv.Utils.setUseBufferPool(tf)
+            %
+            % ## Input
+            % * __tf__ flag
+            %
+            % When enabled, a process-wide pool is installed as the default
+            % OpenCV matrix allocator. Buffers of released matrices (image
+            % conversion temporaries as well as outputs of OpenCV functions)
+            % are kept in size buckets and reused by subsequent calls instead
+            % of being returned to the heap. This avoids heap fragmentation
+            % in long-running sessions processing many frames of the same
+            % size. Allocations smaller than 4KB are not pooled.
+            %
+            % Disabling the pool restores the standard allocator and frees
+            % all reserved buffers. Once the pool has been enabled, the
+            % `Utils_` MEX-file stays locked in memory until MATLAB exits.
+            % Disabled by default.
+            %
+            % See also: cv.Utils.useBufferPool, cv.Utils.getBufferPoolStats,
+            %  cv.Utils.setBufferPoolMaxReservedSize
+            %
+            Utils_('setUseBufferPool', tf);
+        end
+
+        function s = getBufferPoolStats()
+            %GETBUFFERPOOLSTATS  Return usage statistics of the Mat buffer pool
+            %
+            %     s = cv.Utils.getBufferPoolStats()
+            %
+            % ## Output
+            % * __s__ a structure with the following fields (all `uint64`):
+            %   * __hits__ number of allocations served from reserved buffers.
+            %   * __misses__ number of pooled allocations that had to go to
+            %     the heap.
+            %   * __bypassed__ number of allocations too small to be pooled.
+            %   * __released__ number of buffers freed to the heap because
+            %     the pool was full.
+            %   * __bytesInUse__ bytes held by live pooled buffers.
+            %   * __bytesReserved__ bytes currently kept for reuse.
+            %   * __maxReservedSize__ capacity of the pool in bytes.
+            %
+            % See also: cv.Utils.resetBufferPoolStats
+            %
+            s = Utils_('getBufferPoolStats');
+        end
+
+        function resetBufferPoolStats()
+            %RESETBUFFERPOOLSTATS  Reset counters of the Mat buffer pool
+            %
+            %     cv.Utils.resetBufferPoolStats()
+            %
+            % Resets the `hits`, `misses`, `bypassed`, and `released` counters.
+            %
+            % See also: cv.Utils.getBufferPoolStats
+            %
+            Utils_('resetBufferPoolStats');
+        end
+
+        function setBufferPoolMaxReservedSize(sz)
+            %SETBUFFERPOOLMAXRESERVEDSIZE  Set capacity of the Mat buffer pool
+            %
+            %     cv.Utils.setBufferPoolMaxReservedSize(sz)
+            %
+            % ## Input
+            % * __sz__ maximum number of bytes kept for reuse. Reserved
+            %   buffers above the new capacity are freed. default 256MB
+            %
+            % See also: cv.Utils.freeAllReservedBuffers
+            %
+            Utils_('setBufferPoolMaxReservedSize', sz);
+        end
+
+        function freeAllReservedBuffers()
+            %FREEALLRESERVEDBUFFERS  Free all buffers reserved in the Mat buffer pool
+            %
+            %     cv.Utils.freeAllReservedBuffers()
+            %
+            % See also: cv.Utils.setBufferPoolMaxReservedSize
+            %
+            Utils_('freeAllReservedBuffers');
+        end
+    end
+
+    % Profiling
+    methods (Static)
+        function tf = useProfile()
+            %USEPROFILE  Check if profiling of MEX-function calls is enabled
+            %
+            %     tf = cv.Utils.useProfile()
+            %
+            % ## Output
+            % * __tf__ status flag
+            %
+            % See also: cv.Utils.setUseProfile
+            %
+            tf = Utils_('useProfile');
+        end
+
+        function setUseProfile(tf)
+            %SETUSEPROFILE  Enable/disable profiling of MEX-function calls
+            %
+            %     cv.Utils.setUseProfile(tf)
+            %
+            % ## Input
+            % * __tf__ flag
+            %
+            % When enabled, frequently used image processing functions
+            % (cv.GaussianBlur, cv.blur, cv.medianBlur, cv.cvtColor,
+            % cv.resize, cv.threshold, cv.Canny) record their number of
+            % calls and overall time, split between argument processing,
+            % conversion of images between MATLAB arrays and OpenCV
+            % matrices, computation, and output. Other functions are not
+            % profiled.
+            %
+            % Counters are shared by all functions of the process, and kept
+            % when profiling is disabled. Disabled by default. The flag is
+            % held in the global variable `MEXOPENCV_PROFILE`.
+            %
+            % See also: cv.Utils.useProfile, cv.Utils.getProfile,
+            %  cv.Utils.resetProfile
+            %
+            Utils_('setUseProfile', tf);
+        end
+
+        function s = getProfile()
+            %GETPROFILE  Return the counters recorded by profiling
+            %
+            %     s = cv.Utils.getProfile()
+            %
+            % ## Output
+            % * __s__ a struct array with one element per profiled function,
+            %   sorted by name, with the following fields:
+            %   * __name__ name of the MEX-function.
+            %   * __calls__ number of calls (`uint64`).
+            %   * __total__ total time of the calls, in seconds.
+            %   * __parse__ time spent processing arguments and options,
+            %     excluding image conversions, in seconds.
+            %   * __input__ time spent converting MATLAB arrays to OpenCV
+            %     matrices, in seconds.
+            %   * __kernel__ time spent in the OpenCV computation, in seconds.
+            %   * __output__ time spent converting results to MATLAB arrays
+            %     and creating the outputs, in seconds.
+            %   * __bytesIn__ bytes of MATLAB arrays converted (`uint64`).
+            %   * __bytesOut__ bytes of OpenCV matrices converted (`uint64`).
+            %   * __maxCallBytes__ most bytes converted by a single call
+            %     (`uint64`), input and output together. This is not the
+            %     peak memory use of the call.
+            %
+            % ## Example
+            % Find where time goes in a processing loop:
+            %
+            %     cv.Utils.setUseProfile(true);
+            %     cv.Utils.resetProfile();
+            %     img = imread(fullfile(mexopencv.root(),'test','img001.jpg'));
+            %     for i=1:100
+            %         out = cv.GaussianBlur(img, 'KSize',[5 5]);
+            %         out = cv.cvtColor(out, 'RGB2GRAY');
+            %     end
+            %     s = cv.Utils.getProfile();
+            %     cv.Utils.setUseProfile(false);
+            %     disp(struct2table(s))
+            %
+            % See also: cv.Utils.resetProfile
+            %
+            s = Utils_('getProfile');
+        end
+
+        function resetProfile()
+            %RESETPROFILE  Clear the counters recorded by profiling
+            %
+            %     cv.Utils.resetProfile()
+            %
+            % See also: cv.Utils.getProfile
+            %
+            Utils_('resetProfile');
+        end
+    end
+
+    % Objects
+    methods (Static)
+        function ids = liveObjects(name)
+            %LIVEOBJECTS  Ids of the live objects of a class
+            %
+            %     ids = cv.Utils.liveObjects(name)
+            %
+            % ## Input
+            % * __name__ name of a class of the package, without the `cv.`
+            %   prefix, e.g 'VideoCapture'.
+            %
+            % ## Output
+            % * __ids__ row vector of the `id` of every object of the class
+            %   that was created and not deleted yet.
+            %
+            % Useful to find objects that were never released, e.g. at the
+            % end of a test. Only classes of the main mexopencv module are
+            % supported, not those of opencv_contrib.
+            %
+            % ## Example
+            %
+            %     cap = cv.VideoCapture();
+            %     ids = cv.Utils.liveObjects('VideoCapture')  % has cap.id
+            %
+            if ~ischar(name) || ~isvarname(name)
+                error('mexopencv:error', 'Invalid class name');
+            end
+            ids = feval([name '_'], 0, 'liveObjects');
+        end
+    end
+
+    methods (Static, Hidden)
+        function recordProfile(name, counters)
+            %RECORDPROFILE  Add counters to the profile of a function
+            %
+            %     cv.Utils.recordProfile(name, counters)
+            %
+            % ## Input
+            % * __name__ name of the function.
+            % * __counters__ vector of 9 values, in the order of the fields
+            %   returned by cv.Utils.getProfile, starting with `calls`.
+            %
+            % Called by MEX-functions to send what they recorded, the
+            % counters of all of them are kept in a single place.
+            %
+            % See also: cv.Utils.getProfile
+            %
+            Utils_('recordProfile', name, counters);
+        end
+    end
+
 end
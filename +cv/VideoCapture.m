@@ -267,6 +267,12 @@ function successFlag = open(this, index, varargin)
             %   * __Aravis__ Aravis GigE SDK.
             %   * __MotionJPEG__ Built-in OpenCV MotionJPEG codec.
             %   * __MediaSDK__ Intel MediaSDK.
+            % * __Prefetch__ number of frames to decode ahead in a background
+            %   thread. When positive, a worker thread keeps up to that many
+            %   frames decoded and already converted to MATLAB layout, so that
+            %   cv.VideoCapture.read only has to copy the next one out.
+            %   Requires mexopencv to be compiled with C++11 support.
+            %   default 0 (no prefetching)
             %
             % The method first calls cv.VideoCapture.release to close the
             % already opened file or camera.
@@ -279,6 +285,11 @@ function successFlag = open(this, index, varargin)
             %
             %     cap.open(1, 'API','MediaFoundation')
             %
+            % To overlap decoding of a video file with processing in MATLAB,
+            % keep up to 8 frames decoded ahead:
+            %
+            %     cap.open('video.avi', 'Prefetch',8)
+            %
             % ### Note
             % Backends are available only if they have been built with your
             % OpenCV binaries.
@@ -342,11 +353,59 @@ function frame = read(this, varargin)
             % grabbed (camera has been disconnected, or there are no more
             % frames in video file), the function return an empty matrix.
             %
+            % With the `Prefetch` option of cv.VideoCapture.open, the frame is
+            % taken from the queue filled by the background thread, waiting
+            % for it if needed.
+            %
             % See also: cv.VideoCapture.grab, cv.VideoCapture.retrieve
             %
             frame = VideoCapture_(this.id, 'read', varargin{:});
         end
 
+        function frames = readBatch(this, n, varargin)
+            %READBATCH  Grabs, decodes and returns several video frames at once
+            %
+            %     frames = cap.readBatch(n)
+            %     frames = cap.readBatch(n, 'OptionName',optionValue, ...)
+            %
+            % ## Input
+            % * __n__ maximum number of frames to return.
+            %
+            % ## Output
+            % * __frames__ output images stacked along the 4th dimension, a
+            %   `H-by-W-by-C-by-N` array (typically `uint8`), where `N <= n`.
+            %   An empty matrix if no frame could be read.
+            %
+            % ## Options
+            % * __Stride__ distance between returned frames. Only every
+            %   `Stride`-th frame is decoded, frames in between are grabbed
+            %   and skipped. default 1
+            % * __Range__ frames to read as a `[start,end)` pair of 0-based
+            %   frame indices. The capture is first positioned at `start`
+            %   (see `PosFrames`), and no frame past `end` is returned.
+            %   By default frames are read from the current position.
+            % * __FlipChannels__ in case the output is color image, flips the
+            %   color order from OpenCV's BGR to MATLAB's RGB order.
+            %   default true
+            %
+            % This is equivalent to calling cv.VideoCapture.read repeatedly
+            % (and cv.VideoCapture.grab to skip frames), but with a single
+            % call and a single output array, into which frames are decoded
+            % directly. Fewer than `n` frames are returned when the end of the
+            % stream (or of `Range`) is reached. All frames must have the
+            % same size and type.
+            %
+            % ## Example
+            % Read every 5th frame among the first 100 frames of a video:
+            %
+            %     cap = cv.VideoCapture('video.avi');
+            %     frames = cap.readBatch(20, 'Stride',5, 'Range',[0 100]);
+            %
+            % See also: cv.VideoCapture.read, cv.VideoCapture.grab
+            %
+            frames = VideoCapture_(this.id, 'readBatch', n, varargin{:});
+        end
+
         function successFlag = grab(this)
             %GRAB  Grabs the next frame from video file or capturing device
             %
@@ -429,6 +488,10 @@ function value = get(this, prop)
             % (eg. steps or percentage). Effective behaviour depends from
             % device driver and API Backend.
             %
+            % With the `Prefetch` option of cv.VideoCapture.open, position
+            % properties (`PosMsec`, `PosFrames`, `PosAviRatio`) describe the
+            % last frame returned, not the frames decoded ahead.
+            %
             % ## Example
             % All the following are equivalent:
             %
@@ -459,6 +522,11 @@ function set(this, prop, value)
             % the property value has been accepted by the capture device.
             % See note in cv.VideoCapture.get.
             %
+            % With the `Prefetch` option of cv.VideoCapture.open, frames
+            % decoded ahead are discarded and background decoding restarts
+            % with the new setting, from the last frame returned unless a
+            % position property was set.
+            %
             % See also: cv.VideoCapture.get
             %
             VideoCapture_(this.id, 'set', prop, value);
@@ -129,6 +129,16 @@ function successFlag = open(this, filename, frameSize, varargin)
             % * __Color__ If true, the encoder will expect and encode color
             %   frames, otherwise it will work with grayscale frames (the flag
             %   is currently supported on Windows only). default true
+            % * __QueueSize__ when positive, frames are encoded
+            %   asynchronously: cv.VideoWriter.write only converts the frame
+            %   and appends it to a queue of at most that many frames, which a
+            %   background thread encodes. Requires mexopencv to be compiled
+            %   with C++11 support. default 0 (synchronous encoding)
+            % * __Backpressure__ what cv.VideoWriter.write does when the
+            %   encoding queue is full. One of:
+            %   * __Block__ wait for the encoder to catch up (default).
+            %   * __DropOldest__ discard the oldest queued frame.
+            %   * __Error__ raise an error, the frame is not written.
             %
             % The method first calls cv.VideoWriter.release to close the
             % already opened file.
@@ -186,11 +196,75 @@ function release(this)
             % The method is automatically called by subsequent
             % cv.VideoWriter.open and by the cv.VideoWriter destructor.
             %
+            % In asynchronous mode (see `QueueSize` option), frames still in
+            % the queue are encoded before the file is closed. If a frame
+            % failed to be encoded, an error reporting the failure and the
+            % number of frames that were not written is raised once the file
+            % is closed (the destructor and cv.VideoWriter.open only issue a
+            % warning).
+            %
             % See also: cv.VideoWriter.open
             %
             VideoWriter_(this.id, 'release');
         end
 
+        function flush(this)
+            %FLUSH  Waits until all queued frames are encoded
+            %
+            %     vid.flush()
+            %
+            % Only relevant in asynchronous mode (see `QueueSize` option of
+            % cv.VideoWriter.open), otherwise frames are already encoded when
+            % cv.VideoWriter.write returns.
+            %
+            % An error is raised if encoding of a queued frame failed. The
+            % queue is then unusable, and the writer must be reopened.
+            %
+            % See also: cv.VideoWriter.write, cv.VideoWriter.getQueueStats
+            %
+            VideoWriter_(this.id, 'flush');
+        end
+
+        function stats = getQueueStats(this)
+            %GETQUEUESTATS  Returns counters of the asynchronous encoding queue
+            %
+            %     stats = vid.getQueueStats()
+            %
+            % ## Output
+            % * __stats__ struct with the following fields:
+            %   * __queued__ number of frames accepted by
+            %     cv.VideoWriter.write.
+            %   * __dropped__ number of frames discarded by the `DropOldest`
+            %     backpressure policy.
+            %   * __encoded__ number of frames written to the video.
+            %   * __pending__ number of frames currently waiting in the queue.
+            %   * __lastEncodeTime__ time (msec) taken to encode the last
+            %     frame.
+            %   * __meanEncodeTime__ mean time (msec) taken to encode a frame.
+            %   * __maxEncodeTime__ longest time (msec) taken to encode a
+            %     frame.
+            %   * __meanLatency__ mean time (msec) from cv.VideoWriter.write
+            %     to the end of encoding of a frame, including time spent in
+            %     the queue.
+            %
+            % All counters are zero in synchronous mode. They are reset when
+            % the writer is opened, and by cv.VideoWriter.resetQueueStats.
+            %
+            % See also: cv.VideoWriter.open, cv.VideoWriter.resetQueueStats
+            %
+            stats = VideoWriter_(this.id, 'getQueueStats');
+        end
+
+        function resetQueueStats(this)
+            %RESETQUEUESTATS  Resets counters of the asynchronous encoding queue
+            %
+            %     vid.resetQueueStats()
+            %
+            % See also: cv.VideoWriter.getQueueStats
+            %
+            VideoWriter_(this.id, 'resetQueueStats');
+        end
+
         function write(this, frame, varargin)
             %WRITE  Writes the next video frame
             %
@@ -209,6 +283,11 @@ function write(this, frame, varargin)
             % have the same size as has been specified when opening the video
             % writer.
             %
+            % In asynchronous mode (see `QueueSize` option of
+            % cv.VideoWriter.open), the frame is only queued, and the
+            % configured `Backpressure` policy applies when the queue is full.
+            % Errors from encoding previous frames are reported here.
+            %
             % See also: cv.VideoWriter.open
             %
             VideoWriter_(this.id, 'write', frame, varargin{:});
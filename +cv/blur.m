@@ -22,6 +22,10 @@
 %
 %     K = ones(KSize) / prod(KSize)
 %
+% `src` can also be a batch of images, either a cell array of images or an
+% `M-by-N-by-C-by-F` stack of `F` frames. The images are then smoothed in
+% parallel, and `dst` is a batch of the same kind.
+%
 % See also: cv.boxFilter, cv.bilateralFilter, cv.GaussianBlur, cv.medianBlur,
 %  imfilter, fspecial
 %
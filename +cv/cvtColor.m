@@ -93,6 +93,10 @@
 %   0, the number of the channels is derived automatically from `src` and
 %   `code`.
 %
+% `src` can also be a batch of images, either a cell array of images or an
+% `M-by-N-by-C-by-F` stack of `F` frames. The images are then converted in
+% parallel, and `dst` is a batch of the same kind.
+%
 % The function converts an input image from one color space to another. In case
 % of a transformation to-from RGB color space, the order of the channels should
 % be specified explicitly (RGB or BGR). Note that the default color format in
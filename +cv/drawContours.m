@@ -8,6 +8,9 @@
 % * __contours__ All the input contours. Each contour is stored as a 2D point
 %   vector (integer points). A cell array of cell arrays of the form:
 %   `{{[x,y],[x,y],...}, ...}`, or a cell array of Nx2 matrices.
+%   It can also be a packed structure with fields `points` (N-by-2) and
+%   `offsets` (zero-based start index of each of the K contours, plus N), as
+%   returned by cv.findContours with the `OutputFormat='Packed'` option.
 %
 % ## Output
 % * __im__ Destination image, same size and type as input `im`.
@@ -26,5 +26,9 @@
 % The algorithm normalizes the brightness and increases the contrast of the
 % image.
 %
+% `src` can also be a batch of images, either a cell array of images or an
+% `M-by-N-by-1-by-F` stack of `F` frames, each one equalized separately (in
+% parallel). `dst` is then a batch of the same kind.
+%
 % See also: cv.calcHist, cv.integral, histeq, imhistmatch
 %
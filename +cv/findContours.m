@@ -25,7 +25,8 @@
 %   respectively. If for the i-th contour there are no next, previous, parent,
 %   or nested contours, the corresponding elements of `hierarchy{i}` will be
 %   negative. A cell array of 4-element integer vectors of the form
-%   `{[next,prev,child,parent], ...}`.
+%   `{[next,prev,child,parent], ...}`. In the packed output format, a
+%   K-by-4 `int32` matrix with one row `[next,prev,child,parent]` per contour.
 %
 % ## Options
 % * __Mode__ Contour retrieval mode,  default is 'List'. One of:
@@ -57,6 +58,19 @@
 % * __Offset__ Optional offset by which every contour point is shifted. This
 %   is useful if the contours are extracted from the image ROI and then they
 %   should be analyzed in the whole image context. default [0,0]
+% * __OutputFormat__ Format of the returned contours, default 'Cell'. One of:
+%   * __Cell__ a cell array of cell arrays of points, as described above.
+%   * __Packed__ a scalar structure in compressed sparse row form, with the
+%     following fields:
+%     * __points__ N-by-2 `int32` matrix of the points of all K contours,
+%       one after the other, `[x,y; x,y; ...]`.
+%     * __offsets__ (K+1)-by-1 `int32` vector of zero-based start indices of
+%       each contour in `points`, starting at 0 and ending at N. The i-th
+%       contour is `points(offsets(i)+1:offsets(i+1),:)`.
+%
+%     This form only allocates two arrays regardless of the number of
+%     contours, and is much faster for images with many contours. It is
+%     accepted as input by cv.drawContours, cv.fillPoly, and cv.polylines.
 %
 % The function retrieves contours from the binary image using the algorithm
 % [Suzuki85]. The contours are a useful tool for shape analysis and object
@@ -21,6 +21,9 @@
 %   default true
 % * __Grayscale__ If set, always convert image to the single channel grayscale
 %   image. default false
+% * __ReduceScale__ Decodes the image reduced by a scale factor (JPEG library
+%   natively supports direct image scaling, other formats are resized after
+%   decoding). One of `1` (no scaling, default), `2`, `4` or `8`.
 % * __IgnoreOrientation__ If set, do not rotate the image according to EXIF's
 %   orientation flag. default false
 % * __Flags__ Advanced option to directly set the flag specifying the depth
@@ -0,0 +1,34 @@
+%IMDECODEBATCH  Decodes a batch of images from memory buffers in parallel
+%
+%     imgs = cv.imdecodeBatch(bufs)
+%     imgs = cv.imdecodeBatch(bufs, 'OptionName',optionValue, ...)
+%     [imgs, ok, msgs] = cv.imdecodeBatch(...)
+%
+% ## Input
+% * __bufs__ Cell array of input buffers, each a vector of bytes (as
+%   returned by cv.imencode or cv.imencodeBatch).
+%
+% ## Output
+% * __imgs__ Decoded images, a cell array of the same size as `bufs`.
+%   Elements of buffers that could not be decoded are empty. If the `Stack`
+%   option is set, a single `M-by-N-by-C-by-F` array of the `F` images.
+% * __ok__ optional output, logical vector, true for each buffer that was
+%   decoded successfully.
+% * __msgs__ optional output, cell array of error messages, empty for
+%   buffers that were decoded successfully.
+%
+% ## Options
+% * __Stack__ If set, return the images stacked along the 4th dimension
+%   instead of a cell array. All images must then have the same size and
+%   type as the first one that is decoded, the others are reported as errors
+%   and their frames left as zeros. default false
+%
+% Other options are the same as cv.imdecode.
+%
+% Buffers are decoded on worker threads (`uint8` buffers are used without
+% being copied). A buffer that cannot be decoded does not stop the others:
+% failures are reported in the `ok` and `msgs` outputs if requested,
+% otherwise a single warning is issued.
+%
+% See also: cv.imdecode, cv.imencodeBatch, cv.imreadBatch
+%
@@ -0,0 +1,32 @@
+%IMENCODEBATCH  Encodes a batch of images into memory buffers in parallel
+%
+%     bufs = cv.imencodeBatch(ext, imgs)
+%     bufs = cv.imencodeBatch(ext, imgs, 'OptionName',optionValue, ...)
+%     [bufs, ok, msgs] = cv.imencodeBatch(...)
+%
+% ## Input
+% * __ext__ File extension that defines the output format. For example:
+%   '.bmp', '.jpg', '.png', '.tif', etc.
+% * __imgs__ Images to be encoded, either a cell array of images, or an
+%   `M-by-N-by-C-by-F` array of `F` images.
+%
+% ## Output
+% * __bufs__ Cell array of output buffers, each a row vector of type `uint8`
+%   with the encoded image. It has the same size as `imgs` if it is a cell
+%   array, otherwise it is `1-by-F`. Elements of images that could not be
+%   encoded are empty.
+% * __ok__ optional output, logical vector, true for each image that was
+%   encoded successfully.
+% * __msgs__ optional output, cell array of error messages, empty for
+%   images that were encoded successfully.
+%
+% ## Options
+% The options are the same as cv.imencode (`FlipChannels` and the
+% format-specific parameters).
+%
+% Images are converted and encoded on worker threads. An image that cannot
+% be encoded does not stop the others: failures are reported in the `ok`
+% and `msgs` outputs if requested, otherwise a single warning is issued.
+%
+% See also: cv.imencode, cv.imdecodeBatch, cv.imwriteBatch
+%
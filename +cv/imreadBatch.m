@@ -0,0 +1,43 @@
+%IMREADBATCH  Loads a batch of images from files in parallel
+%
+%     imgs = cv.imreadBatch(filenames)
+%     imgs = cv.imreadBatch(filenames, 'OptionName',optionValue, ...)
+%     [imgs, ok, msgs] = cv.imreadBatch(...)
+%
+% ## Input
+% * __filenames__ Cell array of names of the files to be loaded.
+%
+% ## Output
+% * __imgs__ Loaded images, a cell array of the same size as `filenames`.
+%   Elements of files that could not be read are empty. If the `Stack`
+%   option is set, a single `M-by-N-by-C-by-F` array of the `F` images.
+% * __ok__ optional output, logical vector, true for each file that was
+%   loaded successfully.
+% * __msgs__ optional output, cell array of error messages, empty for files
+%   that were loaded successfully.
+%
+% ## Options
+% * __Stack__ If set, return the images stacked along the 4th dimension
+%   instead of a cell array. All images must then have the same size and
+%   type as the first one that is loaded, the others are reported as errors
+%   and their frames left as zeros. default false
+%
+% Other options are the same as cv.imread (`Unchanged`, `AnyDepth`,
+% `AnyColor`, `Color`, `Grayscale`, `GDAL`, `ReduceScale`,
+% `IgnoreOrientation`, `Flags`, `FlipChannels`).
+%
+% Files are read and decoded on worker threads, which is much faster than
+% calling cv.imread in a loop on a multi-core machine. A file that cannot be
+% read does not stop the others from being loaded: failures are reported in
+% the `ok` and `msgs` outputs if requested, otherwise a single warning is
+% issued. Decoded images are converted to MATLAB arrays in chunks, so the
+% extra memory used does not grow with the size of the batch.
+%
+% ## Example
+%
+%     files = dir(fullfile(mexopencv.root(),'test','*.jpg'));
+%     files = fullfile({files.folder}, {files.name});
+%     [imgs, ok] = cv.imreadBatch(files, 'ReduceScale',2);
+%
+% See also: cv.imread, cv.imdecodeBatch, cv.imwriteBatch
+%
@@ -43,5 +43,5 @@
 %
 % See cv.imread for details.
 %
-% See also: cv.imread, imread, multibandread
+% See also: cv.imread, cv.MultiPageReader, imread, multibandread
 %
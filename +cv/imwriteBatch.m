@@ -0,0 +1,29 @@
+%IMWRITEBATCH  Saves a batch of images to files in parallel
+%
+%     cv.imwriteBatch(filenames, imgs)
+%     cv.imwriteBatch(filenames, imgs, 'OptionName',optionValue, ...)
+%     [ok, msgs] = cv.imwriteBatch(...)
+%
+% ## Input
+% * __filenames__ Cell array of names of the files, one per image. The
+%   format of each file is chosen from its extension.
+% * __imgs__ Images to be saved, either a cell array of images, or an
+%   `M-by-N-by-C-by-F` array of `F` images.
+%
+% ## Output
+% * __ok__ optional output, logical vector, true for each image that was
+%   saved successfully.
+% * __msgs__ optional output, cell array of error messages, empty for
+%   images that were saved successfully.
+%
+% ## Options
+% The options are the same as cv.imwrite (`FlipChannels` and the
+% format-specific parameters).
+%
+% Images are converted, encoded and written on worker threads. An image that
+% cannot be saved does not stop the others: failures are reported in the
+% `ok` and `msgs` outputs if requested, otherwise a single warning is
+% issued.
+%
+% See also: cv.imwrite, cv.imreadBatch, cv.imencodeBatch
+%
@@ -22,6 +22,10 @@
 % Note: The median filter uses `BorderType=Replicate` internally to cope with
 % border pixels. See cv.copyMakeBorder.
 %
+% `src` can also be a batch of images, either a cell array of images or an
+% `M-by-N-by-C-by-F` stack of `F` frames. The images are then filtered in
+% parallel, and `dst` is a batch of the same kind.
+%
 % See also: cv.bilateralFilter, cv.blur, cv.boxFilter, cv.GaussianBlur,
 %  medfilt2
 %
@@ -8,6 +8,9 @@
 % * __pts__ Array of polygonal curves, where each polygon is represented as an
 %   array of points. A cell array of cell arrays of 2-element vectors, in the
 %   form `{{[x,y], [x,y], ...}, ...}`, or a cell array of Nx2 matries.
+%   It can also be a packed structure with fields `points` (N-by-2) and
+%   `offsets` (zero-based start index of each of the K curves, plus N), as
+%   returned by cv.findContours with the `OutputFormat='Packed'` option.
 %
 % ## Output
 % * __img__ Output image, same size and type as input `img`.
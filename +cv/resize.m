@@ -44,5 +44,9 @@
 % whereas to enlarge an image, it will generally look best with 'Cubic' (slow)
 % or 'Linear' (faster but still looks OK).
 %
+% `src` can also be a batch of images, either a cell array of images or an
+% `M-by-N-by-C-by-F` stack of `F` frames. The images are then resized in
+% parallel, and `dst` is a batch of the same kind.
+%
 % See also: cv.warpAffine, cv.warpPerspective, cv.remap, imresize
 %
@@ -48,6 +48,11 @@
 % inverted with cv.invertAffineTransform and then put in the formula above
 % instead of `M`.
 %
+% `src` can also be a batch of images, either a cell array of images or an
+% `M-by-N-by-C-by-F` stack of `F` frames, all warped in parallel with the same
+% transformation. `dst` is then a batch of the same kind (the `Dst` option is
+% not supported in that case).
+%
 % See also: cv.warpPerspective, cv.remap, cv.resize, cv.getRectSubPix,
 %  cv.transform, imtransform, imwarp, imtranslate, imrotate
 %
@@ -16,6 +16,7 @@ function make(varargin)
 %   default `false`.
 % * __clean__ clean all compiled MEX files. default `false`
 % * __test__ run all unit-tests. default `false`
+% * __perf__ run all performance benchmarks. default `false`
 % * __dryrun__ dont actually run commands, just print them. default `false`
 % * __force__ Unconditionally build all files. default `false`
 % * __verbose__ output verbosity. The higher the number, the more output is
@@ -38,6 +39,7 @@ function make(varargin)
 %     mexopencv.make(..., 'opencv_contrib', true)  % build with contrib modules
 %     mexopencv.make('clean',true)                 % clean MEX files
 %     mexopencv.make('test',true)                  % run unittests
+%     mexopencv.make('perf',true)                  % run benchmarks
 %     mexopencv.make('dryrun',true, 'force',true)  % print commands used to build
 %     mexopencv.make(..., 'verbose',2)             % verbose compiler output
 %     mexopencv.make(..., 'progress',true)         % show progress bar
@@ -72,6 +74,12 @@ function make(varargin)
         return;
     end
 
+    % Benchmarks
+    if opts.perf
+        target_perf(opts);
+        return;
+    end
+
     % in Octave, set "more off" locally for this function
     if mexopencv.isOctave()
         page_output_immediately(true, 'local');  % auto flush output
@@ -184,6 +192,7 @@ function makefile_unix(opts)
     if opts.clean          , targets = ['clean' targets]; end
     if opts.opencv_contrib , targets{end+1} = 'contrib'; end
     if opts.test           , targets{end+1} = 'test'; end
+    if opts.perf           , targets{end+1} = 'perf'; end
     targets = strtrim(sprintf(' %s', targets{:}));
 
     % call Makefile
@@ -255,6 +264,17 @@ function target_test(opts)
     end
 end
 
+function target_perf(opts)
+    %TARGET_PERF  make perf
+    %
+
+    if opts.verbose > 0, fprintf('Running benchmarks...\n'); end
+    cd(fullfile(mexopencv.root(),'test'));
+    if ~opts.dryrun
+        PerfTest('Verbosity',opts.verbose);
+    end
+end
+
 function mex_flags = mex_options(opts)
     %MEX_OPTIONS  Construct options string to pass to MEX command
     %
@@ -742,6 +762,7 @@ function opts = getargs(varargin)
     opts.opencv_contrib = false;     % optional/extra OpenCV modules
     opts.clean = false;              % clean mode
     opts.test = false;               % unittest mode
+    opts.perf = false;               % benchmark mode
     opts.dryrun = false;             % dry run mode
     opts.force = false;              % force recompilation of all files
     opts.verbose = 1;                % output verbosity
@@ -767,6 +788,8 @@ function opts = getargs(varargin)
                 opts.clean = logical(val);
             case 'test'
                 opts.test = logical(val);
+            case 'perf'
+                opts.perf = logical(val);
             case 'dryrun'
                 opts.dryrun = logical(val);
             case 'force'
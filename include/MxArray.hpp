@@ -114,10 +114,42 @@ template<> struct MxTypes<bool> {
  * @param userdata optional user data pointer (unused).
  * @return zero code.
  * @sa cv::redirectError
+ *
+ * The MATLAB error is only raised on the MATLAB thread. Called from any
+ * other thread (workers of cv::parallel_for_, or background threads), it
+ * returns immediately so that OpenCV throws a cv::Exception instead, to be
+ * caught on that thread and reported back on the MATLAB thread.
  */
 int MexErrorHandler(int status, const char *func_name, const char *err_msg,
     const char *file_name, int line, void *userdata);
 
+/** Make cv::error() throw for the lifetime of the object.
+ *
+ * Suspends the error callback installed with cv::redirectError (such as
+ * MexErrorHandler), and restores it on destruction. Used on the MATLAB
+ * thread around cv::parallel_for_ regions, where the calling thread also
+ * runs loop bodies: errors are caught in the bodies and reported once the
+ * loop is over, instead of leaving the loop while workers still run.
+ */
+class ErrorCallbackSuspender
+{
+  public:
+    /// Suspend the current error callback
+    ErrorCallbackSuspender()
+    : data_(0), callback_(cv::redirectError(0, 0, &data_))
+    {}
+    /// Restore the suspended error callback
+    ~ErrorCallbackSuspender() { cv::redirectError(callback_, data_); }
+  private:
+    // non-copyable
+    ErrorCallbackSuspender(const ErrorCallbackSuspender&);
+    ErrorCallbackSuspender& operator=(const ErrorCallbackSuspender&);
+    /// user data of the suspended callback
+    void *data_;
+    /// suspended callback
+    cv::ErrorCallback callback_;
+};
+
 /** mxArray object wrapper for data conversion and manipulation.
  */
 class MxArray
@@ -317,6 +349,34 @@ class MxArray
             mexErrMsgIdAndTxt("mexopencv:error", "Allocation error");
         return MxArray(pm);
     }
+    /** Create a new numeric matrix.
+     * @param m Number of rows.
+     * @param n Number of cols.
+     * @param classid class of the array, e.g. \c mxUINT8_CLASS.
+     * @return MxArray object, a 2D real numeric array initialized to zeros.
+     *
+     * Example:
+     * @code
+     * MxArray out = MxArray::Numeric(rhs[0].rows(), rhs[0].cols(), mxUINT8_CLASS);
+     * cv::Mat dst(out.toMatView());
+     * @endcode
+     */
+    static inline MxArray Numeric(mwSize m, mwSize n, mxClassID classid)
+    {
+        mxArray *pm = (classid == mxLOGICAL_CLASS) ?
+            mxCreateLogicalMatrix(m, n) :
+            mxCreateNumericMatrix(m, n, classid, mxREAL);
+        if (!pm)
+            mexErrMsgIdAndTxt("mexopencv:error", "Allocation error");
+        return MxArray(pm);
+    }
+    /** Create a new N-dimensional numeric array.
+     * @param dims dimensions of the array.
+     * @param depth OpenCV depth matching the class of the array,
+     *    e.g. \c CV_8U for \c uint8.
+     * @return MxArray object, a real numeric array initialized to zeros.
+     */
+    static MxArray Numeric(const std::vector<mwSize>& dims, int depth);
     /** Clone mxArray. This allocates new mxArray*.
      * @return MxArray object, a deep-copy clone.
      */
@@ -411,6 +471,86 @@ class MxArray
      * @endcode
      */
     cv::MatND toMatND(int depth = CV_USRTYPE1, bool transpose = true) const;
+    /** Wrap MxArray data in a single-channel cv::Mat header, without copying.
+     * @return cv::Mat header sharing data with the MxArray.
+     *
+     * This is an opt-in zero-copy alternative to toMat for element-wise
+     * operations, where the memory layout does not matter. Since MATLAB
+     * stores arrays in column-major order, an \c MxN array is seen as its
+     * \c NxM transpose (any dimensions beyond the second are folded into the
+     * rows of the header). Only real dense arrays whose class maps exactly
+     * to an OpenCV depth (see isMatViewable) are supported.
+     *
+     * The header does not own the data; it is valid only as long as the
+     * mxArray is alive. Writing through it modifies the array in-place,
+     * which should only ever be done on arrays created by the MEX-function
+     * itself, never on its right-hand side arguments.
+     *
+     * Example:
+     * @code
+     * MxArray out = MxArray::Numeric(rhs[0].rows(), rhs[0].cols(), rhs[0].classID());
+     * cv::Mat src(rhs[0].toMatView()), dst(out.toMatView());
+     * cv::bitwise_not(src, dst);  // result is written directly into out
+     * plhs[0] = out;
+     * @endcode
+     */
+    cv::Mat toMatView() const;
+    /** Rearrange cv::Mat data into the memory layout of MATLAB arrays.
+     * @param mat cv::Mat object (any number of dimensions and channels).
+     * @return continuous single-channel cv::Mat of the same depth, with
+     *    dimensions <tt>(channels, dim N, ..., dim 1)</tt>. Its row-major
+     *    data is exactly the column-major data of the MxArray that
+     *    MxArray(mat) would create, so it can later be copied as-is into a
+     *    numeric array of size <tt>(dim 1, ..., dim N, channels)</tt>.
+     *
+     * This performs the expensive part of the cv::Mat to MxArray conversion
+     * without calling any MEX API function, so unlike the MxArray
+     * constructor it can be used from worker threads.
+     */
+    static cv::Mat toColumnMajor(const cv::Mat& mat);
+    /** Rearrange cv::Mat data into the memory layout of MATLAB arrays.
+     * @param mat cv::Mat object (any number of dimensions and channels).
+     * @param out destination, allocated as in toColumnMajor(mat) unless it
+     *    already has the expected dimensions and depth, in which case the
+     *    data is written in place (e.g. into a header over a slice of a
+     *    preallocated MxArray).
+     */
+    static void toColumnMajor(const cv::Mat& mat, cv::Mat& out);
+    /** Create a numeric array from data prepared by toColumnMajor.
+     * @param mat continuous cv::Mat returned by toColumnMajor.
+     * @param flipChannels whether to reverse the order of the channels when
+     *    there are three of them (i.e BGR to RGB), at no extra cost.
+     * @return MxArray object of size <tt>(dim 1, ..., dim N, channels)</tt>,
+     *    an empty \c double matrix when \p mat is empty.
+     *
+     * Only allocation and plain memory copies happen here.
+     */
+    static MxArray fromColumnMajor(const cv::Mat& mat,
+        bool flipChannels = false);
+    /** Fill a cv::Mat from data in the memory layout of MATLAB arrays.
+     * @param data column-major planar data of a <tt>M-by-N-by-C</tt> array,
+     *    e.g. a slice of a larger numeric array.
+     * @param sdepth depth of the source elements, e.g. \c CV_8U.
+     * @param mat destination, already allocated as a 2D <tt>M-by-N</tt>
+     *    matrix of \c C channels. Elements are converted to its depth.
+     *
+     * This is the inverse of toColumnMajor for 2D matrices, and likewise
+     * does not call any MEX API function.
+     */
+    static void columnMajorToMat(const void *data, int sdepth, cv::Mat& mat);
+    /** Determine whether the array is a cv.MatHandle object.
+     * @return true if the array is an instance of cv.MatHandle.
+     */
+    inline bool isMatHandle() const
+    {
+        return !isNull() && mxIsClass(p_, "cv.MatHandle");
+    }
+    /** Determine whether the array can be wrapped by toMatView.
+     * @return true if the array is real, dense and of class \c double,
+     *         \c single, \c int8, \c uint8, \c int16, \c uint16 or
+     *         \c int32, false otherwise.
+     */
+    bool isMatViewable() const;
     /** Convert double sparse MxArray to 2D single-channel cv::SparseMat.
      * @param depth depth of cv::SparseMat. e.g., \c CV_32F, \c CV_64F. When
      *    \c CV_USERTYPE1 is specified, depth will be automatically determined
@@ -1817,6 +1957,10 @@ std::vector<cv::RotatedRect> MxArray::toVector() const;
  *   <tt>{struct('pt',[x,y], 'size',[a,b], 'angle',t), ...}</tt>
  * - a structure-array of length \c N, in the form:
  *   <tt>struct('pt',{[x,y],...}, 'size',{[a,b],...}, 'angle',{t,...})</tt>
+ * - a scalar struct of arrays, where \c pt is an \c Nx2 matrix and the
+ *   remaining fields are vectors of length \c N, in the form:
+ *   <tt>struct('pt',[x1,y1; x2,y2; ...], 'size',[s1; s2; ...], ...)</tt>
+ *   (converted with bulk copies, see toStructOfArrays)
  * .
  * where \c N will be the output vector size.
  *
@@ -1837,6 +1981,9 @@ std::vector<cv::KeyPoint> MxArray::toVector() const;
  *   <tt>{struct('queryIdx',i, 'trainIdx',j, 'distance',d), ...}</tt>
  * - a structure-array of length \c N, in the form:
  *   <tt>struct('queryIdx',{i,...}, 'trainIdx',{j,...}, 'distance',{d,...})</tt>
+ * - a scalar struct of arrays, with fields being vectors of length \c N,
+ *   in the form:
+ *   <tt>struct('queryIdx',[i1;i2;...], 'trainIdx',[j1;j2;...], ...)</tt>
  * .
  * where \c N will be the output vector size.
  *
@@ -1849,4 +1996,198 @@ std::vector<cv::KeyPoint> MxArray::toVector() const;
 template <>
 std::vector<cv::DMatch> MxArray::toVector() const;
 
+/** Process-wide pool of recycled cv::Mat buffers.
+ *
+ * Released buffers are kept in size buckets (four per power of two) up to
+ * a maximum reserved size, so that calls processing frames of the same size
+ * reuse memory instead of going back to the heap each time. Allocations
+ * smaller than a page bypass the pool.
+ *
+ * The pool is enabled by installing its allocator as the default
+ * cv::MatAllocator of OpenCV, which is shared by all MEX-files in the
+ * process. From then on, both the temporaries of MxArray conversions and
+ * the outputs of OpenCV algorithms are served from the pool.
+ *
+ * Each MEX-file links its own copy of this class, and buffers remember the
+ * allocator that created them. The MEX-file that installs the pool must
+ * therefore stay locked in memory (see \c mexLock) for as long as any of its
+ * buffers may be alive, which in practice means until MATLAB exits.
+ */
+class MatBufferPool
+{
+public:
+    /// Pool usage counters
+    struct Stats
+    {
+        size_t hits;             ///< allocations served from reserved buffers
+        size_t misses;           ///< pooled allocations that hit the heap
+        size_t bypassed;         ///< allocations too small to be pooled
+        size_t released;         ///< buffers freed because pool was full
+        size_t bytesInUse;       ///< bytes held by live pooled buffers
+        size_t bytesReserved;    ///< bytes kept in the pool for reuse
+        size_t maxReservedSize;  ///< capacity of the pool in bytes
+    };
+
+    /** Allocator backed by the pool
+     * @return pointer to the pool allocator (never deleted).
+     */
+    static cv::MatAllocator* allocator();
+    /** Install or uninstall the pool as default OpenCV allocator
+     * @param enable whether to install the pool allocator, or restore the
+     *   standard OpenCV allocator. Disabling also frees reserved buffers.
+     */
+    static void install(bool enable);
+    /** Check if the pool is the current default OpenCV allocator
+     * @return true if installed.
+     */
+    static bool installed();
+    /** Get pool usage counters
+     * @return current statistics.
+     */
+    static Stats stats();
+    /// Reset event counters (hits, misses, bypassed, released)
+    static void resetStats();
+    /** Set capacity of the pool
+     * @param size maximum number of bytes kept for reuse. Reserved buffers
+     *   above the new capacity are freed.
+     */
+    static void setMaxReservedSize(size_t size);
+    /// Free all buffers currently reserved in the pool
+    static void freeAllReservedBuffers();
+};
+
+/** Process-wide profile of MEX-function calls.
+ *
+ * When enabled, MEX-functions that create a ProfileCall in their body
+ * record the number of calls, their total time, and how that time splits
+ * between argument processing, the OpenCV computation, and the output.
+ * The MxArray conversions between MATLAB arrays and cv::Mat made during
+ * the call (toMat, toMatND, and the cv::Mat constructor) are timed
+ * separately, with the size of their source data. Other MEX-functions are
+ * not profiled.
+ *
+ * The counters are kept by a single MEX-file, the collector (\c Utils_,
+ * behind cv.Utils.getProfile): every MEX-file sends the calls it records
+ * to it through \c mexCallMATLAB, by calling the
+ * \c cv.Utils.recordProfile method, which ends up in Profiler::record.
+ * Whether profiling is enabled is held in the MATLAB global variable
+ * \c MEXOPENCV_PROFILE. MEX-files share no other state.
+ *
+ * Only the MATLAB thread records anything. Profiling is disabled by
+ * default, in which case the cost is a lookup of the global variable per
+ * instrumented call, and a check of a flag of the MEX-file per conversion.
+ */
+class Profiler
+{
+public:
+    /// Phases of a call, in the order they normally occur
+    enum Phase {
+        PARSE = 0,  ///< argument processing
+        KERNEL,     ///< OpenCV computation
+        OUTPUT      ///< creation of the outputs
+    };
+
+    /// Counters of a MEX-function
+    struct Entry
+    {
+        size_t calls;       ///< number of calls (instrumented functions only)
+        double total;       ///< total time of calls, in seconds
+        double parse;       ///< argument processing, excluding conversions
+        double input;       ///< conversions of MATLAB arrays to cv::Mat
+        double kernel;      ///< OpenCV computation, excluding conversions
+        double output;      ///< conversions to MATLAB arrays, and output
+        size_t bytesIn;     ///< bytes of MATLAB arrays converted to cv::Mat
+        size_t bytesOut;    ///< bytes of cv::Mat converted to MATLAB arrays
+        size_t maxCallBytes;  ///< most bytes converted by a single call
+    };
+
+    /** Enable or disable profiling
+     * @param enable whether conversions and calls are recorded. Counters
+     *   recorded so far are kept.
+     */
+    static void enable(bool enable);
+    /** Check if profiling is enabled
+     * @return true if enabled.
+     */
+    static bool enabled();
+    /// Clear the counters of all functions (collector only)
+    static void reset();
+    /** Get the counters of all functions (collector only)
+     * @return copy of the table, keyed by MEX-function name.
+     */
+    static std::map<std::string, Entry> entries();
+    /** Add counters to those of a function (collector only)
+     * @param name name of the function.
+     * @param e counters sent by the MEX-file of the function. They are
+     *   summed, except for \c maxCallBytes which keeps the maximum.
+     */
+    static void record(const std::string& name, const Entry& e);
+    /** Check if conversions are being recorded
+     * @return true on the MATLAB thread during a profiled call of the
+     *   current MEX-file. Unlike enabled, this only reads a flag of the
+     *   MEX-file.
+     */
+    static bool recording();
+    /** Record a conversion
+     * @param input whether the conversion is from a MATLAB array to a
+     *   cv::Mat, as opposed to the other direction.
+     * @param bytes size of the source data.
+     * @param ticks duration, in cv::getTickCount units.
+     *
+     * The time is attributed to the ProfileCall in progress in the current
+     * MEX-file, if any.
+     */
+    static void recordConversion(bool input, size_t bytes, int64_t ticks);
+};
+
+/** Profile of a MEX-function call, in the mexFunction prologue/epilogue.
+ *
+ * Create an object at the start of \c mexFunction, and mark the phases of
+ * the call as it goes; the counters of the function are updated when the
+ * object goes out of scope. Does nothing when profiling is disabled.
+ *
+ * Example:
+ * @code
+ * void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+ * {
+ *     ProfileCall prof;
+ *     // ... option processing, input conversion
+ *     prof.phase(Profiler::KERNEL);
+ *     // ... OpenCV computation
+ *     prof.phase(Profiler::OUTPUT);
+ *     plhs[0] = MxArray(dst);
+ * }
+ * @endcode
+ *
+ * Calls ended by an error raised with \c mexErrMsgIdAndTxt are not
+ * recorded. Only one call is profiled at a time in a MEX-file, a call
+ * starting while another is in progress in the same MEX-file (nested
+ * through \c mexCallMATLAB, or left unfinished by an error) takes its
+ * place.
+ */
+class ProfileCall
+{
+public:
+    /** Start profiling a call
+     * @param name name the call is recorded under, the name of the current
+     *   MEX-function by default.
+     */
+    explicit ProfileCall(const char *name = NULL);
+    /// Stop profiling the call, and update the counters of the function
+    ~ProfileCall();
+    /** Start a new phase
+     * @param p phase the call enters, the time since the previous phase
+     *   started is attributed to the previous phase.
+     */
+    void phase(Profiler::Phase p);
+
+private:
+    // not copyable
+    ProfileCall(const ProfileCall&);
+    ProfileCall& operator=(const ProfileCall&);
+
+    /// identifier of the call in this MEX-file, 0 if not profiled
+    size_t id_;
+};
+
 #endif // MXARRAY_HPP
@@ -185,6 +185,68 @@ inline void nargchk(bool cond)
     }
 }
 
+/** Check if an array can be processed element-wise on its MATLAB buffer
+ * @param arr input array.
+ * @return true if \p arr is a non-empty 2D array accepted by
+ *   MxArray::toMatView.
+ */
+inline bool isElementwiseView(const MxArray& arr)
+{
+    return (arr.isMatViewable() && arr.ndims() == 2 && !arr.isEmpty());
+}
+
+/** Check if two arrays can be processed element-wise on their MATLAB buffers
+ * @param arr1 first input array.
+ * @param arr2 second input array.
+ * @return true if both arrays satisfy isElementwiseView, and have the
+ *   same class and size.
+ */
+inline bool isElementwiseView(const MxArray& arr1, const MxArray& arr2)
+{
+    return (isElementwiseView(arr1) && isElementwiseView(arr2) &&
+        arr1.classID() == arr2.classID() &&
+        arr1.rows() == arr2.rows() && arr1.cols() == arr2.cols());
+}
+
+/** Convert a vector of vectors of 2D points to a packed MxArray
+ * @param vvp vector of \c K vectors of 2D points, \c N points in total.
+ * @return MxArray object, a scalar struct with fields \c points (an \c Nx2
+ *   matrix of class corresponding to \c T) and \c offsets (a \c (K+1)x1
+ *   \c int32 vector of zero-based start indices). This is the inverse of
+ *   MxArrayToPackedVectorVectorPoint.
+ *
+ * Only two arrays are allocated regardless of the number of sets, instead
+ * of a cell-array element per set (and per point).
+ */
+template <typename T>
+MxArray toPackedMxArray(const std::vector<std::vector<cv::Point_<T> > >& vvp)
+{
+    mwSize npts = 0;
+    for (size_t k = 0; k < vvp.size(); ++k)
+        npts += vvp[k].size();
+    mxArray *points = mxCreateNumericMatrix(npts, 2, MxTypes<T>::type, mxREAL);
+    mxArray *offsets = mxCreateNumericMatrix(vvp.size() + 1, 1,
+        mxINT32_CLASS, mxREAL);
+    if (!points || !offsets)
+        mexErrMsgIdAndTxt("mexopencv:error", "Allocation error");
+    // column-major: all x coordinates, followed by all y coordinates
+    T *px = static_cast<T*>(mxGetData(points)), *py = px + npts;
+    int32_t *po = static_cast<int32_t*>(mxGetData(offsets));
+    po[0] = 0;
+    for (size_t k = 0; k < vvp.size(); ++k) {
+        for (size_t i = 0; i < vvp[k].size(); ++i) {
+            *px++ = vvp[k][i].x;
+            *py++ = vvp[k][i].y;
+        }
+        po[k+1] = po[k] + static_cast<int32_t>(vvp[k].size());
+    }
+    const char *fields[2] = {"points", "offsets"};
+    MxArray s = MxArray::Struct(fields, 2);
+    s.set(fields[0], MxArray(points));
+    s.set(fields[1], MxArray(offsets));
+    return s;
+}
+
 /**************************************************************\
 *           Conversion Functions: MxArray to vector            *
 \**************************************************************/
@@ -476,6 +538,57 @@ std::vector<std::vector<T> > MxArrayToVectorVectorPrimitive(const MxArray& arr)
     return arr.toVector(func);
 }
 
+/** Convert a packed point set to std::vector<std::vector<cv::Point_<T>>>
+ *
+ * @param arr MxArray object, a scalar struct in compressed sparse row form
+ *   with the following fields:
+ *   - \c points numeric matrix of size \c Nx2 holding the points of all
+ *     \c K sets one after the other, <tt>[x,y; x,y; ...]</tt>
+ *   - \c offsets vector of length \c K+1 of zero-based start indices of
+ *     each set in \c points, starting at 0 and ending at \c N. Set \c k
+ *     is made of rows <tt>offsets(k)+1:offsets(k+1)</tt>.
+ * @return vector of \c K vectors of 2D points
+ *
+ * Unlike cell-arrays, this form is converted with one bulk copy of the
+ * points regardless of the number of sets.
+ *
+ * Example:
+ * @code
+ * MxArray packed(prhs[0]);
+ * vector<vector<Point>> vvp = MxArrayToPackedVectorVectorPoint<int>(packed);
+ * @endcode
+ */
+template <typename T>
+std::vector<std::vector<cv::Point_<T> > > MxArrayToPackedVectorVectorPoint(const MxArray& arr)
+{
+    if (!arr.isStruct() || arr.numel() != 1 ||
+        !arr.isField("points") || !arr.isField("offsets"))
+        mexErrMsgIdAndTxt("mexopencv:error",
+            "Packed points must be a scalar struct with points and offsets");
+    const MxArray points(arr.at("points"));
+    const std::vector<int> offsets(arr.at("offsets").toVector<int>());
+    const int npts = (points.isEmpty()) ? 0 : static_cast<int>(points.rows());
+    if (!points.isEmpty() && (points.ndims() != 2 || points.cols() != 2))
+        mexErrMsgIdAndTxt("mexopencv:error", "Packed points must be Nx2");
+    if (offsets.empty() || offsets.front() != 0 || offsets.back() != npts)
+        mexErrMsgIdAndTxt("mexopencv:error",
+            "Packed offsets must start at 0 and end at the number of points");
+    // validate all offsets before any copy, they index into the points
+    for (size_t k = 1; k < offsets.size(); ++k)
+        if (offsets[k] < offsets[k-1] || offsets[k] > npts)
+            mexErrMsgIdAndTxt("mexopencv:error",
+                "Packed offsets must be non-decreasing, up to %d", npts);
+    // Nx2 matrix viewed as a contiguous array of N points
+    cv::Mat mat;
+    if (npts > 0)
+        mat = points.toMat(cv::DataType<T>::depth).reshape(2, npts);
+    const cv::Point_<T> *pts = (npts > 0) ? mat.ptr<cv::Point_<T> >() : NULL;
+    std::vector<std::vector<cv::Point_<T> > > vvp(offsets.size() - 1);
+    for (size_t k = 0; k < vvp.size(); ++k)
+        vvp[k].assign(pts + offsets[k], pts + offsets[k+1]);
+    return vvp;
+}
+
 /** Convert an MxArray to std::vector<std::vector<cv::Point_<T>>>
  *
  * @param arr MxArray object. In one of the following forms:
@@ -484,6 +597,7 @@ std::vector<std::vector<T> > MxArrayToVectorVectorPrimitive(const MxArray& arr)
  * - a cell-array of numeric matrices of size \c Mx2, \c Mx1x2, or \c 1xMx2,
  *   e.g: <tt>{[x,y; x,y; ...], [x,y; x,y; ...], ...}</tt> or
  *   <tt>{cat(3, [x,y], [x,y], ...), cat(3, [x,y], [x,y], ...), ...}</tt>
+ * - a packed scalar struct, as accepted by MxArrayToPackedVectorVectorPoint
  * @return vector of vectors of 2D points
  *
  * Example:
@@ -495,6 +609,8 @@ std::vector<std::vector<T> > MxArrayToVectorVectorPrimitive(const MxArray& arr)
 template <typename T>
 std::vector<std::vector<cv::Point_<T> > > MxArrayToVectorVectorPoint(const MxArray& arr)
 {
+    if (arr.isStruct())
+        return MxArrayToPackedVectorVectorPoint<T>(arr);
     std::vector<MxArray> vva(arr.toVector<MxArray>());
     std::vector<std::vector<cv::Point_<T> > > vvp;
     vvp.reserve(vva.size());
@@ -548,4 +664,207 @@ std::vector<std::vector<cv::Point3_<T> > > MxArrayToVectorVectorPoint3(const MxA
     return vvp;
 }
 
+/**************************************************************\
+*                       Object Registry                        *
+\**************************************************************/
+
+/** Registry of persistent objects referenced from MATLAB by integer ids
+ * @tparam T class of the registered objects.
+ *
+ * Class wrappers keep their objects in a registry and return ids to MATLAB.
+ * Objects are stored in a vector of slots, and an id encodes a slot index
+ * together with the generation of that slot. Lookups are O(1), slots of
+ * deleted objects are reused, and an id of a deleted object never resolves
+ * to the object that later took over its slot: a slot is retired once its
+ * generations are exhausted, instead of handing out an old id again.
+ *
+ * add, erase and operator[] must only be called from the MATLAB thread, and
+ * get needs no lock there since that thread is the only one modifying the
+ * registry. Other threads use getLocked, which synchronizes with updates.
+ *
+ * Example:
+ * @code
+ * ObjectRegistry<cv::KalmanFilter> obj_;
+ * int id = obj_.add(cv::makePtr<cv::KalmanFilter>());
+ * cv::Ptr<cv::KalmanFilter> obj = obj_.get(id);
+ * obj_.erase(id);
+ * @endcode
+ */
+template <typename T>
+class ObjectRegistry
+{
+public:
+    /// Create an empty registry
+    ObjectRegistry() : count_(0) {}
+
+    /** Register an object.
+     * @param obj object to register.
+     * @return id of the object, a positive integer.
+     *
+     * Raises an error when all slots are in use or retired.
+     */
+    int add(const cv::Ptr<T>& obj)
+    {
+        int id = 0;
+        {
+            cv::AutoLock lock(mtx_);
+            int index = -1;
+            if (!free_.empty()) {
+                index = free_.back();
+                free_.pop_back();
+            }
+            else if (slots_.size() < static_cast<size_t>(MAX_SLOTS)) {
+                index = static_cast<int>(slots_.size());
+                slots_.push_back(Slot());
+            }
+            if (index >= 0) {
+                slots_[index].obj = obj;
+                slots_[index].live = true;
+                ++count_;
+                id = (slots_[index].generation << SLOT_BITS) | (index + 1);
+            }
+        }
+        // raised outside the lock, the error does not return
+        if (id == 0)
+            mexErrMsgIdAndTxt("mexopencv:error", "Too many objects");
+        return id;
+    }
+
+    /** Find an object.
+     * @param id object id.
+     * @return registered object, empty if the id is unknown or the object
+     *    was deleted.
+     */
+    cv::Ptr<T> get(int id) const
+    {
+        const Slot *slot = find(id);
+        return (slot) ? slot->obj : cv::Ptr<T>();
+    }
+
+    /** Find an object, from any thread.
+     * @param id object id.
+     * @return registered object, empty if not found.
+     */
+    cv::Ptr<T> getLocked(int id) const
+    {
+        cv::AutoLock lock(mtx_);
+        return get(id);
+    }
+
+    /** Access the slot of a live object, e.g. to replace it.
+     * @param id object id.
+     * @return reference to the registered object.
+     *
+     * Raises an error if the id is unknown or the object was deleted.
+     */
+    cv::Ptr<T>& operator[](int id)
+    {
+        Slot *slot = const_cast<Slot*>(find(id));
+        if (!slot)
+            mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
+        return slot->obj;
+    }
+
+    /** Unregister an object.
+     * @param id object id.
+     * @return true if the object was found and unregistered.
+     */
+    bool erase(int id)
+    {
+        cv::AutoLock lock(mtx_);
+        Slot *slot = const_cast<Slot*>(find(id));
+        if (!slot)
+            return false;
+        slot->obj.release();
+        slot->live = false;
+        --count_;
+        // a slot whose generations are exhausted is retired for good,
+        // otherwise its next ids would repeat those of deleted objects
+        if (slot->generation < MAX_GENERATION) {
+            slot->generation++;
+            free_.push_back((id & MAX_SLOTS) - 1);
+        }
+        return true;
+    }
+
+    /// Number of live objects
+    size_t size() const { return count_; }
+
+    /** Enumerate live objects, e.g. to report leaks.
+     * @return ids of all live objects, in slot order.
+     */
+    std::vector<int> ids() const
+    {
+        cv::AutoLock lock(mtx_);
+        std::vector<int> v;
+        v.reserve(count_);
+        for (size_t i = 0; i < slots_.size(); ++i)
+            if (slots_[i].live)
+                v.push_back((slots_[i].generation << SLOT_BITS) |
+                    static_cast<int>(i + 1));
+        return v;
+    }
+
+    /** Answer the queries about the registry shared by all class wrappers.
+     * @param method name of the method called on the wrapper.
+     * @param nlhs number of output arguments.
+     * @param plhs output arguments.
+     * @return true if the method was a registry query and was answered.
+     *
+     * The \c "liveObjects" method returns the ids of all live objects as a
+     * row vector (see cv.Utils.liveObjects). Class wrappers call this
+     * before looking up the object id, which is ignored.
+     */
+    bool query(const std::string& method, int nlhs, mxArray *plhs[]) const
+    {
+        if (method != "liveObjects")
+            return false;
+        nargchk(nlhs<=1);
+        const std::vector<int> v(ids());
+        plhs[0] = mxCreateDoubleMatrix(1, v.size(), mxREAL);
+        std::copy(v.begin(), v.end(), mxGetPr(plhs[0]));
+        return true;
+    }
+
+private:
+    /// bits of an id holding the slot index (plus one)
+    enum { SLOT_BITS = 20 };
+    /// largest number of slots
+    enum { MAX_SLOTS = (1 << SLOT_BITS) - 1 };
+    /// largest generation, so that ids stay positive
+    enum { MAX_GENERATION = (1 << (30 - SLOT_BITS)) - 1 };
+
+    /// Storage of one object
+    struct Slot
+    {
+        Slot() : generation(0), live(false) {}
+        /// registered object
+        cv::Ptr<T> obj;
+        /// incremented each time the object is deleted
+        int generation;
+        /// whether the slot holds a registered object
+        bool live;
+    };
+
+    /// Slot of a live object, NULL if not found
+    const Slot* find(int id) const
+    {
+        const int index = (id & MAX_SLOTS) - 1;
+        if (id <= 0 || index < 0 || index >= static_cast<int>(slots_.size()))
+            return NULL;
+        const Slot& slot = slots_[index];
+        return (slot.live && slot.generation == (id >> SLOT_BITS)) ?
+            &slot : NULL;
+    }
+
+    /// object slots
+    std::vector<Slot> slots_;
+    /// indices of free slots
+    std::vector<int> free_;
+    /// number of live objects
+    size_t count_;
+    /// guards updates against getLocked and ids
+    mutable cv::Mutex mtx_;
+};
+
 #endif
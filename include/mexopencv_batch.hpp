@@ -0,0 +1,108 @@
+/**
+ * @file mexopencv_batch.hpp
+ * @brief Batch processing of images in MEX-functions
+ *
+ * Header file for MEX-functions that process a single image per call, and
+ * also accept a batch of images (a cell array, or a 4-D stack of frames).
+ * Conversions between MATLAB and OpenCV memory layouts and the processing
+ * itself are spread over worker threads.
+ */
+#ifndef MEXOPENCV_BATCH_HPP
+#define MEXOPENCV_BATCH_HPP
+
+#include "mexopencv.hpp"
+
+
+/** Operation applied to each image of a batch.
+ *
+ * Derived classes hold the parsed options of the MEX-function.
+ *
+ * @code
+ * struct EqualizeHistOp : public BatchOperation
+ * {
+ *     virtual void operator()(const Mat& src, Mat& dst) const
+ *     {
+ *         equalizeHist(src, dst);
+ *     }
+ * };
+ * if (isBatch(rhs[0])) {
+ *     plhs[0] = processBatch(rhs[0], EqualizeHistOp(), CV_8U);
+ *     return;
+ * }
+ * @endcode
+ */
+class BatchOperation
+{
+  public:
+    /// Destructor
+    virtual ~BatchOperation() {}
+    /** Process one image.
+     * @param src input image.
+     * @param dst output image.
+     *
+     * Called concurrently from worker threads, so it must not call any MEX
+     * API function (errors are reported by throwing exceptions).
+     */
+    virtual void operator()(const cv::Mat& src, cv::Mat& dst) const = 0;
+};
+
+/// Image of a batch, still in the memory layout of MATLAB arrays
+struct BatchImage
+{
+    /// column-major planar data
+    const void *data;
+    /// depth of the elements
+    int depth;
+    /// number of rows
+    int rows;
+    /// number of columns
+    int cols;
+    /// number of channels
+    int cn;
+    /** Convert to cv::Mat.
+     * @param ddepth depth of the result, \c CV_USRTYPE1 to keep \c depth.
+     * @return 2D cv::Mat of \c cn channels.
+     *
+     * Does not call any MEX API function, so it can be used from worker
+     * threads.
+     */
+    cv::Mat toMat(int ddepth = CV_USRTYPE1) const;
+};
+
+/** Determine whether an argument is a batch of images.
+ * @param arr MxArray object.
+ * @return true if \p arr is a cell array, or a 4-D numeric array.
+ */
+bool isBatch(const MxArray& arr);
+
+/** Describe the images of a batch.
+ * @param arr batch of images, see processBatch.
+ * @return one element per image (in column-major order for a cell array).
+ *
+ * Raises an error if an element is not a non-empty real numeric array.
+ * The returned descriptions point to the data of \p arr.
+ */
+std::vector<BatchImage> batchImages(const MxArray& arr);
+
+/** Apply an operation to each image of a batch.
+ * @param arr batch of images, either a cell array of \c M-by-N-by-C
+ *    numeric arrays (possibly of different sizes and classes), or a
+ *    \c M-by-N-by-C-by-F numeric array of \c F images.
+ * @param op operation.
+ * @param depth depth the images are converted to before \p op is applied,
+ *    \c CV_USRTYPE1 to keep the depth corresponding to their class.
+ * @return batch of results of the same kind as \p arr: a cell array of the
+ *    same size, or a 4-D numeric array (in which case all results must
+ *    have the same size and type).
+ *
+ * Images are processed in parallel when there are enough of them to keep
+ * all threads busy, otherwise one after the other (OpenCV functions then
+ * use all threads on each image). Cell array results are converted back to
+ * MATLAB arrays in chunks, so that the memory held by intermediate results
+ * stays bounded however large the batch is, while stack results are written
+ * in place.
+ */
+MxArray processBatch(const MxArray& arr, const BatchOperation& op,
+    int depth = CV_USRTYPE1);
+
+#endif
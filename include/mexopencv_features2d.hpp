@@ -424,4 +424,49 @@ cv::Ptr<cv::DescriptorMatcher> createDescriptorMatcher(
     std::vector<MxArray>::const_iterator first,
     std::vector<MxArray>::const_iterator last);
 
+
+// ==================== Output Formats ====================
+
+/// Output formats for keypoints and matches (true for struct-of-arrays)
+const ConstMap<std::string, bool> OutputFormatSoAMap = ConstMap<std::string, bool>
+    ("AoS", false)
+    ("SoA", true);
+
+/** Convert keypoints to a scalar struct of column vectors
+ * @param keypoints vector of \c N keypoints.
+ * @return MxArray object, a scalar struct with fields \c pt (Nx2 matrix),
+ *    \c size, \c angle, \c response, \c octave, and \c class_id
+ *    (Nx1 vectors each).
+ *
+ * This struct-of-arrays layout is much cheaper to build than the 1xN struct
+ * array returned by MxArray(const std::vector<cv::KeyPoint>&), since it
+ * creates six arrays instead of six per keypoint. It is accepted back by
+ * MxArray::toVector<cv::KeyPoint>.
+ */
+MxArray toStructOfArrays(const std::vector<cv::KeyPoint>& keypoints);
+
+/** Convert matches to a scalar struct of column vectors
+ * @param matches vector of \c N matches.
+ * @return MxArray object, a scalar struct with fields \c queryIdx,
+ *    \c trainIdx, \c imgIdx, and \c distance (Nx1 vectors each).
+ *
+ * Struct-of-arrays counterpart of
+ * MxArray(const std::vector<cv::DMatch>&), accepted back by
+ * MxArray::toVector<cv::DMatch>.
+ */
+MxArray toStructOfArrays(const std::vector<cv::DMatch>& matches);
+
+/** Convert vector of vectors to a cell array of structs of column vectors
+ * @param vv vector of vectors of keypoints or matches.
+ * @return MxArray object, a cell array of scalar structs.
+ */
+template <typename T>
+MxArray toStructOfArrays(const std::vector<std::vector<T> >& vv)
+{
+    MxArray arr(MxArray::Cell(1, vv.size()));
+    for (mwIndex i = 0; i < vv.size(); ++i)
+        arr.set(i, toStructOfArrays(vv[i]));
+    return arr;
+}
+
 #endif
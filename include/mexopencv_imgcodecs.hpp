@@ -0,0 +1,331 @@
+/**
+ * @file mexopencv_imgcodecs.hpp
+ * @brief Common definitions for the imgcodecs module
+ * @ingroup imgcodecs
+ *
+ * Header file for MEX-functions that use the imgcodecs module from OpenCV
+ * library. This file includes maps for option processing, as well as
+ * functions parsing the options of the reading and writing functions (shared
+ * between the single image and the batch variants), and a reader of the TIFF
+ * container giving access to single strips, tiles and pages of a file.
+ */
+#ifndef MEXOPENCV_IMGCODECS_HPP
+#define MEXOPENCV_IMGCODECS_HPP
+
+#include <fstream>
+#include "mexopencv.hpp"
+#include "mexopencv_batch.hpp"
+#include "opencv2/imgcodecs.hpp"
+#include "opencv2/imgproc.hpp"
+
+
+// ==================== Options ====================
+
+/// PNG encoding strategies for option processing
+const ConstMap<std::string,int> PngStrategyMap = ConstMap<std::string,int>
+    ("Default",     cv::IMWRITE_PNG_STRATEGY_DEFAULT)
+    ("Filtered",    cv::IMWRITE_PNG_STRATEGY_FILTERED)
+    ("HuffmanOnly", cv::IMWRITE_PNG_STRATEGY_HUFFMAN_ONLY)
+    ("RLE",         cv::IMWRITE_PNG_STRATEGY_RLE)
+    ("Fixed",       cv::IMWRITE_PNG_STRATEGY_FIXED);
+
+/// EXR storage types for option processing
+const ConstMap<std::string,int> ExrTypeMap = ConstMap<std::string,int>
+    //("Int",   cv::IMWRITE_EXR_TYPE_UNIT)
+    ("Half",  cv::IMWRITE_EXR_TYPE_HALF)
+    ("Float", cv::IMWRITE_EXR_TYPE_FLOAT);
+
+/// PAM tuple types for option processing
+const ConstMap<std::string,int> PamFormatMap = ConstMap<std::string,int>
+    ("Null",           cv::IMWRITE_PAM_FORMAT_NULL)
+    ("BlackWhite",     cv::IMWRITE_PAM_FORMAT_BLACKANDWHITE)
+    ("Grayscale",      cv::IMWRITE_PAM_FORMAT_GRAYSCALE)
+    ("GrayscaleAlpha", cv::IMWRITE_PAM_FORMAT_GRAYSCALE_ALPHA)
+    ("RGB",            cv::IMWRITE_PAM_FORMAT_RGB)
+    ("RGBA",           cv::IMWRITE_PAM_FORMAT_RGB_ALPHA);
+
+/** Build the flags of cv::imread or cv::imdecode from MATLAB options.
+ * @param first iterator at the first option name.
+ * @param last iterator past the last option value.
+ * @param flip set to the value of the \c FlipChannels option, true by
+ *    default.
+ * @param file whether images are read from files, in which case the \c GDAL
+ *    option is also accepted.
+ * @return flags, e.g. <tt>cv::IMREAD_COLOR | cv::IMREAD_REDUCED_COLOR_2</tt>.
+ *
+ * The options are those of cv.imread.
+ */
+int parseImreadFlags(
+    std::vector<MxArray>::const_iterator first,
+    std::vector<MxArray>::const_iterator last,
+    bool& flip, bool file = true);
+
+/** Build the parameters of cv::imwrite or cv::imencode from MATLAB options.
+ * @param first iterator at the first option name.
+ * @param last iterator past the last option value.
+ * @param flip set to the value of the \c FlipChannels option, true by
+ *    default.
+ * @return pairs of parameter id and value.
+ *
+ * The options are those of cv.imwrite.
+ */
+std::vector<int> parseImwriteParams(
+    std::vector<MxArray>::const_iterator first,
+    std::vector<MxArray>::const_iterator last,
+    bool& flip);
+
+/** Depth of an image for encoding.
+ * @param depth depth of the source array.
+ * @return \c CV_32F for floating-point, \c CV_16U for 16-bit unsigned,
+ *    \c CV_8U otherwise.
+ */
+inline int imwriteDepth(int depth)
+{
+    return (depth == CV_32F || depth == CV_64F) ? CV_32F :
+        ((depth == CV_16U) ? CV_16U : CV_8U);
+}
+
+/** Swap the red and blue channels of a 3- or 4-channel image in place.
+ * @param img image, left unchanged when it has another number of channels.
+ *
+ * OpenCV's default is BGR/BGRA while MATLAB's is RGB/RGBA.
+ */
+inline void flipChannels(cv::Mat& img)
+{
+    if (img.channels() == 3 || img.channels() == 4)
+        cv::cvtColor(img, img, (img.channels() == 3 ?
+            cv::COLOR_BGR2RGB : cv::COLOR_BGRA2RGBA));
+}
+
+
+// ==================== Batches ====================
+
+/** Decode a batch of images in parallel.
+ * @param files names of the files to read, or empty to decode \p buffers.
+ * @param buffers encoded images, used when \p files is empty. They must
+ *    stay valid during the call (e.g. headers over MATLAB arrays).
+ * @param flags flags of cv::imread / cv::imdecode.
+ * @param flip whether to flip color images from BGR/BGRA to RGB/RGBA order.
+ * @param stack whether to return a single \c M-by-N-by-C-by-F array instead
+ *    of a cell array. Images whose size or type differs from the first
+ *    decoded one are reported as errors, and left as zeros in the stack.
+ * @param sz size of the returned cell array, its number of elements must be
+ *    the number of images.
+ * @param errors receives one error message per image, empty on success.
+ * @return decoded images, an empty cell array element (or a slice of zeros)
+ *    for images that could not be decoded.
+ *
+ * A failure to decode one image does not stop the other ones from being
+ * decoded. Decoded images are turned into MATLAB arrays in chunks, so the
+ * memory held by intermediate results stays bounded.
+ */
+MxArray decodeBatch(const std::vector<std::string>& files,
+    const std::vector<cv::Mat>& buffers, int flags, bool flip, bool stack,
+    const cv::Size& sz, std::vector<std::string>& errors);
+
+/** Encode a batch of images in parallel.
+ * @param images images to encode.
+ * @param files names of the files to write (one per image), or empty to
+ *    encode to memory buffers.
+ * @param ext file extension defining the format, when encoding to memory.
+ * @param params format-specific parameters.
+ * @param flip whether to flip color images from RGB/RGBA to BGR/BGRA order.
+ * @param buffers receives the encoded images, when encoding to memory.
+ * @param errors receives one error message per image, empty on success.
+ *
+ * A failure to encode one image does not stop the other ones from being
+ * encoded. Floating-point images are encoded as \c CV_32F, \c uint16 ones
+ * as \c CV_16U, and others as \c CV_8U.
+ */
+void encodeBatch(const std::vector<BatchImage>& images,
+    const std::vector<std::string>& files, const std::string& ext,
+    const std::vector<int>& params, bool flip,
+    std::vector<std::vector<uchar> >& buffers,
+    std::vector<std::string>& errors);
+
+/** Success flags of a batch.
+ * @param errors one error message per element of the batch, empty on
+ *    success.
+ * @return one flag per element, true on success.
+ */
+std::vector<bool> batchSuccess(const std::vector<std::string>& errors);
+
+/** Report errors of a batch.
+ * @param errors one error message per element of the batch, empty on
+ *    success.
+ *
+ * Issues a single warning giving the number of failed elements and the
+ * first message, if any. Used when the caller does not request the
+ * per-element status outputs.
+ */
+void warnBatchErrors(const std::vector<std::string>& errors);
+
+
+// ==================== TIFF ====================
+
+/** Random access to the strips, tiles and pages of a TIFF file.
+ *
+ * Only the TIFF container is parsed (classic and BigTIFF, either byte
+ * order); pixel data is never decompressed here. Instead, the strips or
+ * tiles needed are copied, along with the tags describing them, into a
+ * small TIFF file in memory which is decoded by cv::imdecode. Any
+ * compression supported by OpenCV's TIFF codec is thus supported, while
+ * only the requested part of a huge image (or page of a multipage file) is
+ * read and decoded.
+ *
+ * @code
+ * TiffFile tif("huge.tif");
+ * TiffFile::Directory dir(tif.directory(0));
+ * Mat strip = tif.decodeBlock(dir, 0, IMREAD_UNCHANGED);
+ * @endcode
+ *
+ * Objects are not thread-safe, they share a file stream between calls.
+ */
+class TiffFile
+{
+  public:
+    /// Entry of an image file directory
+    struct Entry
+    {
+        /// tag identifier
+        uint16_t tag;
+        /// field type
+        uint16_t type;
+        /// number of values
+        uint64_t count;
+        /// values, in the byte order of the file
+        std::vector<uchar> data;
+    };
+
+    /// Image file directory, describing one image (page) of the file
+    struct Directory
+    {
+        /// all entries, sorted by tag
+        std::vector<Entry> entries;
+        /// image width
+        int width;
+        /// image height
+        int height;
+        /// number of samples per pixel
+        int samples;
+        /// number of bits per sample
+        int bits;
+        /// compression scheme, 1 for uncompressed data
+        int compression;
+        /// planar configuration, 1 for interleaved samples
+        int planar;
+        /// whether data is organized in tiles rather than strips
+        bool tiled;
+        /// width of a tile, or of the image for strips
+        int blockWidth;
+        /// height of a tile, or rows per strip
+        int blockHeight;
+        /// file offsets of the strips or tiles
+        std::vector<uint64_t> offsets;
+        /// sizes in bytes of the strips or tiles
+        std::vector<uint64_t> byteCounts;
+        /// number of blocks in a row of the image
+        int blocksAcross() const
+        { return (width + blockWidth - 1) / blockWidth; }
+        /// number of blocks in a column of the image
+        int blocksDown() const
+        { return (height + blockHeight - 1) / blockHeight; }
+        /// number of bytes in a row of interleaved uncompressed samples
+        size_t rowBytes() const
+        { return (static_cast<size_t>(width) * samples * bits + 7) / 8; }
+    };
+
+    /** Open a file.
+     * @param filename name of the file.
+     *
+     * Raises an error if the file cannot be opened, or is not a TIFF file.
+     * The chain of directories is walked to count pages, without loading
+     * them.
+     */
+    explicit TiffFile(const std::string& filename);
+
+    /** Determine whether a file is a TIFF file from its header.
+     * @param filename name of the file.
+     * @return true if the file starts with a TIFF or BigTIFF signature.
+     */
+    static bool isTiff(const std::string& filename);
+
+    /// Number of pages (image file directories) of the file
+    size_t pages() const { return ifds_.size(); }
+
+    /** Load the directory of a page.
+     * @param page 0-based page index.
+     * @return parsed directory.
+     */
+    Directory directory(size_t page);
+
+    /** Decode a strip or tile.
+     * @param dir directory of the page.
+     * @param index index of the strip or tile, in row-major order.
+     * @param flags flags of cv::imdecode.
+     * @return decoded block, cropped to the image bounds.
+     */
+    cv::Mat decodeBlock(const Directory& dir, size_t index, int flags);
+
+    /** Decode a band of rows of an uncompressed stripped image.
+     * @param dir directory of the page, uncompressed with interleaved
+     *    samples and organized in strips.
+     * @param rows range of rows, possibly spanning several strips.
+     * @param flags flags of cv::imdecode.
+     * @return decoded rows.
+     *
+     * This gives row-level access to images stored in a single strip.
+     */
+    cv::Mat decodeRows(const Directory& dir, const cv::Range& rows,
+        int flags);
+
+    /** Decode a whole page.
+     * @param dir directory of the page.
+     * @param flags flags of cv::imdecode.
+     * @return decoded image.
+     */
+    cv::Mat decodePage(const Directory& dir, int flags);
+
+    /** Copy a whole page into a single-page TIFF file in memory.
+     * @param dir directory of the page.
+     * @param buf receives the TIFF file, to be decoded by cv::imdecode.
+     *    Its capacity is reused.
+     *
+     * Decoding can then happen on another thread.
+     */
+    void extractPage(const Directory& dir, std::vector<uchar>& buf);
+
+  private:
+    /// Check that count values of n bytes at a file offset are in the file
+    bool fits(uint64_t offset, uint64_t count, size_t n) const;
+    /// Read bytes at a file offset
+    void read(uint64_t offset, void *buf, size_t n);
+    /// Read an unsigned integer of 1, 2, 4 or 8 bytes at a file offset
+    uint64_t readUInt(uint64_t offset, size_t n);
+    /// Unsigned integer values of an entry
+    std::vector<uint64_t> values(const Entry& e) const;
+    /// Read blocks of a page into blocks_, one per index
+    void readBlocks(const Directory& dir, const std::vector<size_t>& index);
+    /// Build an in-memory TIFF file holding the blocks read in blocks_
+    void makeTiff(const Directory& dir, int width, int height,
+        std::vector<uchar>& buf) const;
+    /// Decode an in-memory TIFF file
+    cv::Mat decode(const std::vector<uchar>& buf, int flags) const;
+
+    /// file stream
+    std::ifstream file_;
+    /// size of the file, in bytes
+    uint64_t size_;
+    /// whether the file is big-endian
+    bool bigEndian_;
+    /// whether the file is a BigTIFF file
+    bool big_;
+    /// file offsets of the image file directories
+    std::vector<uint64_t> ifds_;
+    /// raw data of the blocks being copied, kept to reuse memory
+    std::vector<std::vector<uchar> > blocks_;
+    /// in-memory TIFF file being decoded, kept to reuse memory
+    std::vector<uchar> buf_;
+};
+
+#endif
@@ -0,0 +1,57 @@
+/**
+ * @file mexopencv_persistence.hpp
+ * @brief Common definitions for XML/YAML/JSON persistence
+ * @ingroup core
+ *
+ * Header file for MEX-functions that use cv::FileStorage. This file includes
+ * the conversions between file nodes and MATLAB arrays, shared between
+ * cv.FileStorage and cv.FileStorageStream.
+ */
+#ifndef MEXOPENCV_PERSISTENCE_HPP
+#define MEXOPENCV_PERSISTENCE_HPP
+
+#include "mexopencv.hpp"
+
+
+// ==================== Reading ====================
+
+/** Check if the node is of a user-defined type
+ * @param node node to test.
+ * @param type_name type name. e.g., "opencv-matrix"
+ * @return flag
+ */
+bool isa(const cv::FileNode& node, const std::string& type_name);
+
+/** Convert a file node and its children to a MATLAB array
+ * @param node FileNode to read
+ * @return MxArray object: a scalar, a string, a cell array for sequences,
+ *    a numeric array for matrices, or a scalar struct for other maps.
+ *
+ * Dense matrices of up to 4 channels (\c opencv-matrix nodes) are decoded
+ * from the node straight into the memory of the MATLAB array, by chunks
+ * of rows, without a full intermediate cv::Mat.
+ */
+MxArray readNode(const cv::FileNode& node);
+
+/** Name of the type of a file node
+ * @param node node.
+ * @return one of "none", "int", "real", "str", "seq", "map", "matrix",
+ *    "nd-matrix", "sparse-matrix".
+ */
+std::string nodeTypeName(const cv::FileNode& node);
+
+
+// ==================== Writing ====================
+
+/** Recursive function to output to a file storage
+ * @param fs FileStorage object
+ * @param x MxArray to be written
+ * @param root Flag inidicating the root node
+ *
+ * Non-scalar 2D and 3D numeric arrays are written as \c opencv-matrix
+ * nodes straight from the memory of the MATLAB array, by chunks of rows,
+ * in Base64 if the storage was opened with that option.
+ */
+void writeNode(cv::FileStorage& fs, const MxArray& x, bool root = false);
+
+#endif
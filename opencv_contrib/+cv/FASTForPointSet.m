@@ -22,6 +22,13 @@
 %   * **TYPE_9_16** (default)
 %   * **TYPE_7_12**
 %   * **TYPE_5_8**
+% * __OutputFormat__ Format of the returned keypoints, one of:
+%   * __AoS__ a 1-by-N structure array, as described above.
+%   * __SoA__ a scalar structure of column vectors, where `pt` is
+%     an N-by-2 matrix and the other fields are N-by-1 vectors.
+%     It is much faster to create for large sets of keypoints,
+%     and is accepted as input wherever keypoints are expected.
+%   default 'AoS'
 %
 % Detects corners using the FAST algorithm by [Rosten06].
 %
@@ -6,6 +6,7 @@
  * @date 2017
  */
 #include "mexopencv.hpp"
+#include "mexopencv_features2d.hpp"  // toStructOfArrays
 #include "opencv2/xfeatures2d.hpp"
 using namespace std;
 using namespace cv;
@@ -38,6 +39,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     int threshold = 10;
     bool nonmaxSupression = true;
     int type = cv::FastFeatureDetector::TYPE_9_16;
+    bool soa = false;
     for (int i=2; i<nrhs; i+=2) {
         string key(rhs[i].toString());
         if (key == "Threshold")
@@ -46,6 +48,8 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
             nonmaxSupression = rhs[i+1].toBool();
         else if (key == "Type")
             type = FASTTypeMap[rhs[i+1].toString()];
+        else if (key == "OutputFormat")
+            soa = OutputFormatSoAMap[rhs[i+1].toString()];
         else
             mexErrMsgIdAndTxt("mexopencv:error",
                 "Unrecognized option %s", key.c_str());
@@ -55,5 +59,5 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     Mat image(rhs[0].toMat(CV_8U));
     vector<KeyPoint> keypoints(rhs[1].toVector<KeyPoint>());
     FASTForPointSet(image, keypoints, threshold, nonmaxSupression, type);
-    plhs[0] = MxArray(keypoints);
+    plhs[0] = (soa) ? toStructOfArrays(keypoints) : MxArray(keypoints);
 }
@@ -13,10 +13,8 @@ using namespace cv::ximgproc;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<AdaptiveManifoldFilter> > obj_;
+ObjectRegistry<AdaptiveManifoldFilter> obj_;
 
 /// Option arguments parser used by create and filter methods
 struct OptionsParser
@@ -75,9 +73,8 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     if (method == "new") {
         nargchk(nrhs>=2 && nlhs<=1);
         OptionsParser opts(rhs.begin() + 2, rhs.end());
-        obj_[++last_id] = createAMFilter(
-            opts.sigma_s, opts.sigma_r, opts.adjust_outliers);
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(createAMFilter(
+            opts.sigma_s, opts.sigma_r, opts.adjust_outliers)));
         mexLock();
         return;
     }
@@ -96,7 +93,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     }
 
     // Big operation switch
-    Ptr<AdaptiveManifoldFilter> obj = obj_[id];
+    Ptr<AdaptiveManifoldFilter> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -15,10 +15,8 @@ using namespace cv::xfeatures2d;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<AffineFeature2D> > obj_;
+ObjectRegistry<AffineFeature2D> obj_;
 
 /// Field names for cv::xfeatures2d::Elliptic_KeyPoint.
 const char *cv_elliptic_keypoint_fields[9] = {"pt", "size", "angle",
@@ -137,15 +135,15 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                 mexErrMsgIdAndTxt("mexopencv:error",
                     "Invalid extractor arguments");
         }
-        obj_[++last_id] = (nrhs == 3) ? AffineFeature2D::create(detector) :
-            AffineFeature2D::create(detector, extractor);
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add((nrhs == 3) ?
+            AffineFeature2D::create(detector) :
+            AffineFeature2D::create(detector, extractor)));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<AffineFeature2D> obj = obj_[id];
+    Ptr<AffineFeature2D> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -218,12 +216,15 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     }
     else if (method == "detect") {
         nargchk(nrhs>=3 && (nrhs%2)==1 && nlhs<=1);
+        bool soa = false;
         if (rhs[2].isNumeric()) {  // first variant that accepts an image
             Mat mask;
             for (int i=3; i<nrhs; i+=2) {
                 string key(rhs[i].toString());
                 if (key == "Mask")
                     mask = rhs[i+1].toMat(CV_8U);
+                else if (key == "OutputFormat")
+                    soa = OutputFormatSoAMap[rhs[i+1].toString()];
                 else
                     mexErrMsgIdAndTxt("mexopencv:error",
                         "Unrecognized option %s", key.c_str());
@@ -231,7 +232,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
             Mat image(rhs[2].toMat(CV_8U));
             vector<KeyPoint> keypoints;
             obj->detect(image, keypoints, mask);
-            plhs[0] = MxArray(keypoints);
+            plhs[0] = (soa) ? toStructOfArrays(keypoints) : MxArray(keypoints);
         }
         else if (rhs[2].isCell()) {  // second variant that accepts an image set
             vector<Mat> masks;
@@ -245,6 +246,8 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                     for (vector<MxArray>::const_iterator it = arr.begin(); it != arr.end(); ++it)
                         masks.push_back(it->toMat(CV_8U));
                 }
+                else if (key == "OutputFormat")
+                    soa = OutputFormatSoAMap[rhs[i+1].toString()];
                 else
                     mexErrMsgIdAndTxt("mexopencv:error",
                         "Unrecognized option %s", key.c_str());
@@ -259,7 +262,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
             }
             vector<vector<KeyPoint> > keypoints;
             obj->detect(images, keypoints, masks);
-            plhs[0] = MxArray(keypoints);
+            plhs[0] = (soa) ? toStructOfArrays(keypoints) : MxArray(keypoints);
         }
         else
             mexErrMsgIdAndTxt("mexopencv:error", "Invalid arguments");
@@ -296,6 +299,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     }
     else if (method == "detectAndCompute") {
         nargchk(nrhs>=3 && (nrhs%2)==1 && nlhs<=2);
+        bool soa = false;
         Mat mask;
         vector<KeyPoint> keypoints;
         bool useProvidedKeypoints = false;
@@ -307,6 +311,8 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                 keypoints = rhs[i+1].toVector<KeyPoint>();
                 useProvidedKeypoints = true;
             }
+            else if (key == "OutputFormat")
+                soa = OutputFormatSoAMap[rhs[i+1].toString()];
             else
                 mexErrMsgIdAndTxt("mexopencv:error",
                     "Unrecognized option %s", key.c_str());
@@ -314,7 +320,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
         Mat image(rhs[2].toMat(CV_8U)), descriptors;
         obj->detectAndCompute(image, mask, keypoints, descriptors,
             useProvidedKeypoints);
-        plhs[0] = MxArray(keypoints);
+        plhs[0] = (soa) ? toStructOfArrays(keypoints) : MxArray(keypoints);
         if (nlhs > 1)
             plhs[1] = MxArray(descriptors);
     }
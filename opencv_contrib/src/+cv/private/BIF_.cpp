@@ -13,10 +13,8 @@ using namespace cv::face;
 
 namespace {
 // Persistent objects
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<BIF> > obj_;
+ObjectRegistry<BIF> obj_;
 }
 
 /**
@@ -51,14 +49,13 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                 mexErrMsgIdAndTxt("mexopencv:error",
                     "Unrecognized option %s", key.c_str());
         }
-        obj_[++last_id] = BIF::create(num_bands, num_rotations);
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(BIF::create(num_bands, num_rotations)));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<BIF> obj = obj_[id];
+    Ptr<BIF> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -13,10 +13,8 @@ using namespace cv::bgsegm;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<BackgroundSubtractorCNT> > obj_;
+ObjectRegistry<BackgroundSubtractorCNT> obj_;
 }
 
 /**
@@ -57,15 +55,14 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                 mexErrMsgIdAndTxt("mexopencv:error",
                     "Unrecognized option %s", key.c_str());
         }
-        obj_[++last_id] = createBackgroundSubtractorCNT(
-            minPixelStability, maxPixelStability, useHistory, isParallel);
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(createBackgroundSubtractorCNT(
+            minPixelStability, maxPixelStability, useHistory, isParallel)));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<BackgroundSubtractorCNT> obj = obj_[id];
+    Ptr<BackgroundSubtractorCNT> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
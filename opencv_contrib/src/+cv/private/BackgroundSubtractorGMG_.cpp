@@ -13,10 +13,8 @@ using namespace cv::bgsegm;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<BackgroundSubtractorGMG> > obj_;
+ObjectRegistry<BackgroundSubtractorGMG> obj_;
 }
 
 /**
@@ -51,15 +49,14 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                 mexErrMsgIdAndTxt("mexopencv:error",
                     "Unrecognized option %s", key.c_str());
         }
-        obj_[++last_id] = createBackgroundSubtractorGMG(
-            initializationFrames, decisionThreshold);
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(createBackgroundSubtractorGMG(
+            initializationFrames, decisionThreshold)));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<BackgroundSubtractorGMG> obj = obj_[id];
+    Ptr<BackgroundSubtractorGMG> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -13,10 +13,8 @@ using namespace cv::bgsegm;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<BackgroundSubtractorGSOC> > obj_;
+ObjectRegistry<BackgroundSubtractorGSOC> obj_;
 
 /// motion compensation types for option processing
 const ConstMap<string,int> MotionCompensationsMap = ConstMap<string,int>
@@ -83,17 +81,16 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                 mexErrMsgIdAndTxt("mexopencv:error",
                     "Unrecognized option %s", key.c_str());
         }
-        obj_[++last_id] = createBackgroundSubtractorGSOC(mc, nSamples,
+        plhs[0] = MxArray(obj_.add(createBackgroundSubtractorGSOC(mc, nSamples,
             replaceRate, propagationRate, hitsThreshold, alpha, beta,
             blinkingSupressionDecay, blinkingSupressionMultiplier,
-            noiseRemovalThresholdFacBG, noiseRemovalThresholdFacFG);
-        plhs[0] = MxArray(last_id);
+            noiseRemovalThresholdFacBG, noiseRemovalThresholdFacFG)));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<BackgroundSubtractorGSOC> obj = obj_[id];
+    Ptr<BackgroundSubtractorGSOC> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
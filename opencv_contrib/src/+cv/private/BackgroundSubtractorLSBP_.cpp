@@ -13,10 +13,8 @@ using namespace cv::bgsegm;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<BackgroundSubtractorLSBP> > obj_;
+ObjectRegistry<BackgroundSubtractorLSBP> obj_;
 
 /// motion compensation types for option processing
 const ConstMap<string,int> MotionCompensationsMap = ConstMap<string,int>
@@ -89,11 +87,10 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                 mexErrMsgIdAndTxt("mexopencv:error",
                     "Unrecognized option %s", key.c_str());
         }
-        obj_[++last_id] = createBackgroundSubtractorLSBP(mc, nSamples,
+        plhs[0] = MxArray(obj_.add(createBackgroundSubtractorLSBP(mc, nSamples,
             LSBPRadius, Tlower, Tupper, Tinc, Tdec, Rscale, Rincdec,
             noiseRemovalThresholdFacBG, noiseRemovalThresholdFacFG,
-            LSBPthreshold, minCount);
-        plhs[0] = MxArray(last_id);
+            LSBPthreshold, minCount)));
         mexLock();
         return;
     }
@@ -111,7 +108,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     }
 
     // Big operation switch
-    Ptr<BackgroundSubtractorLSBP> obj = obj_[id];
+    Ptr<BackgroundSubtractorLSBP> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -13,10 +13,8 @@ using namespace cv::bgsegm;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<BackgroundSubtractorMOG> > obj_;
+ObjectRegistry<BackgroundSubtractorMOG> obj_;
 }
 
 /**
@@ -57,15 +55,14 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                 mexErrMsgIdAndTxt("mexopencv:error",
                     "Unrecognized option %s", key.c_str());
         }
-        obj_[++last_id] = createBackgroundSubtractorMOG(
-            history, nmixtures, backgroundRatio, noiseSigma);
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(createBackgroundSubtractorMOG(
+            history, nmixtures, backgroundRatio, noiseSigma)));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<BackgroundSubtractorMOG> obj = obj_[id];
+    Ptr<BackgroundSubtractorMOG> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
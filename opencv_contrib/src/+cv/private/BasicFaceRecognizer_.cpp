@@ -14,10 +14,8 @@ using namespace cv::face;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<BasicFaceRecognizer> > obj_;
+ObjectRegistry<BasicFaceRecognizer> obj_;
 
 /** Create an instance of BasicFaceRecognizer using options in arguments
  * @param type face recognizer type, one of:
@@ -97,15 +95,14 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     // Constructor is called. Create a new object from argument
     if (method == "new") {
         nargchk(nrhs>=3 && nlhs<=1);
-        obj_[++last_id] = create_BasicFaceRecognizer(
-            rhs[2].toString(), rhs.begin() + 3, rhs.end());
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(create_BasicFaceRecognizer(
+            rhs[2].toString(), rhs.begin() + 3, rhs.end())));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<BasicFaceRecognizer> obj = obj_[id];
+    Ptr<BasicFaceRecognizer> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
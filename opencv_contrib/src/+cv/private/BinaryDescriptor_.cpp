@@ -13,10 +13,8 @@ using namespace cv::line_descriptor;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<BinaryDescriptor> > obj_;
+ObjectRegistry<BinaryDescriptor> obj_;
 
 /** Convert keylines to struct array
  * @param keylines vector of keylines
@@ -155,14 +153,14 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                 mexErrMsgIdAndTxt("mexopencv:error",
                     "Unrecognized option %s", key.c_str());
         }
-        obj_[++last_id] = BinaryDescriptor::createBinaryDescriptor(parameters);
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(BinaryDescriptor::createBinaryDescriptor(
+            parameters)));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<BinaryDescriptor> obj = obj_[id];
+    Ptr<BinaryDescriptor> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
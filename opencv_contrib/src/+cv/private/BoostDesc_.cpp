@@ -15,10 +15,8 @@ using namespace cv::xfeatures2d;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<BoostDesc> > obj_;
+ObjectRegistry<BoostDesc> obj_;
 }
 
 /**
@@ -41,14 +39,14 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     // Constructor is called. Create a new object from argument
     if (method == "new") {
         nargchk(nrhs>=2 && nlhs<=1);
-        obj_[++last_id] = createBoostDesc(rhs.begin() + 2, rhs.end());
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(createBoostDesc(
+            rhs.begin() + 2, rhs.end())));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<BoostDesc> obj = obj_[id];
+    Ptr<BoostDesc> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -13,10 +13,8 @@ using namespace cv::ximgproc;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<ContourFitting> > obj_;
+ObjectRegistry<ContourFitting> obj_;
 }
 
 /**
@@ -51,8 +49,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                 mexErrMsgIdAndTxt("mexopencv:error",
                     "Unrecognized option %s", key.c_str());
         }
-        obj_[++last_id] = createContourFitting(ctr, fd);
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(createContourFitting(ctr, fd)));
         mexLock();
         return;
     }
@@ -130,7 +127,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     }
 
     // Big operation switch
-    Ptr<ContourFitting> obj = obj_[id];
+    Ptr<ContourFitting> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -13,10 +13,8 @@ using namespace cv::optflow;
 
 namespace {
 // Persistent objects
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<DISOpticalFlow> > obj_;
+ObjectRegistry<DISOpticalFlow> obj_;
 
 /// DIS preset types
 const ConstMap<string,int> DISPresetMap = ConstMap<string,int>
@@ -54,14 +52,13 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                 mexErrMsgIdAndTxt("mexopencv:error",
                     "Unrecognized option %s", key.c_str());
         }
-        obj_[++last_id] = createOptFlow_DIS(preset);
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(createOptFlow_DIS(preset)));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<DISOpticalFlow> obj = obj_[id];
+    Ptr<DISOpticalFlow> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -14,10 +14,8 @@ using namespace cv::dpm;
 
 namespace {
 
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<DPMDetector> > obj_;
+ObjectRegistry<DPMDetector> obj_;
 
 /** Convert object detections to struct array
  * @param vo vector of detections
@@ -65,17 +63,16 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     // Constructor call
     if (method == "new") {
         nargchk((nrhs==3 || nrhs==4) && nlhs<=1);
-        obj_[++last_id] = (nrhs == 3) ?
+        plhs[0] = MxArray(obj_.add((nrhs == 3) ?
             DPMDetector::create(rhs[2].toVector<string>()) :
             DPMDetector::create(rhs[2].toVector<string>(),
-                rhs[3].toVector<string>());
-        plhs[0] = MxArray(last_id);
+                rhs[3].toVector<string>())));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<DPMDetector> obj = obj_[id];
+    Ptr<DPMDetector> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -13,10 +13,8 @@ using namespace cv::ximgproc;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<DTFilter> > obj_;
+ObjectRegistry<DTFilter> obj_;
 
 /// Domain Transform filter modes
 const ConstMap<string, int> EdgeAwareFiltersListMap = ConstMap<string, int>
@@ -86,9 +84,8 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
         nargchk(nrhs>=3 && nlhs<=1);
         Mat guide(rhs[2].toMat(rhs[2].isUint8() ? CV_8U : CV_32F));
         OptionsParser opts(rhs.begin() + 3, rhs.end());
-        obj_[++last_id] = createDTFilter(guide,
-            opts.sigmaSpatial, opts.sigmaColor, opts.mode, opts.numIters);
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(createDTFilter(guide,
+            opts.sigmaSpatial, opts.sigmaColor, opts.mode, opts.numIters)));
         mexLock();
         return;
     }
@@ -106,7 +103,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     }
 
     // Big operation switch
-    Ptr<DTFilter> obj = obj_[id];
+    Ptr<DTFilter> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
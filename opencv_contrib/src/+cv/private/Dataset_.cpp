@@ -42,10 +42,8 @@ using namespace cv::datasets;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<Dataset> > obj_;
+ObjectRegistry<Dataset> obj_;
 
 /// map for cv::datasets::genderType enum values
 const ConstMap<int,string> GenderTypeInvMap = ConstMap<int,string>
@@ -896,8 +894,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     // Constructor is called. Create a new object from argument
     if (method == "new") {
         nargchk(nrhs==3 && nlhs<=1);
-        obj_[++last_id] = create_Dataset(klass);
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(create_Dataset(klass)));
         mexLock();
         return;
     }
@@ -927,7 +924,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     }
 
     // Big operation switch
-    Ptr<Dataset> obj = obj_[id];
+    Ptr<Dataset> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -14,10 +14,8 @@ using namespace cv::ximgproc;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<DisparityWLSFilter> > obj_;
+ObjectRegistry<DisparityWLSFilter> obj_;
 
 /// Option values for StereoBM PreFilterType
 const ConstMap<string, int> PreFilerTypeMap = ConstMap<string, int>
@@ -257,18 +255,19 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     // Constructor is called. Create a new object from argument
     if (method == "new") {
         nargchk(nrhs==3 && nlhs<=1);
+        Ptr<DisparityWLSFilter> obj;
         if (rhs[2].isLogicalScalar()) {
             bool use_confidence = rhs[2].toBool();
-            obj_[++last_id] = createDisparityWLSFilterGeneric(use_confidence);
+            obj = createDisparityWLSFilterGeneric(use_confidence);
         }
         else {
             vector<MxArray> args(rhs[2].toVector<MxArray>());
             nargchk(args.size() >= 1);
             Ptr<StereoMatcher> matcher_left = create_StereoMatcher(
                 args[0].toString(), args.begin() + 1, args.end());
-            obj_[++last_id] = createDisparityWLSFilter(matcher_left);
+            obj = createDisparityWLSFilter(matcher_left);
         }
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(obj));
         mexLock();
         return;
     }
@@ -353,7 +352,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     }
 
     // Big operation switch
-    Ptr<DisparityWLSFilter> obj = obj_[id];
+    Ptr<DisparityWLSFilter> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -13,10 +13,8 @@ using namespace cv::ximgproc;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<EdgeBoxes> > obj_;
+ObjectRegistry<EdgeBoxes> obj_;
 }
 
 /**
@@ -81,16 +79,15 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                 mexErrMsgIdAndTxt("mexopencv:error",
                     "Unrecognized option %s", key.c_str());
         }
-        obj_[++last_id] = createEdgeBoxes(alpha, beta, eta, minScore,
+        plhs[0] = MxArray(obj_.add(createEdgeBoxes(alpha, beta, eta, minScore,
             maxBoxes, edgeMinMag, edgeMergeThr, clusterMinMag, maxAspectRatio,
-            minBoxArea, gamma, kappa);
-        plhs[0] = MxArray(last_id);
+            minBoxArea, gamma, kappa)));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<EdgeBoxes> obj = obj_[id];
+    Ptr<EdgeBoxes> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -13,10 +13,8 @@ using namespace cv::face;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<FacemarkKazemi> > obj_;
+ObjectRegistry<FacemarkKazemi> obj_;
 /// name of MATLAB function to evaluate (custom face detector)
 string func;
 
@@ -112,14 +110,14 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     // constructor call
     if (method == "new") {
         nargchk(nrhs>=3 && nlhs<=1);
-        obj_[++last_id] = createFacemarkKazemi(rhs.begin() + 3, rhs.end());
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(createFacemarkKazemi(
+            rhs.begin() + 3, rhs.end())));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<FacemarkKazemi> obj = obj_[id];
+    Ptr<FacemarkKazemi> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -13,10 +13,8 @@ using namespace cv::face;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<Facemark> > obj_;
+ObjectRegistry<Facemark> obj_;
 /// name of MATLAB function to evaluate (custom face detector)
 string func;
 
@@ -235,9 +233,8 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     // constructor call
     if (method == "new") {
         nargchk(nrhs>=4 && nlhs<=1);
-        obj_[++last_id] = createFacemark(
-            rhs[3].toString(), rhs.begin() + 4, rhs.end());
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(createFacemark(
+            rhs[3].toString(), rhs.begin() + 4, rhs.end())));
         mexLock();
         return;
     }
@@ -370,7 +367,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     }
 
     // Big operation switch
-    Ptr<Facemark> obj = obj_[id];
+    Ptr<Facemark> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
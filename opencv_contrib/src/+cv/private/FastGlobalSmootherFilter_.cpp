@@ -13,10 +13,8 @@ using namespace cv::ximgproc;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<FastGlobalSmootherFilter> > obj_;
+ObjectRegistry<FastGlobalSmootherFilter> obj_;
 
 /// Option arguments parser used by create and filter methods
 struct OptionsParser
@@ -80,10 +78,9 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
         nargchk(nrhs>=3 && nlhs<=1);
         Mat guide(rhs[2].toMat(CV_8U));
         OptionsParser opts(rhs.begin() + 3, rhs.end());
-        obj_[++last_id] = createFastGlobalSmootherFilter(guide,
+        plhs[0] = MxArray(obj_.add(createFastGlobalSmootherFilter(guide,
             opts.lambda, opts.sigma_color,
-            opts.lambda_attenuation, opts.num_iter);
-        plhs[0] = MxArray(last_id);
+            opts.lambda_attenuation, opts.num_iter)));
         mexLock();
         return;
     }
@@ -103,7 +100,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     }
 
     // Big operation switch
-    Ptr<FastGlobalSmootherFilter> obj = obj_[id];
+    Ptr<FastGlobalSmootherFilter> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
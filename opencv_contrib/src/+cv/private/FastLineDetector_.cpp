@@ -13,10 +13,8 @@ using namespace cv::ximgproc;
 
 namespace {
 // Persistent objects
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<FastLineDetector> > obj_;
+ObjectRegistry<FastLineDetector> obj_;
 }
 
 /**
@@ -63,16 +61,15 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                 mexErrMsgIdAndTxt("mexopencv:error",
                     "Unrecognized option %s", key.c_str());
         }
-        obj_[++last_id] = createFastLineDetector(
+        plhs[0] = MxArray(obj_.add(createFastLineDetector(
             length_threshold, distance_threshold, canny_th1, canny_th2,
-            canny_aperture_size, do_merge);
-        plhs[0] = MxArray(last_id);
+            canny_aperture_size, do_merge)));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<FastLineDetector> obj = obj_[id];
+    Ptr<FastLineDetector> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
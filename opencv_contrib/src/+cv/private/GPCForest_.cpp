@@ -17,10 +17,8 @@ typedef cv::optflow::GPCForest<nTrees> GPCForest5;
 
 namespace {
 // Persistent objects
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<GPCForest5> > obj_;
+ObjectRegistry<GPCForest5> obj_;
 
 /// GPC descriptor types for option processing
 const ConstMap<string,GPCDescType> GPCDescTypeMap = ConstMap<string,GPCDescType>
@@ -63,14 +61,13 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     // Constructor is called. Create a new object from argument
     if (method == "new") {
         nargchk(nrhs==2 && nlhs<=1);
-        obj_[++last_id] = GPCForest5::create();
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(GPCForest5::create()));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<GPCForest5> obj = obj_[id];
+    Ptr<GPCForest5> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -13,10 +13,8 @@ using namespace cv::ximgproc::segmentation;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<GraphSegmentation> > obj_;
+ObjectRegistry<GraphSegmentation> obj_;
 }
 
 /**
@@ -54,14 +52,14 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                 mexErrMsgIdAndTxt("mexopencv:error",
                     "Unrecognized option %s", key.c_str());
         }
-        obj_[++last_id] = createGraphSegmentation(sigma, k, min_size);
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(createGraphSegmentation(
+            sigma, k, min_size)));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<GraphSegmentation> obj = obj_[id];
+    Ptr<GraphSegmentation> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -13,10 +13,8 @@ using namespace cv::ximgproc;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<GuidedFilter> > obj_;
+ObjectRegistry<GuidedFilter> obj_;
 
 /// Option arguments parser used by create and filter methods
 struct OptionsParser
@@ -73,8 +71,8 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
         Mat guide(rhs[2].toMat(rhs[2].isUint8() ? CV_8U :
             (rhs[2].isUint16() ? CV_16U : CV_32F)));
         OptionsParser opts(rhs.begin() + 3, rhs.end());
-        obj_[++last_id] = createGuidedFilter(guide, opts.radius, opts.eps);
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(createGuidedFilter(
+            guide, opts.radius, opts.eps)));
         mexLock();
         return;
     }
@@ -92,7 +90,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     }
 
     // Big operation switch
-    Ptr<GuidedFilter> obj = obj_[id];
+    Ptr<GuidedFilter> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -13,10 +13,8 @@ using namespace cv::hfs;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<HfsSegment> > obj_;
+ObjectRegistry<HfsSegment> obj_;
 
 /// backends for option processing
 enum { HFS_BACKEND_CPU, HFS_BACKEND_GPU };
@@ -74,16 +72,15 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
         }
         int height = rhs[2].toInt(),
             width = rhs[3].toInt();
-        obj_[++last_id] = HfsSegment::create(height, width,
+        plhs[0] = MxArray(obj_.add(HfsSegment::create(height, width,
             segEgbThresholdI, minRegionSizeI, segEgbThresholdII,
-            minRegionSizeII, spatialWeight, slicSpixelSize, numSlicIter);
-        plhs[0] = MxArray(last_id);
+            minRegionSizeII, spatialWeight, slicSpixelSize, numSlicIter)));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<HfsSegment> obj = obj_[id];
+    Ptr<HfsSegment> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
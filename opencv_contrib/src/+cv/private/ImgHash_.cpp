@@ -14,10 +14,8 @@ using namespace cv::img_hash;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<ImgHashBase> > obj_;
+ObjectRegistry<ImgHashBase> obj_;
 
 /// BlockMeanHash mode map for option processing
 const ConstMap<string,int> BlockMeanHashModeMap = ConstMap<string,int>
@@ -132,9 +130,8 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     // Constructor is called. Create a new object from argument
     if (method == "new") {
         nargchk(nrhs>=3 && nlhs<=1);
-        obj_[++last_id] = createImgHashBase(
-            rhs[2].toString(), rhs.begin() + 3, rhs.end());
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(createImgHashBase(
+            rhs[2].toString(), rhs.begin() + 3, rhs.end())));
         mexLock();
         return;
     }
@@ -216,7 +213,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     }
 
     // Big operation switch
-    Ptr<ImgHashBase> obj = obj_[id];
+    Ptr<ImgHashBase> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -14,10 +14,8 @@ using namespace cv::face;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<LBPHFaceRecognizer> > obj_;
+ObjectRegistry<LBPHFaceRecognizer> obj_;
 
 /** Create an instance of LBPHFaceRecognizer using options in arguments
  * @param first iterator at the beginning of the vector range
@@ -92,15 +90,14 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     // Constructor is called. Create a new object from argument
     if (method == "new") {
         nargchk(nrhs>=2 && nlhs<=1);
-        obj_[++last_id] = create_LBPHFaceRecognizer(
-            rhs.begin() + 2, rhs.end());
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(create_LBPHFaceRecognizer(
+            rhs.begin() + 2, rhs.end())));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<LBPHFaceRecognizer> obj = obj_[id];
+    Ptr<LBPHFaceRecognizer> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
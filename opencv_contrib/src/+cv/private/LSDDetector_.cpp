@@ -13,10 +13,8 @@ using namespace cv::line_descriptor;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<LSDDetector> > obj_;
+ObjectRegistry<LSDDetector> obj_;
 
 /** Convert keylines to struct array
  * @param keylines vector of keylines
@@ -78,14 +76,13 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     // Constructor is called. Create a new object from argument
     if (method == "new") {
         nargchk(nrhs==2 && nlhs<=1);
-        obj_[++last_id] = LSDDetector::createLSDDetector();
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(LSDDetector::createLSDDetector()));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<LSDDetector> obj = obj_[id];
+    Ptr<LSDDetector> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
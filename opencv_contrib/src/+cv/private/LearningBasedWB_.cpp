@@ -13,10 +13,8 @@ using namespace cv::xphoto;
 
 namespace {
 // Persistent objects
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<LearningBasedWB> > obj_;
+ObjectRegistry<LearningBasedWB> obj_;
 }
 
 /**
@@ -48,14 +46,13 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                 mexErrMsgIdAndTxt("mexopencv:error",
                     "Unrecognized option %s", key.c_str());
         }
-        obj_[++last_id] = createLearningBasedWB(path_to_model);
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(createLearningBasedWB(path_to_model)));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<LearningBasedWB> obj = obj_[id];
+    Ptr<LearningBasedWB> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
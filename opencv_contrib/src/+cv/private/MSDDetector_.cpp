@@ -15,10 +15,8 @@ using namespace cv::xfeatures2d;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<MSDDetector> > obj_;
+ObjectRegistry<MSDDetector> obj_;
 }
 
 /**
@@ -41,14 +39,14 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     // Constructor is called. Create a new object from argument
     if (method == "new") {
         nargchk(nrhs>=2 && nlhs<=1);
-        obj_[++last_id] = createMSDDetector(rhs.begin() + 2, rhs.end());
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(createMSDDetector(
+            rhs.begin() + 2, rhs.end())));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<MSDDetector> obj = obj_[id];
+    Ptr<MSDDetector> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -96,12 +94,15 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     }
     else if (method == "detect") {
         nargchk(nrhs>=3 && (nrhs%2)==1 && nlhs<=1);
+        bool soa = false;
         if (rhs[2].isNumeric()) {  // first variant that accepts an image
             Mat mask;
             for (int i=3; i<nrhs; i+=2) {
                 string key(rhs[i].toString());
                 if (key == "Mask")
                     mask = rhs[i+1].toMat(CV_8U);
+                else if (key == "OutputFormat")
+                    soa = OutputFormatSoAMap[rhs[i+1].toString()];
                 else
                     mexErrMsgIdAndTxt("mexopencv:error",
                         "Unrecognized option %s", key.c_str());
@@ -109,7 +110,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
             Mat image(rhs[2].toMat(CV_8U));
             vector<KeyPoint> keypoints;
             obj->detect(image, keypoints, mask);
-            plhs[0] = MxArray(keypoints);
+            plhs[0] = (soa) ? toStructOfArrays(keypoints) : MxArray(keypoints);
         }
         else if (rhs[2].isCell()) {  // second variant that accepts an image set
             vector<Mat> masks;
@@ -123,6 +124,8 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                     for (vector<MxArray>::const_iterator it = arr.begin(); it != arr.end(); ++it)
                         masks.push_back(it->toMat(CV_8U));
                 }
+                else if (key == "OutputFormat")
+                    soa = OutputFormatSoAMap[rhs[i+1].toString()];
                 else
                     mexErrMsgIdAndTxt("mexopencv:error",
                         "Unrecognized option %s", key.c_str());
@@ -137,7 +140,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
             }
             vector<vector<KeyPoint> > keypoints;
             obj->detect(images, keypoints, masks);
-            plhs[0] = MxArray(keypoints);
+            plhs[0] = (soa) ? toStructOfArrays(keypoints) : MxArray(keypoints);
         }
         else
             mexErrMsgIdAndTxt("mexopencv:error", "Invalid arguments");
@@ -13,10 +13,8 @@ using namespace cv::saliency;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<MotionSaliencyBinWangApr2014> > obj_;
+ObjectRegistry<MotionSaliencyBinWangApr2014> obj_;
 }
 
 /**
@@ -39,14 +37,13 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     // Constructor is called. Create a new object from argument
     if (method == "new") {
         nargchk(nrhs==2 && nlhs<=1);
-        obj_[++last_id] = MotionSaliencyBinWangApr2014::create();
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(MotionSaliencyBinWangApr2014::create()));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<MotionSaliencyBinWangApr2014> obj = obj_[id];
+    Ptr<MotionSaliencyBinWangApr2014> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -13,10 +13,8 @@ using namespace cv::optflow;
 
 namespace {
 // Persistent objects
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<OpticalFlowPCAFlow> > obj_;
+ObjectRegistry<OpticalFlowPCAFlow> obj_;
 }
 
 /**
@@ -69,17 +67,16 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
         Ptr<PCAPrior> prior;
         if (!pathToPrior.empty())
             prior = makePtr<PCAPrior>(pathToPrior.c_str());
-        obj_[++last_id] = makePtr<OpticalFlowPCAFlow>(prior, basisSize,
-            sparseRate, retainedCornersFraction, occlusionsThreshold,
-            dampingFactor, claheClip);
-        //obj_[++last_id] = createOptFlow_PCAFlow();
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(makePtr<OpticalFlowPCAFlow>(prior,
+            basisSize, sparseRate, retainedCornersFraction,
+            occlusionsThreshold, dampingFactor, claheClip)));
+        //plhs[0] = MxArray(obj_.add(createOptFlow_PCAFlow()));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<OpticalFlowPCAFlow> obj = obj_[id];
+    Ptr<OpticalFlowPCAFlow> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
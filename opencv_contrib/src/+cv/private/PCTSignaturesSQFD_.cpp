@@ -13,10 +13,8 @@ using namespace cv::xfeatures2d;
 
 namespace {
 // Persistent objects
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<PCTSignaturesSQFD> > obj_;
+ObjectRegistry<PCTSignaturesSQFD> obj_;
 
 /// Lp distance function selector for option processing
 const ConstMap<string,int> DistanceFuncMap = ConstMap<string,int>
@@ -72,15 +70,14 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                 mexErrMsgIdAndTxt("mexopencv:error",
                     "Unrecognized option %s", key.c_str());
         }
-        obj_[++last_id] = PCTSignaturesSQFD::create(
-            distanceFunction, similarityFunction, similarityParameter);
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(PCTSignaturesSQFD::create(
+            distanceFunction, similarityFunction, similarityParameter)));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<PCTSignaturesSQFD> obj = obj_[id];
+    Ptr<PCTSignaturesSQFD> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
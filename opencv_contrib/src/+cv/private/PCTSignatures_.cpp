@@ -13,10 +13,8 @@ using namespace cv::xfeatures2d;
 
 namespace {
 // Persistent objects
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<PCTSignatures> > obj_;
+ObjectRegistry<PCTSignatures> obj_;
 
 /// Lp distance function selector for option processing
 const ConstMap<string,int> DistanceFuncMap = ConstMap<string,int>
@@ -91,8 +89,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
             p = PCTSignatures::create(
                 initSampleCount, initSeedCount, pointDistribution);
         }
-        obj_[++last_id] = p;
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(p));
         mexLock();
         return;
     }
@@ -131,7 +128,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     }
 
     // Big operation switch
-    Ptr<PCTSignatures> obj = obj_[id];
+    Ptr<PCTSignatures> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -13,10 +13,8 @@ using namespace cv::plot;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<Plot2d> > obj_;
+ObjectRegistry<Plot2d> obj_;
 }
 
 /**
@@ -49,14 +47,13 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                 dataY(rhs[3].toMat(CV_64F));
             p = Plot2d::create(dataX, dataY);
         }
-        obj_[++last_id] = p;
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(p));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<Plot2d> obj = obj_[id];
+    Ptr<Plot2d> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -13,10 +13,8 @@ using namespace cv::bioinspired;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<Retina> > obj_;
+ObjectRegistry<Retina> obj_;
 
 /// Retina color sampling methods
 const ConstMap<string,int> RetinaColorSampMap = ConstMap<string,int>
@@ -247,14 +245,13 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     // Constructor is called. Create a new object from argument
     if (method == "new") {
         nargchk(nrhs>=2 && nlhs<=1);
-        obj_[++last_id] = create_Retina(rhs.begin() + 2, rhs.end());
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(create_Retina(rhs.begin() + 2, rhs.end())));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<Retina> obj = obj_[id];
+    Ptr<Retina> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -13,10 +13,8 @@ using namespace cv::ximgproc;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<RidgeDetectionFilter> > obj_;
+ObjectRegistry<RidgeDetectionFilter> obj_;
 }
 
 /**
@@ -71,15 +69,14 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                 mexErrMsgIdAndTxt("mexopencv:error",
                     "Unrecognized option %s", key.c_str());
         }
-        obj_[++last_id] = RidgeDetectionFilter::create(ddepth, dx, dy, ksize,
-            out_dtype, scale, delta, borderType);
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(RidgeDetectionFilter::create(
+            ddepth, dx, dy, ksize, out_dtype, scale, delta, borderType)));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<RidgeDetectionFilter> obj = obj_[id];
+    Ptr<RidgeDetectionFilter> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -15,10 +15,8 @@ using namespace cv::xfeatures2d;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<SURF> > obj_;
+ObjectRegistry<SURF> obj_;
 }
 
 /**
@@ -41,14 +39,13 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     // Constructor is called. Create a new object from argument
     if (method == "new") {
         nargchk(nrhs>=2 && nlhs<=1);
-        obj_[++last_id] = createSURF(rhs.begin() + 2, rhs.end());
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(createSURF(rhs.begin() + 2, rhs.end())));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<SURF> obj = obj_[id];
+    Ptr<SURF> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -108,12 +105,15 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     }
     else if (method == "detect") {
         nargchk(nrhs>=3 && (nrhs%2)==1 && nlhs<=1);
+        bool soa = false;
         if (rhs[2].isNumeric()) {  // first variant that accepts an image
             Mat mask;
             for (int i=3; i<nrhs; i+=2) {
                 string key(rhs[i].toString());
                 if (key == "Mask")
                     mask = rhs[i+1].toMat(CV_8U);
+                else if (key == "OutputFormat")
+                    soa = OutputFormatSoAMap[rhs[i+1].toString()];
                 else
                     mexErrMsgIdAndTxt("mexopencv:error",
                         "Unrecognized option %s", key.c_str());
@@ -121,7 +121,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
             Mat image(rhs[2].toMat(CV_8U));
             vector<KeyPoint> keypoints;
             obj->detect(image, keypoints, mask);
-            plhs[0] = MxArray(keypoints);
+            plhs[0] = (soa) ? toStructOfArrays(keypoints) : MxArray(keypoints);
         }
         else if (rhs[2].isCell()) {  // second variant that accepts an image set
             vector<Mat> masks;
@@ -135,6 +135,8 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                     for (vector<MxArray>::const_iterator it = arr.begin(); it != arr.end(); ++it)
                         masks.push_back(it->toMat(CV_8U));
                 }
+                else if (key == "OutputFormat")
+                    soa = OutputFormatSoAMap[rhs[i+1].toString()];
                 else
                     mexErrMsgIdAndTxt("mexopencv:error",
                         "Unrecognized option %s", key.c_str());
@@ -149,7 +151,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
             }
             vector<vector<KeyPoint> > keypoints;
             obj->detect(images, keypoints, masks);
-            plhs[0] = MxArray(keypoints);
+            plhs[0] = (soa) ? toStructOfArrays(keypoints) : MxArray(keypoints);
         }
         else
             mexErrMsgIdAndTxt("mexopencv:error", "Invalid arguments");
@@ -186,6 +188,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     }
     else if (method == "detectAndCompute") {
         nargchk(nrhs>=3 && (nrhs%2)==1 && nlhs<=2);
+        bool soa = false;
         Mat mask;
         vector<KeyPoint> keypoints;
         bool useProvidedKeypoints = false;
@@ -197,6 +200,8 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                 keypoints = rhs[i+1].toVector<KeyPoint>();
                 useProvidedKeypoints = true;
             }
+            else if (key == "OutputFormat")
+                soa = OutputFormatSoAMap[rhs[i+1].toString()];
             else
                 mexErrMsgIdAndTxt("mexopencv:error",
                     "Unrecognized option %s", key.c_str());
@@ -204,7 +209,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
         Mat image(rhs[2].toMat(CV_8U)), descriptors;
         obj->detectAndCompute(image, mask, keypoints, descriptors,
             useProvidedKeypoints);
-        plhs[0] = MxArray(keypoints);
+        plhs[0] = (soa) ? toStructOfArrays(keypoints) : MxArray(keypoints);
         if (nlhs > 1)
             plhs[1] = MxArray(descriptors);
     }
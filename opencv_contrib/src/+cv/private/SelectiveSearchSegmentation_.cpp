@@ -13,10 +13,8 @@ using namespace cv::ximgproc::segmentation;
 
 namespace {
 // Persistent objects
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<SelectiveSearchSegmentation> > obj_;
+ObjectRegistry<SelectiveSearchSegmentation> obj_;
 
 /** Create an instance of GraphSegmentation using options in arguments
  * @param first iterator at the beginning of the vector range
@@ -137,14 +135,13 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     // Constructor is called. Create a new object from argument
     if (method == "new") {
         nargchk(nrhs==2 && nlhs<=1);
-        obj_[++last_id] = createSelectiveSearchSegmentation();
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(createSelectiveSearchSegmentation()));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<SelectiveSearchSegmentation> obj = obj_[id];
+    Ptr<SelectiveSearchSegmentation> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
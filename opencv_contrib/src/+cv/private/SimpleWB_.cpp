@@ -13,10 +13,8 @@ using namespace cv::xphoto;
 
 namespace {
 // Persistent objects
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<SimpleWB> > obj_;
+ObjectRegistry<SimpleWB> obj_;
 }
 
 /**
@@ -39,14 +37,13 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     // constructor call
     if (method == "new") {
         nargchk(nrhs==2 && nlhs<=1);
-        obj_[++last_id] = createSimpleWB();
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(createSimpleWB()));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<SimpleWB> obj = obj_[id];
+    Ptr<SimpleWB> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -13,10 +13,8 @@ using namespace cv::ximgproc;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<StructuredEdgeDetection> > obj_;
+ObjectRegistry<StructuredEdgeDetection> obj_;
 
 /// Custom feature extractor class implemented as a MATLAB function.
 class MatlabRFFeatureGetter : public cv::ximgproc::RFFeatureGetter
@@ -125,9 +123,8 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                 rhs[3].toString());
         else
             howToGetFeatures = createRFFeatureGetter();
-        obj_[++last_id] = createStructuredEdgeDetection(
-            model, howToGetFeatures);
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(createStructuredEdgeDetection(
+            model, howToGetFeatures)));
         mexLock();
         return;
     }
@@ -148,7 +145,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     }
 
     // Big operation switch
-    Ptr<StructuredEdgeDetection> obj = obj_[id];
+    Ptr<StructuredEdgeDetection> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -13,10 +13,8 @@ using namespace cv::ximgproc;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<SuperpixelLSC> > obj_;
+ObjectRegistry<SuperpixelLSC> obj_;
 }
 
 /**
@@ -52,14 +50,14 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                     "Unrecognized option %s", key.c_str());
         }
         Mat image(rhs[2].toMat());
-        obj_[++last_id] = createSuperpixelLSC(image, region_size, ratio);
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(createSuperpixelLSC(
+            image, region_size, ratio)));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<SuperpixelLSC> obj = obj_[id];
+    Ptr<SuperpixelLSC> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -13,10 +13,8 @@ using namespace cv::ximgproc;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<SuperpixelSEEDS> > obj_;
+ObjectRegistry<SuperpixelSEEDS> obj_;
 }
 
 /**
@@ -62,16 +60,15 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
             image_channels = (sz.size() == 3 ? sz[2] : 1),
             num_superpixels = rhs[3].toInt(),
             num_levels = rhs[4].toInt();
-        obj_[++last_id] = createSuperpixelSEEDS(
+        plhs[0] = MxArray(obj_.add(createSuperpixelSEEDS(
             image_width, image_height, image_channels,
-            num_superpixels, num_levels, prior, histogram_bins, double_step);
-        plhs[0] = MxArray(last_id);
+            num_superpixels, num_levels, prior, histogram_bins, double_step)));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<SuperpixelSEEDS> obj = obj_[id];
+    Ptr<SuperpixelSEEDS> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
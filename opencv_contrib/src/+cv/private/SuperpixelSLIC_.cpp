@@ -13,10 +13,8 @@ using namespace cv::ximgproc;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<SuperpixelSLIC> > obj_;
+ObjectRegistry<SuperpixelSLIC> obj_;
 
 /// Option values for SLIC algorithms
 const ConstMap<string, int> SLICAlgorithmMap = ConstMap<string, int>
@@ -61,15 +59,14 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                     "Unrecognized option %s", key.c_str());
         }
         Mat image(rhs[2].toMat());
-        obj_[++last_id] = createSuperpixelSLIC(
-            image, algorithm, region_size, ruler);
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(createSuperpixelSLIC(
+            image, algorithm, region_size, ruler)));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<SuperpixelSLIC> obj = obj_[id];
+    Ptr<SuperpixelSLIC> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
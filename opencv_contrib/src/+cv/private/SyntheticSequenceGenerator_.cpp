@@ -13,10 +13,8 @@ using namespace cv::bgsegm;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<SyntheticSequenceGenerator> > obj_;
+ObjectRegistry<SyntheticSequenceGenerator> obj_;
 }
 
 /**
@@ -59,15 +57,14 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
         }
         Mat background(rhs[2].toMat(CV_8U)),
             object(rhs[3].toMat(CV_8U));
-        obj_[++last_id] = createSyntheticSequenceGenerator(background, object,
-            amplitude, wavelength, wavespeed, objspeed);
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(createSyntheticSequenceGenerator(
+            background, object, amplitude, wavelength, wavespeed, objspeed)));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<SyntheticSequenceGenerator> obj = obj_[id];
+    Ptr<SyntheticSequenceGenerator> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
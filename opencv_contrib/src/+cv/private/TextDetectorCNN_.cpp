@@ -13,10 +13,8 @@ using namespace cv::text;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<TextDetectorCNN> > obj_;
+ObjectRegistry<TextDetectorCNN> obj_;
 }
 
 /**
@@ -50,15 +48,14 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
         }
         string modelArchFilename(rhs[2].toString()),
             modelWeightsFilename(rhs[3].toString());
-        obj_[++last_id] = TextDetectorCNN::create(
-            modelArchFilename, modelWeightsFilename, detectionSizes);
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(TextDetectorCNN::create(
+            modelArchFilename, modelWeightsFilename, detectionSizes)));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<TextDetectorCNN> obj = obj_[id];
+    Ptr<TextDetectorCNN> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
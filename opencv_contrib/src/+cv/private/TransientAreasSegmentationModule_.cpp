@@ -13,10 +13,8 @@ using namespace cv::bioinspired;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<TransientAreasSegmentationModule> > obj_;
+ObjectRegistry<TransientAreasSegmentationModule> obj_;
 
 /** Create an instance of SegmentationParameters using options in arguments
  * @param[in,out] params SegmentationParameters struct to fill
@@ -99,15 +97,14 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     // Constructor is called. Create a new object from argument
     if (method == "new") {
         nargchk(nrhs==3 && nlhs<=1);
-        obj_[++last_id] = TransientAreasSegmentationModule::create(
-            rhs[2].toSize());
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(TransientAreasSegmentationModule::create(
+            rhs[2].toSize())));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<TransientAreasSegmentationModule> obj = obj_[id];
+    Ptr<TransientAreasSegmentationModule> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -13,10 +13,8 @@ using namespace cv::optflow;
 
 namespace {
 // Persistent objects
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<VariationalRefinement> > obj_;
+ObjectRegistry<VariationalRefinement> obj_;
 }
 
 /**
@@ -39,14 +37,13 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     // constructor call
     if (method == "new") {
         nargchk(nrhs==2 && nlhs<=1);
-        obj_[++last_id] = createVariationalFlowRefinement();
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(createVariationalFlowRefinement()));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<VariationalRefinement> obj = obj_[id];
+    Ptr<VariationalRefinement> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -13,10 +13,8 @@ using namespace cv::xobjdetect;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<WBDetector> > obj_;
+ObjectRegistry<WBDetector> obj_;
 }
 
 /**
@@ -39,14 +37,13 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     // Constructor call
     if (method == "new") {
         nargchk(nrhs==2 && nlhs<=1);
-        obj_[++last_id] = WBDetector::create();
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(WBDetector::create()));
         mexLock();
         return;
     }
 
     // Big operation switch
-    Ptr<WBDetector> obj = obj_[id];
+    Ptr<WBDetector> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
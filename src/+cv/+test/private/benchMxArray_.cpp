@@ -0,0 +1,99 @@
+/**
+ * @file benchMxArray_.cpp
+ * @brief Micro-benchmarks for MxArray conversions
+ * @ingroup test
+ */
+#include "mexopencv.hpp"
+using namespace std;
+using namespace cv;
+
+namespace {
+/** Reference implementation of MxArray::toMat for 2D and 3D arrays.
+ * @param arr input numeric array.
+ * @param depth output depth, \c CV_USRTYPE1 to keep the input depth.
+ * @return cv::Mat object.
+ *
+ * This is the former split/convert/transpose/merge conversion, kept here to
+ * measure the single-pass implementation against.
+ */
+Mat toMatReference(const MxArray& arr, int depth)
+{
+    const mwSize *d = arr.dims();
+    const int m = static_cast<int>(d[0]), n = static_cast<int>(d[1]);
+    const int cn = (arr.ndims() > 2) ? static_cast<int>(d[2]) : 1;
+    const int sdepth = ClassNameMap[arr.className()];
+    depth = (depth == CV_USRTYPE1) ? sdepth : depth;
+    const size_t plane = static_cast<size_t>(m) * n * CV_ELEM_SIZE1(sdepth);
+    const uchar *data = static_cast<const uchar*>(
+        mxGetData(static_cast<const mxArray*>(arr)));
+    vector<Mat> channels(cn);
+    for (int i = 0; i < cn; ++i) {
+        const Mat hdr(n, m, sdepth, const_cast<uchar*>(data + i*plane));
+        hdr.convertTo(channels[i], depth);
+        transpose(channels[i], channels[i]);
+    }
+    Mat mat;
+    merge(channels, mat);
+    return mat;
+}
+}
+
+/**
+ * Main entry called from Matlab
+ * @param nlhs number of left-hand-side arguments
+ * @param plhs pointers to mxArrays in the left-hand-side
+ * @param nrhs number of right-hand-side arguments
+ * @param prhs pointers to mxArrays in the right-hand-side
+ */
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+    // Set a cutom error handler to be called by cv::error() and cousins
+    cv::redirectError(MexErrorHandler);
+
+    // Check the number of arguments
+    nargchk(nrhs>=2 && (nrhs%2)==0 && nlhs<=1);
+
+    // Argument vector
+    vector<MxArray> rhs(prhs, prhs+nrhs);
+    string method(rhs[0].toString());
+
+    // Option processing
+    int depth = CV_USRTYPE1;
+    int nrepeat = 10;
+    for (int i=2; i<nrhs; i+=2) {
+        string key(rhs[i].toString());
+        if (key == "Depth")
+            depth = (rhs[i+1].isChar()) ?
+                ClassNameMap[rhs[i+1].toString()] : rhs[i+1].toInt();
+        else if (key == "Repeat")
+            nrepeat = rhs[i+1].toInt();
+        else
+            mexErrMsgIdAndTxt("mexopencv:error",
+                "Unrecognized option %s", key.c_str());
+    }
+    CV_Assert(nrepeat > 0);
+
+    if (method == "toMat") {
+        CV_Assert(rhs[1].ndims() <= 3 && !rhs[1].isEmpty());
+        TickMeter tmCurrent, tmReference;
+        for (int i=0; i<nrepeat; ++i) {
+            tmCurrent.start();
+            Mat m1(rhs[1].toMat(depth));
+            tmCurrent.stop();
+            tmReference.start();
+            Mat m2(toMatReference(rhs[1], depth));
+            tmReference.stop();
+            if (i == 0)
+                CV_Assert(m1.type() == m2.type() && m1.size() == m2.size() &&
+                    norm(m1, m2, cv::NORM_INF) == 0);
+        }
+        const char *fields[] = {"Current", "Reference"};
+        MxArray s = MxArray::Struct(fields, 2);
+        s.set("Current",   tmCurrent.getTimeMilli() / nrepeat);
+        s.set("Reference", tmReference.getTimeMilli() / nrepeat);
+        plhs[0] = s;
+    }
+    else
+        mexErrMsgIdAndTxt("mexopencv:error",
+            "Unrecognized method %s", method.c_str());
+}
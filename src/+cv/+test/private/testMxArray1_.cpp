@@ -86,6 +86,36 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
             CV_Assert(data[i] == (i+1));
         plhs[0] = MxArray(true);
     }
+    else if (method == "toMat_multi_channel") {
+        nargchk(nrhs==3 && nlhs<=1);
+        Mat m(rhs[1].toMat(ClassNameMap[rhs[2].toString()]));
+        const mwSize cn = (rhs[1].ndims() > 2) ? rhs[1].dims()[2] : 1;
+        CV_Assert(m.dims == 2 && m.rows == rhs[1].rows() && m.channels() == cn);
+        plhs[0] = MxArray(m);
+    }
+    else if (method == "toMatND_roundtrip") {
+        nargchk(nrhs==2 && nlhs<=1);
+        MatND m(rhs[1].toMatND());
+        CV_Assert(m.dims == rhs[1].ndims() && m.channels() == 1);
+        // element (i,j,k,...) of the MATLAB array is at the same subscript
+        vector<mwIndex> si(m.dims);
+        vector<int> idx(m.dims);
+        for (int i=0; i<m.dims; i++)
+            si[i] = idx[i] = m.size[i] - 1;
+        CV_Assert(m.at<double>(&idx[0]) == rhs[1].at<double>(si));
+        plhs[0] = MxArray(m);
+    }
+    else if (method == "toMatView_copy") {
+        nargchk(nrhs==2 && nlhs<=1);
+        CV_Assert(isElementwiseView(rhs[1]));
+        MxArray arr(MxArray::Numeric(
+            rhs[1].rows(), rhs[1].cols(), rhs[1].classID()));
+        Mat src(rhs[1].toMatView()), dst(arr.toMatView());
+        CV_Assert(src.rows == rhs[1].cols() && src.cols == rhs[1].rows());
+        src.copyTo(dst);
+        CV_Assert(dst.data == mxGetData(static_cast<const mxArray*>(arr)));
+        plhs[0] = arr;
+    }
     else if (method == "fromMat_row_vector") {
         nargchk(nrhs==1 && nlhs<=1);
         Mat m = (Mat_<double>(1,10) << 1, 2, 3, 4, 5, 6, 7, 8, 9, 10);
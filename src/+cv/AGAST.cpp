@@ -6,6 +6,7 @@
  * @date 2015
  */
 #include "mexopencv.hpp"
+#include "mexopencv_features2d.hpp"  // toStructOfArrays
 #include "opencv2/features2d.hpp"
 using namespace std;
 using namespace cv;
@@ -38,6 +39,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     int threshold = 10;
     bool nonmaxSupression = true;
     int type = cv::AgastFeatureDetector::OAST_9_16;
+    bool soa = false;
     for (int i=1; i<nrhs; i+=2) {
         string key(rhs[i].toString());
         if (key == "Threshold")
@@ -46,6 +48,8 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
             nonmaxSupression = rhs[i+1].toBool();
         else if (key == "Type")
             type = AgastTypeMap[rhs[i+1].toString()];
+        else if (key == "OutputFormat")
+            soa = OutputFormatSoAMap[rhs[i+1].toString()];
         else
             mexErrMsgIdAndTxt("mexopencv:error",
                 "Unrecognized option %s", key.c_str());
@@ -55,5 +59,5 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     Mat image(rhs[0].toMat(CV_8U));
     vector<KeyPoint> keypoints;
     AGAST(image, keypoints, threshold, nonmaxSupression, type);
-    plhs[0] = MxArray(keypoints);
+    plhs[0] = (soa) ? toStructOfArrays(keypoints) : MxArray(keypoints);
 }
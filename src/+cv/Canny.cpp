@@ -6,10 +6,34 @@
  * @date 2011
  */
 #include "mexopencv.hpp"
+#include "mexopencv_batch.hpp"
 #include "opencv2/imgproc.hpp"
 using namespace std;
 using namespace cv;
 
+namespace {
+/// Batch operation for cv::Canny
+class CannyOperation : public BatchOperation
+{
+  public:
+    /// Constructor
+    CannyOperation(double threshold1, double threshold2, int apertureSize,
+        bool L2gradient)
+    : threshold1_(threshold1), threshold2_(threshold2),
+      apertureSize_(apertureSize), L2gradient_(L2gradient)
+    {}
+    virtual void operator()(const Mat& src, Mat& dst) const
+    {
+        Canny(src, dst, threshold1_, threshold2_, apertureSize_, L2gradient_);
+    }
+  private:
+    double threshold1_;
+    double threshold2_;
+    int apertureSize_;
+    bool L2gradient_;
+};
+}
+
 /**
  * Main entry called from Matlab
  * @param nlhs number of left-hand-side arguments
@@ -19,6 +43,8 @@ using namespace cv;
  */
 void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 {
+    ProfileCall prof;
+
     // Check the number of arguments
     nargchk(nrhs>=2 && (nrhs%2)==0 && nlhs<=1);
 
@@ -51,8 +77,16 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     }
 
     // Process
+    prof.phase(Profiler::KERNEL);
+    if (isBatch(rhs[0])) {
+        // cell array or HxWxCxN stack of images, processed in parallel
+        plhs[0] = processBatch(rhs[0], CannyOperation(threshold1, threshold2,
+            apertureSize, L2gradient), CV_8U);
+        return;
+    }
     Mat image(rhs[0].toMat(CV_8U)),
         edges;
     Canny(image, edges, threshold1, threshold2, apertureSize, L2gradient);
+    prof.phase(Profiler::OUTPUT);
     plhs[0] = MxArray(edges);
 }
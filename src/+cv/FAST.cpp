@@ -6,6 +6,7 @@
  * @date 2011
  */
 #include "mexopencv.hpp"
+#include "mexopencv_features2d.hpp"  // toStructOfArrays
 #include "opencv2/features2d.hpp"
 using namespace std;
 using namespace cv;
@@ -37,6 +38,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     int threshold = 10;
     bool nonmaxSupression = true;
     int type = cv::FastFeatureDetector::TYPE_9_16;
+    bool soa = false;
     for (int i=1; i<nrhs; i+=2) {
         string key(rhs[i].toString());
         if (key == "Threshold")
@@ -45,6 +47,8 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
             nonmaxSupression = rhs[i+1].toBool();
         else if (key == "Type")
             type = FASTTypeMap[rhs[i+1].toString()];
+        else if (key == "OutputFormat")
+            soa = OutputFormatSoAMap[rhs[i+1].toString()];
         else
             mexErrMsgIdAndTxt("mexopencv:error",
                 "Unrecognized option %s", key.c_str());
@@ -54,5 +58,5 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     Mat image(rhs[0].toMat(CV_8U));
     vector<KeyPoint> keypoints;
     FAST(image, keypoints, threshold, nonmaxSupression, type);
-    plhs[0] = MxArray(keypoints);
+    plhs[0] = (soa) ? toStructOfArrays(keypoints) : MxArray(keypoints);
 }
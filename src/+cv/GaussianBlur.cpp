@@ -6,10 +6,33 @@
  * @date 2011
  */
 #include "mexopencv.hpp"
+#include "mexopencv_batch.hpp"
 #include "opencv2/imgproc.hpp"
 using namespace std;
 using namespace cv;
 
+namespace {
+/// Batch operation for cv::GaussianBlur
+class GaussianBlurOperation : public BatchOperation
+{
+  public:
+    /// Constructor
+    GaussianBlurOperation(const Size& ksize, double sigmaX, double sigmaY,
+        int borderType)
+    : ksize_(ksize), sigmaX_(sigmaX), sigmaY_(sigmaY), borderType_(borderType)
+    {}
+    virtual void operator()(const Mat& src, Mat& dst) const
+    {
+        GaussianBlur(src, dst, ksize_, sigmaX_, sigmaY_, borderType_);
+    }
+  private:
+    Size ksize_;
+    double sigmaX_;
+    double sigmaY_;
+    int borderType_;
+};
+}
+
 /**
  * Main entry called from Matlab
  * @param nlhs number of left-hand-side arguments
@@ -19,6 +42,8 @@ using namespace cv;
  */
 void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 {
+    ProfileCall prof;
+
     // Check the number of arguments
     nargchk(nrhs>=1 && (nrhs%2)==1 && nlhs<=1);
 
@@ -46,7 +71,15 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     }
 
     // Process
+    prof.phase(Profiler::KERNEL);
+    if (isBatch(rhs[0])) {
+        // cell array or HxWxCxN stack of images, processed in parallel
+        plhs[0] = processBatch(rhs[0],
+            GaussianBlurOperation(ksize, sigmaX, sigmaY, borderType));
+        return;
+    }
     Mat src(rhs[0].toMat()), dst;
     GaussianBlur(src, dst, ksize, sigmaX, sigmaY, borderType);
+    prof.phase(Profiler::OUTPUT);
     plhs[0] = MxArray(dst);
 }
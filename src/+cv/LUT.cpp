@@ -25,6 +25,16 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     vector<MxArray> rhs(prhs, prhs+nrhs);
 
     // Process
+    if ((rhs[0].isUint8() || rhs[0].isInt8()) &&
+        isElementwiseView(rhs[0]) && isElementwiseView(rhs[1])) {
+        // zero-copy: look up directly into the output MATLAB array
+        MxArray out(MxArray::Numeric(
+            rhs[0].rows(), rhs[0].cols(), rhs[1].classID()));
+        Mat dst(out.toMatView());
+        LUT(rhs[0].toMatView(), rhs[1].toMatView(), dst);
+        plhs[0] = out;
+        return;
+    }
     Mat src(rhs[0].toMat(rhs[0].isInt8() ? CV_8S : CV_8U)),
         lut(rhs[1].toMat()),
         dst;
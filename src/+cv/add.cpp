@@ -42,6 +42,16 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     }
 
     // Process
+    if (mask.empty() && dst.empty() && isElementwiseView(rhs[0], rhs[1]) &&
+        (dtype < 0 || dtype == DepthOf[rhs[0].classID()])) {
+        // zero-copy: compute directly into the output MATLAB array
+        MxArray out(MxArray::Numeric(
+            rhs[0].rows(), rhs[0].cols(), rhs[0].classID()));
+        dst = out.toMatView();
+        add(rhs[0].toMatView(), rhs[1].toMatView(), dst);
+        plhs[0] = out;
+        return;
+    }
     Mat src1(rhs[0].toMat()),
         src2(rhs[1].toMat());
     add(src1, src2, dst, mask, dtype);
@@ -38,6 +38,15 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     }
 
     // Process
+    if (mask.empty() && dst.empty() && isElementwiseView(rhs[0])) {
+        // zero-copy: compute directly into the output MATLAB array
+        MxArray out(MxArray::Numeric(
+            rhs[0].rows(), rhs[0].cols(), rhs[0].classID()));
+        dst = out.toMatView();
+        bitwise_not(rhs[0].toMatView(), dst);
+        plhs[0] = out;
+        return;
+    }
     Mat src(rhs[0].toMat());
     bitwise_not(src, dst, mask);
     plhs[0] = MxArray(dst);
@@ -6,10 +6,31 @@
  * @date 2011
  */
 #include "mexopencv.hpp"
+#include "mexopencv_batch.hpp"
 #include "opencv2/imgproc.hpp"
 using namespace std;
 using namespace cv;
 
+namespace {
+/// Batch operation for cv::blur
+class BlurOperation : public BatchOperation
+{
+  public:
+    /// Constructor
+    BlurOperation(const Size& ksize, const Point& anchor, int borderType)
+    : ksize_(ksize), anchor_(anchor), borderType_(borderType)
+    {}
+    virtual void operator()(const Mat& src, Mat& dst) const
+    {
+        blur(src, dst, ksize_, anchor_, borderType_);
+    }
+  private:
+    Size ksize_;
+    Point anchor_;
+    int borderType_;
+};
+}
+
 /**
  * Main entry called from Matlab
  * @param nlhs number of left-hand-side arguments
@@ -19,6 +40,8 @@ using namespace cv;
  */
 void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 {
+    ProfileCall prof;
+
     // Check the number of arguments
     nargchk(nrhs>=1 && (nrhs%2)==1 && nlhs<=1);
 
@@ -43,7 +66,15 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     }
 
     // Process
+    prof.phase(Profiler::KERNEL);
+    if (isBatch(rhs[0])) {
+        // cell array or HxWxCxN stack of images, processed in parallel
+        plhs[0] = processBatch(rhs[0],
+            BlurOperation(ksize, anchor, borderType));
+        return;
+    }
     Mat src(rhs[0].toMat()), dst;
     blur(src, dst, ksize, anchor, borderType);
+    prof.phase(Profiler::OUTPUT);
     plhs[0] = MxArray(dst);
 }
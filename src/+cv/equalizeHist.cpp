@@ -6,10 +6,23 @@
  * @date 2012
  */
 #include "mexopencv.hpp"
+#include "mexopencv_batch.hpp"
 #include "opencv2/imgproc.hpp"
 using namespace std;
 using namespace cv;
 
+namespace {
+/// Batch operation for cv::equalizeHist
+class EqualizeHistOperation : public BatchOperation
+{
+  public:
+    virtual void operator()(const Mat& src, Mat& dst) const
+    {
+        equalizeHist(src, dst);
+    }
+};
+}
+
 /**
  * Main entry called from Matlab
  * @param nlhs number of left-hand-side arguments
@@ -26,6 +39,11 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     vector<MxArray> rhs(prhs, prhs+nrhs);
 
     // Process
+    if (isBatch(rhs[0])) {
+        // cell array or HxWxCxN stack of images, processed in parallel
+        plhs[0] = processBatch(rhs[0], EqualizeHistOperation(), CV_8U);
+        return;
+    }
     Mat src(rhs[0].toMat(CV_8U)), dst;
     equalizeHist(src, dst);
     plhs[0] = MxArray(dst);
@@ -27,6 +27,11 @@ const ConstMap<string,int> ContourType = ConstMap<string,int>
     ("Simple",    cv::CHAIN_APPROX_SIMPLE)
     ("TC89_L1",   cv::CHAIN_APPROX_TC89_L1)
     ("TC89_KCOS", cv::CHAIN_APPROX_TC89_KCOS);
+
+/// Output formats for option processing (true for packed)
+const ConstMap<string,bool> OutputFormatMap = ConstMap<string,bool>
+    ("Cell",   false)
+    ("Packed", true);
 }
 
 /**
@@ -48,6 +53,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     int mode = cv::RETR_LIST;
     int method = cv::CHAIN_APPROX_SIMPLE;
     Point offset;
+    bool packed = false;
     for (int i=1; i<nrhs; i+=2) {
         string key(rhs[i].toString());
         if (key == "Mode")
@@ -56,6 +62,8 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
             method = ContourType[rhs[i+1].toString()];
         else if (key == "Offset")
             offset = rhs[i+1].toPoint();
+        else if (key == "OutputFormat")
+            packed = OutputFormatMap[rhs[i+1].toString()];
         else
             mexErrMsgIdAndTxt("mexopencv:error",
                 "Unrecognized option %s", key.c_str());
@@ -67,7 +75,16 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     vector<Vec4i> hierarchy;
     findContours(image, contours, ((nlhs>1) ? hierarchy : noArray()),
         mode, method, offset);
-    plhs[0] = MxArray(contours);
-    if (nlhs > 1)
-        plhs[1] = MxArray(hierarchy);
+    plhs[0] = (packed) ? toPackedMxArray(contours) : MxArray(contours);
+    if (nlhs > 1) {
+        if (!packed)
+            plhs[1] = MxArray(hierarchy);
+        else if (hierarchy.empty())
+            // keep the Kx4 shape, an empty Mat would give a 0x0 array
+            plhs[1] = MxArray(mxCreateNumericMatrix(0, 4, mxINT32_CLASS,
+                mxREAL));
+        else
+            plhs[1] = MxArray(
+                Mat(hierarchy, false).reshape(1, hierarchy.size()));
+    }
 }
@@ -0,0 +1,63 @@
+/**
+ * @file imdecodeBatch.cpp
+ * @brief mex interface for cv::imdecode on a batch of buffers
+ * @ingroup imgcodecs
+ */
+#include "mexopencv_imgcodecs.hpp"
+using namespace std;
+using namespace cv;
+
+/**
+ * Main entry called from Matlab
+ * @param nlhs number of left-hand-side arguments
+ * @param plhs pointers to mxArrays in the left-hand-side
+ * @param nrhs number of right-hand-side arguments
+ * @param prhs pointers to mxArrays in the right-hand-side
+ */
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+    // Check the number of arguments
+    nargchk(nrhs>=1 && (nrhs%2)==1 && nlhs<=3);
+
+    // Argument vector
+    vector<MxArray> rhs(prhs, prhs+nrhs);
+
+    // Option processing
+    bool stack = false;
+    vector<MxArray> opts;
+    for (int i=1; i<nrhs; i+=2) {
+        if (rhs[i].toString() == "Stack")
+            stack = rhs[i+1].toBool();
+        else {
+            opts.push_back(rhs[i]);
+            opts.push_back(rhs[i+1]);
+        }
+    }
+    bool flip = true;
+    int flags = parseImreadFlags(opts.begin(), opts.end(), flip, false);
+
+    // Process
+    if (!rhs[0].isCell())
+        mexErrMsgIdAndTxt("mexopencv:error",
+            "Buffers must be a cell array of uint8 vectors");
+    const mwSize n = rhs[0].numel();
+    vector<Mat> bufs(n);
+    for (mwIndex i = 0; i < n; ++i) {
+        // uint8 buffers are used in place, others are converted
+        MxArray buf(rhs[0].at<MxArray>(i));
+        if (buf.isUint8())
+            bufs[i] = Mat(1, static_cast<int>(buf.numel()), CV_8U,
+                mxGetData(static_cast<const mxArray*>(buf)));
+        else
+            bufs[i] = buf.toMat(CV_8U);
+    }
+    vector<string> errors;
+    plhs[0] = decodeBatch(vector<string>(), bufs, flags, flip, stack,
+        Size(rhs[0].cols(), rhs[0].rows()), errors);
+    if (nlhs > 1)
+        plhs[1] = MxArray(batchSuccess(errors));
+    else
+        warnBatchErrors(errors);
+    if (nlhs > 2)
+        plhs[2] = MxArray(errors);
+}
@@ -0,0 +1,50 @@
+/**
+ * @file imencodeBatch.cpp
+ * @brief mex interface for cv::imencode on a batch of images
+ * @ingroup imgcodecs
+ */
+#include "mexopencv_imgcodecs.hpp"
+using namespace std;
+using namespace cv;
+
+/**
+ * Main entry called from Matlab
+ * @param nlhs number of left-hand-side arguments
+ * @param plhs pointers to mxArrays in the left-hand-side
+ * @param nrhs number of right-hand-side arguments
+ * @param prhs pointers to mxArrays in the right-hand-side
+ */
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+    // Check the number of arguments
+    nargchk(nrhs>=2 && (nrhs%2)==0 && nlhs<=3);
+
+    // Argument vector
+    vector<MxArray> rhs(prhs, prhs+nrhs);
+
+    // Option processing
+    bool flip = true;
+    vector<int> params(parseImwriteParams(rhs.begin() + 2, rhs.end(), flip));
+
+    // Process
+    string ext(rhs[0].toString());
+    vector<BatchImage> images(batchImages(rhs[1]));
+    vector<vector<uchar> > bufs;
+    vector<string> errors;
+    encodeBatch(images, vector<string>(), ext, params, flip, bufs, errors);
+    MxArray cell(rhs[1].isCell() ?
+        MxArray::Cell(rhs[1].rows(), rhs[1].cols()) :
+        MxArray::Cell(1, static_cast<int>(images.size())));
+    for (size_t i = 0; i < bufs.size(); ++i) {
+        if (errors[i].empty())
+            cell.set(i, MxArray(Mat(bufs[i]), mxUINT8_CLASS, false));
+        vector<uchar>().swap(bufs[i]);
+    }
+    plhs[0] = cell;
+    if (nlhs > 1)
+        plhs[1] = MxArray(batchSuccess(errors));
+    else
+        warnBatchErrors(errors);
+    if (nlhs > 2)
+        plhs[2] = MxArray(errors);
+}
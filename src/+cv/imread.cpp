@@ -5,8 +5,7 @@
  * @author Kota Yamaguchi
  * @date 2012
  */
-#include "mexopencv.hpp"
-#include "opencv2/imgcodecs.hpp"
+#include "mexopencv_imgcodecs.hpp"
 using namespace std;
 using namespace cv;
 
@@ -26,85 +25,8 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     vector<MxArray> rhs(prhs, prhs + nrhs);
 
     // Option processing
-    bool unchanged = false,
-         anydepth = false,
-         anycolor = false,
-         color = true,
-         gdal = false,
-         norotate = false;
-    int scale_denom = 1;
-    int flags = 0;
-    bool override = false;
     bool flip = true;
-    for (int i=1; i<nrhs; i+=2) {
-        string key(rhs[i].toString());
-        if (key == "Flags") {
-            flags = rhs[i+1].toInt();
-            override = true;
-        }
-        else if (key == "Unchanged")
-            unchanged = rhs[i+1].toBool();
-        else if (key == "AnyDepth")
-            anydepth = rhs[i+1].toBool();
-        else if (key == "AnyColor")
-            anycolor = rhs[i+1].toBool();
-        else if (key == "Grayscale") {
-            color = !rhs[i+1].toBool();
-            anycolor = false;
-        }
-        else if (key == "Color") {
-            color = rhs[i+1].toBool();
-            anycolor = false;
-        }
-        else if (key == "GDAL")
-            gdal = rhs[i+1].toBool();
-        else if (key == "ReduceScale") {
-            scale_denom = rhs[i+1].toInt();
-            CV_Assert(scale_denom==1 || scale_denom==2 ||
-                scale_denom==4 || scale_denom==8);
-        }
-        else if (key == "IgnoreOrientation")
-            norotate = rhs[i+1].toBool();
-        else if (key == "FlipChannels")
-            flip = rhs[i+1].toBool();
-        else
-            mexErrMsgIdAndTxt("mexopencv:error",
-                "Unrecognized option %s", key.c_str());
-    }
-
-    // build flag value from options
-    if (!override) {
-        if (unchanged) {
-            // depth and cn as is (as determined by decoder).
-            // This is the only way to load alpha channel if present
-            flags = cv::IMREAD_UNCHANGED;
-        }
-        else if (gdal) {
-            // use GDAL as decoder
-            flags = cv::IMREAD_LOAD_GDAL;
-        }
-        else {
-            // depth as is, otherwise CV_8U
-            flags |= (anydepth ? cv::IMREAD_ANYDEPTH : 0);
-            // channels as is (if gray then cn=1, else cn=3 [BGR])
-            flags |= (anycolor ? cv::IMREAD_ANYCOLOR :
-                // otherwise explicitly either cn = 3 or cn = 1
-                (color ? cv::IMREAD_COLOR : cv::IMREAD_GRAYSCALE));
-
-            // image size reduction (this applies to both grayscale/color)
-            if (scale_denom > 1) {
-                if (scale_denom == 2)
-                    flags |= cv::IMREAD_REDUCED_GRAYSCALE_2;
-                else if (scale_denom == 4)
-                    flags |= cv::IMREAD_REDUCED_GRAYSCALE_4;
-                else if (scale_denom == 8)
-                    flags |= cv::IMREAD_REDUCED_GRAYSCALE_8;
-            }
-
-            // EXIF orientation
-            flags |= (norotate ? cv::IMREAD_IGNORE_ORIENTATION : 0);
-        }
-    }
+    int flags = parseImreadFlags(rhs.begin() + 1, rhs.end(), flip);
 
     // Process
     string filename(rhs[0].toString());
@@ -0,0 +1,53 @@
+/**
+ * @file imreadBatch.cpp
+ * @brief mex interface for cv::imread on a batch of files
+ * @ingroup imgcodecs
+ */
+#include "mexopencv_imgcodecs.hpp"
+using namespace std;
+using namespace cv;
+
+/**
+ * Main entry called from Matlab
+ * @param nlhs number of left-hand-side arguments
+ * @param plhs pointers to mxArrays in the left-hand-side
+ * @param nrhs number of right-hand-side arguments
+ * @param prhs pointers to mxArrays in the right-hand-side
+ */
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+    // Check the number of arguments
+    nargchk(nrhs>=1 && (nrhs%2)==1 && nlhs<=3);
+
+    // Argument vector
+    vector<MxArray> rhs(prhs, prhs + nrhs);
+
+    // Option processing
+    bool stack = false;
+    vector<MxArray> opts;
+    for (int i=1; i<nrhs; i+=2) {
+        if (rhs[i].toString() == "Stack")
+            stack = rhs[i+1].toBool();
+        else {
+            opts.push_back(rhs[i]);
+            opts.push_back(rhs[i+1]);
+        }
+    }
+    bool flip = true;
+    int flags = parseImreadFlags(opts.begin(), opts.end(), flip);
+
+    // Process
+    if (!rhs[0].isCell())
+        mexErrMsgIdAndTxt("mexopencv:error",
+            "Filenames must be a cell array of strings");
+    vector<string> filenames(rhs[0].toVector<string>());
+    vector<string> errors;
+    plhs[0] = decodeBatch(filenames, vector<Mat>(), flags, flip, stack,
+        Size(rhs[0].cols(), rhs[0].rows()), errors);
+    if (nlhs > 1)
+        plhs[1] = MxArray(batchSuccess(errors));
+    else
+        warnBatchErrors(errors);
+    if (nlhs > 2)
+        plhs[2] = MxArray(errors);
+}
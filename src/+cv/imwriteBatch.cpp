@@ -0,0 +1,47 @@
+/**
+ * @file imwriteBatch.cpp
+ * @brief mex interface for cv::imwrite on a batch of images
+ * @ingroup imgcodecs
+ */
+#include "mexopencv_imgcodecs.hpp"
+using namespace std;
+using namespace cv;
+
+/**
+ * Main entry called from Matlab
+ * @param nlhs number of left-hand-side arguments
+ * @param plhs pointers to mxArrays in the left-hand-side
+ * @param nrhs number of right-hand-side arguments
+ * @param prhs pointers to mxArrays in the right-hand-side
+ */
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+    // Check the number of arguments
+    nargchk(nrhs>=2 && (nrhs%2)==0 && nlhs<=2);
+
+    // Argument vector
+    vector<MxArray> rhs(prhs, prhs+nrhs);
+
+    // Option processing
+    bool flip = true;
+    vector<int> params(parseImwriteParams(rhs.begin() + 2, rhs.end(), flip));
+
+    // Process
+    if (!rhs[0].isCell())
+        mexErrMsgIdAndTxt("mexopencv:error",
+            "Filenames must be a cell array of strings");
+    vector<string> filenames(rhs[0].toVector<string>());
+    vector<BatchImage> images(batchImages(rhs[1]));
+    if (filenames.size() != images.size())
+        mexErrMsgIdAndTxt("mexopencv:error",
+            "Number of filenames and images must match");
+    vector<vector<uchar> > bufs;
+    vector<string> errors;
+    encodeBatch(images, filenames, string(), params, flip, bufs, errors);
+    if (nlhs > 0)
+        plhs[0] = MxArray(batchSuccess(errors));
+    else
+        warnBatchErrors(errors);
+    if (nlhs > 1)
+        plhs[1] = MxArray(errors);
+}
@@ -6,10 +6,27 @@
  * @date 2011
  */
 #include "mexopencv.hpp"
+#include "mexopencv_batch.hpp"
 #include "opencv2/imgproc.hpp"
 using namespace std;
 using namespace cv;
 
+namespace {
+/// Batch operation for cv::medianBlur
+class MedianBlurOperation : public BatchOperation
+{
+  public:
+    /// Constructor
+    explicit MedianBlurOperation(int ksize) : ksize_(ksize) {}
+    virtual void operator()(const Mat& src, Mat& dst) const
+    {
+        medianBlur(src, dst, ksize_);
+    }
+  private:
+    int ksize_;
+};
+}
+
 /**
  * Main entry called from Matlab
  * @param nlhs number of left-hand-side arguments
@@ -19,6 +36,8 @@ using namespace cv;
  */
 void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 {
+    ProfileCall prof;
+
     // Check the number of arguments
     nargchk(nrhs>=1 && (nrhs%2)==1 && nlhs<=1);
 
@@ -37,7 +56,14 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     }
 
     // Process
+    prof.phase(Profiler::KERNEL);
+    if (isBatch(rhs[0])) {
+        // cell array or HxWxCxN stack of images, processed in parallel
+        plhs[0] = processBatch(rhs[0], MedianBlurOperation(ksize));
+        return;
+    }
     Mat src(rhs[0].toMat()), dst;
     medianBlur(src, dst, ksize);
+    prof.phase(Profiler::OUTPUT);
     plhs[0] = MxArray(dst);
 }
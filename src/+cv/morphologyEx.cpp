@@ -5,24 +5,10 @@
  * @author Kota Yamaguchi
  * @date 2011
  */
-#include "mexopencv.hpp"
-#include "opencv2/imgproc.hpp"
+#include "mexopencv_imgproc.hpp"
 using namespace std;
 using namespace cv;
 
-namespace {
-/// Type map for morphological operation for option processing
-const ConstMap<string,int> MorphType = ConstMap<string,int>
-    ("Erode",    cv::MORPH_ERODE)
-    ("Dilate",   cv::MORPH_DILATE)
-    ("Open",     cv::MORPH_OPEN)
-    ("Close",    cv::MORPH_CLOSE)
-    ("Gradient", cv::MORPH_GRADIENT)
-    ("Tophat",   cv::MORPH_TOPHAT)
-    ("Blackhat", cv::MORPH_BLACKHAT)
-    ("HitMiss",  cv::MORPH_HITMISS);
-}
-
 /**
  * Main entry called from Matlab
  * @param nlhs number of left-hand-side arguments
@@ -14,10 +14,8 @@ using namespace cv::ml;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<ANN_MLP> > obj_;
+ObjectRegistry<ANN_MLP> obj_;
 
 /// Option values for ANN_MLP train types
 const ConstMap<string,int> ANN_MLPTrain = ConstMap<string,int>
@@ -68,14 +66,17 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     // Constructor is called. Create a new object from argument
     if (method == "new") {
         nargchk(nrhs==2 && nlhs<=1);
-        obj_[++last_id] = ANN_MLP::create();
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(ANN_MLP::create()));
         mexLock();
         return;
     }
 
+    // Registry queries, e.g. to report leaks
+    if (obj_.query(method, nlhs, plhs))
+        return;
+
     // Big operation switch
-    Ptr<ANN_MLP> obj = obj_[id];
+    Ptr<ANN_MLP> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -14,10 +14,8 @@ using namespace cv;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<BOWImgDescriptorExtractor> > obj_;
+ObjectRegistry<BOWImgDescriptorExtractor> obj_;
 }
 
 /**
@@ -65,15 +63,18 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
         }
         else
             mexErrMsgIdAndTxt("mexopencv:error", "Invalid matcher arguments");
-        obj_[++last_id] = makePtr<BOWImgDescriptorExtractor>(
-            extractor, matcher);
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(makePtr<BOWImgDescriptorExtractor>(
+            extractor, matcher)));
         mexLock();
         return;
     }
 
+    // Registry queries, e.g. to report leaks
+    if (obj_.query(method, nlhs, plhs))
+        return;
+
     // Big operation switch
-    Ptr<BOWImgDescriptorExtractor> obj = obj_[id];
+    Ptr<BOWImgDescriptorExtractor> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -11,10 +11,8 @@ using namespace std;
 using namespace cv;
 
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<BOWKMeansTrainer> > obj_;
+ObjectRegistry<BOWKMeansTrainer> obj_;
 
 /// KMeans initalization types
 const ConstMap<string,int> KmeansInitMap = ConstMap<string,int>
@@ -58,15 +56,18 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                 mexErrMsgIdAndTxt("mexopencv:error",
                     "Unrecognized option %s", key.c_str());
         }
-        obj_[++last_id] = makePtr<BOWKMeansTrainer>(
-            clusterCount, criteria, attempts, flags);
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(makePtr<BOWKMeansTrainer>(
+            clusterCount, criteria, attempts, flags)));
         mexLock();
         return;
     }
 
+    // Registry queries, e.g. to report leaks
+    if (obj_.query(method, nlhs, plhs))
+        return;
+
     // Big operation switch
-    Ptr<BOWKMeansTrainer> obj = obj_[id];
+    Ptr<BOWKMeansTrainer> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
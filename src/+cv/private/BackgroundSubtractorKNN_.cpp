@@ -12,10 +12,8 @@ using namespace cv;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<BackgroundSubtractorKNN> > obj_;
+ObjectRegistry<BackgroundSubtractorKNN> obj_;
 }
 
 /**
@@ -53,15 +51,18 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                 mexErrMsgIdAndTxt("mexopencv:error",
                     "Unrecognized option %s", key.c_str());
         }
-        obj_[++last_id] = createBackgroundSubtractorKNN(
-            history, dist2Threshold, detectShadows);
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(createBackgroundSubtractorKNN(
+            history, dist2Threshold, detectShadows)));
         mexLock();
         return;
     }
 
+    // Registry queries, e.g. to report leaks
+    if (obj_.query(method, nlhs, plhs))
+        return;
+
     // Big operation switch
-    Ptr<BackgroundSubtractorKNN> obj = obj_[id];
+    Ptr<BackgroundSubtractorKNN> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -15,10 +15,8 @@ using namespace cv::detail;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<Blender> > obj_;
+ObjectRegistry<Blender> obj_;
 }
 
 /**
@@ -41,9 +39,8 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     // Constructor is called. Create a new object from argument
     if (method == "new") {
         nargchk(nrhs>=3 && nlhs<=1);
-        obj_[++last_id] = createBlender(
-            rhs[2].toString(), rhs.begin() + 3, rhs.end());
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(createBlender(
+            rhs[2].toString(), rhs.begin() + 3, rhs.end())));
         mexLock();
         return;
     }
@@ -137,8 +134,12 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
         return;
     }
 
+    // Registry queries, e.g. to report leaks
+    if (obj_.query(method, nlhs, plhs))
+        return;
+
     // Big operation switch
-    Ptr<Blender> obj = obj_[id];
+    Ptr<Blender> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -12,10 +12,8 @@ using namespace cv;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<CalibrateDebevec> > obj_;
+ObjectRegistry<CalibrateDebevec> obj_;
 
 /** Create an instance of CalibrateDebevec using options in arguments
  * @param first iterator at the beginning of the vector range
@@ -68,15 +66,18 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     // Constructor is called. Create a new object from argument
     if (method == "new") {
         nargchk(nrhs>=2 && nlhs<=1);
-        obj_[++last_id] = create_CalibrateDebevec(
-            rhs.begin() + 2, rhs.end());
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(create_CalibrateDebevec(
+            rhs.begin() + 2, rhs.end())));
         mexLock();
         return;
     }
 
+    // Registry queries, e.g. to report leaks
+    if (obj_.query(method, nlhs, plhs))
+        return;
+
     // Big operation switch
-    Ptr<CalibrateDebevec> obj = obj_[id];
+    Ptr<CalibrateDebevec> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -12,10 +12,8 @@ using namespace cv;
 
 namespace {
 // Persistent objects
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<CascadeClassifier> > obj_;
+ObjectRegistry<CascadeClassifier> obj_;
 
 /// feature types for option processing
 const ConstMap<int,string> FeatureTypeMap = ConstMap<int,string>
@@ -117,8 +115,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     // Constructor call and static methods
     if (method == "new") {
         nargchk(nrhs==2 && nlhs<=1);
-        obj_[++last_id] = makePtr<CascadeClassifier>();
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(makePtr<CascadeClassifier>()));
         mexLock();
         return;
     }
@@ -134,8 +131,12 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
         return;
     }
 
+    // Registry queries, e.g. to report leaks
+    if (obj_.query(method, nlhs, plhs))
+        return;
+
     // Big operation switch
-    Ptr<CascadeClassifier> obj = obj_[id];
+    Ptr<CascadeClassifier> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
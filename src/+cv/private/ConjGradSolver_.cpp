@@ -11,10 +11,8 @@ using namespace cv;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<ConjGradSolver> > obj_;
+ObjectRegistry<ConjGradSolver> obj_;
 
 /// Represents objective function being optimized, implemented as a MATLAB file.
 class MatlabFunction : public cv::MinProblemSolver::Function
@@ -214,14 +212,17 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                 mexErrMsgIdAndTxt("mexopencv:error",
                     "Unrecognized option %s", key.c_str());
         }
-        obj_[++last_id] = ConjGradSolver::create(f, termcrit);
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(ConjGradSolver::create(f, termcrit)));
         mexLock();
         return;
     }
 
+    // Registry queries, e.g. to report leaks
+    if (obj_.query(method, nlhs, plhs))
+        return;
+
     // Big operation switch
-    Ptr<ConjGradSolver> obj = obj_[id];
+    Ptr<ConjGradSolver> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -15,10 +15,8 @@ using namespace cv;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<DescriptorMatcher> > obj_;
+ObjectRegistry<DescriptorMatcher> obj_;
 }
 
 /**
@@ -41,15 +39,18 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     // Constructor is called. Create a new object from argument
     if (method == "new") {
         nargchk(nrhs>=3 && nlhs<=1);
-        obj_[++last_id] = createDescriptorMatcher(
-            rhs[2].toString(), rhs.begin() + 3, rhs.end());
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(createDescriptorMatcher(
+            rhs[2].toString(), rhs.begin() + 3, rhs.end())));
         mexLock();
         return;
     }
 
+    // Registry queries, e.g. to report leaks
+    if (obj_.query(method, nlhs, plhs))
+        return;
+
     // Big operation switch
-    Ptr<DescriptorMatcher> obj = obj_[id];
+    Ptr<DescriptorMatcher> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -136,6 +137,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
         nargchk(nrhs>=3 && nlhs<=1);
         Mat queryDescriptors(rhs[2].toMat(rhs[2].isUint8() ? CV_8U : CV_32F));
         vector<DMatch> matches;
+        bool soa = false;
         if (nrhs>=4 && rhs[3].isNumeric()) {  // first variant
             nargchk((nrhs%2)==0);
             Mat trainDescriptors(rhs[3].toMat(rhs[3].isUint8() ? CV_8U : CV_32F));
@@ -144,6 +146,8 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                 string key(rhs[i].toString());
                 if (key == "Mask")
                     mask = rhs[i+1].toMat(CV_8U);
+                else if (key == "OutputFormat")
+                    soa = OutputFormatSoAMap[rhs[i+1].toString()];
                 else
                     mexErrMsgIdAndTxt("mexopencv:error",
                         "Unrecognized option %s", key.c_str());
@@ -163,18 +167,21 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                     for (vector<MxArray>::const_iterator it = va.begin(); it != va.end(); ++it)
                         masks.push_back(it->toMat(CV_8U));
                 }
+                else if (key == "OutputFormat")
+                    soa = OutputFormatSoAMap[rhs[i+1].toString()];
                 else
                     mexErrMsgIdAndTxt("mexopencv:error",
                         "Unrecognized option %s", key.c_str());
             }
             obj->match(queryDescriptors, matches, masks);
         }
-        plhs[0] = MxArray(matches);
+        plhs[0] = (soa) ? toStructOfArrays(matches) : MxArray(matches);
     }
     else if (method == "knnMatch") {
         nargchk(nrhs>=4 && nlhs<=1);
         Mat queryDescriptors(rhs[2].toMat(rhs[2].isUint8() ? CV_8U : CV_32F));
         vector<vector<DMatch> > matches;
+        bool soa = false;
         if (nrhs>=5 && rhs[3].isNumeric() && rhs[4].isNumeric()) {  // first variant
             nargchk((nrhs%2)==1);
             Mat trainDescriptors(rhs[3].toMat(rhs[3].isUint8() ? CV_8U : CV_32F));
@@ -187,6 +194,8 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                     mask = rhs[i+1].toMat(CV_8U);
                 else if (key == "CompactResult")
                     compactResult = rhs[i+1].toBool();
+                else if (key == "OutputFormat")
+                    soa = OutputFormatSoAMap[rhs[i+1].toString()];
                 else
                     mexErrMsgIdAndTxt("mexopencv:error",
                         "Unrecognized option %s", key.c_str());
@@ -211,18 +220,21 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                 }
                 else if (key == "CompactResult")
                     compactResult = rhs[i+1].toBool();
+                else if (key == "OutputFormat")
+                    soa = OutputFormatSoAMap[rhs[i+1].toString()];
                 else
                     mexErrMsgIdAndTxt("mexopencv:error",
                         "Unrecognized option %s", key.c_str());
             }
             obj->knnMatch(queryDescriptors, matches, k, masks, compactResult);
         }
-        plhs[0] = MxArray(matches);
+        plhs[0] = (soa) ? toStructOfArrays(matches) : MxArray(matches);
     }
     else if (method == "radiusMatch") {
         nargchk(nrhs>=4 && nlhs<=1);
         Mat queryDescriptors(rhs[2].toMat(rhs[2].isUint8() ? CV_8U : CV_32F));
         vector<vector<DMatch> > matches;
+        bool soa = false;
         if (nrhs>=5 && rhs[3].isNumeric() && rhs[4].isNumeric()) {  // first variant
             nargchk((nrhs%2)==1);
             Mat trainDescriptors(rhs[3].toMat(rhs[3].isUint8() ? CV_8U : CV_32F));
@@ -235,6 +247,8 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                     mask = rhs[i+1].toMat(CV_8U);
                 else if (key == "CompactResult")
                     compactResult = rhs[i+1].toBool();
+                else if (key == "OutputFormat")
+                    soa = OutputFormatSoAMap[rhs[i+1].toString()];
                 else
                     mexErrMsgIdAndTxt("mexopencv:error",
                         "Unrecognized option %s", key.c_str());
@@ -259,6 +273,8 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                 }
                 else if (key == "CompactResult")
                     compactResult = rhs[i+1].toBool();
+                else if (key == "OutputFormat")
+                    soa = OutputFormatSoAMap[rhs[i+1].toString()];
                 else
                     mexErrMsgIdAndTxt("mexopencv:error",
                         "Unrecognized option %s", key.c_str());
@@ -266,7 +282,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
             obj->radiusMatch(queryDescriptors, matches,
                 maxDistance, masks, compactResult);
         }
-        plhs[0] = MxArray(matches);
+        plhs[0] = (soa) ? toStructOfArrays(matches) : MxArray(matches);
     }
     else
         mexErrMsgIdAndTxt("mexopencv:error",
@@ -19,10 +19,8 @@ using namespace cv;
 
 namespace {
 // Persistent objects
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<DetectionBasedTracker> > obj_;
+ObjectRegistry<DetectionBasedTracker> obj_;
 
 /// extended object status inverse map for option processing
 const ConstMap<int,string> ObjectStatusInvMap = ConstMap<int,string>
@@ -191,15 +189,18 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
             mexErrMsgIdAndTxt("mexopencv:error", "Failed to create IDetector");
         DetectionBasedTracker::Parameters params = createParameters(
             rhs.begin() + 4, rhs.end());
-        obj_[++last_id] = makePtr<DetectionBasedTracker>(
-            mainDetector, trackingDetector, params);
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(makePtr<DetectionBasedTracker>(
+            mainDetector, trackingDetector, params)));
         mexLock();
         return;
     }
 
+    // Registry queries, e.g. to report leaks
+    if (obj_.query(method, nlhs, plhs))
+        return;
+
     // Big operation switch
-    Ptr<DetectionBasedTracker> obj = obj_[id];
+    Ptr<DetectionBasedTracker> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -11,10 +11,8 @@ using namespace cv;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<DownhillSolver> > obj_;
+ObjectRegistry<DownhillSolver> obj_;
 
 /// Represents objective function being optimized, implemented as a MATLAB file.
 class MatlabFunction : public cv::MinProblemSolver::Function
@@ -148,14 +146,18 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                 mexErrMsgIdAndTxt("mexopencv:error",
                     "Unrecognized option %s", key.c_str());
         }
-        obj_[++last_id] = DownhillSolver::create(f, initStep, termcrit);
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(DownhillSolver::create(
+            f, initStep, termcrit)));
         mexLock();
         return;
     }
 
+    // Registry queries, e.g. to report leaks
+    if (obj_.query(method, nlhs, plhs))
+        return;
+
     // Big operation switch
-    Ptr<DownhillSolver> obj = obj_[id];
+    Ptr<DownhillSolver> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
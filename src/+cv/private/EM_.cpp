@@ -14,10 +14,8 @@ using namespace cv::ml;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<EM> > obj_;
+ObjectRegistry<EM> obj_;
 
 /// CovMatType map for option processing
 const ConstMap<string, int> CovMatType = ConstMap<string, int>
@@ -54,14 +52,17 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     // Constructor is called. Create a new object from argument
     if (method == "new") {
         nargchk(nrhs==2 && nlhs<=1);
-        obj_[++last_id] = EM::create();
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(EM::create()));
         mexLock();
         return;
     }
 
+    // Registry queries, e.g. to report leaks
+    if (obj_.query(method, nlhs, plhs))
+        return;
+
     // Big operation switch
-    Ptr<EM> obj = obj_[id];
+    Ptr<EM> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -0,0 +1,155 @@
+/**
+ * @file FileStorageStream_.cpp
+ * @brief mex interface for cv.FileStorageStream, incremental file storage
+ * @ingroup core
+ */
+#include "mexopencv_persistence.hpp"
+using namespace std;
+using namespace cv;
+
+namespace {
+// Persistent objects
+/// Object container
+ObjectRegistry<FileStorage> obj_;
+
+/// File storage modes for option processing
+const ConstMap<string,int> FileStorageMode = ConstMap<string,int>
+    ("r", FileStorage::READ)
+    ("w", FileStorage::WRITE)
+    ("a", FileStorage::APPEND);
+
+/** Find a node from its path
+ * @param fs FileStorage object opened for reading.
+ * @param first iterator at the first path element.
+ * @param last iterator past the last path element.
+ * @return node, the first top-level node if the path is empty.
+ *
+ * Path elements are either a name of a map element, or a 1-based index of
+ * a sequence element. A single argument may also be a cell array holding
+ * the whole path.
+ */
+FileNode findNode(const FileStorage& fs,
+    vector<MxArray>::const_iterator first,
+    vector<MxArray>::const_iterator last)
+{
+    if (std::distance(first, last) == 1 && first->isCell()) {
+        vector<MxArray> path(first->toVector<MxArray>());
+        return findNode(fs, path.begin(), path.end());
+    }
+    FileNode node(fs.root());
+    for (; first != last; ++first) {
+        if (first->isChar()) {
+            if (!node.isMap())
+                mexErrMsgIdAndTxt("mexopencv:error", "Node is not a map");
+            node = node[first->toString()];
+        }
+        else {
+            const int idx = first->toInt() - 1;
+            if (!node.isSeq() || idx < 0 ||
+                idx >= static_cast<int>(node.size()))
+                mexErrMsgIdAndTxt("mexopencv:error",
+                    "Invalid sequence index %d", idx + 1);
+            node = node[idx];
+        }
+        if (node.empty())
+            mexErrMsgIdAndTxt("mexopencv:error", "Node not found");
+    }
+    return node;
+}
+}
+
+/**
+ * Main entry called from Matlab
+ * @param nlhs number of left-hand-side arguments
+ * @param plhs pointers to mxArrays in the left-hand-side
+ * @param nrhs number of right-hand-side arguments
+ * @param prhs pointers to mxArrays in the right-hand-side
+ */
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+    // Check the number of arguments
+    nargchk(nrhs>=2 && nlhs<=1);
+
+    // Argument vector
+    vector<MxArray> rhs(prhs, prhs+nrhs);
+    int id = rhs[0].toInt();
+    string method(rhs[1].toString());
+
+    // Constructor is called. Create a new object from argument
+    if (method == "new") {
+        nargchk(nrhs>=4 && (nrhs%2)==0 && nlhs<=1);
+        int flags = FileStorageMode[rhs[3].toString()];
+        for (int i=4; i<nrhs; i+=2) {
+            string key(rhs[i].toString());
+            if (key == "Memory")
+                UPDATE_FLAG(flags, rhs[i+1].toBool(), FileStorage::MEMORY);
+            else if (key == "Base64")
+                UPDATE_FLAG(flags, rhs[i+1].toBool(), FileStorage::BASE64);
+            else
+                mexErrMsgIdAndTxt("mexopencv:error",
+                    "Unrecognized option %s", key.c_str());
+        }
+        Ptr<FileStorage> obj = makePtr<FileStorage>(rhs[2].toString(), flags);
+        if (!obj->isOpened())
+            mexErrMsgIdAndTxt("mexopencv:error", "Failed to open file");
+        plhs[0] = MxArray(obj_.add(obj));
+        mexLock();
+        return;
+    }
+
+    // Registry queries, e.g. to report leaks
+    if (obj_.query(method, nlhs, plhs))
+        return;
+
+    // Big operation switch
+    Ptr<FileStorage> obj = obj_.get(id);
+    if (obj.empty())
+        mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
+    if (method == "delete") {
+        nargchk(nrhs==2 && nlhs==0);
+        obj_.erase(id);
+        mexUnlock();
+        return;
+    }
+    if (!obj->isOpened())
+        mexErrMsgIdAndTxt("mexopencv:error", "File storage was released");
+    if (method == "release") {
+        nargchk(nrhs==2 && nlhs<=1);
+        // memory storages opened for writing return their content
+        string str(obj->releaseAndGetString());
+        if (nlhs > 0)
+            plhs[0] = MxArray(str);
+    }
+    else if (method == "keys") {
+        nargchk(nrhs>=2 && nlhs<=1);
+        FileNode node(findNode(*obj, rhs.begin()+2, rhs.end()));
+        vector<string> names;
+        if (node.isMap())
+            for (FileNodeIterator it = node.begin(); it != node.end(); ++it)
+                names.push_back((*it).name());
+        plhs[0] = MxArray(names);
+    }
+    else if (method == "type") {
+        nargchk(nrhs>=2 && nlhs<=1);
+        plhs[0] = MxArray(nodeTypeName(
+            findNode(*obj, rhs.begin()+2, rhs.end())));
+    }
+    else if (method == "count") {
+        nargchk(nrhs>=2 && nlhs<=1);
+        FileNode node(findNode(*obj, rhs.begin()+2, rhs.end()));
+        plhs[0] = MxArray(static_cast<int>(node.size()));
+    }
+    else if (method == "read") {
+        nargchk(nrhs>=2 && nlhs<=1);
+        plhs[0] = readNode(findNode(*obj, rhs.begin()+2, rhs.end()));
+    }
+    else if (method == "write") {
+        nargchk(nrhs==4 && nlhs==0);
+        // each call appends a top-level node, written out immediately
+        (*obj) << rhs[2].toString();
+        writeNode(*obj, rhs[3]);
+    }
+    else
+        mexErrMsgIdAndTxt("mexopencv:error",
+            "Unrecognized operation %s", method.c_str());
+}
@@ -12,10 +12,8 @@ using namespace cv;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<GeneralizedHoughBallard> > obj_;
+ObjectRegistry<GeneralizedHoughBallard> obj_;
 }
 
 /**
@@ -38,14 +36,17 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     // Constructor is called. Create a new object from argument
     if (method == "new") {
         nargchk(nrhs==2 && nlhs<=1);
-        obj_[++last_id] = createGeneralizedHoughBallard();
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(createGeneralizedHoughBallard()));
         mexLock();
         return;
     }
 
+    // Registry queries, e.g. to report leaks
+    if (obj_.query(method, nlhs, plhs))
+        return;
+
     // Big operation switch
-    Ptr<GeneralizedHoughBallard> obj = obj_[id];
+    Ptr<GeneralizedHoughBallard> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
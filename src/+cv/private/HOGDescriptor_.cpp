@@ -11,10 +11,8 @@ using namespace std;
 using namespace cv;
 
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<HOGDescriptor> > obj_;
+ObjectRegistry<HOGDescriptor> obj_;
 
 /// HistogramNormType map
 const ConstMap<string,int> HistogramNormType = ConstMap<string,int>
@@ -140,17 +138,20 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                 mexErrMsgIdAndTxt("mexopencv:error",
                     "Unknown option %s",key.c_str());
         }
-        obj_[++last_id] = makePtr<HOGDescriptor>(
+        plhs[0] = MxArray(obj_.add(makePtr<HOGDescriptor>(
             winSize, blockSize, blockStride, cellSize, nbins, derivAperture,
             winSigma, histogramNormType, L2HysThreshold, gammaCorrection,
-            nlevels, signedGradient);
-        plhs[0] = MxArray(last_id);
+            nlevels, signedGradient)));
         mexLock();
         return;
     }
 
+    // Registry queries, e.g. to report leaks
+    if (obj_.query(method, nlhs, plhs))
+        return;
+
     // Big operation switch
-    Ptr<HOGDescriptor> obj = obj_[id];
+    Ptr<HOGDescriptor> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -0,0 +1,578 @@
+/**
+ * @file ImageReader_.cpp
+ * @brief mex interface for cv.ImageReader, tiled reading of huge images
+ * @ingroup imgcodecs
+ */
+#include "mexopencv_imgcodecs.hpp"
+#include <list>
+using namespace std;
+using namespace cv;
+
+namespace {
+/// Default size of tiles, unless the file is organized in tiles
+const int DEFAULT_TILE = 256;
+
+/// Default amount of memory in bytes the tile cache may take
+const size_t DEFAULT_CACHE_BYTES = 256 * 1024 * 1024;
+
+/// Key of a cached tile or block
+struct TileKey
+{
+    /// pyramid level, negated minus one for blocks of the source
+    int level;
+    /// column index
+    int x;
+    /// row index
+    int y;
+    /// Order of keys
+    bool operator<(const TileKey& o) const
+    {
+        return (level != o.level) ? (level < o.level) :
+            ((y != o.y) ? (y < o.y) : (x < o.x));
+    }
+};
+
+/// Least recently used cache of tiles, bounded in memory
+class TileCache
+{
+  public:
+    /// Constructor
+    explicit TileCache(size_t capacity) : capacity_(capacity), usage_(0) {}
+    /** Look up a tile.
+     * @param key tile key.
+     * @param tile receives the tile if found.
+     * @return whether the tile was found.
+     */
+    bool get(const TileKey& key, Mat& tile)
+    {
+        std::map<TileKey, List::iterator>::iterator it = index_.find(key);
+        if (it == index_.end())
+            return false;
+        // most recently used first
+        items_.splice(items_.begin(), items_, it->second);
+        tile = it->second->second;
+        return true;
+    }
+    /** Insert a tile, evicting the least recently used ones over capacity.
+     * @param key tile key.
+     * @param tile tile data, shared with the caller.
+     */
+    void put(const TileKey& key, const Mat& tile)
+    {
+        std::map<TileKey, List::iterator>::iterator it = index_.find(key);
+        if (it != index_.end()) {
+            usage_ -= bytes(it->second->second);
+            items_.erase(it->second);
+            index_.erase(it);
+        }
+        items_.push_front(std::make_pair(key, tile));
+        index_[key] = items_.begin();
+        usage_ += bytes(tile);
+        evict();
+    }
+    /// Remove all tiles
+    void clear()
+    {
+        items_.clear();
+        index_.clear();
+        usage_ = 0;
+    }
+    /// Maximum amount of memory in bytes
+    size_t capacity() const { return capacity_; }
+    /// Change the maximum amount of memory in bytes
+    void setCapacity(size_t capacity)
+    {
+        capacity_ = capacity;
+        evict();
+    }
+    /// Amount of memory in bytes taken by cached tiles
+    size_t usage() const { return usage_; }
+  private:
+    typedef std::list<std::pair<TileKey, Mat> > List;
+    /// Size of a tile in bytes
+    static size_t bytes(const Mat& m) { return m.total() * m.elemSize(); }
+    /// Drop least recently used tiles until within capacity
+    void evict()
+    {
+        while (usage_ > capacity_ && !items_.empty()) {
+            usage_ -= bytes(items_.back().second);
+            index_.erase(items_.back().first);
+            items_.pop_back();
+        }
+    }
+    /// tiles, most recently used first
+    List items_;
+    /// position of each tile in the list
+    std::map<TileKey, List::iterator> index_;
+    /// maximum amount of memory in bytes
+    size_t capacity_;
+    /// amount of memory in bytes taken by tiles
+    size_t usage_;
+};
+
+/// Source of image data, decoded by blocks
+class BlockSource
+{
+  public:
+    /// Destructor
+    virtual ~BlockSource() {}
+    /// Size of the image
+    virtual Size size() const = 0;
+    /// Size of a block, blocks on the right and bottom edges may be smaller
+    virtual Size blockSize() const = 0;
+    /// Decode a block given its column and row indices
+    virtual Mat block(int bx, int by) = 0;
+    /// Description of the access granularity
+    virtual string layout() const = 0;
+};
+
+/// Blocks of the first page of a TIFF file, decoded one by one
+class TiffBlocks : public BlockSource
+{
+  public:
+    /// Constructor
+    TiffBlocks(const string& filename, int flags)
+    : tif_(filename), dir_(tif_.directory(0)), flags_(flags), bandRows_(0)
+    {}
+    virtual Size size() const { return Size(dir_.width, dir_.height); }
+    virtual Size blockSize() const
+    {
+        return Size(dir_.blockWidth, bandRows_ ? bandRows_ : dir_.blockHeight);
+    }
+    virtual Mat block(int bx, int by)
+    {
+        if (bandRows_ > 0)
+            return tif_.decodeRows(dir_, Range(by*bandRows_,
+                std::min(dir_.height, (by + 1)*bandRows_)), flags_);
+        return tif_.decodeBlock(dir_,
+            static_cast<size_t>(by) * dir_.blocksAcross() + bx, flags_);
+    }
+    virtual string layout() const
+    {
+        return dir_.tiled ? "tiles" : (bandRows_ ? "rows" : "strips");
+    }
+    /// Whether the file is organized in tiles
+    bool tiled() const { return dir_.tiled; }
+    /** Read uncompressed strips by bands of rows.
+     * @param rows number of rows in a band.
+     *
+     * Only used when strips are taller than a band, e.g. images stored in
+     * a single strip.
+     */
+    void setBandRows(int rows)
+    {
+        if (!dir_.tiled && dir_.compression == 1 && dir_.planar == 1 &&
+            dir_.blockHeight > rows)
+            bandRows_ = rows;
+    }
+  private:
+    /// file
+    TiffFile tif_;
+    /// directory of the first page
+    TiffFile::Directory dir_;
+    /// flags of cv::imdecode
+    int flags_;
+    /// number of rows of a band, 0 to read whole strips
+    int bandRows_;
+};
+
+/// Whole image decoded by cv::imread, as a single block
+class ImageBlocks : public BlockSource
+{
+  public:
+    /** Constructor, decodes the image to know its size.
+     * @param filename name of the file.
+     * @param flags flags of cv::imread.
+     * @param sz size the image is resized to, if not empty.
+     */
+    ImageBlocks(const string& filename, int flags, Size sz = Size())
+    : filename_(filename), flags_(flags), size_(sz)
+    {
+        img_ = decode();
+        size_ = img_.size();
+    }
+    virtual Size size() const { return size_; }
+    virtual Size blockSize() const { return size_; }
+    virtual Mat block(int, int)
+    {
+        // the image decoded by the constructor is handed over to the cache,
+        // and decoded again if it was evicted since
+        Mat img;
+        std::swap(img, img_);
+        return img.empty() ? decode() : img;
+    }
+    virtual string layout() const { return "image"; }
+  private:
+    /// Decode the image, resized to size_ if set
+    Mat decode() const
+    {
+        Mat img(imread(filename_, flags_));
+        if (img.empty())
+            mexErrMsgIdAndTxt("mexopencv:error", "imread failed");
+        if (size_.area() > 0 && img.size() != size_)
+            resize(img, img, size_, 0, 0, cv::INTER_AREA);
+        return img;
+    }
+    /// name of the file
+    string filename_;
+    /// flags of cv::imread
+    int flags_;
+    /// size of the image
+    Size size_;
+    /// image decoded but not handed over yet
+    Mat img_;
+};
+
+/// Determine whether a file is a JPEG file from its header
+bool isJpeg(const string& filename)
+{
+    std::ifstream f(filename.c_str(), std::ios::in | std::ios::binary);
+    uchar hdr[2] = {0};
+    f.read(reinterpret_cast<char*>(hdr), sizeof(hdr));
+    return (f && hdr[0] == 0xFF && hdr[1] == 0xD8);
+}
+
+/// Reader of rectangular regions and pyramid levels of an image file
+class ImageReader
+{
+  public:
+    /** Open an image file.
+     * @param filename name of the file.
+     * @param flags flags of cv::imread.
+     * @param tileSize size of tiles, or empty to choose it from the file.
+     * @param cacheBytes capacity of the tile cache in bytes.
+     */
+    ImageReader(const string& filename, int flags, Size tileSize,
+        size_t cacheBytes)
+    : flip(true), cache(cacheBytes), filename_(filename), flags_(flags)
+    {
+        const bool gdal = (flags >= 0 && (flags & cv::IMREAD_LOAD_GDAL));
+        if (!gdal && TiffFile::isTiff(filename)) {
+            Ptr<TiffBlocks> src = makePtr<TiffBlocks>(filename, flags);
+            if (tileSize.area() == 0)
+                tileSize = src->tiled() ? src->blockSize() :
+                    Size(DEFAULT_TILE, DEFAULT_TILE);
+            src->setBandRows(tileSize.height);
+            sources_.push_back(src);
+        }
+        else {
+            sources_.push_back(makePtr<ImageBlocks>(filename, flags));
+            if (tileSize.area() == 0)
+                tileSize = Size(DEFAULT_TILE, DEFAULT_TILE);
+        }
+        if (tileSize.width <= 0 || tileSize.height <= 0)
+            mexErrMsgIdAndTxt("mexopencv:error", "Invalid tile size");
+        tileSize_ = tileSize;
+
+        // JPEG files are decoded at reduced resolution by the codec itself
+        // (by DCT scaling) for the first levels, rather than from the
+        // full resolution image
+        sources_.resize(numLevels());
+        const int mode = flags & ~cv::IMREAD_IGNORE_ORIENTATION;
+        reduced_ = (sources_[0]->layout() == "image" && isJpeg(filename) &&
+            (mode == cv::IMREAD_COLOR || mode == cv::IMREAD_GRAYSCALE));
+    }
+
+    /// Size of tiles
+    Size tileSize() const { return tileSize_; }
+
+    /// Description of the access granularity of the file
+    string layout() const { return sources_[0]->layout(); }
+
+    /** Size of a pyramid level.
+     * @param level pyramid level, 0 for full resolution.
+     * @return size of the image halved (rounded up) \p level times.
+     */
+    Size levelSize(int level) const
+    {
+        Size sz(sources_[0]->size());
+        for (int i = 0; i < level; ++i)
+            sz = Size((sz.width + 1) / 2, (sz.height + 1) / 2);
+        return sz;
+    }
+
+    /// Number of pyramid levels, the last one fitting in a single tile
+    int numLevels() const
+    {
+        int n = 1;
+        for (Size sz(levelSize(0)); sz.width > tileSize_.width ||
+            sz.height > tileSize_.height; ++n)
+            sz = Size((sz.width + 1) / 2, (sz.height + 1) / 2);
+        return n;
+    }
+
+    /** Read a region of a pyramid level.
+     * @param roi region, in coordinates of the level.
+     * @param level pyramid level.
+     * @return copy of the region, with the channels in BGR order.
+     */
+    Mat read(const Rect& roi, int level)
+    {
+        if (level < 0 || level >= numLevels())
+            mexErrMsgIdAndTxt("mexopencv:error", "Invalid level %d", level);
+        const Size ls(levelSize(level));
+        if (roi.area() <= 0 || roi.x < 0 || roi.y < 0 ||
+            roi.x + roi.width > ls.width || roi.y + roi.height > ls.height)
+            mexErrMsgIdAndTxt("mexopencv:error",
+                "Region out of the bounds of the image");
+        const Size& T = tileSize_;
+        Mat out;
+        for (int ty = roi.y / T.height;
+            ty <= (roi.y + roi.height - 1) / T.height; ++ty) {
+            for (int tx = roi.x / T.width;
+                tx <= (roi.x + roi.width - 1) / T.width; ++tx) {
+                Mat t(tile(level, tx, ty));
+                if (out.empty())
+                    out.create(roi.size(), t.type());
+                else if (t.type() != out.type())
+                    mexErrMsgIdAndTxt("mexopencv:error",
+                        "Tiles of different types");
+                const Rect tr(Point(tx*T.width, ty*T.height), t.size());
+                const Rect r(tr & roi);
+                t(r - tr.tl()).copyTo(out(r - roi.tl()));
+            }
+        }
+        return out;
+    }
+
+    /// output channels flipped to RGB order
+    bool flip;
+    /// cache of tiles and source blocks
+    TileCache cache;
+
+  private:
+    /** Get a tile, from the cache or computed.
+     * @param level pyramid level.
+     * @param tx column index of the tile.
+     * @param ty row index of the tile.
+     * @return tile, possibly smaller on the right and bottom edges.
+     *
+     * Tiles of level 0 are assembled from blocks of the file, and tiles of
+     * other levels are computed from the 4 tiles of the previous level they
+     * cover, so that any tile is computed with bounded memory.
+     */
+    Mat tile(int level, int tx, int ty)
+    {
+        const TileKey key = {level, tx, ty};
+        Mat t;
+        if (cache.get(key, t))
+            return t;
+        const Size ls(levelSize(level));
+        const Size& T = tileSize_;
+        const Rect r(tx*T.width, ty*T.height,
+            std::min(T.width, ls.width - tx*T.width),
+            std::min(T.height, ls.height - ty*T.height));
+        Ptr<BlockSource> src(source(level));
+        if (!src.empty())
+            t = region(*src, level, r);
+        else {
+            const Size ps(levelSize(level - 1));
+            const Rect pr(2*r.x, 2*r.y, std::min(2*r.width, ps.width - 2*r.x),
+                std::min(2*r.height, ps.height - 2*r.y));
+            resize(read(pr, level - 1), t, r.size(), 0, 0, cv::INTER_AREA);
+        }
+        cache.put(key, t);
+        return t;
+    }
+
+    /** Source of a pyramid level.
+     * @param level pyramid level.
+     * @return source decoding the level directly, or empty if the level is
+     *    computed from the previous one.
+     */
+    Ptr<BlockSource> source(int level)
+    {
+        if (level > 0 && level <= 3 && reduced_ && sources_[level].empty()) {
+            // combined with IMREAD_COLOR, these are the IMREAD_REDUCED_COLOR
+            const int reduce[] = {0,
+                cv::IMREAD_REDUCED_GRAYSCALE_2,
+                cv::IMREAD_REDUCED_GRAYSCALE_4,
+                cv::IMREAD_REDUCED_GRAYSCALE_8};
+            sources_[level] = makePtr<ImageBlocks>(filename_,
+                flags_ | reduce[level], levelSize(level));
+        }
+        return sources_[level];
+    }
+
+    /** Assemble a region from blocks of a source.
+     * @param src source of the level.
+     * @param level pyramid level.
+     * @param r region in coordinates of the level.
+     * @return region, shared with the cache when it is exactly a block.
+     */
+    Mat region(BlockSource& src, int level, const Rect& r)
+    {
+        const Size bs(src.blockSize());
+        Mat out;
+        for (int by = r.y / bs.height;
+            by <= (r.y + r.height - 1) / bs.height; ++by) {
+            for (int bx = r.x / bs.width;
+                bx <= (r.x + r.width - 1) / bs.width; ++bx) {
+                const Rect br(bx*bs.width, by*bs.height,
+                    std::min(bs.width, src.size().width - bx*bs.width),
+                    std::min(bs.height, src.size().height - by*bs.height));
+                Mat b;
+                if (br == r)
+                    return src.block(bx, by);  // cached as a tile
+                const TileKey key = {-1 - level, bx, by};
+                if (!cache.get(key, b)) {
+                    b = src.block(bx, by);
+                    cache.put(key, b);
+                }
+                if (out.empty())
+                    out.create(r.size(), b.type());
+                else if (b.type() != out.type())
+                    mexErrMsgIdAndTxt("mexopencv:error",
+                        "Blocks of different types");
+                const Rect isect(Rect(br.tl(), b.size()) & r);
+                b(isect - br.tl()).copyTo(out(isect - r.tl()));
+            }
+        }
+        return out;
+    }
+
+    /// name of the file
+    string filename_;
+    /// flags of cv::imread
+    int flags_;
+    /// size of tiles
+    Size tileSize_;
+    /// whether levels 1 to 3 are decoded at reduced resolution
+    bool reduced_;
+    /// source of each level decoded directly, empty for computed ones
+    vector<Ptr<BlockSource> > sources_;
+};
+
+// Persistent objects
+/// Object container
+ObjectRegistry<ImageReader> obj_;
+}
+
+/**
+ * Main entry called from Matlab
+ * @param nlhs number of left-hand-side arguments
+ * @param plhs pointers to mxArrays in the left-hand-side
+ * @param nrhs number of right-hand-side arguments
+ * @param prhs pointers to mxArrays in the right-hand-side
+ */
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+    // Check the number of arguments
+    nargchk(nrhs>=2 && nlhs<=1);
+
+    // Argument vector
+    vector<MxArray> rhs(prhs, prhs+nrhs);
+    int id = rhs[0].toInt();
+    string method(rhs[1].toString());
+
+    // Constructor is called. Create a new object from argument
+    if (method == "new") {
+        nargchk(nrhs>=3 && (nrhs%2)==1 && nlhs<=1);
+        Size tileSize;
+        size_t cacheBytes = DEFAULT_CACHE_BYTES;
+        vector<MxArray> opts;
+        for (int i=3; i<nrhs; i+=2) {
+            string key(rhs[i].toString());
+            if (key == "TileSize")
+                tileSize = rhs[i+1].toSize();
+            else if (key == "CacheSize")
+                cacheBytes = static_cast<size_t>(rhs[i+1].toDouble());
+            else {
+                opts.push_back(rhs[i]);
+                opts.push_back(rhs[i+1]);
+            }
+        }
+        bool flip = true;
+        int flags = parseImreadFlags(opts.begin(), opts.end(), flip);
+        if (flags >= 0 && (flags & (cv::IMREAD_REDUCED_GRAYSCALE_2 |
+            cv::IMREAD_REDUCED_GRAYSCALE_4 | cv::IMREAD_REDUCED_GRAYSCALE_8)))
+            mexErrMsgIdAndTxt("mexopencv:error",
+                "ReduceScale is not supported, read pyramid levels instead");
+        Ptr<ImageReader> obj = makePtr<ImageReader>(rhs[2].toString(), flags,
+            tileSize, cacheBytes);
+        obj->flip = flip;
+        plhs[0] = MxArray(obj_.add(obj));
+        mexLock();
+        return;
+    }
+
+    // Registry queries, e.g. to report leaks
+    if (obj_.query(method, nlhs, plhs))
+        return;
+
+    // Big operation switch
+    Ptr<ImageReader> obj = obj_.get(id);
+    if (obj.empty())
+        mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
+    if (method == "delete") {
+        nargchk(nrhs==2 && nlhs==0);
+        obj_.erase(id);
+        mexUnlock();
+    }
+    else if (method == "read") {
+        // optional region, followed by options
+        const bool hasRoi = (nrhs%2) == 1;
+        nargchk(nlhs<=1);
+        int level = 0;
+        for (int i=(hasRoi ? 3 : 2); i<nrhs; i+=2) {
+            string key(rhs[i].toString());
+            if (key == "Level")
+                level = rhs[i+1].toInt();
+            else
+                mexErrMsgIdAndTxt("mexopencv:error",
+                    "Unrecognized option %s", key.c_str());
+        }
+        if (level < 0 || level >= obj->numLevels())
+            mexErrMsgIdAndTxt("mexopencv:error", "Invalid level %d", level);
+        Rect roi(hasRoi ? rhs[2].toRect() :
+            Rect(Point(), obj->levelSize(level)));
+        Mat img(obj->read(roi, level));
+        if (obj->flip)
+            flipChannels(img);
+        plhs[0] = MxArray(img);
+    }
+    else if (method == "levelSize") {
+        nargchk(nrhs==3 && nlhs<=1);
+        int level = rhs[2].toInt();
+        if (level < 0 || level >= obj->numLevels())
+            mexErrMsgIdAndTxt("mexopencv:error", "Invalid level %d", level);
+        plhs[0] = MxArray(obj->levelSize(level));
+    }
+    else if (method == "clearCache") {
+        nargchk(nrhs==2 && nlhs==0);
+        obj->cache.clear();
+    }
+    else if (method == "get") {
+        nargchk(nrhs==3 && nlhs<=1);
+        string prop(rhs[2].toString());
+        if (prop == "Width")
+            plhs[0] = MxArray(obj->levelSize(0).width);
+        else if (prop == "Height")
+            plhs[0] = MxArray(obj->levelSize(0).height);
+        else if (prop == "NumLevels")
+            plhs[0] = MxArray(obj->numLevels());
+        else if (prop == "TileSize")
+            plhs[0] = MxArray(obj->tileSize());
+        else if (prop == "Layout")
+            plhs[0] = MxArray(obj->layout());
+        else if (prop == "CacheSize")
+            plhs[0] = MxArray(static_cast<double>(obj->cache.capacity()));
+        else if (prop == "CacheUsage")
+            plhs[0] = MxArray(static_cast<double>(obj->cache.usage()));
+        else
+            mexErrMsgIdAndTxt("mexopencv:error",
+                "Unrecognized property %s", prop.c_str());
+    }
+    else if (method == "set") {
+        nargchk(nrhs==4 && nlhs==0);
+        string prop(rhs[2].toString());
+        if (prop == "CacheSize")
+            obj->cache.setCapacity(static_cast<size_t>(rhs[3].toDouble()));
+        else
+            mexErrMsgIdAndTxt("mexopencv:error",
+                "Unrecognized property %s", prop.c_str());
+    }
+    else
+        mexErrMsgIdAndTxt("mexopencv:error",
+            "Unrecognized operation %s", method.c_str());
+}
@@ -12,10 +12,8 @@ using namespace cv;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<LineSegmentDetector> > obj_;
+ObjectRegistry<LineSegmentDetector> obj_;
 
 /// Line Segment Detector modes for option processing
 const ConstMap<string,int> LineSegmentDetectorModesMap = ConstMap<string,int>
@@ -74,15 +72,18 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                 mexErrMsgIdAndTxt("mexopencv:error",
                     "Unrecognized option %s", key.c_str());
         }
-        obj_[++last_id] = createLineSegmentDetector(refine, scale,
-            sigma_scale, quant, ang_th, log_eps, density_th, n_bins);
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(createLineSegmentDetector(refine, scale,
+            sigma_scale, quant, ang_th, log_eps, density_th, n_bins)));
         mexLock();
         return;
     }
 
+    // Registry queries, e.g. to report leaks
+    if (obj_.query(method, nlhs, plhs))
+        return;
+
     // Big operation switch
-    Ptr<LineSegmentDetector> obj = obj_[id];
+    Ptr<LineSegmentDetector> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -0,0 +1,89 @@
+/**
+ * @file MatHandle_.cpp
+ * @brief mex interface for cv.MatHandle, cv::Mat objects resident in C++
+ * @ingroup core
+ */
+#include "mexopencv.hpp"
+using namespace std;
+using namespace cv;
+
+namespace {
+// Persistent objects
+/// Object container
+ObjectRegistry<Mat> obj_;
+}
+
+/**
+ * Main entry called from Matlab
+ * @param nlhs number of left-hand-side arguments
+ * @param plhs pointers to mxArrays in the left-hand-side
+ * @param nrhs number of right-hand-side arguments
+ * @param prhs pointers to mxArrays in the right-hand-side
+ */
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+    // Check the number of arguments
+    nargchk(nrhs>=2 && nlhs<=1);
+
+    // Argument vector
+    vector<MxArray> rhs(prhs, prhs+nrhs);
+    int id = rhs[0].toInt();
+    string method(rhs[1].toString());
+
+    // Constructor is called. Create a new object from argument
+    if (method == "new") {
+        nargchk(nrhs==3 && nlhs<=1);
+        Ptr<Mat> mat;
+        if (rhs[2].isMatHandle()) {
+            // both handles are resident here, copy directly
+            Ptr<Mat> src = obj_.get(
+                MxArray(mxGetProperty(rhs[2], 0, "id")).toInt());
+            if (src.empty())
+                mexErrMsgIdAndTxt("mexopencv:error", "Invalid cv.MatHandle");
+            mat = makePtr<Mat>(src->clone());
+        }
+        else
+            mat = makePtr<Mat>(rhs[2].toMat());
+        plhs[0] = MxArray(obj_.add(mat));
+        mexLock();
+        return;
+    }
+
+    // Registry queries, e.g. to report leaks
+    if (obj_.query(method, nlhs, plhs))
+        return;
+
+    // Big operation switch
+    Ptr<Mat> obj = obj_.get(id);
+    if (obj.empty())
+        mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
+    if (method == "delete") {
+        nargchk(nrhs==2 && nlhs==0);
+        obj_.erase(id);
+        mexUnlock();
+    }
+    else if (method == "toMat") {
+        nargchk(nrhs==2 && nlhs<=1);
+        plhs[0] = MxArray(*obj);
+    }
+    else if (method == "get") {
+        nargchk(nrhs==3 && nlhs<=1);
+        string prop(rhs[2].toString());
+        if (prop == "Size") {
+            vector<int> sz(obj->size.p, obj->size.p + obj->dims);
+            plhs[0] = MxArray(sz);
+        }
+        else if (prop == "Channels")
+            plhs[0] = MxArray(obj->channels());
+        else if (prop == "Class")
+            plhs[0] = MxArray(ClassNameInvMap[obj->depth()]);
+        else if (prop == "Empty")
+            plhs[0] = MxArray(obj->empty());
+        else
+            mexErrMsgIdAndTxt("mexopencv:error",
+                "Unrecognized property %s", prop.c_str());
+    }
+    else
+        mexErrMsgIdAndTxt("mexopencv:error",
+            "Unrecognized operation %s", method.c_str());
+}
@@ -0,0 +1,200 @@
+/**
+ * @file MultiPageReader_.cpp
+ * @brief mex interface for cv.MultiPageReader, lazy access to TIFF pages
+ * @ingroup imgcodecs
+ */
+#include "mexopencv_imgcodecs.hpp"
+using namespace std;
+using namespace cv;
+
+namespace {
+/// Reader of single pages or ranges of pages of a multi-page image file
+class MultiPageReader
+{
+  public:
+    /** Open a file.
+     * @param filename name of the file.
+     * @param flags flags of cv::imdecode.
+     * @param flip whether color pages are returned in RGB order.
+     *
+     * Files in other formats than TIFF are read as a single page.
+     */
+    MultiPageReader(const string& filename, int flags, bool flip)
+    : filename_(filename), flags_(flags), flip_(flip)
+    {
+        if (TiffFile::isTiff(filename))
+            tif_ = makePtr<TiffFile>(filename);
+    }
+
+    /// Number of pages
+    int count() const
+    {
+        return tif_.empty() ? 1 : static_cast<int>(tif_->pages());
+    }
+
+    /** Decode a single page.
+     * @param page 0-based page index.
+     * @return MATLAB array of the decoded page.
+     */
+    MxArray read(int page)
+    {
+        check(page, page + 1);
+        Mat img;
+        if (tif_.empty())
+            img = imread(filename_, flags_);
+        else
+            img = tif_->decodePage(directory(page), flags_);
+        if (img.empty())
+            mexErrMsgIdAndTxt("mexopencv:error", "imread failed");
+        if (flip_)
+            flipChannels(img);
+        return MxArray(img);
+    }
+
+    /** Decode a range of pages in parallel.
+     * @param pages range of 0-based page indices.
+     * @param stack whether to return a 4-D stack rather than a cell array.
+     * @return MATLAB array of the decoded pages.
+     *
+     * The compressed data of the pages is copied (serially) into in-memory
+     * TIFF files, which are then decoded in parallel.
+     */
+    MxArray readRange(const Range& pages, bool stack)
+    {
+        check(pages.start, pages.end);
+        if (tif_.empty()) {
+            MxArray img(read(0));
+            if (stack)
+                return img;
+            MxArray cell(MxArray::Cell(1, 1));
+            cell.set(0, img);
+            return cell;
+        }
+        const int n = pages.size();
+        buffers_.resize(std::max<size_t>(buffers_.size(), n));
+        vector<Mat> bufs(n);
+        for (int i = 0; i < n; ++i) {
+            tif_->extractPage(directory(pages.start + i), buffers_[i]);
+            bufs[i] = Mat(buffers_[i]);
+        }
+        vector<string> errors;
+        MxArray out(decodeBatch(vector<string>(), bufs, flags_, flip_, stack,
+            Size(n, 1), errors));
+        for (int i = 0; i < n; ++i)
+            if (!errors[i].empty())
+                mexErrMsgIdAndTxt("mexopencv:error", "Page %d: %s",
+                    pages.start + i + 1, errors[i].c_str());
+        return out;
+    }
+
+  private:
+    /// Check a range of 0-based page indices
+    void check(int first, int last) const
+    {
+        if (first < 0 || last > count() || first >= last)
+            mexErrMsgIdAndTxt("mexopencv:error",
+                "Invalid pages %d to %d, the file has %d pages",
+                first + 1, last, count());
+    }
+
+    /// Directory of a page, parsed once
+    const TiffFile::Directory& directory(int page)
+    {
+        std::map<int, TiffFile::Directory>::iterator it = dirs_.find(page);
+        if (it == dirs_.end())
+            it = dirs_.insert(std::make_pair(page,
+                tif_->directory(page))).first;
+        return it->second;
+    }
+
+    /// name of the file
+    string filename_;
+    /// flags of cv::imdecode
+    int flags_;
+    /// whether color pages are returned in RGB order
+    bool flip_;
+    /// TIFF file, empty for other formats
+    Ptr<TiffFile> tif_;
+    /// directories of the pages read so far
+    std::map<int, TiffFile::Directory> dirs_;
+    /// in-memory TIFF files of a range of pages, kept to reuse memory
+    vector<vector<uchar> > buffers_;
+};
+
+// Persistent objects
+/// Object container
+ObjectRegistry<MultiPageReader> obj_;
+}
+
+/**
+ * Main entry called from Matlab
+ * @param nlhs number of left-hand-side arguments
+ * @param plhs pointers to mxArrays in the left-hand-side
+ * @param nrhs number of right-hand-side arguments
+ * @param prhs pointers to mxArrays in the right-hand-side
+ */
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+    // Check the number of arguments
+    nargchk(nrhs>=2 && nlhs<=1);
+
+    // Argument vector
+    vector<MxArray> rhs(prhs, prhs+nrhs);
+    int id = rhs[0].toInt();
+    string method(rhs[1].toString());
+
+    // Constructor is called. Create a new object from argument
+    if (method == "new") {
+        nargchk(nrhs>=3 && (nrhs%2)==1 && nlhs<=1);
+        // same defaults as cv.imreadmulti
+        vector<MxArray> opts;
+        opts.push_back(MxArray(string("AnyColor")));
+        opts.push_back(MxArray(true));
+        opts.insert(opts.end(), rhs.begin() + 3, rhs.end());
+        bool flip = true;
+        int flags = parseImreadFlags(opts.begin(), opts.end(), flip, false);
+        plhs[0] = MxArray(obj_.add(makePtr<MultiPageReader>(
+            rhs[2].toString(), flags, flip)));
+        mexLock();
+        return;
+    }
+
+    // Registry queries, e.g. to report leaks
+    if (obj_.query(method, nlhs, plhs))
+        return;
+
+    // Big operation switch
+    Ptr<MultiPageReader> obj = obj_.get(id);
+    if (obj.empty())
+        mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
+    if (method == "delete") {
+        nargchk(nrhs==2 && nlhs==0);
+        obj_.erase(id);
+        mexUnlock();
+    }
+    else if (method == "count") {
+        nargchk(nrhs==2 && nlhs<=1);
+        plhs[0] = MxArray(obj->count());
+    }
+    else if (method == "read") {
+        nargchk(nrhs==3 && nlhs<=1);
+        plhs[0] = obj->read(rhs[2].toInt() - 1);
+    }
+    else if (method == "readRange") {
+        nargchk(nrhs>=4 && (nrhs%2)==0 && nlhs<=1);
+        bool stack = false;
+        for (int i=4; i<nrhs; i+=2) {
+            string key(rhs[i].toString());
+            if (key == "Stack")
+                stack = rhs[i+1].toBool();
+            else
+                mexErrMsgIdAndTxt("mexopencv:error",
+                    "Unrecognized option %s", key.c_str());
+        }
+        plhs[0] = obj->readRange(
+            Range(rhs[2].toInt() - 1, rhs[3].toInt()), stack);
+    }
+    else
+        mexErrMsgIdAndTxt("mexopencv:error",
+            "Unrecognized operation %s", method.c_str());
+}
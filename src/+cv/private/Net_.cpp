@@ -7,16 +7,32 @@
  */
 #include "mexopencv.hpp"
 #include "opencv2/dnn.hpp"
+#include <cstdlib>
+#include <fstream>
+#include <sys/types.h>
+#include <sys/stat.h>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define MEXOPENCV_HAVE_MMAP
+#endif
+#ifdef CV_CXX11
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <thread>
+#endif
 using namespace std;
 using namespace cv;
 using namespace cv::dnn;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<Net> > obj_;
+ObjectRegistry<Net> obj_;
 
 /// Computation backends for option processing
 const ConstMap<string,int> BackendsMap = ConstMap<string,int>
@@ -203,7 +219,609 @@ MxArray toMxArray(int64_t i)
     return arr;
 }
 
-/** Create an instance of Net using options in arguments
+/** Convert MxArray to std::vector<cv::dnn::MatShape>
+ * @param arr MxArray object. In one of the following forms:
+ * - a numeric vector, a single shape
+ * - a cell array of numeric vectors
+ * @return vector of shapes
+ */
+vector<MatShape> MxArrayToVectorMatShape(const MxArray& arr)
+{
+    vector<MatShape> shapes;
+    if (arr.isCell()) {
+        vector<MxArray> v(arr.toVector<MxArray>());
+        shapes.reserve(v.size());
+        for (vector<MxArray>::const_iterator it = v.begin();
+             it != v.end(); ++it)
+            shapes.push_back(it->toVector<int>());
+    }
+    else
+        shapes.push_back(arr.toVector<int>());
+    return shapes;
+}
+
+/** Convert MxArray to the integer id of a layer
+ * @param net network containing the layer
+ * @param arr layer name (string) or layer id (integer)
+ * @return layer id
+ */
+int MxArrayToLayerIndex(Net& net, const MxArray& arr)
+{
+    int lid = arr.isChar() ? net.getLayerId(arr.toString()) : arr.toInt();
+    if (lid < 0)
+        mexErrMsgIdAndTxt("mexopencv:error", "Layer not found");
+    return lid;
+}
+
+/** Parse the LayerId option of the network cost estimates
+ * @param net network containing the layer
+ * @param first iterator at the first option name
+ * @param last iterator past the last option value
+ * @return layer id, or -1 for the whole network
+ */
+int MxArrayToLayerOption(Net& net, vector<MxArray>::const_iterator first,
+    vector<MxArray>::const_iterator last)
+{
+    int lid = -1;
+    for (; first != last; first += 2) {
+        string key(first->toString());
+        if (key == "LayerId")
+            lid = MxArrayToLayerIndex(net, *(first + 1));
+        else
+            mexErrMsgIdAndTxt("mexopencv:error",
+                "Unrecognized option %s", key.c_str());
+    }
+    return lid;
+}
+
+/** Measure and estimate the cost of each layer of a network
+ * @param net network, with its input set.
+ * @param inShapes shapes of the network inputs.
+ * @param outNames names of the outputs to compute, default output if empty.
+ * @param runs number of timed forward passes, after a warm-up pass.
+ * @param totals output, struct of the totals of the network.
+ * @return struct-array MxArray object, one element per layer.
+ */
+MxArray profileNet(Net& net, const vector<MatShape>& inShapes,
+    const vector<String>& outNames, int runs, MxArray& totals)
+{
+    // warm-up pass, which also allocates and initializes layers
+    vector<MatND> outputs;
+    if (outNames.empty())
+        net.forward();
+    else
+        net.forward(outputs, outNames);
+    vector<double> timings, time;
+    int64 total = 0;
+    for (int r = 0; r < runs; ++r) {
+        if (outNames.empty())
+            net.forward();
+        else
+            net.forward(outputs, outNames);
+        total += net.getPerfProfile(timings);
+        time.resize(std::max(time.size(), timings.size()), 0.0);
+        for (size_t i = 0; i < timings.size(); ++i)
+            time[i] += timings[i];
+    }
+    const double msec = 1000.0 / (cv::getTickFrequency() * runs);
+
+    // estimates, from the shapes of the inputs
+    vector<int> ids, memIds;
+    vector<vector<MatShape> > inLayersShapes, outLayersShapes;
+    net.getLayersShapes(inShapes, ids, inLayersShapes, outLayersShapes);
+    vector<size_t> weights, blobs;
+    net.getMemoryConsumption(inShapes, memIds, weights, blobs);
+    map<int,size_t> weightsMap, blobsMap;
+    for (size_t i = 0; i < memIds.size(); ++i) {
+        weightsMap[memIds[i]] = weights[i];
+        blobsMap[memIds[i]] = blobs[i];
+    }
+
+    // one element per layer, the network input (id 0) excluded
+    const char *fields[] = {"id", "name", "type", "outputShapes",
+        "flops", "weights", "blobs", "time"};
+    mwSize n = 0;
+    for (size_t i = 0; i < ids.size(); ++i)
+        if (ids[i] > 0) ++n;
+    MxArray s = MxArray::Struct(fields, 8, 1, n);
+    double sumFlops = 0, sumWeights = 0, sumBlobs = 0;
+    mwIndex j = 0;
+    for (size_t i = 0; i < ids.size(); ++i) {
+        const int lid = ids[i];
+        if (lid <= 0)
+            continue;
+        Ptr<Layer> layer = net.getLayer(lid);
+        const double flops =
+            static_cast<double>(net.getFLOPS(lid, inShapes));
+        const double w = static_cast<double>(weightsMap[lid]),
+            b = static_cast<double>(blobsMap[lid]);
+        s.set("id",           lid, j);
+        s.set("name",         layer->name, j);
+        s.set("type",         layer->type, j);
+        s.set("outputShapes", outLayersShapes[i], j);
+        s.set("flops",        flops, j);
+        s.set("weights",      w, j);
+        s.set("blobs",        b, j);
+        s.set("time",         (static_cast<size_t>(lid) <= time.size()) ?
+            time[lid - 1] * msec : 0.0, j);
+        sumFlops += flops;
+        sumWeights += w;
+        sumBlobs += b;
+        ++j;
+    }
+
+    const char *tfields[] = {"layers", "flops", "weights", "blobs",
+        "time", "runs"};
+    totals = MxArray::Struct(tfields, 6);
+    totals.set("layers",  static_cast<int>(n));
+    totals.set("flops",   sumFlops);
+    totals.set("weights", sumWeights);
+    totals.set("blobs",   sumBlobs);
+    totals.set("time",    total * msec);
+    totals.set("runs",    runs);
+    return s;
+}
+
+/// Options of the conversion of images to a blob
+struct BlobOptions
+{
+    double scalefactor;  ///< multiplier for image values
+    Size size;           ///< spatial size of the blob, image size if empty
+    Scalar mean;         ///< values subtracted from channels
+    bool swapRB;         ///< whether first and last channels are swapped
+    bool crop;           ///< whether images are cropped after resize
+    string name;         ///< name of the input blob to set
+    /// Default options
+    BlobOptions() : scalefactor(1.0), swapRB(true), crop(true) {}
+};
+
+/** Parse options of the conversion of images to a blob
+ * @param first iterator at the first option name
+ * @param last iterator past the last option value
+ * @param withName whether the "Name" option is accepted
+ * @return options
+ */
+BlobOptions MxArrayToBlobOptions(vector<MxArray>::const_iterator first,
+    vector<MxArray>::const_iterator last, bool withName = false)
+{
+    BlobOptions opts;
+    for (; first != last; first += 2) {
+        string key(first->toString());
+        const MxArray& val = *(first + 1);
+        if (key == "ScaleFactor")
+            opts.scalefactor = val.toDouble();
+        else if (key == "Size")
+            opts.size = val.toSize();
+        else if (key == "Mean")
+            opts.mean = val.toScalar();
+        else if (key == "SwapRB")
+            opts.swapRB = val.toBool();
+        else if (key == "Crop")
+            opts.crop = val.toBool();
+        else if (withName && key == "Name")
+            opts.name = val.toString();
+        else
+            mexErrMsgIdAndTxt("mexopencv:error",
+                "Unrecognized option %s", key.c_str());
+    }
+    return opts;
+}
+
+/// Number of blob columns processed together by the fused conversion
+const int BLOB_TILE_COLS = 16;
+
+/// Resampling of one image into the blob, by bilinear interpolation
+struct BlobImage
+{
+    const uchar *data;     ///< planes of uint8 pixels, see MxArrayToPlanes
+    size_t plane;          ///< number of pixels of a channel
+    vector<size_t> xofs0;  ///< offset of left source column, per blob col
+    vector<size_t> xofs1;  ///< offset of right source column, per blob col
+    vector<float> alpha;   ///< weight of right source column, per blob col
+    vector<size_t> yofs0;  ///< top source row, per blob row
+    vector<size_t> yofs1;  ///< bottom source row, per blob row
+    vector<float> beta;    ///< weight of bottom source row, per blob row
+};
+
+/** Compute bilinear interpolation coefficients along one axis
+ * @param ssize source size.
+ * @param dsize blob size.
+ * @param scale source pixels per resized pixel.
+ * @param offset position of the first blob pixel in the resized image.
+ * @param mult multiplier of the source offsets.
+ * @param ofs0 output, offsets of the first source pixel.
+ * @param ofs1 output, offsets of the second source pixel.
+ * @param w output, weights of the second source pixel.
+ *
+ * Same sampling positions and border handling as cv::resize with
+ * \c INTER_LINEAR.
+ */
+void linearCoeffs(int ssize, int dsize, double scale, int offset,
+    size_t mult, vector<size_t>& ofs0, vector<size_t>& ofs1, vector<float>& w)
+{
+    ofs0.resize(dsize);
+    ofs1.resize(dsize);
+    w.resize(dsize);
+    for (int d = 0; d < dsize; ++d) {
+        float f = static_cast<float>((d + offset + 0.5) * scale - 0.5);
+        int s = cvFloor(f);
+        f -= s;
+        if (s < 0)
+            s = 0, f = 0;
+        if (s >= ssize - 1)
+            s = ssize - 1, f = 0;
+        ofs0[d] = s * mult;
+        ofs1[d] = std::min(s + 1, ssize - 1) * mult;
+        w[d] = f;
+    }
+}
+
+/** Prepare the resampling of an image into the blob
+ * @param planes uint8 image, see MxArrayToPlanes.
+ * @param cn number of channels of the image.
+ * @param size spatial size of the blob.
+ * @param crop whether the image is resized preserving its aspect ratio,
+ *    and cropped from the center.
+ * @return resampling coefficients.
+ *
+ * Reproduces the geometry of cv::dnn::blobFromImages: when cropping, the
+ * image is scaled so that it covers the blob, otherwise it is stretched.
+ */
+BlobImage prepareBlobImage(const Mat& planes, int cn, const Size& size,
+    bool crop)
+{
+    const int rows = planes.cols, cols = planes.rows / cn;
+    BlobImage img;
+    img.data = planes.data;
+    img.plane = static_cast<size_t>(rows) * cols;
+    double sx = 1, sy = 1;
+    int ox = 0, oy = 0;
+    if (size != Size(cols, rows)) {
+        if (crop) {
+            const float f = std::max(size.width / (float)cols,
+                size.height / (float)rows);
+            sx = sy = 1. / f;
+            ox = std::max(
+                saturate_cast<int>(cols * (double)f) - size.width, 0) / 2;
+            oy = std::max(
+                saturate_cast<int>(rows * (double)f) - size.height, 0) / 2;
+        }
+        else {
+            sx = 1. / ((double)size.width / cols);
+            sy = 1. / ((double)size.height / rows);
+        }
+    }
+    // columns are rows apart in column-major order
+    linearCoeffs(cols, size.width, sx, ox, rows,
+        img.xofs0, img.xofs1, img.alpha);
+    linearCoeffs(rows, size.height, sy, oy, 1,
+        img.yofs0, img.yofs1, img.beta);
+    return img;
+}
+
+/** Parallel loop body of the fused conversion of uint8 images to a blob
+ *
+ * Reads MATLAB images in place, and in a single pass resamples them,
+ * subtracts the mean, scales, swaps channels, and stores the values at
+ * any layout. The blob is walked in tiles of columns, so that the strided
+ * reads of the column-major images stay in cache.
+ */
+class BlobFromImagesInvoker : public ParallelLoopBody
+{
+  public:
+    /// Constructor
+    BlobFromImagesInvoker(const vector<BlobImage>& images, int cn,
+        const Size& size, const BlobOptions& opts, float *dst,
+        const size_t *step)
+    : images_(images), cn_(cn), size_(size),
+      scale_(static_cast<float>(opts.scalefactor)), dst_(dst)
+    {
+        // mean is given in blob channel order
+        Scalar mean(opts.mean);
+        if (opts.swapRB)
+            std::swap(mean[0], mean[2]);
+        for (int c = 0; c < 4; ++c) {
+            mean_[c] = static_cast<float>(mean[c]);
+            chan_[c] = c;
+        }
+        if (opts.swapRB && cn_ >= 3)
+            std::swap(chan_[0], chan_[2]);
+        std::copy(step, step + 4, step_);
+    }
+    /// Process a range of column tiles of the blob
+    virtual void operator()(const Range& range) const
+    {
+        for (int t = range.start; t < range.end; ++t) {
+            const int x0 = t * BLOB_TILE_COLS,
+                x1 = std::min(x0 + BLOB_TILE_COLS, size_.width);
+            for (size_t n = 0; n < images_.size(); ++n) {
+                const BlobImage& img = images_[n];
+                for (int c = 0; c < cn_; ++c) {
+                    const uchar *src = img.data + c * img.plane;
+                    const float m = mean_[c];
+                    float *d = dst_ + n * step_[0] + chan_[c] * step_[1];
+                    for (int y = 0; y < size_.height; ++y) {
+                        const uchar *s0 = src + img.yofs0[y],
+                            *s1 = src + img.yofs1[y];
+                        const float b = img.beta[y];
+                        float *dy = d + y * step_[2];
+                        for (int x = x0; x < x1; ++x) {
+                            const size_t i0 = img.xofs0[x],
+                                i1 = img.xofs1[x];
+                            const float a = img.alpha[x];
+                            const float top = s0[i0] * (1 - a) + s0[i1] * a,
+                                bot = s1[i0] * (1 - a) + s1[i1] * a;
+                            dy[x * step_[3]] =
+                                (top * (1 - b) + bot * b - m) * scale_;
+                        }
+                    }
+                }
+            }
+        }
+    }
+  private:
+    const vector<BlobImage>& images_;
+    int cn_;
+    Size size_;
+    float scale_;
+    float mean_[4];
+    int chan_[4];
+    float *dst_;
+    size_t step_[4];
+};
+
+/** Check whether images can take the fused uint8 conversion to a blob
+ * @param images input images.
+ * @param size spatial size of the blob, image size if empty.
+ * @param cn output, number of channels of the images.
+ * @return true if all images are non-empty real uint8 arrays with 1, 3, or
+ *    4 channels, and of the same size when \p size is empty.
+ */
+bool isFusedBlobInput(const vector<MxArray>& images, const Size& size,
+    int& cn)
+{
+    if (images.empty())
+        return false;
+    cn = 0;
+    for (size_t i = 0; i < images.size(); ++i) {
+        const MxArray& img = images[i];
+        if (!img.isUint8() || img.isComplex() || img.isSparse() ||
+            img.isEmpty() || img.ndims() > 3)
+            return false;
+        const int c = (img.ndims() > 2) ? img.dims()[2] : 1;
+        if (i == 0)
+            cn = c;
+        else if (c != cn || (size.area() == 0 &&
+            (img.dims()[0] != images[0].dims()[0] ||
+             img.dims()[1] != images[0].dims()[1])))
+            return false;
+    }
+    return (cn == 1 || cn == 3 || cn == 4);
+}
+
+/** View a uint8 MATLAB image as a matrix of planes
+ * @param arr HxWxC uint8 array.
+ * @param cn number of channels of the image.
+ * @return CV_8U matrix of size (C*W)xH sharing the data of \p arr, which
+ *    is how column-major data looks from OpenCV.
+ */
+Mat MxArrayToPlanes(const MxArray& arr, int cn)
+{
+    return Mat(arr.dims()[1] * cn, arr.dims()[0], CV_8U,
+        mxGetData(static_cast<const mxArray*>(arr)));
+}
+
+/** Convert images to a blob, writing in place
+ * @param planes uint8 input images, see MxArrayToPlanes.
+ * @param cn number of channels of the images.
+ * @param opts conversion options, with a non-empty size.
+ * @param dst pointer to the first element of the blob.
+ * @param step offsets (in elements) between consecutive images, channels,
+ *    rows, and columns of the blob.
+ */
+void fusedBlobFromImages(const vector<Mat>& planes, int cn,
+    const BlobOptions& opts, float *dst, const size_t *step)
+{
+    vector<BlobImage> imgs;
+    imgs.reserve(planes.size());
+    for (size_t i = 0; i < planes.size(); ++i)
+        imgs.push_back(prepareBlobImage(planes[i], cn, opts.size,
+            opts.crop));
+    const int ntiles =
+        (opts.size.width + BLOB_TILE_COLS - 1) / BLOB_TILE_COLS;
+    parallel_for_(Range(0, ntiles), BlobFromImagesInvoker(
+        imgs, cn, opts.size, opts, dst, step));
+}
+
+/// Images taken from MATLAB, to be converted to a blob
+struct BlobInput
+{
+    /// uint8 planes (see MxArrayToPlanes) or CV_32F images
+    vector<Mat> images;
+    /// number of channels of uint8 planes, 0 for CV_32F images
+    int cn;
+    /// No images
+    BlobInput() : cn(0) {}
+};
+
+/** Take images from MATLAB for their conversion to a blob
+ * @param arr input image, or cell array of images.
+ * @param size spatial size of the blob, image size if empty.
+ * @param copy whether uint8 images are copied, rather than referenced
+ *    (required when the conversion outlives the MEX call).
+ * @return images, as uint8 planes when they can take the fused conversion.
+ */
+BlobInput MxArrayToBlobInput(const MxArray& arr, const Size& size,
+    bool copy = false)
+{
+    vector<MxArray> arrs(arr.isCell() ? arr.toVector<MxArray>() :
+        vector<MxArray>(1, arr));
+    BlobInput in;
+    in.images.reserve(arrs.size());
+    if (isFusedBlobInput(arrs, size, in.cn)) {
+        for (size_t i = 0; i < arrs.size(); ++i) {
+            Mat planes(MxArrayToPlanes(arrs[i], in.cn));
+            in.images.push_back(copy ? planes.clone() : planes);
+        }
+    }
+    else {
+        in.cn = 0;
+        for (size_t i = 0; i < arrs.size(); ++i)
+            in.images.push_back(arrs[i].toMat(CV_32F));
+    }
+    return in;
+}
+
+/** Spatial size of the blob made from uint8 images
+ * @param in images, as uint8 planes.
+ * @param size requested size, image size if empty.
+ * @return size of the blob.
+ */
+Size blobSize(const BlobInput& in, const Size& size)
+{
+    return (size.area() > 0) ? size :
+        Size(in.images[0].rows / in.cn, in.images[0].cols);
+}
+
+/** Convert images to a blob
+ * @param in images.
+ * @param opts conversion options.
+ * @return 4-dimensional blob, NCHW order.
+ *
+ * Does not use the MEX API, can be called from worker threads.
+ */
+MatND blobFromInput(const BlobInput& in, BlobOptions opts)
+{
+    if (in.cn == 0)
+        return blobFromImages(in.images, opts.scalefactor, opts.size,
+            opts.mean, opts.swapRB, opts.crop);
+    opts.size = blobSize(in, opts.size);
+    const int sz[4] = {static_cast<int>(in.images.size()), in.cn,
+        opts.size.height, opts.size.width};
+    MatND blob(4, sz, CV_32F);
+    const size_t step[4] = {blob.step[0] / sizeof(float),
+        blob.step[1] / sizeof(float), blob.step[2] / sizeof(float), 1};
+    fusedBlobFromImages(in.images, in.cn, opts, blob.ptr<float>(), step);
+    return blob;
+}
+
+/// Contents of a model file, read into memory or memory-mapped
+class ModelFile
+{
+public:
+    /** Read a model file
+     * @param filename path to the file.
+     * @param mapped whether to memory-map the file instead of reading it.
+     *    Only supported on POSIX systems, the file is read otherwise.
+     */
+    ModelFile(const string &filename, bool mapped)
+    :   filename_(filename), data_(NULL), size_(0), mtime_(0),
+        mapped_(false)
+    {
+        struct stat st;
+        if (stat(filename.c_str(), &st) != 0)
+            mexErrMsgIdAndTxt("mexopencv:error",
+                "Failed to open file %s", filename.c_str());
+        mtime_ = st.st_mtime;
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ == 0)
+            return;
+#ifdef MEXOPENCV_HAVE_MMAP
+        if (mapped) {
+            int fd = open(filename.c_str(), O_RDONLY);
+            if (fd >= 0) {
+                void *p = mmap(NULL, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+                close(fd);
+                if (p != MAP_FAILED) {
+                    data_ = static_cast<const char*>(p);
+                    mapped_ = true;
+                    return;
+                }
+            }
+        }
+#endif
+        buf_.resize(size_);
+        std::ifstream ifs(filename.c_str(), std::ios::in | std::ios::binary);
+        if (!ifs.read(&buf_[0], static_cast<std::streamsize>(size_)))
+            mexErrMsgIdAndTxt("mexopencv:error",
+                "Failed to read file %s", filename.c_str());
+        data_ = &buf_[0];
+    }
+
+    /// Unmap or free the contents
+    ~ModelFile()
+    {
+#ifdef MEXOPENCV_HAVE_MMAP
+        if (mapped_)
+            munmap(const_cast<char*>(data_), size_);
+#endif
+    }
+
+    /** Check whether the file changed since it was read
+     * @return true if the file was removed, or its time of last
+     *    modification or its size differ.
+     */
+    bool stale() const
+    {
+        struct stat st;
+        return (stat(filename_.c_str(), &st) != 0 ||
+            st.st_mtime != mtime_ || static_cast<size_t>(st.st_size) != size_);
+    }
+
+    /// path to the file
+    const string& filename() const { return filename_; }
+    /// contents of the file, NULL if empty
+    const char* data() const { return data_; }
+    /// size of the file in bytes
+    size_t size() const { return size_; }
+    /// whether the contents are memory-mapped
+    bool mapped() const { return mapped_; }
+
+private:
+    // non-copyable, the contents are owned
+    ModelFile(const ModelFile&);
+    ModelFile& operator=(const ModelFile&);
+
+    string filename_;
+    vector<char> buf_;
+    const char *data_;
+    size_t size_;
+    time_t mtime_;
+    bool mapped_;
+};
+
+struct CachedModel;
+
+/// Model files a network was read from, and settings applied to it
+struct NetSource
+{
+    /// type of network, empty for networks not read from files
+    string type;
+    /// first file argument (prototxt, model, filename, or cfgFile)
+    string file1;
+    /// second file argument (caffeModel, config, or darknetModel)
+    string file2;
+    /// Torch serialization format
+    bool isBinary;
+    /// preferable computation backend
+    int backend;
+    /// preferable computation target
+    int target;
+    /// whether layers fusion is enabled
+    bool fusion;
+    /// model of the cache whose weights are shared, NULL if not shared
+    Ptr<CachedModel> model;
+    /// Default settings
+    NetSource()
+    : isBinary(true), backend(cv::dnn::DNN_BACKEND_DEFAULT),
+      target(cv::dnn::DNN_TARGET_CPU), fusion(true)
+    {}
+};
+
+/// Sources of networks, by object id
+map<int,NetSource> source_;
+
+/** Parse the arguments of the network importer
  * @param type type of network to import, one of:
  *    - "Caffe"
  *    - "Tensorflow"
@@ -211,43 +829,767 @@ MxArray toMxArray(int64_t i)
  *    - "Darknet"
  * @param first iterator at the beginning of the vector range
  * @param last iterator at the end of the vector range
- * @return smart pointer to created Net
+ * @return source of the network
  */
-Ptr<Net> readNetFrom(const string &type,
+NetSource MxArrayToNetSource(const string &type,
     vector<MxArray>::const_iterator first,
     vector<MxArray>::const_iterator last)
 {
     ptrdiff_t len = std::distance(first, last);
+    nargchk(len==1 || len==2);
+    NetSource src;
+    src.type = type;
+    src.file1 = first->toString(); ++first;
+    if (type == "Torch")
+        src.isBinary = (len==2 ? first->toBool() : true);
+    else if (len==2)
+        src.file2 = first->toString();
+    return src;
+}
+
+/** Create an instance of Net from model files
+ * @param src source of the network, see MxArrayToNetSource
+ * @return smart pointer to created Net
+ */
+Ptr<Net> readNetFrom(const NetSource &src)
+{
     Net net;
-    if (type == "Caffe") {
-        nargchk(len==1 || len==2);
-        string prototxt(first->toString()); ++first;
-        string caffeModel(len==2 ? first->toString() : string());
-        net = readNetFromCaffe(prototxt, caffeModel);
-    }
-    else if (type == "Tensorflow") {
-        nargchk(len==1 || len==2);
-        string model(first->toString()); ++first;
-        string config(len==2 ? first->toString() : string());
-        net = readNetFromTensorflow(model, config);
-    }
-    else if (type == "Torch") {
-        nargchk(len==1 || len==2);
-        string filename(first->toString()); ++first;
-        bool isBinary = (len==2 ? first->toBool() : true);
-        net = readNetFromTorch(filename, isBinary);
-    }
-    else if (type == "Darknet") {
-        nargchk(len==1 || len==2);
-        string cfgFile(first->toString()); ++first;
-        string darknetModel(len==2 ? first->toString() : string());
-        net = readNetFromDarknet(cfgFile, darknetModel);
-    }
+    if (src.type == "Caffe")
+        net = readNetFromCaffe(src.file1, src.file2);
+    else if (src.type == "Tensorflow")
+        net = readNetFromTensorflow(src.file1, src.file2);
+    else if (src.type == "Torch")
+        net = readNetFromTorch(src.file1, src.isBinary);
+    else if (src.type == "Darknet")
+        net = readNetFromDarknet(src.file1, src.file2);
     else
         mexErrMsgIdAndTxt("mexopencv:error",
-            "Unrecognized network type %s", type.c_str());
+            "Unrecognized network type %s", src.type.c_str());
+    return makePtr<Net>(net);
+}
+
+/// Model files and weights shared by the networks read from the cache
+struct CachedModel
+{
+    /// type of network
+    string type;
+    /// Torch serialization format
+    bool isBinary;
+    /// contents of the first file argument
+    Ptr<ModelFile> file1;
+    /// contents of the second file argument, NULL if not given
+    Ptr<ModelFile> file2;
+    /// network holding the shared weights, never run
+    Ptr<Net> weights;
+
+    /** Check whether any of the model files changed since they were read
+     * @return true if the model must be read again.
+     */
+    bool stale() const
+    {
+        return (file1->stale() || (!file2.empty() && file2->stale()));
+    }
+};
+
+/// Process-wide cache of models, keyed by type and paths of model files
+struct ModelCache
+{
+    /// whether networks read from files go through the cache
+    bool enabled;
+    /// whether model files are memory-mapped
+    bool mapped;
+    /// cached models
+    map<string, Ptr<CachedModel> > models;
+    /// Default settings
+    ModelCache() : enabled(false), mapped(false) {}
+} cache_;
+
+/** Create an instance of Net from the contents of cached model files
+ * @param model cached model.
+ * @return smart pointer to created Net
+ *
+ * Caffe and TensorFlow models are parsed from the cached contents, other
+ * types are read again from the files.
+ */
+Ptr<Net> readNetFrom(const CachedModel &model)
+{
+    const char *data2 = model.file2.empty() ? NULL : model.file2->data();
+    const size_t size2 = model.file2.empty() ? 0 : model.file2->size();
+    Net net;
+    if (model.type == "Caffe")
+        net = readNetFromCaffe(model.file1->data(), model.file1->size(),
+            data2, size2);
+    else if (model.type == "Tensorflow")
+        net = readNetFromTensorflow(model.file1->data(),
+            model.file1->size(), data2, size2);
+    else {
+        NetSource src;
+        src.type = model.type;
+        src.file1 = model.file1->filename();
+        if (!model.file2.empty())
+            src.file2 = model.file2->filename();
+        src.isBinary = model.isBinary;
+        return readNetFrom(src);
+    }
     return makePtr<Net>(net);
 }
+
+/** Canonical absolute path of a file
+ * @param filename path to the file.
+ * @return absolute path with symbolic links (POSIX only), "." and ".."
+ *    resolved, or @p filename itself if it cannot be resolved.
+ *
+ * Different spellings of the same file map to the same cached model.
+ */
+string canonicalPath(const string &filename)
+{
+    if (filename.empty())
+        return filename;
+#ifdef _WIN32
+    char *p = _fullpath(NULL, filename.c_str(), 0);
+#else
+    char *p = realpath(filename.c_str(), NULL);
+#endif
+    if (!p)
+        return filename;
+    string path(p);
+    free(p);
+    return path;
+}
+
+/** Get a model from the cache, reading it if not cached or stale
+ * @param src source of the network.
+ * @return cached model
+ *
+ * Networks still sharing the weights of a replaced stale model keep it
+ * alive until they are deleted.
+ */
+Ptr<CachedModel> getCachedModel(const NetSource &src)
+{
+    const string file1(canonicalPath(src.file1)),
+        file2(canonicalPath(src.file2));
+    const string key(src.type + "\n" + file1 + "\n" + file2 +
+        (src.type == "Torch" && !src.isBinary ? "\nascii" : ""));
+    map<string, Ptr<CachedModel> >::const_iterator it =
+        cache_.models.find(key);
+    if (it != cache_.models.end() && !it->second->stale())
+        return it->second;
+    Ptr<CachedModel> model = makePtr<CachedModel>();
+    model->type = src.type;
+    model->isBinary = src.isBinary;
+    model->file1 = makePtr<ModelFile>(file1, cache_.mapped);
+    if (!file2.empty())
+        model->file2 = makePtr<ModelFile>(file2, cache_.mapped);
+    model->weights = readNetFrom(*model);
+    cache_.models[key] = model;
+    return model;
+}
+
+/** Share the layer parameters of a network
+ * @param net network whose parameters are replaced.
+ * @param weights network whose parameters are shared.
+ *
+ * Only the layer blobs are replaced. Layers that derived their own
+ * matrices from the parsed blobs when they were created keep those, and
+ * the parsed data they reference stays allocated. In OpenCV 3.4 this is
+ * the case of fully connected (InnerProduct) layers, whose weight and bias
+ * matrices reference the parsed blobs, and of batch normalization layers,
+ * which precompute their scale and shift. Convolution layers prepare their
+ * weights when the network is first run, from the shared blobs.
+ */
+void shareWeights(Net &net, Net &weights)
+{
+    vector<String> names(weights.getLayerNames());
+    for (size_t i = 0; i < names.size(); ++i)
+        net.getLayer(names[i])->blobs = weights.getLayer(names[i])->blobs;
+}
+
+/** Bytes used by the layer parameters of a network
+ * @param net network.
+ * @return total size of all layer blobs.
+ */
+size_t weightsBytes(Net &net)
+{
+    size_t bytes = 0;
+    vector<String> names(net.getLayerNames());
+    for (size_t i = 0; i < names.size(); ++i) {
+        const vector<Mat> &blobs = net.getLayer(names[i])->blobs;
+        for (size_t j = 0; j < blobs.size(); ++j)
+            bytes += blobs[j].total() * blobs[j].elemSize();
+    }
+    return bytes;
+}
+
+/** Create a worker copy of a network
+ * @param src source of the network.
+ * @param weights network whose layer parameters are shared by the copy,
+ *    or NULL to keep the parameters read from the files (or those of the
+ *    cached model the source refers to).
+ * @return smart pointer to created Net
+ *
+ * Layers fusion modifies weights in place, so it is disabled in networks
+ * that share them.
+ */
+Ptr<Net> cloneNet(const NetSource &src, Net *weights = NULL)
+{
+    if (src.type.empty())
+        mexErrMsgIdAndTxt("mexopencv:error",
+            "Network was not read from model files and cannot be copied");
+    Ptr<Net> net;
+    if (!src.model.empty()) {
+        net = readNetFrom(*src.model);
+        if (!weights)
+            weights = src.model->weights.get();
+    }
+    else
+        net = readNetFrom(src);
+    net->setPreferableBackend(src.backend);
+    net->setPreferableTarget(src.target);
+    net->enableFusion(src.fusion && !weights);
+    if (weights)
+        shareWeights(*net, *weights);
+    return net;
+}
+
+/// Inference request of the asynchronous queue
+struct AsyncRequest
+{
+    /// request id, returned to MATLAB
+    int id;
+    /// input blob, empty when made from images
+    MatND blob;
+    /// input images, converted to a blob on the worker
+    BlobInput images;
+    /// options of the conversion of images
+    BlobOptions opts;
+    /// names of the requested outputs, default output if empty
+    vector<String> outputNames;
+    /// whether the outputs are returned as a cell array
+    bool multiple;
+    /// outputs of the forward pass
+    vector<MatND> outputs;
+    /// error message, empty on success
+    string error;
+    /// number of requests in the forward pass that computed the outputs
+    int batchSize;
+    /// tick counts when queued, started, and finished
+    int64 queued, started, finished;
+
+    /** Shape of the input blob, without the batch dimension
+     * @return sizes of the blob dimensions after the first one.
+     */
+    vector<int> shape() const
+    {
+        if (images.images.empty())
+            return vector<int>(blob.size.p + 1, blob.size.p + blob.dims);
+        const Mat& img = images.images[0];
+        const int cn = (images.cn > 0) ? images.cn : img.channels();
+        Size sz(opts.size);
+        if (sz.area() == 0)
+            sz = (images.cn > 0) ? blobSize(images, sz) : img.size();
+        vector<int> s(3, cn);
+        s[1] = sz.height;
+        s[2] = sz.width;
+        return s;
+    }
+
+    /** Number of samples of the input
+     * @return size of the batch dimension of the input blob.
+     */
+    int samples() const
+    {
+        return images.images.empty() ? (blob.empty() ? 0 : blob.size[0]) :
+            static_cast<int>(images.images.size());
+    }
+};
+
+/// Options of the asynchronous queue
+struct AsyncOptions
+{
+    /// number of worker threads
+    int workers;
+    /// maximum number of queued requests
+    int depth;
+    /// whether network copies share the layer parameters
+    bool share;
+    /// maximum number of samples run in a single forward pass
+    int maxBatchSize;
+    /// maximum time (msec) a request waits for others to batch with
+    double maxWait;
+    /// Default options
+    AsyncOptions()
+    : workers(2), depth(4), share(true), maxBatchSize(1), maxWait(0)
+    {}
+};
+
+/// Counters of an asynchronous queue
+struct AsyncStats
+{
+    /// finished requests
+    double completed;
+    /// requests finished with an error
+    double failed;
+    /// forward passes run
+    double batches;
+    /// mean number of requests per forward pass
+    double meanBatchSize;
+    /// mean time (msec) from queueing to completion
+    double meanLatency;
+    /// longest time (msec) from queueing to completion
+    double maxLatency;
+    /// mean time (msec) spent waiting for a worker, batching included
+    double meanQueueTime;
+    /// mean time (msec) of the conversion and forward pass of a request
+    double meanComputeTime;
+    /// finished requests per second, since the counters were reset
+    double throughput;
+};
+
+#ifdef CV_CXX11
+/** Pool of workers running forward passes in the background.
+ *
+ * Inputs are converted from MATLAB on the calling thread and queued. Each
+ * worker thread owns a copy of the network (see cloneNet), and converts
+ * images to blobs and runs the forward pass itself, so that several
+ * requests are processed concurrently while MATLAB prepares the next ones.
+ * Workers never call the MEX API.
+ *
+ * With micro-batching enabled, a worker taking a request also takes the
+ * queued requests with the same input shape and outputs (waiting for more
+ * of them up to a maximum time), runs them as a single batch, and splits
+ * the outputs back along the batch dimension.
+ */
+class AsyncForward
+{
+public:
+    /** Create the network copies and start the worker threads.
+     * @param src source of the network.
+     * @param opts pool options.
+     */
+    AsyncForward(const NetSource& src, const AsyncOptions& opts)
+    :   depth_(std::max(opts.depth, 1)),
+        maxBatchSize_(std::max(opts.maxBatchSize, 1)),
+        maxWait_(static_cast<int64>(opts.maxWait * cv::getTickFrequency()
+            / 1000.0)),
+        lastId_(0), running_(0), stopping_(false)
+    {
+        resetStats();
+        // created on the MATLAB thread, where reading errors can be raised
+        nets_.push_back(cloneNet(src, NULL));
+        if (opts.share)
+            nets_[0]->enableFusion(false);
+        for (int i = 1; i < opts.workers; ++i)
+            nets_.push_back(cloneNet(src,
+                opts.share ? nets_[0].get() : NULL));
+        for (size_t i = 0; i < nets_.size(); ++i)
+            threads_.push_back(std::thread(&AsyncForward::run, this, i));
+    }
+
+    /// Stop the workers, discarding queued requests
+    ~AsyncForward()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            queue_.clear();
+            stopping_ = true;
+        }
+        notEmpty_.notify_all();
+        for (size_t i = 0; i < threads_.size(); ++i)
+            if (threads_[i].joinable())
+                threads_[i].join();
+    }
+
+    /** Queue a request, waiting while the queue is full.
+     * @param req request, without id.
+     * @return id of the request.
+     */
+    int push(AsyncRequest& req)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            while (queue_.size() >= static_cast<size_t>(depth_))
+                notFull_.wait(lock);
+            req.id = ++lastId_;
+            req.queued = cv::getTickCount();
+            queue_.push_back(req);
+            outstanding_.insert(req.id);
+        }
+        // a worker gathering a batch may not take this request
+        notEmpty_.notify_all();
+        return req.id;
+    }
+
+    /** Take finished requests.
+     * @param wait whether to wait until all queued requests are finished.
+     * @return finished requests not taken yet, in order of completion.
+     */
+    vector<AsyncRequest> take(bool wait)
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        while (wait && (!queue_.empty() || running_ > 0))
+            idle_.wait(lock);
+        vector<AsyncRequest> reqs(done_.begin(), done_.end());
+        done_.clear();
+        for (size_t i = 0; i < reqs.size(); ++i)
+            outstanding_.erase(reqs[i].id);
+        return reqs;
+    }
+
+    /** Wait for given requests and take them.
+     * @param ids ids of the requests.
+     * @param reqs output, the requests in the order of \p ids.
+     * @return empty string on success, or an error message when an id is
+     *    unknown or already taken.
+     */
+    string take(const vector<int>& ids, vector<AsyncRequest>& reqs)
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        if (std::set<int>(ids.begin(), ids.end()).size() != ids.size())
+            return "Duplicate request ids";
+        for (size_t i = 0; i < ids.size(); ++i)
+            if (outstanding_.count(ids[i]) == 0)
+                return cv::format("Unknown or already retrieved request %d",
+                    ids[i]);
+        reqs.assign(ids.size(), AsyncRequest());
+        for (size_t i = 0; i < ids.size(); ++i) {
+            for (;;) {
+                std::deque<AsyncRequest>::iterator it = done_.begin();
+                while (it != done_.end() && it->id != ids[i])
+                    ++it;
+                if (it != done_.end()) {
+                    reqs[i] = *it;
+                    done_.erase(it);
+                    outstanding_.erase(ids[i]);
+                    break;
+                }
+                idle_.wait(lock);
+            }
+        }
+        return string();
+    }
+
+    /** Number of requests not finished yet
+     * @return queued and running requests.
+     */
+    size_t pending()
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return queue_.size() + running_;
+    }
+
+    /// Current counters
+    AsyncStats stats()
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        AsyncStats st = stats_;
+        const double sec = (cv::getTickCount() - since_) /
+            cv::getTickFrequency();
+        st.throughput = (sec > 0) ? st.completed / sec : 0;
+        st.meanBatchSize = (st.batches > 0) ? st.completed / st.batches : 0;
+        if (st.completed > 0) {
+            st.meanLatency /= st.completed;
+            st.meanQueueTime /= st.completed;
+            st.meanComputeTime /= st.completed;
+        }
+        return st;
+    }
+
+    /// Reset counters
+    void resetStats()
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        AsyncStats st = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+        stats_ = st;
+        since_ = cv::getTickCount();
+    }
+
+private:
+    /// Worker thread body
+    void run(size_t w)
+    {
+        Net& net = *nets_[w];
+        for (;;) {
+            vector<AsyncRequest> batch;
+            {
+                std::unique_lock<std::mutex> lock(mtx_);
+                while (queue_.empty() && !stopping_)
+                    notEmpty_.wait(lock);
+                if (stopping_)
+                    return;
+                batch.push_back(queue_.front());
+                queue_.pop_front();
+                gather(lock, batch);
+                running_ += static_cast<int>(batch.size());
+            }
+            notFull_.notify_all();
+            const int64 start = cv::getTickCount();
+            for (size_t i = 0; i < batch.size(); ++i)
+                batch[i].started = start;
+            if (batch.size() == 1 || !forwardBatch(net, batch))
+                for (size_t i = 0; i < batch.size(); ++i)
+                    forwardOne(net, batch[i]);
+            const int64 end = cv::getTickCount();
+            {
+                std::lock_guard<std::mutex> lock(mtx_);
+                const double msec = 1000.0 / cv::getTickFrequency();
+                for (size_t i = 0; i < batch.size(); ++i) {
+                    AsyncRequest& r = batch[i];
+                    r.finished = end;
+                    done_.push_back(r);
+                    const double latency = (end - r.queued) * msec;
+                    stats_.completed++;
+                    stats_.failed += r.error.empty() ? 0 : 1;
+                    stats_.meanLatency += latency;
+                    stats_.maxLatency = std::max(stats_.maxLatency, latency);
+                    stats_.meanQueueTime += (start - r.queued) * msec;
+                    stats_.meanComputeTime += (end - start) * msec;
+                }
+                // counted per forward pass, sequential fallback included
+                const bool batched = (batch[0].batchSize > 1);
+                stats_.batches += batched ? 1 : batch.size();
+                running_ -= static_cast<int>(batch.size());
+            }
+            idle_.notify_all();
+        }
+    }
+
+    /** Add queued requests compatible with the first one of a batch.
+     * @param lock lock held on the queue, released while waiting.
+     * @param batch requests of the batch, with at least one request.
+     *
+     * Waits for more requests until the batch is full, or the first
+     * request has waited for the maximum time.
+     */
+    void gather(std::unique_lock<std::mutex>& lock,
+        vector<AsyncRequest>& batch)
+    {
+        int samples = batch[0].samples();
+        if (maxBatchSize_ <= 1 || samples >= maxBatchSize_)
+            return;
+        const vector<int> shape(batch[0].shape());
+        const int64 deadline = batch[0].queued + maxWait_;
+        for (;;) {
+            std::deque<AsyncRequest>::iterator it = queue_.begin();
+            while (it != queue_.end() && samples < maxBatchSize_) {
+                if (samples + it->samples() <= maxBatchSize_ &&
+                    it->opts.name == batch[0].opts.name &&
+                    it->outputNames == batch[0].outputNames &&
+                    it->shape() == shape) {
+                    samples += it->samples();
+                    batch.push_back(*it);
+                    it = queue_.erase(it);
+                }
+                else
+                    ++it;
+            }
+            const int64 now = cv::getTickCount();
+            if (samples >= maxBatchSize_ || stopping_ || now >= deadline)
+                break;
+            notEmpty_.wait_for(lock, std::chrono::microseconds(
+                static_cast<int64>((deadline - now) * 1e6 /
+                    cv::getTickFrequency()) + 1));
+        }
+    }
+
+    /** Run a request on its own.
+     * @param net network copy of the worker.
+     * @param req request, whose outputs or error are set.
+     */
+    void forwardOne(Net& net, AsyncRequest& req)
+    {
+        req.batchSize = 1;
+        // cv::error throws on worker threads (see MexErrorHandler), errors
+        // are returned with the request to the MATLAB thread
+        try {
+            if (req.blob.empty())
+                req.blob = blobFromInput(req.images, req.opts);
+            net.setInput(req.blob, req.opts.name);
+            if (req.outputNames.empty())
+                req.outputs.assign(1, net.forward());
+            else
+                net.forward(req.outputs, req.outputNames);
+        }
+        catch (const std::exception& e) {
+            req.error = e.what();
+            req.outputs.clear();
+        }
+        catch (...) {
+            // an exception leaving the thread would terminate MATLAB
+            req.error = "Unknown error in forward pass";
+            req.outputs.clear();
+        }
+        req.blob.release();
+        req.images.images.clear();
+    }
+
+    /** Run requests as a single batch.
+     * @param net network copy of the worker.
+     * @param batch requests, whose outputs or error are set on success.
+     * @return false if outputs cannot be split back along the batch
+     *    dimension, in which case requests are left to be run one by one.
+     */
+    bool forwardBatch(Net& net, vector<AsyncRequest>& batch)
+    {
+        vector<int> offsets(1, 0);
+        for (size_t i = 0; i < batch.size(); ++i)
+            offsets.push_back(offsets.back() + batch[i].samples());
+        vector<MatND> outputs;
+        string err;
+        // cv::error throws on worker threads (see MexErrorHandler)
+        try {
+            // inputs are written into their slice of the batch blob
+            vector<int> sz(batch[0].shape());
+            sz.insert(sz.begin(), offsets.back());
+            MatND input(static_cast<int>(sz.size()), &sz[0], CV_32F);
+            vector<Range> ranges(sz.size(), Range::all());
+            for (size_t i = 0; i < batch.size(); ++i) {
+                AsyncRequest& r = batch[i];
+                ranges[0] = Range(offsets[i], offsets[i+1]);
+                Mat slice(input(&ranges[0]));
+                if (!r.blob.empty())
+                    r.blob.copyTo(slice);
+                else if (r.images.cn > 0) {
+                    BlobOptions opts(r.opts);
+                    opts.size = blobSize(r.images, opts.size);
+                    const size_t step[4] = {slice.step[0] / sizeof(float),
+                        slice.step[1] / sizeof(float),
+                        slice.step[2] / sizeof(float), 1};
+                    fusedBlobFromImages(r.images.images, r.images.cn, opts,
+                        slice.ptr<float>(), step);
+                }
+                else
+                    blobFromInput(r.images, r.opts).copyTo(slice);
+            }
+            net.setInput(input, batch[0].opts.name);
+            if (batch[0].outputNames.empty())
+                outputs.assign(1, net.forward());
+            else
+                net.forward(outputs, batch[0].outputNames);
+        }
+        catch (const std::exception& e) {
+            err = e.what();
+        }
+        catch (...) {
+            // an exception leaving the thread would terminate MATLAB
+            err = "Unknown error in forward pass";
+        }
+        if (!err.empty()) {
+            for (size_t i = 0; i < batch.size(); ++i) {
+                batch[i].error = err;
+                batch[i].batchSize = static_cast<int>(batch.size());
+                batch[i].blob.release();
+                batch[i].images.images.clear();
+            }
+            return true;
+        }
+        for (size_t k = 0; k < outputs.size(); ++k)
+            if (outputs[k].dims < 1 || outputs[k].size[0] != offsets.back())
+                return false;
+        for (size_t i = 0; i < batch.size(); ++i) {
+            AsyncRequest& r = batch[i];
+            r.batchSize = static_cast<int>(batch.size());
+            for (size_t k = 0; k < outputs.size(); ++k) {
+                vector<Range> ranges(outputs[k].dims, Range::all());
+                ranges[0] = Range(offsets[i], offsets[i+1]);
+                r.outputs.push_back(outputs[k](&ranges[0]).clone());
+            }
+            r.blob.release();
+            r.images.images.clear();
+        }
+        return true;
+    }
+
+    /// network copy of each worker
+    vector<Ptr<Net> > nets_;
+    /// worker threads
+    vector<std::thread> threads_;
+    /// maximum queue length
+    int depth_;
+    /// maximum number of samples run in a single forward pass
+    int maxBatchSize_;
+    /// maximum time (ticks) a request waits for others to batch with
+    int64 maxWait_;
+    /// id of the last queued request
+    int lastId_;
+    /// requests waiting for a worker
+    std::deque<AsyncRequest> queue_;
+    /// finished requests, not taken yet
+    std::deque<AsyncRequest> done_;
+    /// ids of requests not taken yet
+    std::set<int> outstanding_;
+    /// number of requests being processed
+    int running_;
+    /// counters, with sums in place of means
+    AsyncStats stats_;
+    /// tick count when the counters were reset
+    int64 since_;
+    /// set to ask the workers to exit
+    bool stopping_;
+    /// guards the queues, counters and flags
+    std::mutex mtx_;
+    /// signaled when a request is queued or on stop
+    std::condition_variable notEmpty_;
+    /// signaled when requests are taken from the queue
+    std::condition_variable notFull_;
+    /// signaled when requests are finished
+    std::condition_variable idle_;
+};
+#else
+/// Stub used when C++11 threads are not available
+class AsyncForward
+{
+public:
+    AsyncForward(const NetSource&, const AsyncOptions&)
+    {
+        mexErrMsgIdAndTxt("mexopencv:error",
+            "Asynchronous forward requires a C++11 compiler");
+    }
+    int push(AsyncRequest&) { return 0; }
+    vector<AsyncRequest> take(bool) { return vector<AsyncRequest>(); }
+    string take(const vector<int>&, vector<AsyncRequest>&)
+    {
+        return string();
+    }
+    size_t pending() { return 0; }
+    AsyncStats stats()
+    {
+        AsyncStats st = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+        return st;
+    }
+    void resetStats() {}
+};
+#endif
+
+/// Worker pools of objects using asynchronous forward
+map<int,Ptr<AsyncForward> > async_;
+
+/** Convert finished requests to struct array
+ * @param reqs finished requests
+ * @return struct-array MxArray object
+ */
+MxArray toStruct(const vector<AsyncRequest>& reqs)
+{
+    const char *fields[] = {"id", "output", "error", "batchSize",
+        "latency", "queueTime", "computeTime"};
+    MxArray s = MxArray::Struct(fields, 7, 1, reqs.size());
+    const double msec = 1000.0 / cv::getTickFrequency();
+    for (mwIndex i = 0; i < reqs.size(); ++i) {
+        const AsyncRequest& r = reqs[i];
+        if (!r.error.empty())
+            s.set("output", Mat(), i);
+        else if (r.multiple)
+            s.set("output", r.outputs, i);
+        else
+            s.set("output", r.outputs[0], i);
+        s.set("id",          r.id, i);
+        s.set("error",       r.error, i);
+        s.set("batchSize",   r.batchSize, i);
+        s.set("latency",     (r.finished - r.queued) * msec, i);
+        s.set("queueTime",   (r.started - r.queued) * msec, i);
+        s.set("computeTime", (r.finished - r.started) * msec, i);
+    }
+    return s;
+}
 }
 
 /**
@@ -270,10 +1612,24 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     // Constructor is called. Create a new object from argument
     if (method == "new") {
         nargchk(nrhs>=2 && nlhs<=1);
-        obj_[++last_id] = (nrhs > 2) ?
-            readNetFrom(rhs[2].toString(), rhs.begin() + 3, rhs.end()) :
-            makePtr<Net>();
-        plhs[0] = MxArray(last_id);
+        NetSource src;
+        if (nrhs > 2)
+            src = MxArrayToNetSource(rhs[2].toString(),
+                rhs.begin() + 3, rhs.end());
+        Ptr<Net> net;
+        if (src.type.empty())
+            net = makePtr<Net>();
+        else if (cache_.enabled) {
+            // parsed from cached contents, sharing the cached weights
+            src.model = getCachedModel(src);
+            src.fusion = false;
+            net = cloneNet(src);
+        }
+        else
+            net = readNetFrom(src);
+        int newId = obj_.add(net);
+        source_[newId] = src;
+        plhs[0] = MxArray(newId);
         mexLock();
         return;
     }
@@ -296,44 +1652,27 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     }
     else if (method == "blobFromImages") {
         nargchk(nrhs>=3 && (nrhs%2)==1 && nlhs<=1);
-        double scalefactor = 1.0;
-        Size size;
-        Scalar mean;
-        bool swapRB = true;
-        bool crop = true;
-        for (int i=3; i<nrhs; i+=2) {
-            string key(rhs[i].toString());
-            if (key == "ScaleFactor")
-                scalefactor = rhs[i+1].toDouble();
-            else if (key == "Size")
-                size = rhs[i+1].toSize();
-            else if (key == "Mean")
-                mean = rhs[i+1].toScalar();
-            else if (key == "SwapRB")
-                swapRB = rhs[i+1].toBool();
-            else if (key == "Crop")
-                crop = rhs[i+1].toBool();
-            else
-                mexErrMsgIdAndTxt("mexopencv:error",
-                    "Unrecognized option %s", key.c_str());
-        }
-        MatND blob;
-        if (rhs[2].isCell()) {
-            //vector<Mat> images(rhs[2].toVector<Mat>());
-            vector<Mat> images;
-            {
-                vector<MxArray> arr(rhs[2].toVector<MxArray>());
-                images.reserve(arr.size());
-                for (vector<MxArray>::const_iterator it = arr.begin(); it != arr.end(); ++it)
-                    images.push_back(it->toMat(CV_32F));
-            }
-            blob = blobFromImages(images, scalefactor, size, mean, swapRB, crop);
-        }
-        else {
-            Mat image(rhs[2].toMat(CV_32F));
-            blob = blobFromImage(image, scalefactor, size, mean, swapRB, crop);
+        BlobOptions opts(MxArrayToBlobOptions(rhs.begin() + 3, rhs.end()));
+        BlobInput in(MxArrayToBlobInput(rhs[2], opts.size));
+        if (in.cn > 0) {
+            // uint8 images go straight into the NxCxHxW output array
+            opts.size = blobSize(in, opts.size);
+            const mwSize n = in.images.size(), cn = in.cn,
+                h = opts.size.height;
+            const mwSize dims[4] = {n, cn, h,
+                static_cast<mwSize>(opts.size.width)};
+            MxArray blob(mxCreateNumericArray(4, dims, mxSINGLE_CLASS,
+                mxREAL));
+            if (blob.isNull())
+                mexErrMsgIdAndTxt("mexopencv:error", "Allocation error");
+            const size_t step[4] = {1, n, n*cn, n*cn*h};
+            fusedBlobFromImages(in.images, in.cn, opts,
+                static_cast<float*>(
+                    mxGetData(static_cast<const mxArray*>(blob))), step);
+            plhs[0] = blob;
         }
-        plhs[0] = MxArray(blob);
+        else
+            plhs[0] = MxArray(blobFromInput(in, opts));
         return;
     }
     else if (method == "imagesFromBlob") {
@@ -361,6 +1700,63 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
             vector<String>(layersTypes.begin(), layersTypes.end()));
         return;
     }
+    else if (method == "useModelCache") {
+        nargchk(nrhs==2 && nlhs<=1);
+        plhs[0] = MxArray(cache_.enabled);
+        return;
+    }
+    else if (method == "setUseModelCache") {
+        nargchk(nrhs>=3 && (nrhs%2)==1 && nlhs==0);
+        bool mapped = cache_.mapped;
+        for (int i=3; i<nrhs; i+=2) {
+            string key(rhs[i].toString());
+            if (key == "MemoryMap")
+                mapped = rhs[i+1].toBool();
+            else
+                mexErrMsgIdAndTxt("mexopencv:error",
+                    "Unrecognized option %s", key.c_str());
+        }
+        cache_.enabled = rhs[2].toBool();
+        cache_.mapped = mapped;
+        return;
+    }
+    else if (method == "getModelCache") {
+        nargchk(nrhs==2 && nlhs<=1);
+        const char *fields[] = {"type", "files", "bytes", "mapped",
+            "weights", "instances"};
+        MxArray s = MxArray::Struct(fields, 6, 1, cache_.models.size());
+        mwIndex i = 0;
+        for (map<string, Ptr<CachedModel> >::const_iterator it =
+             cache_.models.begin(); it != cache_.models.end(); ++it, ++i) {
+            const CachedModel &model = *(it->second);
+            vector<string> files(1, model.file1->filename());
+            size_t bytes = model.file1->size();
+            if (!model.file2.empty()) {
+                files.push_back(model.file2->filename());
+                bytes += model.file2->size();
+            }
+            int instances = 0;
+            for (map<int,NetSource>::const_iterator jt = source_.begin();
+                 jt != source_.end(); ++jt)
+                if (jt->second.model == it->second)
+                    ++instances;
+            s.set("type",      model.type, i);
+            s.set("files",     files, i);
+            s.set("bytes",     static_cast<double>(bytes), i);
+            s.set("mapped",    model.file1->mapped(), i);
+            s.set("weights",
+                static_cast<double>(weightsBytes(*model.weights)), i);
+            s.set("instances", instances, i);
+        }
+        plhs[0] = s;
+        return;
+    }
+    else if (method == "clearModelCache") {
+        nargchk(nrhs==2 && nlhs==0);
+        // networks sharing the weights keep their models alive
+        cache_.models.clear();
+        return;
+    }
     else if (method == "NMSBoxes") {
         nargchk(nrhs>=6 && (nrhs%2)==0 && nlhs<=1);
         float eta = 1.0f;
@@ -386,12 +1782,18 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
         return;
     }
 
+    // Registry queries, e.g. to report leaks
+    if (obj_.query(method, nlhs, plhs))
+        return;
+
     // Big operation switch
-    Ptr<Net> obj = obj_[id];
+    Ptr<Net> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
         nargchk(nrhs==2 && nlhs==0);
+        async_.erase(id);
+        source_.erase(id);
         obj_.erase(id);
         mexUnlock();
     }
@@ -495,17 +1897,140 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
             plhs[0] = MxArray(outputBlobs);
         }
     }
+    else if (method == "startAsync") {
+        nargchk(nrhs>=2 && (nrhs%2)==0 && nlhs==0);
+        AsyncOptions opts;
+        opts.depth = 0;
+        for (int i=2; i<nrhs; i+=2) {
+            string key(rhs[i].toString());
+            if (key == "Workers")
+                opts.workers = rhs[i+1].toInt();
+            else if (key == "QueueDepth")
+                opts.depth = rhs[i+1].toInt();
+            else if (key == "ShareWeights")
+                opts.share = rhs[i+1].toBool();
+            else if (key == "MaxBatchSize")
+                opts.maxBatchSize = rhs[i+1].toInt();
+            else if (key == "MaxWait")
+                opts.maxWait = rhs[i+1].toDouble();
+            else
+                mexErrMsgIdAndTxt("mexopencv:error",
+                    "Unrecognized option %s", key.c_str());
+        }
+        if (opts.workers < 1 || opts.depth < 0 || opts.maxBatchSize < 1 ||
+            opts.maxWait < 0)
+            mexErrMsgIdAndTxt("mexopencv:error", "Invalid pool options");
+        // by default, enough queued requests to fill a batch per worker
+        if (opts.depth == 0)
+            opts.depth = 2 * opts.workers * opts.maxBatchSize;
+        async_.erase(id);
+        async_[id] = makePtr<AsyncForward>(source_[id], opts);
+    }
+    else if (method == "stopAsync") {
+        nargchk(nrhs==2 && nlhs==0);
+        async_.erase(id);
+    }
+    else if (method == "forwardAsync") {
+        nargchk(nrhs>=3 && (nrhs%2)==1 && nlhs<=1);
+        AsyncRequest req;
+        req.multiple = false;
+        req.batchSize = 1;
+        vector<MxArray> blobOpts;
+        for (int i=3; i<nrhs; i+=2) {
+            string key(rhs[i].toString());
+            if (key == "OutputName") {
+                req.multiple = !rhs[i+1].isChar();
+                vector<string> names(req.multiple ?
+                    rhs[i+1].toVector<string>() :
+                    vector<string>(1, rhs[i+1].toString()));
+                req.outputNames.assign(names.begin(), names.end());
+            }
+            else {
+                blobOpts.push_back(rhs[i]);
+                blobOpts.push_back(rhs[i+1]);
+            }
+        }
+        req.opts = MxArrayToBlobOptions(blobOpts.begin(), blobOpts.end(),
+            true);
+        // images are converted to a blob on the workers
+        if (rhs[2].isCell())
+            req.images = MxArrayToBlobInput(rhs[2], req.opts.size, true);
+        else
+            req.blob = MxArrayToBlob(rhs[2]);
+        if (async_.find(id) == async_.end())
+            async_[id] = makePtr<AsyncForward>(source_[id],
+                AsyncOptions());
+        plhs[0] = MxArray(async_[id]->push(req));
+    }
+    else if (method == "poll" || method == "waitAll") {
+        nargchk(nrhs==2 && nlhs<=2);
+        map<int,Ptr<AsyncForward> >::iterator it = async_.find(id);
+        vector<AsyncRequest> reqs;
+        size_t pending = 0;
+        if (it != async_.end()) {
+            reqs = it->second->take(method == "waitAll");
+            pending = it->second->pending();
+        }
+        plhs[0] = toStruct(reqs);
+        if (nlhs > 1)
+            plhs[1] = MxArray(static_cast<int>(pending));
+    }
+    else if (method == "wait") {
+        nargchk(nrhs==3 && nlhs<=1);
+        vector<int> ids(rhs[2].toVector<int>());
+        map<int,Ptr<AsyncForward> >::iterator it = async_.find(id);
+        vector<AsyncRequest> reqs;
+        string err("Asynchronous forward not started");
+        if (it != async_.end())
+            err = it->second->take(ids, reqs);
+        else if (ids.empty())
+            err.clear();
+        if (!err.empty())
+            mexErrMsgIdAndTxt("mexopencv:error", "%s", err.c_str());
+        plhs[0] = toStruct(reqs);
+    }
+    else if (method == "getAsyncStats") {
+        nargchk(nrhs==2 && nlhs<=1);
+        map<int,Ptr<AsyncForward> >::iterator it = async_.find(id);
+        AsyncStats st = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+        if (it != async_.end())
+            st = it->second->stats();
+        const char *fields[9] = {"completed", "failed", "batches",
+            "meanBatchSize", "meanLatency", "maxLatency", "meanQueueTime",
+            "meanComputeTime", "throughput"};
+        MxArray s = MxArray::Struct(fields, 9);
+        s.set(fields[0], st.completed);
+        s.set(fields[1], st.failed);
+        s.set(fields[2], st.batches);
+        s.set(fields[3], st.meanBatchSize);
+        s.set(fields[4], st.meanLatency);
+        s.set(fields[5], st.maxLatency);
+        s.set(fields[6], st.meanQueueTime);
+        s.set(fields[7], st.meanComputeTime);
+        s.set(fields[8], st.throughput);
+        plhs[0] = s;
+    }
+    else if (method == "resetAsyncStats") {
+        nargchk(nrhs==2 && nlhs==0);
+        map<int,Ptr<AsyncForward> >::iterator it = async_.find(id);
+        if (it != async_.end())
+            it->second->resetStats();
+    }
     else if (method == "setHalideScheduler") {
         nargchk(nrhs==3 && nlhs==0);
         obj->setHalideScheduler(rhs[2].toString());
     }
     else if (method == "setPreferableBackend") {
         nargchk(nrhs==3 && nlhs==0);
-        obj->setPreferableBackend(BackendsMap[rhs[2].toString()]);
+        int backend = BackendsMap[rhs[2].toString()];
+        obj->setPreferableBackend(backend);
+        source_[id].backend = backend;
     }
     else if (method == "setPreferableTarget") {
         nargchk(nrhs==3 && nlhs==0);
-        obj->setPreferableTarget(TargetsMap[rhs[2].toString()]);
+        int target = TargetsMap[rhs[2].toString()];
+        obj->setPreferableTarget(target);
+        source_[id].target = target;
     }
     else if (method == "setInput") {
         nargchk((nrhs==3 || nrhs==4) && nlhs==0);
@@ -515,6 +2040,13 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
         else
             obj->setInput(blob);
     }
+    else if (method == "setInputFromImages") {
+        nargchk(nrhs>=3 && (nrhs%2)==1 && nlhs==0);
+        BlobOptions opts(
+            MxArrayToBlobOptions(rhs.begin() + 3, rhs.end(), true));
+        obj->setInput(blobFromInput(
+            MxArrayToBlobInput(rhs[2], opts.size), opts), opts.name);
+    }
     else if (method == "setParam") {
         nargchk(nrhs==5 && nlhs==0);
         Net::LayerId layer(MxArrayToLayerId(rhs[2]));
@@ -548,7 +2080,13 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     }
     else if (method == "enableFusion") {
         nargchk(nrhs==3 && nlhs==0);
-        obj->enableFusion(rhs[2].toBool());
+        bool fusion = rhs[2].toBool();
+        if (fusion && !source_[id].model.empty())
+            mexErrMsgIdAndTxt("mexopencv:error",
+                "Layers fusion cannot be enabled in networks sharing "
+                "cached weights");
+        obj->enableFusion(fusion);
+        source_[id].fusion = fusion;
     }
     else if (method == "getPerfProfile") {
         nargchk(nrhs==2 && nlhs<=2);
@@ -558,11 +2096,84 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
         if (nlhs > 1)
             plhs[1] = toMxArray(total);
     }
-    //TODO:
-    //else if (method == "getLayerShapes") {}
-    //else if (method == "getLayersShapes") {}
-    //else if (method == "getFLOPS") {}
-    //else if (method == "getMemoryConsumption") {}
+    else if (method == "getLayerShapes") {
+        nargchk(nrhs==4 && nlhs<=2);
+        vector<MatShape> netInputShapes(MxArrayToVectorMatShape(rhs[2]));
+        int layerId = MxArrayToLayerIndex(*obj, rhs[3]);
+        vector<MatShape> inLayerShapes, outLayerShapes;
+        obj->getLayerShapes(netInputShapes, layerId,
+            inLayerShapes, outLayerShapes);
+        plhs[0] = MxArray(inLayerShapes);
+        if (nlhs > 1)
+            plhs[1] = MxArray(outLayerShapes);
+    }
+    else if (method == "getLayersShapes") {
+        nargchk(nrhs==3 && nlhs<=3);
+        vector<MatShape> netInputShapes(MxArrayToVectorMatShape(rhs[2]));
+        vector<int> layersIds;
+        vector<vector<MatShape> > inLayersShapes, outLayersShapes;
+        obj->getLayersShapes(netInputShapes, layersIds,
+            inLayersShapes, outLayersShapes);
+        plhs[0] = MxArray(layersIds);
+        if (nlhs > 1)
+            plhs[1] = MxArray(inLayersShapes);
+        if (nlhs > 2)
+            plhs[2] = MxArray(outLayersShapes);
+    }
+    else if (method == "getFLOPS") {
+        nargchk(nrhs>=3 && (nrhs%2)==1 && nlhs<=1);
+        vector<MatShape> netInputShapes(MxArrayToVectorMatShape(rhs[2]));
+        int layerId = MxArrayToLayerOption(*obj, rhs.begin() + 3, rhs.end());
+        int64 flops = (layerId < 0) ? obj->getFLOPS(netInputShapes) :
+            obj->getFLOPS(layerId, netInputShapes);
+        plhs[0] = toMxArray(flops);
+    }
+    else if (method == "getMemoryConsumption") {
+        nargchk(nrhs>=3 && (nrhs%2)==1 && nlhs<=2);
+        vector<MatShape> netInputShapes(MxArrayToVectorMatShape(rhs[2]));
+        int layerId = MxArrayToLayerOption(*obj, rhs.begin() + 3, rhs.end());
+        size_t weights = 0, blobs = 0;
+        if (layerId < 0)
+            obj->getMemoryConsumption(netInputShapes, weights, blobs);
+        else
+            obj->getMemoryConsumption(layerId, netInputShapes,
+                weights, blobs);
+        plhs[0] = MxArray(static_cast<double>(weights));
+        if (nlhs > 1)
+            plhs[1] = MxArray(static_cast<double>(blobs));
+    }
+    else if (method == "profile") {
+        nargchk(nrhs>=3 && (nrhs%2)==1 && nlhs<=2);
+        int runs = 10;
+        string name;
+        vector<String> outNames;
+        for (int i=3; i<nrhs; i+=2) {
+            string key(rhs[i].toString());
+            if (key == "Runs")
+                runs = rhs[i+1].toInt();
+            else if (key == "Name")
+                name = rhs[i+1].toString();
+            else if (key == "OutputName") {
+                vector<string> names(rhs[i+1].isChar() ?
+                    vector<string>(1, rhs[i+1].toString()) :
+                    rhs[i+1].toVector<string>());
+                outNames.assign(names.begin(), names.end());
+            }
+            else
+                mexErrMsgIdAndTxt("mexopencv:error",
+                    "Unrecognized option %s", key.c_str());
+        }
+        if (runs < 1)
+            mexErrMsgIdAndTxt("mexopencv:error", "Invalid number of runs");
+        MatND blob(MxArrayToBlob(rhs[2]));
+        vector<MatShape> inShapes(1,
+            MatShape(blob.size.p, blob.size.p + blob.dims));
+        obj->setInput(blob, name);
+        MxArray totals(MxArray::Struct());
+        plhs[0] = profileNet(*obj, inShapes, outNames, runs, totals);
+        if (nlhs > 1)
+            plhs[1] = totals;
+    }
     else
         mexErrMsgIdAndTxt("mexopencv:error",
             "Unrecognized operation %s",method.c_str());
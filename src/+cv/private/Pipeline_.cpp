@@ -0,0 +1,720 @@
+/**
+ * @file Pipeline_.cpp
+ * @brief mex interface for cv.Pipeline, fused multi-stage image processing
+ * @ingroup imgproc
+ */
+#include "mexopencv_imgproc.hpp"
+#include "mexopencv_batch.hpp"
+using namespace std;
+using namespace cv;
+
+namespace {
+/// Target size in bytes of a row tile, so that a tile and the intermediate
+/// results computed from it stay in cache
+const size_t TILE_BYTES = 256 * 1024;
+
+/// Operation performed by a pipeline stage
+class Stage
+{
+  public:
+    /// Destructor
+    virtual ~Stage() {}
+    /** Apply the operation.
+     * @param src input image, or a band of full rows of it.
+     * @param dst output of the same number of rows (unless halo is -1).
+     */
+    virtual void apply(const Mat& src, Mat& dst) const = 0;
+    /** Context needed by the operation around each row.
+     * @return number of input rows above and below an output row it depends
+     *    on, or -1 if the operation must see the whole image (e.g. it
+     *    changes the image size or computes global statistics).
+     */
+    virtual int halo() const = 0;
+};
+
+/// Check the number of stage arguments, positional ones then name/value pairs
+void stagechk(const vector<MxArray>& args, size_t npos)
+{
+    nargchk(args.size() >= npos && ((args.size() - npos) % 2) == 0);
+}
+
+/// Half-size of a structuring element or kernel along the rows
+int kernelHalo(int ksize, int anchor)
+{
+    return (anchor < 0) ? ksize/2 : std::max(anchor, ksize - 1 - anchor);
+}
+
+/// cv::cvtColor stage
+class CvtColorStage : public Stage
+{
+  public:
+    explicit CvtColorStage(const vector<MxArray>& args)
+    : dstCn(0), spatial(false)
+    {
+        stagechk(args, 1);
+        const string name(args[0].toString());
+        code = ColorConv[name];
+        // demosaicing and planar YUV 4:2:0 conversions mix several rows
+        const char *geom[] = {"Bayer", "420", "NV12", "NV21", "YV12",
+            "IYUV", "I420"};
+        for (size_t i = 0; i < sizeof(geom)/sizeof(geom[0]); ++i)
+            spatial = spatial || (name.find(geom[i]) != string::npos);
+        for (size_t i = 1; i < args.size(); i += 2) {
+            string key(args[i].toString());
+            if (key == "DstCn")
+                dstCn = args[i+1].toInt();
+            else
+                mexErrMsgIdAndTxt("mexopencv:error",
+                    "Unrecognized option %s", key.c_str());
+        }
+    }
+    virtual void apply(const Mat& src, Mat& dst) const
+    {
+        const int depth = src.depth();
+        if (depth == CV_8U || depth == CV_16U || depth == CV_32F)
+            cvtColor(src, dst, code, dstCn);
+        else {
+            Mat tmp;
+            src.convertTo(tmp, CV_32F);
+            cvtColor(tmp, dst, code, dstCn);
+        }
+    }
+    virtual int halo() const { return (spatial ? -1 : 0); }
+  private:
+    int code;
+    int dstCn;
+    bool spatial;
+};
+
+/// cv::resize stage
+class ResizeStage : public Stage
+{
+  public:
+    explicit ResizeStage(const vector<MxArray>& args)
+    : fx(0), fy(0), interpolation(cv::INTER_LINEAR)
+    {
+        const bool scale_variant = (args.size() >= 2 &&
+            args[0].isNumeric() && args[0].numel() == 1 &&
+            args[1].isNumeric() && args[1].numel() == 1);
+        stagechk(args, scale_variant ? 2 : 1);
+        if (scale_variant) {
+            fx = args[0].toDouble();
+            fy = args[1].toDouble();
+        }
+        else
+            dsize = args[0].toSize();
+        for (size_t i = (scale_variant ? 2 : 1); i < args.size(); i += 2) {
+            string key(args[i].toString());
+            if (key == "Interpolation")
+                interpolation = InterpType[args[i+1].toString()];
+            else
+                mexErrMsgIdAndTxt("mexopencv:error",
+                    "Unrecognized option %s", key.c_str());
+        }
+    }
+    virtual void apply(const Mat& src, Mat& dst) const
+    {
+        resize(src, dst, dsize, fx, fy, interpolation);
+    }
+    virtual int halo() const { return -1; }
+  private:
+    Size dsize;
+    double fx;
+    double fy;
+    int interpolation;
+};
+
+/// cv::GaussianBlur stage
+class GaussianBlurStage : public Stage
+{
+  public:
+    explicit GaussianBlurStage(const vector<MxArray>& args)
+    : ksize(5,5), sigmaX(0), sigmaY(0), borderType(cv::BORDER_DEFAULT)
+    {
+        stagechk(args, 0);
+        for (size_t i = 0; i < args.size(); i += 2) {
+            string key(args[i].toString());
+            if (key == "KSize")
+                ksize = args[i+1].toSize();
+            else if (key == "SigmaX")
+                sigmaX = args[i+1].toDouble();
+            else if (key == "SigmaY")
+                sigmaY = args[i+1].toDouble();
+            else if (key == "BorderType")
+                borderType = BorderType[args[i+1].toString()];
+            else
+                mexErrMsgIdAndTxt("mexopencv:error",
+                    "Unrecognized option %s", key.c_str());
+        }
+    }
+    virtual void apply(const Mat& src, Mat& dst) const
+    {
+        GaussianBlur(src, dst, ksize, sigmaX, sigmaY, borderType);
+    }
+    virtual int halo() const
+    {
+        if (ksize.height > 0)
+            return ksize.height/2;
+        // kernel size derived from sigma (largest of the sizes OpenCV uses)
+        const double sigma = (sigmaY > 0) ? sigmaY : sigmaX;
+        return (cvRound(sigma*4*2 + 1) | 1)/2;
+    }
+  private:
+    Size ksize;
+    double sigmaX;
+    double sigmaY;
+    int borderType;
+};
+
+/// cv::blur stage
+class BlurStage : public Stage
+{
+  public:
+    explicit BlurStage(const vector<MxArray>& args)
+    : ksize(5,5), anchor(-1,-1), borderType(cv::BORDER_DEFAULT)
+    {
+        stagechk(args, 0);
+        for (size_t i = 0; i < args.size(); i += 2) {
+            string key(args[i].toString());
+            if (key == "KSize")
+                ksize = args[i+1].toSize();
+            else if (key == "Anchor")
+                anchor = args[i+1].toPoint();
+            else if (key == "BorderType")
+                borderType = BorderType[args[i+1].toString()];
+            else
+                mexErrMsgIdAndTxt("mexopencv:error",
+                    "Unrecognized option %s", key.c_str());
+        }
+    }
+    virtual void apply(const Mat& src, Mat& dst) const
+    {
+        blur(src, dst, ksize, anchor, borderType);
+    }
+    virtual int halo() const { return kernelHalo(ksize.height, anchor.y); }
+  private:
+    Size ksize;
+    Point anchor;
+    int borderType;
+};
+
+/// cv::medianBlur stage
+class MedianBlurStage : public Stage
+{
+  public:
+    explicit MedianBlurStage(const vector<MxArray>& args)
+    : ksize(5)
+    {
+        stagechk(args, 0);
+        for (size_t i = 0; i < args.size(); i += 2) {
+            string key(args[i].toString());
+            if (key == "KSize")
+                ksize = args[i+1].toInt();
+            else
+                mexErrMsgIdAndTxt("mexopencv:error",
+                    "Unrecognized option %s", key.c_str());
+        }
+    }
+    virtual void apply(const Mat& src, Mat& dst) const
+    {
+        medianBlur(src, dst, ksize);
+    }
+    virtual int halo() const { return ksize/2; }
+  private:
+    int ksize;
+};
+
+/// cv::threshold stage
+class ThresholdStage : public Stage
+{
+  public:
+    explicit ThresholdStage(const vector<MxArray>& args)
+    : thresh(0), maxval(255), type(cv::THRESH_BINARY), automatic(false)
+    {
+        stagechk(args, 1);
+        for (size_t i = 1; i < args.size(); i += 2) {
+            string key(args[i].toString());
+            if (key == "MaxValue")
+                maxval = args[i+1].toDouble();
+            else if (key == "Type")
+                type = ThreshType[args[i+1].toString()];
+            else
+                mexErrMsgIdAndTxt("mexopencv:error",
+                    "Unrecognized option %s", key.c_str());
+        }
+        if (args[0].isChar()) {
+            type |= AutoThresholdTypesMap[args[0].toString()];
+            automatic = true;
+        }
+        else
+            thresh = args[0].toDouble();
+    }
+    virtual void apply(const Mat& src, Mat& dst) const
+    {
+        threshold(src, dst, thresh, maxval, type);
+    }
+    // histogram-based thresholds need the whole image
+    virtual int halo() const { return (automatic ? -1 : 0); }
+  private:
+    double thresh;
+    double maxval;
+    int type;
+    bool automatic;
+};
+
+/// cv::morphologyEx stage (also used for cv::erode and cv::dilate)
+class MorphologyStage : public Stage
+{
+  public:
+    MorphologyStage(const vector<MxArray>& args, int op_ = -1)
+    : op(op_), anchor(-1,-1), iterations(1), borderType(cv::BORDER_CONSTANT),
+      borderValue(morphologyDefaultBorderValue())
+    {
+        const size_t npos = (op < 0) ? 1 : 0;
+        stagechk(args, npos);
+        if (op < 0)
+            op = MorphType[args[0].toString()];
+        for (size_t i = npos; i < args.size(); i += 2) {
+            string key(args[i].toString());
+            if (key == "Element")
+                kernel = args[i+1].toMat(
+                    op == cv::MORPH_HITMISS ? CV_32S : CV_8U);
+            else if (key == "Anchor")
+                anchor = args[i+1].toPoint();
+            else if (key == "Iterations")
+                iterations = args[i+1].toInt();
+            else if (key == "BorderType")
+                borderType = BorderType[args[i+1].toString()];
+            else if (key == "BorderValue")
+                borderValue = args[i+1].toScalar();
+            else
+                mexErrMsgIdAndTxt("mexopencv:error",
+                    "Unrecognized option %s", key.c_str());
+        }
+    }
+    virtual void apply(const Mat& src, Mat& dst) const
+    {
+        morphologyEx(src, dst, op, kernel, anchor, iterations,
+            borderType, borderValue);
+    }
+    virtual int halo() const
+    {
+        // an empty element stands for a 3x3 rectangle
+        const int r = kernelHalo(kernel.empty() ? 3 : kernel.rows, anchor.y) *
+            std::max(iterations, 1);
+        switch (op) {
+            case cv::MORPH_ERODE:
+            case cv::MORPH_DILATE:
+            case cv::MORPH_GRADIENT:
+                return r;
+            case cv::MORPH_OPEN:
+            case cv::MORPH_CLOSE:
+            case cv::MORPH_TOPHAT:
+            case cv::MORPH_BLACKHAT:
+                return 2*r;  // erosion followed by dilation or vice versa
+            default:
+                return -1;
+        }
+    }
+  private:
+    int op;
+    Mat kernel;
+    Point anchor;
+    int iterations;
+    int borderType;
+    Scalar borderValue;
+};
+
+/// cv::Canny stage
+class CannyStage : public Stage
+{
+  public:
+    explicit CannyStage(const vector<MxArray>& args)
+    : threshold1(0), threshold2(0), apertureSize(3), L2gradient(false)
+    {
+        stagechk(args, 1);
+        for (size_t i = 1; i < args.size(); i += 2) {
+            string key(args[i].toString());
+            if (key == "ApertureSize")
+                apertureSize = args[i+1].toInt();
+            else if (key == "L2Gradient")
+                L2gradient = args[i+1].toBool();
+            else
+                mexErrMsgIdAndTxt("mexopencv:error",
+                    "Unrecognized option %s", key.c_str());
+        }
+        if (args[0].numel() == 2) {
+            Scalar s(args[0].toScalar());
+            threshold1 = s[0];
+            threshold2 = s[1];
+        }
+        else {
+            threshold2 = args[0].toDouble();
+            threshold1 = 0.4 * threshold2;
+        }
+    }
+    virtual void apply(const Mat& src, Mat& dst) const
+    {
+        if (src.depth() == CV_8U)
+            Canny(src, dst, threshold1, threshold2, apertureSize, L2gradient);
+        else {
+            Mat tmp;
+            src.convertTo(tmp, CV_8U);
+            Canny(tmp, dst, threshold1, threshold2, apertureSize, L2gradient);
+        }
+    }
+    // hysteresis tracking propagates edges across the whole image
+    virtual int halo() const { return -1; }
+  private:
+    double threshold1;
+    double threshold2;
+    int apertureSize;
+    bool L2gradient;
+};
+
+/** Create a pipeline stage from its MATLAB description.
+ * @param op name of the operation, same as the corresponding function.
+ * @param args arguments of the function, without the input image.
+ * @return smart pointer to the created stage.
+ */
+Ptr<Stage> createStage(const string& op, const vector<MxArray>& args)
+{
+    Ptr<Stage> p;
+    if (op == "cvtColor")
+        p = makePtr<CvtColorStage>(args);
+    else if (op == "resize")
+        p = makePtr<ResizeStage>(args);
+    else if (op == "GaussianBlur")
+        p = makePtr<GaussianBlurStage>(args);
+    else if (op == "blur")
+        p = makePtr<BlurStage>(args);
+    else if (op == "medianBlur")
+        p = makePtr<MedianBlurStage>(args);
+    else if (op == "threshold")
+        p = makePtr<ThresholdStage>(args);
+    else if (op == "morphologyEx")
+        p = makePtr<MorphologyStage>(args);
+    else if (op == "erode")
+        p = makePtr<MorphologyStage>(args, int(cv::MORPH_ERODE));
+    else if (op == "dilate")
+        p = makePtr<MorphologyStage>(args, int(cv::MORPH_DILATE));
+    else if (op == "Canny")
+        p = makePtr<CannyStage>(args);
+    else
+        mexErrMsgIdAndTxt("mexopencv:error",
+            "Unrecognized operation %s", op.c_str());
+    return p;
+}
+
+/// First error raised by the bodies of a parallel loop
+class LoopError
+{
+  public:
+    /// Record an error message, unless one was already recorded
+    void set(const string& msg)
+    {
+        cv::AutoLock lock(mtx_);
+        if (msg_.empty())
+            msg_ = msg;
+    }
+    /// Recorded error message, empty if none
+    const string& message() const { return msg_; }
+  private:
+    cv::Mutex mtx_;
+    string msg_;
+};
+
+/// Parallel loop body running a group of tileable stages on row tiles
+class TiledGroupInvoker : public cv::ParallelLoopBody
+{
+  public:
+    /// Constructor
+    TiledGroupInvoker(const vector<Ptr<Stage> >& stages, size_t first,
+        size_t last, int halo, int tileRows, const Mat& src, Mat& dst,
+        LoopError& err)
+    : stages_(stages), first_(first), last_(last), halo_(halo),
+      tileRows_(tileRows), src_(src), dst_(dst), err_(err)
+    {}
+    /// Number of tiles
+    int size() const { return (src_.rows + tileRows_ - 1) / tileRows_; }
+    /** Run the stages on a tile.
+     * @param t tile index.
+     * @param buf intermediate tile buffers, reused from one tile to the next.
+     * @return rows of the result belonging to the tile.
+     */
+    Mat tile(int t, vector<Mat>& buf) const
+    {
+        const int r0 = t*tileRows_, r1 = std::min(r0 + tileRows_, src_.rows),
+            i0 = std::max(r0 - halo_, 0),
+            i1 = std::min(r1 + halo_, src_.rows);
+        // rows of context are computed along with the tile, then discarded
+        Mat cur(src_.rowRange(i0, i1));
+        for (size_t k = first_; k < last_; ++k) {
+            Mat& out = buf[(k - first_) % 2];
+            stages_[k]->apply(cur, out);
+            CV_Assert(out.rows == i1 - i0);
+            cur = out;
+        }
+        return cur.rowRange(r0 - i0, r1 - i0);
+    }
+    /// Process a range of tiles
+    virtual void operator()(const cv::Range& range) const
+    {
+        try {
+            vector<Mat> buf(2);
+            for (int t = range.start; t < range.end; ++t) {
+                const Mat rows(tile(t, buf));
+                rows.copyTo(dst_.rowRange(t*tileRows_,
+                    t*tileRows_ + rows.rows));
+            }
+        }
+        catch (const std::exception& e) {
+            err_.set(e.what());
+        }
+        catch (...) {
+            err_.set("Unknown error in pipeline stage");
+        }
+    }
+  private:
+    const vector<Ptr<Stage> >& stages_;
+    size_t first_;
+    size_t last_;
+    int halo_;
+    int tileRows_;
+    const Mat& src_;
+    Mat& dst_;
+    LoopError& err_;
+};
+
+/// Chain of image processing operations executed in a single call
+class Pipeline
+{
+  public:
+    /// Constructor
+    Pipeline() : tileRows(0) {}
+
+    /** Append a stage.
+     * @param op name of the operation.
+     * @param args arguments of the operation.
+     */
+    void add(const string& op, const vector<MxArray>& args)
+    {
+        stages_.push_back(createStage(op, args));
+        names_.push_back(op);
+    }
+
+    /// Remove all stages
+    void clear()
+    {
+        stages_.clear();
+        names_.clear();
+    }
+
+    /// Names of the operations, in order
+    const vector<string>& names() const { return names_; }
+
+    /** Run all stages on an image.
+     * @param src input image.
+     * @param dst output image, must not share data with \p src.
+     *
+     * Consecutive stages that only need a few rows of context are fused and
+     * run tile by tile in parallel, so that intermediate results stay in
+     * cache. Other stages run on the whole image. Full-size intermediate
+     * images are kept between calls and reused when their size matches.
+     * Can be called concurrently from several threads, and does not call
+     * any MEX API function.
+     */
+    void run(const Mat& src, Mat& dst)
+    {
+        if (stages_.empty()) {
+            src.copyTo(dst);
+            return;
+        }
+        Ptr<vector<Mat> > ws(acquire());
+        const Mat *cur = &src;
+        size_t i = 0, k = 0;
+        while (i < stages_.size()) {
+            // group of consecutive tileable stages, or a single other stage
+            size_t j = i + 1;
+            int halo = stages_[i]->halo();
+            if (halo >= 0)
+                for (; j < stages_.size() && stages_[j]->halo() >= 0; ++j)
+                    halo += stages_[j]->halo();
+            Mat& out = (j == stages_.size()) ? dst : (*ws)[k++ % 2];
+            if (halo < 0)
+                stages_[i]->apply(*cur, out);
+            else
+                runTiled(i, j, halo, *cur, out);
+            cur = &out;
+            i = j;
+        }
+        release(ws);
+    }
+
+    /// Rows per tile, 0 to derive it from the image width
+    int tileRows;
+
+  private:
+    /// Run a group of tileable stages
+    void runTiled(size_t first, size_t last, int halo, const Mat& src,
+        Mat& dst) const
+    {
+        int rows = tileRows;
+        if (rows <= 0) {
+            const size_t rowBytes = std::max<size_t>(
+                src.cols * src.elemSize(), 1);
+            rows = static_cast<int>(std::max<size_t>(
+                TILE_BYTES / rowBytes, 8));
+        }
+        // keep the recomputed context small compared to the tile itself
+        rows = std::max(rows, 2*halo);
+        LoopError err;
+        TiledGroupInvoker body(stages_, first, last, halo, rows, src, dst,
+            err);
+        vector<Mat> buf(2);
+        const Mat head(body.tile(0, buf));
+        dst.create(src.rows, head.cols, head.type());
+        head.copyTo(dst.rowRange(0, head.rows));
+        if (body.size() > 1) {
+            // cv::error throws in the bodies, on all threads, and the first
+            // error is raised once the loop is over
+            ErrorCallbackSuspender suspender;
+            cv::parallel_for_(cv::Range(1, body.size()), body);
+        }
+        if (!err.message().empty())
+            CV_Error(cv::Error::StsError, err.message());
+    }
+
+    /// Get a set of intermediate buffers from the pool
+    Ptr<vector<Mat> > acquire()
+    {
+        cv::AutoLock lock(mtx_);
+        if (pool_.empty())
+            return makePtr<vector<Mat> >(2);
+        Ptr<vector<Mat> > ws(pool_.back());
+        pool_.pop_back();
+        return ws;
+    }
+
+    /// Return a set of intermediate buffers to the pool
+    void release(const Ptr<vector<Mat> >& ws)
+    {
+        cv::AutoLock lock(mtx_);
+        pool_.push_back(ws);
+    }
+
+    /// stages, in order
+    vector<Ptr<Stage> > stages_;
+    /// names of the stages operations
+    vector<string> names_;
+    /// intermediate buffers, one set per concurrent run
+    vector<Ptr<vector<Mat> > > pool_;
+    /// mutex guarding the pool
+    cv::Mutex mtx_;
+};
+
+/// Batch operation running a pipeline on each image
+class PipelineOperation : public BatchOperation
+{
+  public:
+    /// Constructor
+    explicit PipelineOperation(Pipeline& p) : p_(p) {}
+    virtual void operator()(const Mat& src, Mat& dst) const
+    {
+        p_.run(src, dst);
+    }
+  private:
+    Pipeline& p_;
+};
+
+// Persistent objects
+/// Object container
+ObjectRegistry<Pipeline> obj_;
+}
+
+/**
+ * Main entry called from Matlab
+ * @param nlhs number of left-hand-side arguments
+ * @param plhs pointers to mxArrays in the left-hand-side
+ * @param nrhs number of right-hand-side arguments
+ * @param prhs pointers to mxArrays in the right-hand-side
+ */
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+    // Check the number of arguments
+    nargchk(nrhs>=2 && nlhs<=1);
+
+    // Argument vector
+    vector<MxArray> rhs(prhs, prhs+nrhs);
+    int id = rhs[0].toInt();
+    string method(rhs[1].toString());
+
+    // Constructor is called. Create a new object from argument
+    if (method == "new") {
+        nargchk(nrhs==2 && nlhs<=1);
+        plhs[0] = MxArray(obj_.add(makePtr<Pipeline>()));
+        mexLock();
+        return;
+    }
+
+    // Registry queries, e.g. to report leaks
+    if (obj_.query(method, nlhs, plhs))
+        return;
+
+    // Big operation switch
+    Ptr<Pipeline> obj = obj_.get(id);
+    if (obj.empty())
+        mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
+    if (method == "delete") {
+        nargchk(nrhs==2 && nlhs==0);
+        obj_.erase(id);
+        mexUnlock();
+    }
+    else if (method == "add") {
+        nargchk(nrhs>=3 && nlhs==0);
+        obj->add(rhs[2].toString(), vector<MxArray>(rhs.begin()+3, rhs.end()));
+    }
+    else if (method == "clear") {
+        nargchk(nrhs==2 && nlhs==0);
+        obj->clear();
+    }
+    else if (method == "stages") {
+        nargchk(nrhs==2 && nlhs<=1);
+        plhs[0] = MxArray(obj->names());
+    }
+    else if (method == "apply") {
+        nargchk(nrhs==3 && nlhs<=1);
+        if (isBatch(rhs[2])) {
+            // cell array or HxWxCxN stack of frames, output of the same kind
+            plhs[0] = processBatch(rhs[2], PipelineOperation(*obj));
+        }
+        else {
+            Mat dst;
+            obj->run(rhs[2].toMat(), dst);
+            plhs[0] = MxArray(dst);
+        }
+    }
+    else if (method == "get") {
+        nargchk(nrhs==3 && nlhs<=1);
+        string prop(rhs[2].toString());
+        if (prop == "TileRows")
+            plhs[0] = MxArray(obj->tileRows);
+        else if (prop == "NumStages")
+            plhs[0] = MxArray(static_cast<int>(obj->names().size()));
+        else
+            mexErrMsgIdAndTxt("mexopencv:error",
+                "Unrecognized property %s", prop.c_str());
+    }
+    else if (method == "set") {
+        nargchk(nrhs==4 && nlhs==0);
+        string prop(rhs[2].toString());
+        if (prop == "TileRows")
+            obj->tileRows = rhs[3].toInt();
+        else
+            mexErrMsgIdAndTxt("mexopencv:error",
+                "Unrecognized property %s", prop.c_str());
+    }
+    else
+        mexErrMsgIdAndTxt("mexopencv:error",
+            "Unrecognized operation %s", method.c_str());
+}
@@ -15,10 +15,8 @@ using namespace cv::detail;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<RotationWarper> > obj_;
+ObjectRegistry<RotationWarper> obj_;
 }
 
 /**
@@ -41,15 +39,18 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     // Constructor is called. Create a new object from argument
     if (method == "new") {
         nargchk(nrhs>=4 && nlhs<=1);
-        obj_[++last_id] = createRotationWarper(
-            rhs[2].toString(), rhs.begin() + 4, rhs.end(), rhs[3].toFloat());
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(createRotationWarper(
+            rhs[2].toString(), rhs.begin() + 4, rhs.end(), rhs[3].toFloat())));
         mexLock();
         return;
     }
 
+    // Registry queries, e.g. to report leaks
+    if (obj_.query(method, nlhs, plhs))
+        return;
+
     // Big operation switch
-    Ptr<RotationWarper> obj = obj_[id];
+    Ptr<RotationWarper> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
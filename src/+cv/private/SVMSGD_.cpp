@@ -14,10 +14,8 @@ using namespace cv::ml;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<SVMSGD> > obj_;
+ObjectRegistry<SVMSGD> obj_;
 
 /// Option values for margin types
 const ConstMap<string,int> MarginTypeMap = ConstMap<string,int>
@@ -60,14 +58,17 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     // Constructor is called. Create a new object from argument
     if (method == "new") {
         nargchk(nrhs==2 && nlhs<=1);
-        obj_[++last_id] = SVMSGD::create();
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(SVMSGD::create()));
         mexLock();
         return;
     }
 
+    // Registry queries, e.g. to report leaks
+    if (obj_.query(method, nlhs, plhs))
+        return;
+
     // Big operation switch
-    Ptr<SVMSGD> obj = obj_[id];
+    Ptr<SVMSGD> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
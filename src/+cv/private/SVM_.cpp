@@ -14,10 +14,8 @@ using namespace cv::ml;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<SVM> > obj_;
+ObjectRegistry<SVM> obj_;
 
 /// Option values for SVM types
 const ConstMap<string,int> SVMType = ConstMap<string,int>
@@ -196,14 +194,17 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     // Constructor is called. Create a new object from argument
     if (method == "new") {
         nargchk(nrhs==2 && nlhs<=1);
-        obj_[++last_id] = SVM::create();
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(SVM::create()));
         mexLock();
         return;
     }
 
+    // Registry queries, e.g. to report leaks
+    if (obj_.query(method, nlhs, plhs))
+        return;
+
     // Big operation switch
-    Ptr<SVM> obj = obj_[id];
+    Ptr<SVM> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
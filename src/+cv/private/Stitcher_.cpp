@@ -14,10 +14,8 @@ using namespace cv::detail;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<Stitcher> > obj_;
+ObjectRegistry<Stitcher> obj_;
 
 /// compositing resolution types
 const ConstMap<string, int> ComposeResolMap = ConstMap<string, int>
@@ -61,14 +59,17 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                 mexErrMsgIdAndTxt("mexopencv:error",
                     "Unrecognized option %s", key.c_str());
         }
-        obj_[++last_id] = Stitcher::create(mode, try_use_gpu);
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(Stitcher::create(mode, try_use_gpu)));
         mexLock();
         return;
     }
 
+    // Registry queries, e.g. to report leaks
+    if (obj_.query(method, nlhs, plhs))
+        return;
+
     // Big operation switch
-    Ptr<Stitcher> obj = obj_[id];
+    Ptr<Stitcher> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
@@ -12,10 +12,8 @@ using namespace cv;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<Subdiv2D> > obj_;
+ObjectRegistry<Subdiv2D> obj_;
 
 /// edge types for option processing
 const ConstMap<string,int> EdgeTypeMap = ConstMap<string,int>
@@ -57,15 +55,18 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     // Constructor is called. Create a new object from argument
     if (method == "new") {
         nargchk((nrhs==2 || nrhs==3) && nlhs<=1);
-        obj_[++last_id] = (nrhs == 3) ?
-            makePtr<Subdiv2D>(rhs[2].toRect()) : makePtr<Subdiv2D>();
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add((nrhs == 3) ?
+            makePtr<Subdiv2D>(rhs[2].toRect()) : makePtr<Subdiv2D>()));
         mexLock();
         return;
     }
 
+    // Registry queries, e.g. to report leaks
+    if (obj_.query(method, nlhs, plhs))
+        return;
+
     // Big operation switch
-    Ptr<Subdiv2D> obj = obj_[id];
+    Ptr<Subdiv2D> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
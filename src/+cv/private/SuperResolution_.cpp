@@ -16,10 +16,8 @@ using namespace cv::superres;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<SuperResolution> > obj_;
+ObjectRegistry<SuperResolution> obj_;
 
 /** Create an instance of FrameSource using options in arguments
  * @param type frame source type, one of:
@@ -367,14 +365,17 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     // constructor call
     if (method == "new") {
         nargchk(nrhs==3 && nlhs<=1);
-        obj_[++last_id] = createSuperResolution(rhs[2].toString());
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(createSuperResolution(rhs[2].toString())));
         mexLock();
         return;
     }
 
+    // Registry queries, e.g. to report leaks
+    if (obj_.query(method, nlhs, plhs))
+        return;
+
     // Big operation switch
-    Ptr<SuperResolution> obj = obj_[id];
+    Ptr<SuperResolution> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
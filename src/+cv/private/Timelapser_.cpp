@@ -15,10 +15,8 @@ using namespace cv::detail;
 
 // Persistent objects
 namespace {
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<Timelapser> > obj_;
+ObjectRegistry<Timelapser> obj_;
 
 /// time lapser types
 const ConstMap<std::string, int> TimelapserTypesMap = ConstMap<std::string, int>
@@ -47,14 +45,18 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     if (method == "new") {
         nargchk(nrhs==3 && nlhs<=1);
         string type(rhs[2].toString());
-        obj_[++last_id] = Timelapser::createDefault(TimelapserTypesMap[type]);
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(Timelapser::createDefault(
+            TimelapserTypesMap[type])));
         mexLock();
         return;
     }
 
+    // Registry queries, e.g. to report leaks
+    if (obj_.query(method, nlhs, plhs))
+        return;
+
     // Big operation switch
-    Ptr<Timelapser> obj = obj_[id];
+    Ptr<Timelapser> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
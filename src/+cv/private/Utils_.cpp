@@ -15,6 +15,9 @@ using namespace cv;
 #include "opencv2/core/cuda.hpp"
 
 namespace {
+/// whether this MEX-file was locked after enabling the buffer pool
+bool poolLocked = false;
+
 /** Convert size type to MxArray.
  * @param i value.
  * @return MxArray object, a scalar uint64 array.
@@ -553,6 +556,103 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
         tegra::setUseTegra(rhs[1].toBool());
 #endif
     }
+    else if (method == "useBufferPool") {
+        nargchk(nrhs==1 && nlhs<=1);
+        plhs[0] = MxArray(MatBufferPool::installed());
+    }
+    else if (method == "setUseBufferPool") {
+        nargchk(nrhs==2 && nlhs==0);
+        const bool enable = rhs[1].toBool();
+        if (enable && !poolLocked) {
+            // pooled buffers point back to the allocator in this MEX-file,
+            // so it must never be unloaded once the pool has been used
+            mexLock();
+            poolLocked = true;
+        }
+        MatBufferPool::install(enable);
+    }
+    else if (method == "getBufferPoolStats") {
+        nargchk(nrhs==1 && nlhs<=1);
+        MatBufferPool::Stats st = MatBufferPool::stats();
+        const char *fields[7] = {"hits", "misses", "bypassed", "released",
+            "bytesInUse", "bytesReserved", "maxReservedSize"};
+        MxArray s = MxArray::Struct(fields, 7);
+        s.set(fields[0], toMxArray(st.hits));
+        s.set(fields[1], toMxArray(st.misses));
+        s.set(fields[2], toMxArray(st.bypassed));
+        s.set(fields[3], toMxArray(st.released));
+        s.set(fields[4], toMxArray(st.bytesInUse));
+        s.set(fields[5], toMxArray(st.bytesReserved));
+        s.set(fields[6], toMxArray(st.maxReservedSize));
+        plhs[0] = s;
+    }
+    else if (method == "resetBufferPoolStats") {
+        nargchk(nrhs==1 && nlhs==0);
+        MatBufferPool::resetStats();
+    }
+    else if (method == "setBufferPoolMaxReservedSize") {
+        nargchk(nrhs==2 && nlhs==0);
+        MatBufferPool::setMaxReservedSize(
+            static_cast<size_t>(rhs[1].toDouble()));
+    }
+    else if (method == "freeAllReservedBuffers") {
+        nargchk(nrhs==1 && nlhs==0);
+        MatBufferPool::freeAllReservedBuffers();
+    }
+    else if (method == "useProfile") {
+        nargchk(nrhs==1 && nlhs<=1);
+        plhs[0] = MxArray(Profiler::enabled());
+    }
+    else if (method == "setUseProfile") {
+        nargchk(nrhs==2 && nlhs==0);
+        Profiler::enable(rhs[1].toBool());
+    }
+    else if (method == "getProfile") {
+        nargchk(nrhs==1 && nlhs<=1);
+        map<string, Profiler::Entry> entries(Profiler::entries());
+        const char *fields[10] = {"name", "calls", "total", "parse",
+            "input", "kernel", "output", "bytesIn", "bytesOut",
+            "maxCallBytes"};
+        MxArray s = MxArray::Struct(fields, 10, 1, entries.size());
+        mwIndex i = 0;
+        for (map<string, Profiler::Entry>::const_iterator it =
+             entries.begin(); it != entries.end(); ++it, ++i) {
+            const Profiler::Entry& e = it->second;
+            s.set(fields[0], it->first, i);
+            s.set(fields[1], toMxArray(e.calls), i);
+            s.set(fields[2], e.total, i);
+            s.set(fields[3], e.parse, i);
+            s.set(fields[4], e.input, i);
+            s.set(fields[5], e.kernel, i);
+            s.set(fields[6], e.output, i);
+            s.set(fields[7], toMxArray(e.bytesIn), i);
+            s.set(fields[8], toMxArray(e.bytesOut), i);
+            s.set(fields[9], toMxArray(e.maxCallBytes), i);
+        }
+        plhs[0] = s;
+    }
+    else if (method == "resetProfile") {
+        nargchk(nrhs==1 && nlhs==0);
+        Profiler::reset();
+    }
+    else if (method == "recordProfile") {
+        nargchk(nrhs==3 && nlhs==0);
+        const string name(rhs[1].toString());
+        const vector<double> v(rhs[2].toVector<double>());
+        if (v.size() != 9)
+            mexErrMsgIdAndTxt("mexopencv:error", "Invalid profile counters");
+        Profiler::Entry e;
+        e.calls = static_cast<size_t>(v[0]);
+        e.total = v[1];
+        e.parse = v[2];
+        e.input = v[3];
+        e.kernel = v[4];
+        e.output = v[5];
+        e.bytesIn = static_cast<size_t>(v[6]);
+        e.bytesOut = static_cast<size_t>(v[7]);
+        e.maxCallBytes = static_cast<size_t>(v[8]);
+        Profiler::record(name, e);
+    }
     else
         mexErrMsgIdAndTxt("mexopencv:error",
             "Unrecognized operation %s", method.c_str());
@@ -7,15 +7,19 @@
  */
 #include "mexopencv.hpp"
 #include "opencv2/videoio.hpp"
+#ifdef CV_CXX11
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#endif
 using namespace std;
 using namespace cv;
 
 namespace {
 // Persistent objects
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<VideoCapture> > obj_;
+ObjectRegistry<VideoCapture> obj_;
 
 /// Capture Property map for option processing
 const ConstMap<string,int> CapProp = ConstMap<string,int>
@@ -95,6 +99,256 @@ const ConstMap<string,int> CameraApiMap = ConstMap<string,int>
     ("Aravis",          cv::CAP_ARAVIS)
     ("MotionJPEG",      cv::CAP_OPENCV_MJPEG)
     ("MediaSDK",        cv::CAP_INTEL_MFX);
+
+/// Frame decoded ahead of time by a FramePrefetcher
+struct PrefetchedFrame
+{
+    /// frame data in MATLAB memory layout (see MxArray::toColumnMajor)
+    Mat data;
+    /// capture position (msec) right after decoding the frame
+    double posMsec;
+    /// capture position (frames) right after decoding the frame
+    double posFrames;
+    /// capture relative position right after decoding the frame
+    double posAviRatio;
+};
+
+#ifdef CV_CXX11
+/** Background frame decoder.
+ *
+ * A worker thread reads frames from the capture and converts them to MATLAB
+ * memory layout, keeping at most a given number of them in a queue. The
+ * worker never calls the MEX API; creating the output mxArray (a plain
+ * memory copy) is left to the MATLAB thread.
+ */
+class FramePrefetcher
+{
+public:
+    /** Start decoding in the background.
+     * @param cap opened capture, shared with the worker thread.
+     * @param capacity maximum number of frames decoded ahead.
+     */
+    FramePrefetcher(const Ptr<VideoCapture>& cap, int capacity)
+    :   cap_(cap), capacity_(std::max(capacity, 1)),
+        stopping_(false), finished_(false)
+    {
+        last_.posMsec = cap_->get(cv::CAP_PROP_POS_MSEC);
+        last_.posFrames = cap_->get(cv::CAP_PROP_POS_FRAMES);
+        last_.posAviRatio = cap_->get(cv::CAP_PROP_POS_AVI_RATIO);
+        worker_ = std::thread(&FramePrefetcher::run, this);
+    }
+
+    /// Stop the worker thread, discarding decoded frames
+    ~FramePrefetcher()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            stopping_ = true;
+        }
+        notFull_.notify_all();
+        if (worker_.joinable())
+            worker_.join();
+    }
+
+    /// Maximum number of frames decoded ahead
+    int capacity() const { return capacity_; }
+
+    /** Take the next decoded frame, waiting for it if necessary.
+     * @return false at the end of the stream, in which case last() holds
+     *    an empty frame.
+     */
+    bool next()
+    {
+        string err;
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            while (queue_.empty() && !finished_)
+                notEmpty_.wait(lock);
+            if (!queue_.empty()) {
+                last_ = queue_.front();
+                queue_.pop_front();
+                notFull_.notify_one();
+                return true;
+            }
+            last_.data.release();
+            err = error_;
+        }
+        // raise outside the lock, mexErrMsgIdAndTxt does not return
+        if (!err.empty())
+            mexErrMsgIdAndTxt("mexopencv:error", "%s", err.c_str());
+        return false;
+    }
+
+    /// Last frame taken by next()
+    const PrefetchedFrame& last() const { return last_; }
+
+    /** Query a capture property while the worker is running.
+     * @param propId property identifier.
+     * @return property value. Position properties describe the last frame
+     *    taken by next() rather than the worker position.
+     */
+    double get(int propId)
+    {
+        switch (propId) {
+            case cv::CAP_PROP_POS_MSEC: return last_.posMsec;
+            case cv::CAP_PROP_POS_FRAMES: return last_.posFrames;
+            case cv::CAP_PROP_POS_AVI_RATIO: return last_.posAviRatio;
+        }
+        std::lock_guard<std::mutex> lock(capMtx_);
+        return cap_->get(propId);
+    }
+
+private:
+    /// Worker thread body
+    void run()
+    {
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mtx_);
+                while (queue_.size() >= static_cast<size_t>(capacity_) &&
+                        !stopping_)
+                    notFull_.wait(lock);
+                if (stopping_)
+                    return;
+            }
+            PrefetchedFrame frame;
+            bool ok = false;
+            string err;
+            // errors are reported by next() on the MATLAB thread, cv::error
+            // throws here since MexErrorHandler only raises on that thread
+            try {
+                Mat image;
+                {
+                    std::lock_guard<std::mutex> lock(capMtx_);
+                    ok = cap_->read(image) && !image.empty();
+                    if (ok) {
+                        frame.posMsec = cap_->get(cv::CAP_PROP_POS_MSEC);
+                        frame.posFrames = cap_->get(cv::CAP_PROP_POS_FRAMES);
+                        frame.posAviRatio = cap_->get(cv::CAP_PROP_POS_AVI_RATIO);
+                    }
+                }
+                if (ok)
+                    frame.data = MxArray::toColumnMajor(image);
+            }
+            catch (const std::exception& e) {
+                ok = false;
+                err = e.what();
+            }
+            catch (...) {
+                // an exception leaving the thread would terminate MATLAB
+                ok = false;
+                err = "Unknown error while decoding a frame";
+            }
+            {
+                std::lock_guard<std::mutex> lock(mtx_);
+                if (ok)
+                    queue_.push_back(frame);
+                else {
+                    finished_ = true;
+                    error_ = err;
+                }
+            }
+            notEmpty_.notify_one();
+            if (!ok)
+                return;
+        }
+    }
+
+    /// capture object
+    Ptr<VideoCapture> cap_;
+    /// maximum queue length
+    int capacity_;
+    /// decoded frames not yet taken
+    std::deque<PrefetchedFrame> queue_;
+    /// last frame taken
+    PrefetchedFrame last_;
+    /// set to ask the worker to exit
+    bool stopping_;
+    /// set by the worker at the end of the stream or on error
+    bool finished_;
+    /// error message of a failed read
+    string error_;
+    /// guards the queue and flags
+    std::mutex mtx_;
+    /// guards the capture object
+    std::mutex capMtx_;
+    /// signaled when a frame is queued or the stream ends
+    std::condition_variable notEmpty_;
+    /// signaled when a frame is taken or on stop
+    std::condition_variable notFull_;
+    /// worker thread
+    std::thread worker_;
+};
+#else
+/// Stub used when C++11 threads are not available
+class FramePrefetcher
+{
+public:
+    FramePrefetcher(const Ptr<VideoCapture>&, int)
+    {
+        mexErrMsgIdAndTxt("mexopencv:error",
+            "Prefetch requires a C++11 compiler");
+    }
+    int capacity() const { return 0; }
+    bool next() { return false; }
+    const PrefetchedFrame& last() const { return last_; }
+    double get(int) { return 0; }
+private:
+    PrefetchedFrame last_;
+};
+#endif
+
+/// Background decoders of objects opened with the Prefetch option
+map<int,Ptr<FramePrefetcher> > prefetch_;
+
+/** Set a capture property, taking care of background decoding.
+ * @param id object id.
+ * @param obj capture object.
+ * @param propId property identifier.
+ * @param value new property value.
+ * @return true on success.
+ *
+ * When prefetching, frames decoded ahead are discarded and decoding resumes
+ * with the new setting, from the last frame handed out unless a position
+ * property is being set.
+ */
+bool setProperty(int id, const Ptr<VideoCapture>& obj, int propId,
+    double value)
+{
+    int prefetch = 0;
+    map<int,Ptr<FramePrefetcher> >::iterator it = prefetch_.find(id);
+    if (it != prefetch_.end()) {
+        prefetch = it->second->capacity();
+        const double posFrames = it->second->last().posFrames;
+        prefetch_.erase(it);
+        if (propId != cv::CAP_PROP_POS_MSEC &&
+            propId != cv::CAP_PROP_POS_FRAMES &&
+            propId != cv::CAP_PROP_POS_AVI_RATIO)
+            obj->set(cv::CAP_PROP_POS_FRAMES, posFrames);
+    }
+    bool success = obj->set(propId, value);
+    if (prefetch > 0)
+        prefetch_[id] = makePtr<FramePrefetcher>(obj, prefetch);
+    return success;
+}
+
+/** Copy a frame in MATLAB layout to its destination.
+ * @param frame frame data as returned by MxArray::toColumnMajor.
+ * @param dst destination buffer.
+ * @param flip whether to reverse the order of 3 color channels.
+ */
+void copyFrame(const Mat& frame, uchar *dst, bool flip)
+{
+    const size_t cn = frame.size[0],
+        plane = frame.total() * frame.elemSize() / cn;
+    if (flip && cn == 3) {
+        for (size_t i = 0; i < cn; ++i)
+            std::copy(frame.data + (cn-1-i)*plane,
+                frame.data + (cn-i)*plane, dst + i*plane);
+    }
+    else
+        std::copy(frame.data, frame.data + cn*plane, dst);
+}
 }
 
 /**
@@ -117,36 +371,48 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     // Constructor is called. Create a new object from arguments
     if (method == "new") {
         nargchk(nrhs==2 && nlhs<=1);
-        obj_[++last_id] = makePtr<VideoCapture>();
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(makePtr<VideoCapture>()));
         mexLock();
         return;
     }
 
+    // Registry queries, e.g. to report leaks
+    if (obj_.query(method, nlhs, plhs))
+        return;
+
     // Big operation switch
-    Ptr<VideoCapture> obj = obj_[id];
+    Ptr<VideoCapture> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
         nargchk(nrhs==2 && nlhs==0);
+        prefetch_.erase(id);
         obj_.erase(id);
         mexUnlock();
     }
     else if (method == "open") {
         nargchk(nrhs>=3 && (nrhs%2)==1 && nlhs<=1);
         int pref = cv::CAP_ANY;
+        int prefetch = 0;
         for (int i=3; i<nrhs; i+=2) {
             string key(rhs[i].toString());
             if (key == "API")
                 pref = CameraApiMap[rhs[i+1].toString()];
+            else if (key == "Prefetch")
+                prefetch = rhs[i+1].toInt();
             else
                 mexErrMsgIdAndTxt("mexopencv:error",
                     "Unrecognized option %s", key.c_str());
         }
+        if (prefetch < 0)
+            mexErrMsgIdAndTxt("mexopencv:error", "Invalid Prefetch value");
+        prefetch_.erase(id);
         // index should be within 0-99, and pref is multiples of 100
         bool b = (rhs[2].isChar()) ?
             obj->open(rhs[2].toString(), pref) :
             obj->open(rhs[2].toInt() + pref);
+        if (b && prefetch > 0)
+            prefetch_[id] = makePtr<FramePrefetcher>(obj, prefetch);
         plhs[0] = MxArray(b);
     }
     else if (method == "isOpened") {
@@ -156,11 +422,13 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     }
     else if (method == "release") {
         nargchk(nrhs==2 && nlhs==0);
+        prefetch_.erase(id);
         obj->release();
     }
     else if (method == "grab") {
         nargchk(nrhs==2 && nlhs<=1);
-        bool b = obj->grab();
+        map<int,Ptr<FramePrefetcher> >::iterator it = prefetch_.find(id);
+        bool b = (it != prefetch_.end()) ? it->second->next() : obj->grab();
         plhs[0] = MxArray(b);
     }
     else if (method == "retrieve") {
@@ -177,6 +445,14 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                 mexErrMsgIdAndTxt("mexopencv:error",
                     "Unrecognized option %s", key.c_str());
         }
+        map<int,Ptr<FramePrefetcher> >::iterator it = prefetch_.find(id);
+        if (it != prefetch_.end()) {
+            if (idx != 0)
+                mexErrMsgIdAndTxt("mexopencv:error",
+                    "StreamIdx is not supported with Prefetch");
+            plhs[0] = MxArray::fromColumnMajor(it->second->last().data, flip);
+            return;
+        }
         Mat image;
         bool b = obj->retrieve(image, idx);
         if (b && flip && image.channels()==3)
@@ -194,17 +470,118 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                 mexErrMsgIdAndTxt("mexopencv:error",
                     "Unrecognized option %s", key.c_str());
         }
+        map<int,Ptr<FramePrefetcher> >::iterator it = prefetch_.find(id);
+        if (it != prefetch_.end()) {
+            it->second->next();
+            plhs[0] = MxArray::fromColumnMajor(it->second->last().data, flip);
+            return;
+        }
         Mat image;
         bool b = obj->read(image);
         if (b && flip && image.channels()==3)
             cvtColor(image, image, cv::COLOR_BGR2RGB);
         plhs[0] = MxArray(b ? image : Mat());
     }
+    else if (method == "readBatch") {
+        nargchk(nrhs>=3 && (nrhs%2)==1 && nlhs<=1);
+        int stride = 1;
+        Range range = Range::all();
+        bool flip = true;
+        for (int i=3; i<nrhs; i+=2) {
+            string key(rhs[i].toString());
+            if (key == "Stride")
+                stride = rhs[i+1].toInt();
+            else if (key == "Range")
+                range = rhs[i+1].toRange();
+            else if (key == "FlipChannels")
+                flip = rhs[i+1].toBool();
+            else
+                mexErrMsgIdAndTxt("mexopencv:error",
+                    "Unrecognized option %s", key.c_str());
+        }
+        int n = rhs[2].toInt();
+        if (n < 0 || stride < 1)
+            mexErrMsgIdAndTxt("mexopencv:error", "Invalid arguments");
+        if (range != Range::all()) {
+            if (range.start < 0 || range.end < range.start)
+                mexErrMsgIdAndTxt("mexopencv:error", "Invalid range value");
+            setProperty(id, obj, cv::CAP_PROP_POS_FRAMES, range.start);
+            n = std::min(n, (range.size() + stride - 1) / stride);
+        }
+        map<int,Ptr<FramePrefetcher> >::iterator it = prefetch_.find(id);
+        FramePrefetcher *p = (it != prefetch_.end()) ? it->second.get() : NULL;
+        // output is allocated once the first frame gives its size,
+        // then every frame is converted straight into its slice
+        mxArray *batch = NULL;
+        vector<mwSize> dims;
+        int depth = -1, count = 0;
+        size_t frameBytes = 0;
+        Mat frame;
+        while (count < n) {
+            // skipped frames are only grabbed, not decoded
+            bool ok = true;
+            for (int k=1; k<stride && count>0 && ok; ++k)
+                ok = (p) ? p->next() : obj->grab();
+            if (ok)
+                ok = (p) ? p->next() : (obj->read(frame) && !frame.empty());
+            if (!ok)
+                break;
+            const Mat& data = (p) ? p->last().data : frame;
+            vector<mwSize> d(3);
+            if (p) {
+                d[0] = data.size[2]; d[1] = data.size[1]; d[2] = data.size[0];
+            }
+            else {
+                d[0] = data.rows; d[1] = data.cols; d[2] = data.channels();
+            }
+            if (!batch) {
+                dims = d;
+                dims.push_back(n);
+                depth = data.depth();
+                frameBytes = d[0] * d[1] * d[2] * CV_ELEM_SIZE1(depth);
+                batch = MxArray::Numeric(dims, depth);
+            }
+            else if (!std::equal(d.begin(), d.end(), dims.begin()) ||
+                data.depth() != depth)
+                mexErrMsgIdAndTxt("mexopencv:error",
+                    "Frame %d has a different size or type", count);
+            uchar *dst = static_cast<uchar*>(mxGetData(batch)) +
+                count * frameBytes;
+            if (p)
+                copyFrame(data, dst, flip);
+            else {
+                const int sz[3] = {static_cast<int>(d[2]),
+                    static_cast<int>(d[1]), static_cast<int>(d[0])};
+                Mat slice(3, sz, depth, dst);
+                MxArray::toColumnMajor(data, slice);
+                if (flip && d[2] == 3) {
+                    const size_t plane = frameBytes / 3;
+                    std::swap_ranges(dst, dst + plane, dst + 2*plane);
+                }
+            }
+            ++count;
+        }
+        if (!batch)
+            plhs[0] = MxArray(Mat());
+        else {
+            // drop the slices left unused at the end of the stream, and
+            // give their memory back (mxSetDimensions frees nothing)
+            if (count < n) {
+                dims.back() = count;
+                mxSetDimensions(batch, &dims[0], dims.size());
+                mxSetData(batch, mxRealloc(mxGetData(batch),
+                    count * frameBytes));
+            }
+            plhs[0] = batch;
+        }
+    }
     else if (method == "get") {
         nargchk(nrhs==3 && nlhs<=1);
         int propId = (rhs[2].isChar()) ?
             CapProp[rhs[2].toString()] : rhs[2].toInt();
-        double value = obj->get(propId);
+        map<int,Ptr<FramePrefetcher> >::iterator it = prefetch_.find(id);
+        double value = (it != prefetch_.end()) ?
+            it->second->get(propId) : obj->get(propId);
         plhs[0] = MxArray(value);
     }
     else if (method == "set") {
@@ -212,7 +589,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
         int propId = (rhs[2].isChar()) ?
             CapProp[rhs[2].toString()] : rhs[2].toInt();
         double value = rhs[3].toDouble();
-        bool success = obj->set(propId, value);
+        bool success = setProperty(id, obj, propId, value);
         if (!success)
             mexWarnMsgIdAndTxt("mexopencv:error",
                 "Error setting property %d", propId);
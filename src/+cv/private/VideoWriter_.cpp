@@ -7,15 +7,19 @@
  */
 #include "mexopencv.hpp"
 #include "opencv2/videoio.hpp"
+#ifdef CV_CXX11
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#endif
 using namespace std;
 using namespace cv;
 
 namespace {
 // Persistent objects
-/// Last object id to allocate
-int last_id = 0;
 /// Object container
-map<int,Ptr<VideoWriter> > obj_;
+ObjectRegistry<VideoWriter> obj_;
 
 /// API backends map for option processing
 const ConstMap<string,int> ApiPreferenceMap = ConstMap<string,int>
@@ -60,6 +64,314 @@ const ConstMap<string,int> PamFormatMap = ConstMap<string,int>
     ("RGB",            cv::IMWRITE_PAM_FORMAT_RGB)
     ("RGBA",           cv::IMWRITE_PAM_FORMAT_RGB_ALPHA);
 
+/// Policies applied when writing to a full encoding queue
+enum BackpressurePolicy {
+    BACKPRESSURE_BLOCK,        //!< wait for a slot to become available
+    BACKPRESSURE_DROP_OLDEST,  //!< discard the oldest queued frame
+    BACKPRESSURE_ERROR         //!< raise an error
+};
+
+/// Backpressure policies map for option processing
+const ConstMap<string,int> BackpressureMap = ConstMap<string,int>
+    ("Block",      BACKPRESSURE_BLOCK)
+    ("DropOldest", BACKPRESSURE_DROP_OLDEST)
+    ("Error",      BACKPRESSURE_ERROR);
+
+/// Counters of an asynchronous encoding queue
+struct EncoderStats
+{
+    /// frames accepted by write
+    double queued;
+    /// frames discarded by the DropOldest policy
+    double dropped;
+    /// frames written to the video
+    double encoded;
+    /// frames waiting in the queue
+    double pending;
+    /// duration (msec) of the last cv::VideoWriter::write call
+    double lastEncodeTime;
+    /// mean duration (msec) of cv::VideoWriter::write calls
+    double meanEncodeTime;
+    /// longest duration (msec) of a cv::VideoWriter::write call
+    double maxEncodeTime;
+    /// mean time (msec) from write to the end of encoding, queueing included
+    double meanLatency;
+};
+
+#ifdef CV_CXX11
+/** Background frame encoder.
+ *
+ * Frames converted from MATLAB on the calling thread are queued, and a
+ * worker thread performs the color conversion and encoding. The worker never
+ * calls the MEX API; errors it encounters are reported by the next call on
+ * the MATLAB thread.
+ */
+class FrameEncoder
+{
+public:
+    /** Start the worker thread.
+     * @param writer opened video writer, shared with the worker thread.
+     * @param capacity maximum number of queued frames.
+     * @param policy BackpressurePolicy applied when the queue is full.
+     */
+    FrameEncoder(const Ptr<VideoWriter>& writer, int capacity, int policy)
+    :   writer_(writer), capacity_(std::max(capacity, 1)), policy_(policy),
+        stopping_(false), busy_(false), lost_(0)
+    {
+        resetStats();
+        worker_ = std::thread(&FrameEncoder::run, this);
+    }
+
+    /// Stop the worker thread once queued frames are encoded
+    ~FrameEncoder()
+    {
+        string err;
+        stop(err);
+    }
+
+    /** Stop the worker thread once queued frames are encoded.
+     * @param err output, error message of a failed write, empty if none.
+     * @return number of frames not written because of the error, the
+     *    frame whose write failed included.
+     */
+    int stop(string& err)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            while ((!queue_.empty() || busy_) && error_.empty())
+                idle_.wait(lock);
+            stopping_ = true;
+        }
+        notEmpty_.notify_all();
+        if (worker_.joinable())
+            worker_.join();
+        err = error_;
+        return lost_;
+    }
+
+    /** Queue a frame for encoding.
+     * @param frame frame in MATLAB channel order when \p flip is set.
+     * @param flip whether to convert 3-channel frames from RGB to BGR.
+     */
+    void push(const Mat& frame, bool flip)
+    {
+        string err;
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            if (error_.empty() && queue_.size() >= static_cast<size_t>(capacity_)) {
+                if (policy_ == BACKPRESSURE_BLOCK) {
+                    while (queue_.size() >= static_cast<size_t>(capacity_) &&
+                            error_.empty())
+                        notFull_.wait(lock);
+                }
+                else if (policy_ == BACKPRESSURE_DROP_OLDEST) {
+                    queue_.pop_front();
+                    stats_.dropped++;
+                }
+                else
+                    err = "Encoding queue is full";
+            }
+            if (!error_.empty())
+                err = error_;
+            if (err.empty()) {
+                QueuedFrame f = {frame, flip, cv::getTickCount()};
+                queue_.push_back(f);
+                stats_.queued++;
+            }
+        }
+        // raise outside the lock, mexErrMsgIdAndTxt does not return
+        if (!err.empty())
+            mexErrMsgIdAndTxt("mexopencv:error", "%s", err.c_str());
+        notEmpty_.notify_one();
+    }
+
+    /// Wait until all queued frames are encoded
+    void flush()
+    {
+        string err;
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            while ((!queue_.empty() || busy_) && error_.empty())
+                idle_.wait(lock);
+            err = error_;
+        }
+        if (!err.empty())
+            mexErrMsgIdAndTxt("mexopencv:error", "%s", err.c_str());
+    }
+
+    /// Current counters
+    EncoderStats stats()
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        EncoderStats st = stats_;
+        st.pending = static_cast<double>(queue_.size());
+        if (st.encoded > 0) {
+            st.meanEncodeTime /= st.encoded;
+            st.meanLatency /= st.encoded;
+        }
+        return st;
+    }
+
+    /// Reset counters
+    void resetStats()
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        stats_.queued = stats_.dropped = stats_.encoded = stats_.pending = 0;
+        stats_.lastEncodeTime = stats_.meanEncodeTime = 0;
+        stats_.maxEncodeTime = stats_.meanLatency = 0;
+    }
+
+    /** Query a writer property while the worker is running.
+     * @param propId property identifier.
+     * @return property value.
+     */
+    double get(int propId)
+    {
+        std::lock_guard<std::mutex> lock(writerMtx_);
+        return writer_->get(propId);
+    }
+
+private:
+    /// Frame waiting to be encoded
+    struct QueuedFrame
+    {
+        /// frame data
+        Mat data;
+        /// whether to convert from RGB to BGR
+        bool flip;
+        /// tick count when queued
+        int64 ticks;
+    };
+
+    /// Worker thread body
+    void run()
+    {
+        for (;;) {
+            QueuedFrame f;
+            {
+                std::unique_lock<std::mutex> lock(mtx_);
+                while (queue_.empty() && !stopping_)
+                    notEmpty_.wait(lock);
+                if (queue_.empty())
+                    return;
+                f = queue_.front();
+                queue_.pop_front();
+                busy_ = true;
+            }
+            notFull_.notify_one();
+            string err;
+            const int64 start = cv::getTickCount();
+            try {
+                if (f.flip && f.data.channels() == 3)
+                    cvtColor(f.data, f.data, cv::COLOR_RGB2BGR);
+                std::lock_guard<std::mutex> lock(writerMtx_);
+                writer_->write(f.data);
+            }
+            catch (const std::exception& e) {
+                err = e.what();
+            }
+            catch (...) {
+                // an exception leaving the thread would terminate MATLAB
+                err = "Unknown error while encoding a frame";
+            }
+            const int64 end = cv::getTickCount();
+            {
+                std::lock_guard<std::mutex> lock(mtx_);
+                busy_ = false;
+                if (err.empty()) {
+                    const double msec = 1000.0 / cv::getTickFrequency();
+                    const double t = (end - start) * msec;
+                    stats_.encoded++;
+                    stats_.lastEncodeTime = t;
+                    stats_.meanEncodeTime += t;
+                    stats_.maxEncodeTime = std::max(stats_.maxEncodeTime, t);
+                    stats_.meanLatency += (end - f.ticks) * msec;
+                }
+                else {
+                    // keep the first error, later frames are discarded
+                    if (error_.empty())
+                        error_ = err;
+                    lost_ += 1 + static_cast<int>(queue_.size());
+                    queue_.clear();
+                }
+            }
+            idle_.notify_all();
+            notFull_.notify_all();
+        }
+    }
+
+    /// video writer
+    Ptr<VideoWriter> writer_;
+    /// maximum queue length
+    int capacity_;
+    /// backpressure policy
+    int policy_;
+    /// frames waiting to be encoded
+    std::deque<QueuedFrame> queue_;
+    /// counters, with sums in place of means
+    EncoderStats stats_;
+    /// set to ask the worker to exit
+    bool stopping_;
+    /// set while the worker encodes a frame
+    bool busy_;
+    /// error message of a failed write
+    string error_;
+    /// frames not written because of the error
+    int lost_;
+    /// guards the queue, counters and flags
+    std::mutex mtx_;
+    /// guards the video writer
+    std::mutex writerMtx_;
+    /// signaled when a frame is queued or on stop
+    std::condition_variable notEmpty_;
+    /// signaled when a frame is taken from the queue
+    std::condition_variable notFull_;
+    /// signaled when a frame is done
+    std::condition_variable idle_;
+    /// worker thread
+    std::thread worker_;
+};
+#else
+/// Stub used when C++11 threads are not available
+class FrameEncoder
+{
+public:
+    FrameEncoder(const Ptr<VideoWriter>&, int, int)
+    {
+        mexErrMsgIdAndTxt("mexopencv:error",
+            "QueueSize requires a C++11 compiler");
+    }
+    void push(const Mat&, bool) {}
+    void flush() {}
+    int stop(string&) { return 0; }
+    EncoderStats stats() { return EncoderStats(); }
+    void resetStats() {}
+    double get(int) { return 0; }
+};
+#endif
+
+/// Background encoders of objects opened with the QueueSize option
+map<int,Ptr<FrameEncoder> > encoder_;
+
+/** Stop the background encoder of an object, if any.
+ * @param id object id.
+ * @return error message of a failed write, along with the number of frames
+ *    that were not written, empty if none.
+ */
+string stopEncoder(int id)
+{
+    map<int,Ptr<FrameEncoder> >::iterator it = encoder_.find(id);
+    if (it == encoder_.end())
+        return string();
+    string err;
+    const int lost = it->second->stop(err);
+    encoder_.erase(it);
+    if (err.empty())
+        return err;
+    return cv::format("%s\n%d frame(s) were not written to the video",
+        err.c_str(), lost);
+}
+
 /// Option arguments parser used by constructor and open method
 struct OptionsParser
 {
@@ -71,6 +383,10 @@ struct OptionsParser
     double fps;
     /// Flag to indicate whether to expect color or grayscale frames.
     bool isColor;
+    /// Length of the asynchronous encoding queue, 0 to encode synchronously.
+    int queueSize;
+    /// Policy applied when the encoding queue is full.
+    int backpressure;
 
     /** Parse input arguments.
      * @param first iterator at the beginning of the arguments vector.
@@ -81,7 +397,9 @@ struct OptionsParser
         : apiPreference(cv::CAP_ANY),
           fourcc(CV_FOURCC('M','J','P','G')),
           fps(25),
-          isColor(true)
+          isColor(true),
+          queueSize(0),
+          backpressure(BACKPRESSURE_BLOCK)
     {
         nargchk((std::distance(first, last) % 2) == 0);
         for (; first != last; first += 2) {
@@ -101,6 +419,10 @@ struct OptionsParser
                 fps = val.toDouble();
             else if (key == "Color")
                 isColor = val.toBool();
+            else if (key == "QueueSize")
+                queueSize = val.toInt();
+            else if (key == "Backpressure")
+                backpressure = BackpressureMap[val.toString()];
             else
                 mexErrMsgIdAndTxt("mexopencv:error",
                     "Unrecognized option %s", key.c_str());
@@ -218,28 +540,42 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     // Constructor is called. Create a new object from arguments
     if (method == "new") {
         nargchk(nrhs==2 && nlhs<=1);
-        obj_[++last_id] = makePtr<VideoWriter>();
-        plhs[0] = MxArray(last_id);
+        plhs[0] = MxArray(obj_.add(makePtr<VideoWriter>()));
         mexLock();
         return;
     }
 
+    // Registry queries, e.g. to report leaks
+    if (obj_.query(method, nlhs, plhs))
+        return;
+
     // Big operation switch
-    Ptr<VideoWriter> obj = obj_[id];
+    Ptr<VideoWriter> obj = obj_.get(id);
     if (obj.empty())
         mexErrMsgIdAndTxt("mexopencv:error", "Object not found id=%d", id);
     if (method == "delete") {
         nargchk(nrhs==2 && nlhs==0);
+        string err(stopEncoder(id));
         obj_.erase(id);
         mexUnlock();
+        if (!err.empty())
+            mexWarnMsgIdAndTxt("mexopencv:error", "%s", err.c_str());
     }
     else if (method == "open") {
         nargchk(nrhs>=4 && nlhs<=1);
         string filename(rhs[2].toString());
         Size frameSize(rhs[3].toSize());
         OptionsParser opts(rhs.begin() + 4, rhs.end());
+        if (opts.queueSize < 0)
+            mexErrMsgIdAndTxt("mexopencv:error", "Invalid QueueSize value");
+        string err(stopEncoder(id));
+        if (!err.empty())
+            mexWarnMsgIdAndTxt("mexopencv:error", "%s", err.c_str());
         bool b = obj->open(filename, opts.apiPreference,
             opts.fourcc, opts.fps, frameSize, opts.isColor);
+        if (b && opts.queueSize > 0)
+            encoder_[id] = makePtr<FrameEncoder>(obj, opts.queueSize,
+                opts.backpressure);
         plhs[0] = MxArray(b);
     }
     else if (method == "isOpened") {
@@ -249,7 +585,11 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     }
     else if (method == "release") {
         nargchk(nrhs==2 && nlhs==0);
+        string err(stopEncoder(id));
         obj->release();
+        // raised once the file is closed
+        if (!err.empty())
+            mexErrMsgIdAndTxt("mexopencv:error", "%s", err.c_str());
     }
     else if (method == "write") {
         nargchk(nrhs>=3 && (nrhs%2)==1 && nlhs==0);
@@ -263,6 +603,11 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                     "Unrecognized option %s", key.c_str());
         }
         Mat frame(rhs[2].toMat());
+        map<int,Ptr<FrameEncoder> >::iterator it = encoder_.find(id);
+        if (it != encoder_.end()) {
+            it->second->push(frame, flip);
+            return;
+        }
         if (flip && frame.channels() == 3)
             cvtColor(frame, frame, cv::COLOR_RGB2BGR);
         obj->write(frame);
@@ -271,13 +616,51 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
         nargchk(nrhs==3 && nlhs<=1);
         int propId = (rhs[2].isChar()) ?
             VidWriterProp[rhs[2].toString()] : rhs[2].toInt();
-        double value = obj->get(propId);
+        map<int,Ptr<FrameEncoder> >::iterator it = encoder_.find(id);
+        double value = (it != encoder_.end()) ?
+            it->second->get(propId) : obj->get(propId);
         plhs[0] = MxArray(value);
     }
+    else if (method == "flush") {
+        nargchk(nrhs==2 && nlhs==0);
+        map<int,Ptr<FrameEncoder> >::iterator it = encoder_.find(id);
+        if (it != encoder_.end())
+            it->second->flush();
+    }
+    else if (method == "getQueueStats") {
+        nargchk(nrhs==2 && nlhs<=1);
+        map<int,Ptr<FrameEncoder> >::iterator it = encoder_.find(id);
+        EncoderStats st = {0, 0, 0, 0, 0, 0, 0, 0};
+        if (it != encoder_.end())
+            st = it->second->stats();
+        const char *fields[8] = {"queued", "dropped", "encoded", "pending",
+            "lastEncodeTime", "meanEncodeTime", "maxEncodeTime",
+            "meanLatency"};
+        MxArray s = MxArray::Struct(fields, 8);
+        s.set(fields[0], st.queued);
+        s.set(fields[1], st.dropped);
+        s.set(fields[2], st.encoded);
+        s.set(fields[3], st.pending);
+        s.set(fields[4], st.lastEncodeTime);
+        s.set(fields[5], st.meanEncodeTime);
+        s.set(fields[6], st.maxEncodeTime);
+        s.set(fields[7], st.meanLatency);
+        plhs[0] = s;
+    }
+    else if (method == "resetQueueStats") {
+        nargchk(nrhs==2 && nlhs==0);
+        map<int,Ptr<FrameEncoder> >::iterator it = encoder_.find(id);
+        if (it != encoder_.end())
+            it->second->resetStats();
+    }
     else if (method == "set") {
         nargchk(nrhs==4 && nlhs==0);
         int propId = (rhs[2].isChar()) ?
             VidWriterProp[rhs[2].toString()] : rhs[2].toInt();
+        // properties apply to frames written after this call
+        map<int,Ptr<FrameEncoder> >::iterator it = encoder_.find(id);
+        if (it != encoder_.end())
+            it->second->flush();
         if (propId == cv::CAP_PROP_IMAGES_BASE) {
             vector<MxArray> args(rhs[3].toVector<MxArray>());
             ImwriteOptionsParser opts(args.begin(), args.end());
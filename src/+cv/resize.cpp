@@ -6,10 +6,32 @@
  * @date 2012
  */
 #include "mexopencv.hpp"
+#include "mexopencv_batch.hpp"
 #include "opencv2/imgproc.hpp"
 using namespace std;
 using namespace cv;
 
+namespace {
+/// Batch operation for cv::resize
+class ResizeOperation : public BatchOperation
+{
+  public:
+    /// Constructor
+    ResizeOperation(const Size& dsize, double fx, double fy, int interpolation)
+    : dsize_(dsize), fx_(fx), fy_(fy), interpolation_(interpolation)
+    {}
+    virtual void operator()(const Mat& src, Mat& dst) const
+    {
+        resize(src, dst, dsize_, fx_, fy_, interpolation_);
+    }
+  private:
+    Size dsize_;
+    double fx_;
+    double fy_;
+    int interpolation_;
+};
+}
+
 /**
  * Main entry called from Matlab
  * @param nlhs number of left-hand-side arguments
@@ -19,6 +41,8 @@ using namespace cv;
  */
 void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 {
+    ProfileCall prof;
+
     // Check the number of arguments
     nargchk(nrhs>=2 && nlhs<=1);
 
@@ -53,7 +77,15 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
         dsize = rhs[1].toSize();
 
     // Process
+    prof.phase(Profiler::KERNEL);
+    if (isBatch(rhs[0])) {
+        // cell array or HxWxCxN stack of images, processed in parallel
+        plhs[0] = processBatch(rhs[0],
+            ResizeOperation(dsize, fx, fy, interpolation));
+        return;
+    }
     Mat src(rhs[0].toMat()), dst;
     resize(src, dst, dsize, fx, fy, interpolation);
+    prof.phase(Profiler::OUTPUT);
     plhs[0] = MxArray(dst);
 }
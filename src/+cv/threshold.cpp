@@ -5,18 +5,10 @@
  * @author Kota Yamaguchi
  * @date 2012
  */
-#include "mexopencv.hpp"
-#include "opencv2/imgproc.hpp"
+#include "mexopencv_imgproc.hpp"
 using namespace std;
 using namespace cv;
 
-namespace {
-/// automatic threshold type for option processing
-const ConstMap<string,int> AutoThresholdTypesMap = ConstMap<string,int>
-    ("Otsu",     cv::THRESH_OTSU)
-    ("Triangle", cv::THRESH_TRIANGLE);
-}
-
 /**
  * Main entry called from Matlab
  * @param nlhs number of left-hand-side arguments
@@ -26,6 +18,8 @@ const ConstMap<string,int> AutoThresholdTypesMap = ConstMap<string,int>
  */
 void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 {
+    ProfileCall prof;
+
     // Check the number of arguments
     nargchk(nrhs>=2 && (nrhs%2)==0 && nlhs<=2);
 
@@ -54,10 +48,24 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
         thresh = rhs[1].toDouble();
 
     // Process
-    Mat src(rhs[0].toMat()),  // 8u, 16s, 16u, 32f, 64f
-        dst;
-    thresh = threshold(src, dst, thresh, maxval, type);
-    plhs[0] = MxArray(dst);
+    prof.phase(Profiler::KERNEL);
+    if (isElementwiseView(rhs[0])) {
+        // zero-copy: compute directly into the output MATLAB array
+        // (histogram-based thresholds are insensitive to the transposed view)
+        MxArray out(MxArray::Numeric(
+            rhs[0].rows(), rhs[0].cols(), rhs[0].classID()));
+        Mat dst(out.toMatView());
+        thresh = threshold(rhs[0].toMatView(), dst, thresh, maxval, type);
+        prof.phase(Profiler::OUTPUT);
+        plhs[0] = out;
+    }
+    else {
+        Mat src(rhs[0].toMat()),  // 8u, 16s, 16u, 32f, 64f
+            dst;
+        thresh = threshold(src, dst, thresh, maxval, type);
+        prof.phase(Profiler::OUTPUT);
+        plhs[0] = MxArray(dst);
+    }
     if (nlhs>1)
         plhs[1] = MxArray(thresh);
 }
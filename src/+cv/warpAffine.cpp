@@ -6,10 +6,35 @@
  * @date 2012
  */
 #include "mexopencv.hpp"
+#include "mexopencv_batch.hpp"
 #include "opencv2/imgproc.hpp"
 using namespace std;
 using namespace cv;
 
+namespace {
+/// Batch operation for cv::warpAffine
+class WarpAffineOperation : public BatchOperation
+{
+  public:
+    /// Constructor
+    WarpAffineOperation(const Mat& M, const Size& dsize, int flags,
+        int borderMode, const Scalar& borderValue)
+    : M_(M), dsize_(dsize), flags_(flags), borderMode_(borderMode),
+      borderValue_(borderValue)
+    {}
+    virtual void operator()(const Mat& src, Mat& dst) const
+    {
+        warpAffine(src, dst, M_, dsize_, flags_, borderMode_, borderValue_);
+    }
+  private:
+    Mat M_;
+    Size dsize_;
+    int flags_;
+    int borderMode_;
+    Scalar borderValue_;
+};
+}
+
 /**
  * Main entry called from Matlab
  * @param nlhs number of left-hand-side arguments
@@ -55,6 +80,15 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
         dsize = dst.size();
 
     // Process
+    if (isBatch(rhs[0])) {
+        // cell array or HxWxCxN stack of images, processed in parallel
+        if (!dst.empty())
+            mexErrMsgIdAndTxt("mexopencv:error",
+                "Dst is not supported with a batch of images");
+        plhs[0] = processBatch(rhs[0], WarpAffineOperation(
+            rhs[1].toMat(CV_64F), dsize, flags, borderMode, borderValue));
+        return;
+    }
     Mat src(rhs[0].toMat()),
         M(rhs[1].toMat(CV_64F));
     warpAffine(src, dst, M, dsize, flags, borderMode, borderValue);
@@ -4,9 +4,40 @@
  * @date 2012
  */
 #include "MxArray.hpp"
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
 
 namespace {
 
+#ifdef _WIN32
+/// Identifier of a thread
+typedef DWORD ThreadId;
+/// Identifier of the calling thread
+inline ThreadId currentThread() { return GetCurrentThreadId(); }
+/// Compare thread identifiers
+inline bool equalThreads(ThreadId a, ThreadId b) { return a == b; }
+#else
+/// Identifier of a thread
+typedef pthread_t ThreadId;
+/// Identifier of the calling thread
+inline ThreadId currentThread() { return pthread_self(); }
+/// Compare thread identifiers
+inline bool equalThreads(ThreadId a, ThreadId b)
+{
+    return pthread_equal(a, b) != 0;
+}
+#endif
+
+/// MATLAB thread, MEX-files are loaded (and called) from it
+const ThreadId matlabThread = currentThread();
+
 /// Field names for cv::Moments.
 const char *cv_moments_fields[24] = {
     "m00", "m10", "m01", "m20", "m11", "m02","m30", "m21", "m12", "m03",
@@ -23,6 +54,32 @@ const char *cv_keypoint_fields[6] = {"pt", "size", "angle", "response",
 const char *cv_dmatch_fields[4] = {"queryIdx", "trainIdx", "imgIdx",
                                    "distance"};
 
+/// Records the time of a conversion in the profile, when enabled
+class ProfileConversion
+{
+public:
+    /** Start timing a conversion
+     * @param input direction of the conversion (see
+     *   Profiler::recordConversion).
+     * @param bytes size of the source data.
+     */
+    ProfileConversion(bool input, size_t bytes)
+    :   input_(input), bytes_(bytes),
+        start_(Profiler::recording() ? cv::getTickCount() : 0)
+    {}
+    /// Record the conversion, if a call was profiled at its start
+    ~ProfileConversion()
+    {
+        if (start_ != 0)
+            Profiler::recordConversion(input_, bytes_,
+                cv::getTickCount() - start_);
+    }
+private:
+    bool input_;
+    size_t bytes_;
+    int64_t start_;
+};
+
 /** Translates data type definition used in MATLAB to that of OpenCV.
  * @param classid data type of MATLAB's mxArray. e.g., \c mxDOUBLE_CLASS.
  * @return OpenCV's data type. e.g., \c CV_8U.
@@ -81,11 +138,301 @@ const ConstMap<std::string, int> TermCritType = ConstMap<std::string, int>
     ("EPS",       cv::TermCriteria::EPS)
     ("Count+EPS", cv::TermCriteria::COUNT+cv::TermCriteria::EPS);
 
+/// Side length of the square tiles used when reordering array elements.
+const int CONVERT_BLOCK_SIZE = 32;
+
+/// Minimum number of bytes per stripe before a conversion is parallelized.
+const double CONVERT_STRIPE_BYTES = 1 << 18;
+
+/** Parallel loop body copying planar column-major data into an interleaved
+ * row-major cv::Mat, casting element type on the fly.
+ *
+ * Element <tt>(r,c)</tt> of channel \c k in the destination is read from
+ * <tt>src[r*rstep + c*cstep + k*plane]</tt>. The destination is walked in
+ * square tiles so that the strided reads of a transposition stay in cache.
+ */
+template <typename SrcT, typename DstT>
+class PlanarToInterleavedInvoker : public cv::ParallelLoopBody
+{
+  public:
+    /// Constructor
+    PlanarToInterleavedInvoker(const SrcT *src, cv::Mat& dst,
+        size_t rstep, size_t cstep, size_t plane)
+    : src_(src), dst_(dst.data), dstep_(dst.step[0]), cols_(dst.cols),
+      cn_(dst.channels()), rstep_(rstep), cstep_(cstep), plane_(plane)
+    {}
+    /// Process a range of destination rows
+    virtual void operator()(const cv::Range& range) const
+    {
+        for (int r0 = range.start; r0 < range.end; r0 += CONVERT_BLOCK_SIZE) {
+            const int r1 = std::min(r0 + CONVERT_BLOCK_SIZE, range.end);
+            for (int c0 = 0; c0 < cols_; c0 += CONVERT_BLOCK_SIZE) {
+                const int c1 = std::min(c0 + CONVERT_BLOCK_SIZE, cols_);
+                for (int r = r0; r < r1; ++r) {
+                    DstT *d = reinterpret_cast<DstT*>(dst_ + r*dstep_) + c0*cn_;
+                    for (int k = 0; k < cn_; ++k) {
+                        const SrcT *s = src_ + r*rstep_ + c0*cstep_ + k*plane_;
+                        for (int c = 0; c < c1 - c0; ++c, s += cstep_)
+                            d[c*cn_ + k] = cv::saturate_cast<DstT>(*s);
+                    }
+                }
+            }
+        }
+    }
+  private:
+    const SrcT *src_;
+    uchar *dst_;
+    size_t dstep_;
+    int cols_;
+    int cn_;
+    size_t rstep_;
+    size_t cstep_;
+    size_t plane_;
+};
+
+/// Planar to interleaved conversion function type.
+typedef void (*PlanarToInterleavedFunc)(const void *src, cv::Mat& dst,
+    size_t rstep, size_t cstep, size_t plane);
+
+/** Copy planar column-major data into a preallocated interleaved cv::Mat.
+ * @param src pointer to the first element of the first plane.
+ * @param dst destination matrix (2D, already allocated).
+ * @param rstep source offset (in elements) between destination rows.
+ * @param cstep source offset (in elements) between destination columns.
+ * @param plane source offset (in elements) between channels.
+ */
+template <typename SrcT, typename DstT>
+void planarToInterleaved(const void *src, cv::Mat& dst,
+    size_t rstep, size_t cstep, size_t plane)
+{
+    const PlanarToInterleavedInvoker<SrcT,DstT> body(
+        static_cast<const SrcT*>(src), dst, rstep, cstep, plane);
+    const double nstripes = (dst.total() * dst.elemSize()) /
+        CONVERT_STRIPE_BYTES;
+    cv::parallel_for_(cv::Range(0, dst.rows), body, std::max(nstripes, 1.0));
+}
+
+/// Row of a conversion function table, one entry per destination depth.
+#define MEXOPENCV_DEPTH_ROW(FUNC, T) \
+    { FUNC<T,uchar>, FUNC<T,schar>, FUNC<T,ushort>, FUNC<T,short>, \
+      FUNC<T,int>, FUNC<T,float>, FUNC<T,double> }
+
+/// Conversion function table indexed by source and destination depths.
+#define MEXOPENCV_DEPTH_TABLE(FUNC) { \
+    MEXOPENCV_DEPTH_ROW(FUNC, uchar), MEXOPENCV_DEPTH_ROW(FUNC, schar), \
+    MEXOPENCV_DEPTH_ROW(FUNC, ushort), MEXOPENCV_DEPTH_ROW(FUNC, short), \
+    MEXOPENCV_DEPTH_ROW(FUNC, int), MEXOPENCV_DEPTH_ROW(FUNC, float), \
+    MEXOPENCV_DEPTH_ROW(FUNC, double) }
+
+/** Get conversion function for a pair of OpenCV depths.
+ * @param sdepth source depth, e.g. \c CV_8U.
+ * @param ddepth destination depth, e.g. \c CV_32F.
+ * @return function pointer.
+ */
+PlanarToInterleavedFunc getPlanarToInterleavedFunc(int sdepth, int ddepth)
+{
+    static const PlanarToInterleavedFunc tab[7][7] =
+        MEXOPENCV_DEPTH_TABLE(planarToInterleaved);
+    CV_Assert(0 <= sdepth && sdepth <= CV_64F && 0 <= ddepth && ddepth <= CV_64F);
+    return tab[sdepth][ddepth];
+}
+
+/** Parallel loop body reversing the order of dimensions of an N-D array,
+ * casting element type on the fly.
+ *
+ * The source is a column-major array (first dimension changes fastest) of
+ * size <tt>d[0] x d[1] x ... x d[n-1]</tt>, and the destination receives the
+ * same elements in row-major order (last dimension changes fastest). This is
+ * equivalent to <tt>permute(src, n:-1:1)</tt> in MATLAB.
+ *
+ * The array is processed as a stack of 2D slices spanning the first and last
+ * dimensions (contiguous in the source and destination respectively), one
+ * slice per combination of the middle dimensions. Each slice is copied in
+ * square tiles, and the work is split over (slice, row tile) pairs.
+ */
+template <typename SrcT, typename DstT>
+class ReverseDimsInvoker : public cv::ParallelLoopBody
+{
+  public:
+    /// Constructor
+    ReverseDimsInvoker(const SrcT *src, DstT *dst, const std::vector<size_t>& d)
+    : src_(src), dst_(dst), d_(d), rs_(d.size(), 1)
+    {
+        const size_t n = d_.size();
+        for (size_t k = n-1; k > 0; --k)
+            rs_[k-1] = rs_[k] * d_[k];  // row-major strides
+        rows_ = d_[0];
+        cols_ = d_[n-1];
+        cstep_ = rs_[0] * d_[0] / d_[n-1];  // column-major stride of last dim
+        ntiles_ = (rows_ + CONVERT_BLOCK_SIZE - 1) / CONVERT_BLOCK_SIZE;
+    }
+    /// Number of work items (row tiles of all slices)
+    size_t size() const
+    {
+        size_t nslices = 1;
+        for (size_t k = 1; k+1 < d_.size(); ++k)
+            nslices *= d_[k];
+        return nslices * ntiles_;
+    }
+    /// Process a range of work items
+    virtual void operator()(const cv::Range& range) const
+    {
+        for (int idx = range.start; idx < range.end; ++idx) {
+            const size_t slice = idx / ntiles_;
+            const size_t r0 = (idx % ntiles_) * CONVERT_BLOCK_SIZE;
+            const size_t r1 = std::min(r0 + CONVERT_BLOCK_SIZE, rows_);
+            // offsets of current slice, the middle dimensions are enumerated
+            // in column-major order which is contiguous in the source
+            size_t soff = slice * rows_, doff = 0;
+            for (size_t k = 1, f = slice; k+1 < d_.size(); ++k) {
+                doff += (f % d_[k]) * rs_[k];
+                f /= d_[k];
+            }
+            for (size_t c0 = 0; c0 < cols_; c0 += CONVERT_BLOCK_SIZE) {
+                const size_t c1 = std::min(c0 + CONVERT_BLOCK_SIZE, cols_);
+                for (size_t r = r0; r < r1; ++r) {
+                    DstT *o = dst_ + doff + r*rs_[0];
+                    const SrcT *i = src_ + soff + r + c0*cstep_;
+                    for (size_t c = c0; c < c1; ++c, i += cstep_)
+                        o[c] = cv::saturate_cast<DstT>(*i);
+                }
+            }
+        }
+    }
+  private:
+    const SrcT *src_;
+    DstT *dst_;
+    std::vector<size_t> d_;
+    std::vector<size_t> rs_;
+    size_t rows_;
+    size_t cols_;
+    size_t cstep_;
+    size_t ntiles_;
+};
+
+/// Dimension reversal function type.
+typedef void (*ReverseDimsFunc)(const void *src, void *dst,
+    const std::vector<size_t>& d);
+
+/** Reverse the order of dimensions of an N-D array.
+ * @param src column-major source data.
+ * @param dst destination buffer (receives row-major data).
+ * @param d dimensions of the source array (at least 2).
+ */
+template <typename SrcT, typename DstT>
+void reverseDims(const void *src, void *dst, const std::vector<size_t>& d)
+{
+    const ReverseDimsInvoker<SrcT,DstT> body(
+        static_cast<const SrcT*>(src), static_cast<DstT*>(dst), d);
+    const size_t n = body.size();
+    CV_Assert(n <= static_cast<size_t>(INT_MAX));
+    size_t total = sizeof(DstT);
+    for (size_t k = 0; k < d.size(); ++k)
+        total *= d[k];
+    const double nstripes = total / CONVERT_STRIPE_BYTES;
+    cv::parallel_for_(cv::Range(0, static_cast<int>(n)), body,
+        std::max(nstripes, 1.0));
+}
+
+/** Reverse the order of dimensions of an N-D array, converting its depth.
+ * @param src column-major source data.
+ * @param sdepth source depth, e.g. \c CV_8U.
+ * @param dst destination buffer (receives row-major data).
+ * @param ddepth destination depth, e.g. \c CV_32F.
+ * @param d dimensions of the source array.
+ *
+ * Reading the result as column-major, its dimensions are those of the
+ * source in reverse order, so calling the function a second time with the
+ * reversed dimensions restores the original layout.
+ */
+void reverseDims(const void *src, int sdepth, void *dst, int ddepth,
+    std::vector<size_t> d)
+{
+    static const ReverseDimsFunc tab[7][7] =
+        MEXOPENCV_DEPTH_TABLE(reverseDims);
+    CV_Assert(0 <= sdepth && sdepth <= CV_64F && 0 <= ddepth && ddepth <= CV_64F);
+    if (d.size() < 2)
+        d.resize(2, 1);
+    for (size_t k = 0; k < d.size(); ++k)
+        if (d[k] == 0) return;  // nothing to copy
+    tab[sdepth][ddepth](src, dst, d);
+}
+
+#undef MEXOPENCV_DEPTH_TABLE
+#undef MEXOPENCV_DEPTH_ROW
+
+/** Field number of a struct array.
+ * @param p struct array.
+ * @param fieldName name of the field.
+ * @param required whether to raise an error if the field doesn't exist.
+ * @return field number, or -1 if the field doesn't exist.
+ */
+int fieldNumber(const mxArray *p, const char *fieldName, bool required)
+{
+    const int fnum = mxGetFieldNumber(p, fieldName);
+    if (fnum < 0 && required)
+        mexErrMsgIdAndTxt("mexopencv:error",
+            "Field '%s' doesn't exist", fieldName);
+    return fnum;
+}
+
+/** Field value of a struct array element, accessed by field number.
+ * @param p struct array.
+ * @param index linear index of the struct array element.
+ * @param fnum field number as returned by fieldNumber.
+ * @return MxArray of the field value.
+ */
+MxArray fieldAt(const mxArray *p, mwIndex index, int fnum)
+{
+    const mxArray *pm = mxGetFieldByNumber(p, index, fnum);
+    if (!pm)
+        mexErrMsgIdAndTxt("mexopencv:error", "Field '%s' is not set",
+            mxGetFieldNameByNumber(p, fnum));
+    return MxArray(pm);
+}
+
+/** Column of a struct-of-arrays as a continuous single-channel matrix.
+ * @param arr scalar struct of arrays.
+ * @param fieldName name of the field.
+ * @param len expected number of elements.
+ * @param depth depth of the output matrix.
+ * @param val default value used when the field doesn't exist.
+ * @return \p len elements of type \p depth.
+ */
+cv::Mat soaColumn(const MxArray& arr, const char *fieldName, int len,
+    int depth, double val)
+{
+    if (!arr.isField(fieldName))
+        return cv::Mat(len, 1, depth, cv::Scalar::all(val));
+    const MxArray field(arr.at(fieldName));
+    if (field.numel() != static_cast<mwSize>(len))
+        mexErrMsgIdAndTxt("mexopencv:error",
+            "Field '%s' must have %d elements", fieldName, len);
+    if (len == 0)
+        return cv::Mat(0, 1, depth);
+    return field.toMat(depth).reshape(1, len);
+}
+
+/** Check if a scalar struct holds matches in struct-of-arrays form.
+ * @param arr scalar struct.
+ * @return true if any DMatch field has other than one element.
+ */
+bool isDMatchSoA(const MxArray& arr)
+{
+    for (int k = 0; k < 4; ++k)
+        if (arr.isField(cv_dmatch_fields[k]) &&
+            arr.at(cv_dmatch_fields[k]).numel() != 1)
+            return true;
+    return false;
+}
 }  // anonymous namespace
 
 int MexErrorHandler(int status, const char *func_name, const char *err_msg,
     const char *file_name, int line, void * /*userdata*/)
 {
+    // the MEX API is not thread-safe, let OpenCV throw on other threads
+    if (!equalThreads(currentThread(), matlabThread))
+        return 0;
     mexErrMsgIdAndTxt("mexopencv:error",
         "OpenCV Error:\n"
         "  Status  : %s (%d)\n"
@@ -207,13 +554,14 @@ MxArray::MxArray(const cv::Mat& mat, mxClassID classid, bool)
         return;
     }
 
+    ProfileConversion prof(false, mat.total() * mat.elemSize());
+
     // Create output mxArray (of specified type), equivalent to the input Mat
     const mwSize cn = mat.channels();
     const mwSize len = mat.total() * cn;
     std::vector<mwSize> sz(mat.size.p, mat.size.p + mat.dims);
     if (cn > 1)
         sz.push_back(cn);  // channels is treated as another dimension
-    std::reverse(sz.begin(), sz.end());  // row vs. column major order
     if (classid == mxLOGICAL_CLASS)
         p_ = mxCreateLogicalArray(sz.size(), &sz[0]);
     else
@@ -221,43 +569,25 @@ MxArray::MxArray(const cv::Mat& mat, mxClassID classid, bool)
     if (!p_)
         mexErrMsgIdAndTxt("mexopencv:error", "Allocation error");
 
-    // fill output with values from input Mat
-    // (linearized as a 1D-vector, both dimensions and channels)
-    {
-        // wrap destination data using a cv::Mat
-        const int type = CV_MAKETYPE(DepthOf[classid], 1); // destination type
-        cv::Mat m(len, 1, type, mxGetData(p_));  // only creates Mat header
-
-        // copy flattened input to output array (converting to specified type)
-        const cv::Mat mat0(len, 1, mat.depth(), mat.data); // no data copying
-        if (classid == mxLOGICAL_CLASS) {
-            // OpenCV's logical true is any nonzero, while MATLAB's true is 1
-            cv::compare(mat0, 0, m, cv::CMP_NE); // values either 0 or 255
-            m.setTo(1, m);  // values either 0 or 1 (CV_8U)
-        }
-        else
-            mat0.convertTo(m, type);
-    }
-
-    // rearrange dimensions of mxArray by calling PERMUTE from MATLAB. We want
-    // to convert from row-major order (C-style, last dim changes fastest) to a
-    // column-major order (MATLAB-style, first dim changes fastest). This will
-    // handle all cases of cv::Mat as multi-channels and/or multi-dimensions.
-    std::vector<double> order;
-    order.reserve(sz.size());
-    for (int i=sz.size(); i>0; i--)
-        order.push_back(i);
-
-    // CALL: out = permute(in, ndims(in):-1:1)
-    mxArray *lhs, *rhs[2];
-    rhs[0] = const_cast<mxArray*>(p_);
-    rhs[1] = MxArray(order);
-    lhs = NULL;              // new data copy will be returned
-    if (mexCallMATLAB(1, &lhs, 2, rhs, "permute") != 0)
-        mexErrMsgIdAndTxt("mexopencv:error", "Error calling permute");
-    p_ = lhs;
-    mxDestroyArray(rhs[0]);  // discard old copy
-    mxDestroyArray(rhs[1]);
+    // source data (linearized as a 1D-vector, both dimensions and channels)
+    cv::Mat src(mat.isContinuous() ? mat : mat.clone());
+    if (classid == mxLOGICAL_CLASS) {
+        // OpenCV's logical true is any nonzero, while MATLAB's true is 1
+        const cv::Mat mat0(len, 1, mat.depth(), src.data); // no data copying
+        cv::Mat m;
+        cv::compare(mat0, 0, m, cv::CMP_NE);  // values either 0 or 255
+        m.setTo(1, m);  // values either 0 or 1 (CV_8U)
+        src = m;
+    }
+
+    // fill output with values from input Mat, rearranging from row-major
+    // order (C-style, last dim changes fastest) to column-major order
+    // (MATLAB-style, first dim changes fastest) and converting to the
+    // specified type in the same pass. Viewed as column-major, the source has
+    // the dimensions of the output in reverse order. This will handle all
+    // cases of cv::Mat as multi-channels and/or multi-dimensions.
+    reverseDims(src.data, src.depth(), mxGetData(p_), DepthOf[classid],
+        std::vector<size_t>(sz.rbegin(), sz.rend()));
     CV_DbgAssert(!isNull() && classID()==classid && numel()==len);
 }
 #endif
@@ -410,18 +740,20 @@ MxArray::MxArray(const std::vector<cv::KeyPoint>& v)
 {
     if (!p_)
         mexErrMsgIdAndTxt("mexopencv:error", "Allocation error");
+    // fields are numbered in the order of cv_keypoint_fields
+    mxArray *p = const_cast<mxArray*>(p_);
     for (mwIndex i = 0; i < v.size(); ++i) {
-        set("pt",       v[i].pt,       i);
-        set("size",     v[i].size,     i);
-        set("angle",    v[i].angle,    i);
-        set("response", v[i].response, i);
-        set("octave",   v[i].octave,   i);
-        set("class_id", v[i].class_id, i);
+        mxSetFieldByNumber(p, i, 0, MxArray(v[i].pt));
+        mxSetFieldByNumber(p, i, 1, MxArray(v[i].size));
+        mxSetFieldByNumber(p, i, 2, MxArray(v[i].angle));
+        mxSetFieldByNumber(p, i, 3, MxArray(v[i].response));
+        mxSetFieldByNumber(p, i, 4, MxArray(v[i].octave));
+        mxSetFieldByNumber(p, i, 5, MxArray(v[i].class_id));
     }
 }
 
 MxArray::MxArray(const cv::DMatch& m)
-    : p_(mxCreateStructMatrix(1, 1, 4, cv_keypoint_fields))
+    : p_(mxCreateStructMatrix(1, 1, 4, cv_dmatch_fields))
 {
     if (!p_)
         mexErrMsgIdAndTxt("mexopencv:error", "Allocation error");
@@ -437,11 +769,13 @@ MxArray::MxArray(const std::vector<cv::DMatch>& v)
 {
     if (!p_)
         mexErrMsgIdAndTxt("mexopencv:error", "Allocation error");
+    // fields are numbered in the order of cv_dmatch_fields
+    mxArray *p = const_cast<mxArray*>(p_);
     for (mwIndex i = 0; i < v.size(); ++i) {
-        set("queryIdx", v[i].queryIdx, i);
-        set("trainIdx", v[i].trainIdx, i);
-        set("imgIdx",   v[i].imgIdx,   i);
-        set("distance", v[i].distance, i);
+        mxSetFieldByNumber(p, i, 0, MxArray(v[i].queryIdx));
+        mxSetFieldByNumber(p, i, 1, MxArray(v[i].trainIdx));
+        mxSetFieldByNumber(p, i, 2, MxArray(v[i].imgIdx));
+        mxSetFieldByNumber(p, i, 3, MxArray(v[i].distance));
     }
 }
 
@@ -531,8 +865,8 @@ cv::Mat MxArray::toMat(int depth, bool transpose) const
     CV_Assert(isNumeric() || isLogical() || isChar());
 
     // the rest of this function works fine for 2D and 3D arrays, but for
-    // higher ND-arrays the order of dimensions is not right (the std::swap
-    // below is only intended for 2d array).
+    // higher ND-arrays the order of dimensions is not right (the row/column
+    // swap below is only intended for 2d array).
     // So instead we use MxArray::toMatND on the input ND-array and then
     // convert the last dimension of the MatND into channels.
     if (ndims() > 3) {
@@ -544,43 +878,147 @@ cv::Mat MxArray::toMat(int depth, bool transpose) const
         CV_Assert(cn <= CV_CN_MAX);
         return matnd.reshape(cn, d.size()-1, &d[0]);
     }
+    ProfileConversion prof(true, numel() * mxGetElementSize(p_));
 
     // Create cv::Mat object (of the specified depth), equivalent to mxArray.
     // At this point we create either a 2-dim with 1-channel mat, or a 2-dim
     // with multi-channels mat. Multi-dims case is handled above.
-    std::vector<int> d(dims(), dims()+ndims());
-    const mwSize ndims = (d.size()>2) ? d.size()-1 : d.size();
-    const mwSize nchannels = (d.size()>2) ? d.back() : 1;
-    depth = (depth == CV_USRTYPE1) ? DepthOf[classID()] : depth;
-    std::swap(d[0], d[1]);
-    cv::Mat mat(ndims, &d[0], CV_MAKETYPE(depth, nchannels));
-    // Copy each channel from mxArray to Mat (converting to specified depth),
-    // as in: channels[i] <- cast_to_mat_depth(p_(:,:,i))
-    std::vector<cv::Mat> channels(nchannels);
-    std::vector<mwSize> si(d.size(), 0);                 // subscript index
-    const int type = CV_MAKETYPE(DepthOf[classID()], 1); // Source type
-    for (mwIndex i = 0; i<nchannels; ++i) {
-        si[si.size() - 1] = i;                   // last dim is a channel idx
-        void *pd = reinterpret_cast<void*>(
-            reinterpret_cast<size_t>(mxGetData(p_)) +
-            mxGetElementSize(p_)*subs(si));      // ptr to i-th channel data
-        const cv::Mat m(ndims, &d[0], type, pd); // only creates Mat headers
-        // Read from mxArray through m, writing into channels[i]
-        // (Note that saturate_cast<> is applied, so values are clipped
-        // rather than wrap-around in a two's complement sense. In
-        // floating-point to integer conversion, numbers are first rounded
-        // to nearest integer then clamped).
-        m.convertTo(channels[i], CV_MAKETYPE(depth, 1));
-        // transpose cv::Mat if needed. We do this inside the loop on each 2d
-        // 1-cn slice to avoid cv::transpose limitation on number of channels
-        if (transpose)
-            cv::transpose(channels[i], channels[i]);  // in-place transpose
-    }
-    // Merge channels back into one cv::Mat array
-    cv::merge(channels, mat);
+    const mwSize m = dims()[0], n = dims()[1];
+    const int cn = (ndims() > 2) ? static_cast<int>(dims()[2]) : 1;
+    const int sdepth = DepthOf[classID()];
+    depth = (depth == CV_USRTYPE1) ? sdepth : depth;
+    cv::Mat mat(static_cast<int>(transpose ? m : n),
+        static_cast<int>(transpose ? n : m), CV_MAKETYPE(depth, cn));
+    if (mat.empty())
+        return mat;
+
+    // MATLAB stores each channel as a separate column-major plane, so that
+    // plane i wrapped as a row-major (n x m) header is p_(:,:,i) transposed.
+    // Fill the destination in a single pass, converting to the target depth
+    // (Note that saturate_cast<> is applied, so values are clipped rather
+    // than wrap-around in a two's complement sense. In floating-point to
+    // integer conversion, numbers are first rounded to nearest integer then
+    // clamped).
+    uchar *data = static_cast<uchar*>(mxGetData(p_));
+    const size_t plane = m*n;
+    if (cn == 1 && !transpose) {
+        const cv::Mat src(mat.size(), sdepth, data);  // only creates header
+        src.convertTo(mat, depth);
+    }
+    else if (cn == 1 && sdepth == depth) {
+        const cv::Mat src(mat.cols, mat.rows, sdepth, data);
+        cv::transpose(src, mat);
+    }
+    else if (!transpose && sdepth == depth) {
+        std::vector<cv::Mat> channels(cn);
+        for (int i = 0; i < cn; ++i)
+            channels[i] = cv::Mat(mat.size(), sdepth,
+                data + i*plane*mxGetElementSize(p_));
+        cv::merge(channels, mat);
+    }
+    else {
+        // general case: fused transpose, interleave and type cast
+        PlanarToInterleavedFunc func = getPlanarToInterleavedFunc(sdepth, depth);
+        func(data, mat, (transpose ? 1 : m), (transpose ? m : 1), plane);
+    }
     return mat;
 }
 
+cv::Mat MxArray::toColumnMajor(const cv::Mat& mat)
+{
+    cv::Mat out;
+    toColumnMajor(mat, out);
+    return out;
+}
+
+void MxArray::toColumnMajor(const cv::Mat& mat, cv::Mat& out)
+{
+    // dimensions of the row-major output, i.e reversed MATLAB dimensions
+    std::vector<int> d(1, mat.channels());
+    for (int i = mat.dims - 1; i >= 0; --i)
+        d.push_back(mat.size[i]);
+    out.create(static_cast<int>(d.size()), &d[0], mat.depth());
+    CV_Assert(out.isContinuous());
+    if (!mat.empty()) {
+        const cv::Mat src(mat.isContinuous() ? mat : mat.clone());
+        reverseDims(src.data, src.depth(), out.data, out.depth(),
+            std::vector<size_t>(d.begin(), d.end()));
+    }
+}
+
+MxArray MxArray::Numeric(const std::vector<mwSize>& dims, int depth)
+{
+    mxArray *pm = mxCreateNumericArray(dims.size(), &dims[0],
+        ClassIDOf[depth], mxREAL);
+    if (!pm)
+        mexErrMsgIdAndTxt("mexopencv:error", "Allocation error");
+    return MxArray(pm);
+}
+
+MxArray MxArray::fromColumnMajor(const cv::Mat& mat, bool flipChannels)
+{
+    if (mat.empty())
+        return MxArray(cv::Mat());
+    CV_Assert(mat.isContinuous() && mat.channels() == 1 && mat.dims >= 2);
+    // MATLAB dimensions are the reverse of the layout ones
+    std::vector<mwSize> d(mat.size.p, mat.size.p + mat.dims);
+    std::reverse(d.begin(), d.end());
+    mxArray *pm = mxCreateNumericArray(d.size(), &d[0],
+        ClassIDOf[mat.depth()], mxREAL);
+    if (!pm)
+        mexErrMsgIdAndTxt("mexopencv:error", "Allocation error");
+    uchar *data = static_cast<uchar*>(mxGetData(pm));
+    const size_t cn = d.back(), plane = mat.total() * mat.elemSize() / cn;
+    if (flipChannels && cn == 3) {
+        for (size_t i = 0; i < cn; ++i)
+            std::copy(mat.data + (cn-1-i)*plane, mat.data + (cn-i)*plane,
+                data + i*plane);
+    }
+    else
+        std::copy(mat.data, mat.data + cn*plane, data);
+    return MxArray(pm);
+}
+
+void MxArray::columnMajorToMat(const void *data, int sdepth, cv::Mat& mat)
+{
+    CV_Assert(mat.dims == 2);
+    if (mat.empty())
+        return;
+    const size_t m = mat.rows, n = mat.cols;
+    PlanarToInterleavedFunc func = getPlanarToInterleavedFunc(sdepth,
+        mat.depth());
+    func(data, mat, 1, m, m*n);
+}
+
+bool MxArray::isMatViewable() const
+{
+    if (isNull() || isSparse() || isComplex())
+        return false;
+    switch (classID()) {
+        case mxDOUBLE_CLASS:
+        case mxSINGLE_CLASS:
+        case mxINT8_CLASS:
+        case mxUINT8_CLASS:
+        case mxINT16_CLASS:
+        case mxUINT16_CLASS:
+        case mxINT32_CLASS:
+            return true;
+        default:
+            return false;
+    }
+}
+
+cv::Mat MxArray::toMatView() const
+{
+    if (!isMatViewable())
+        mexErrMsgIdAndTxt("mexopencv:error",
+            "MxArray of class %s cannot be viewed as cv::Mat",
+            className().c_str());
+    // column-major MxN array seen as a row-major NxM matrix
+    return cv::Mat(static_cast<int>(cols()), static_cast<int>(rows()),
+        CV_MAKETYPE(DepthOf[classID()], 1), mxGetData(p_));
+}
+
 #if 0
 // works for 2D, but for ND-arrays the dimensions are not arranged correctly
 cv::MatND MxArray::toMatND(int depth, bool transpose) const
@@ -606,25 +1044,7 @@ cv::MatND MxArray::toMatND(int depth, bool) const
 {
     CV_Assert(isNumeric() || isLogical() || isChar());
     CV_Assert(ndims() <= CV_MAX_DIM);
-
-    // rearrange ND-array from MATLAB-style (column-major order, first dim
-    // changes fastest) to C-style (row-major order, last dim changes fastest)
-    // by calling PERMUTE from MATLAB.
-    std::vector<double> order;
-    order.reserve(ndims());
-    for (int i=ndims(); i>0; i--)
-        order.push_back(i);
-
-    // CALL: out = permute(in, ndims(in):-1:1)
-    mxArray *lhs, *rhs[2];
-    rhs[0] = const_cast<mxArray*>(p_);
-    rhs[1] = MxArray(order);
-    lhs = NULL;    // new data copy will be returned
-    if (mexCallMATLAB(1, &lhs, 2, rhs, "permute") != 0)
-        mexErrMsgIdAndTxt("mexopencv:error", "Error calling permute");
-    mxDestroyArray(rhs[1]);
-    CV_DbgAssert(lhs!=NULL && mxGetClassID(lhs)==classID() &&
-        mxGetNumberOfElements(lhs)==numel());
+    ProfileConversion prof(true, numel() * mxGetElementSize(p_));
 
     // Create output cv::MatND object of the specified depth, and of same size
     // as mxArray. This is a single-channel multi-dimensional array.
@@ -632,18 +1052,11 @@ cv::MatND MxArray::toMatND(int depth, bool) const
     depth = (depth == CV_USRTYPE1) ? DepthOf[classID()] : depth;
     cv::MatND mat(d.size(), &d[0], CV_MAKETYPE(depth, 1));
 
-    // Copy data from mxArray to cv::MatND (converting to specified depth)
-    {
-        // wrap source data using a cv::Mat (only creates header, data shared)
-        const int type = CV_MAKETYPE(DepthOf[classID()], 1);  // source type
-        const cv::MatND m(d.size(), &d[0], type, mxGetData(lhs));
-
-        // Read from mxArray through m, writing into mat
-        m.convertTo(mat, CV_MAKETYPE(depth, 1));
-    }
-
-    // clean temporary copy, and return result
-    mxDestroyArray(lhs);
+    // rearrange ND-array from MATLAB-style (column-major order, first dim
+    // changes fastest) to C-style (row-major order, last dim changes fastest),
+    // converting to the specified depth in the same pass
+    reverseDims(mxGetData(p_), DepthOf[classID()], mat.data, depth,
+        std::vector<size_t>(dims(), dims() + ndims()));
     return mat;
 }
 #endif
@@ -1163,13 +1576,52 @@ std::vector<cv::KeyPoint> MxArray::toVector() const
 {
     const mwSize n = numel();
     std::vector<cv::KeyPoint> v;
-    v.reserve(n);
-    if (isCell())
+    if (isCell()) {
+        v.reserve(n);
         for (mwIndex i = 0; i < n; ++i)
             v.push_back(at<MxArray>(i).toKeyPoint());
-    else if (isStruct())
+    }
+    else if (isStruct() && n == 1 && isField("pt") && at("pt").numel() != 2) {
+        // struct-of-arrays: bulk conversion of each column
+        const MxArray ptArr(at("pt"));
+        if (!ptArr.isEmpty() && (ptArr.ndims() != 2 || ptArr.cols() != 2))
+            mexErrMsgIdAndTxt("mexopencv:error",
+                "Field 'pt' must be an Nx2 matrix");
+        const int len = (ptArr.isEmpty()) ? 0 : static_cast<int>(ptArr.rows());
+        const cv::Mat pt((len > 0) ? ptArr.toMat(CV_32F) : cv::Mat());
+        const cv::Mat sz(soaColumn(*this, "size", len, CV_32F, 0)),
+            angle(soaColumn(*this, "angle", len, CV_32F, -1)),
+            response(soaColumn(*this, "response", len, CV_32F, 0)),
+            octave(soaColumn(*this, "octave", len, CV_32S, 0)),
+            class_id(soaColumn(*this, "class_id", len, CV_32S, -1));
+        v.resize(len);
+        for (int i = 0; i < len; ++i) {
+            v[i].pt = cv::Point2f(pt.at<float>(i,0), pt.at<float>(i,1));
+            v[i].size = sz.at<float>(i);
+            v[i].angle = angle.at<float>(i);
+            v[i].response = response.at<float>(i);
+            v[i].octave = octave.at<int>(i);
+            v[i].class_id = class_id.at<int>(i);
+        }
+    }
+    else if (isStruct()) {
+        // look up field numbers once, rather than per element
+        const int fpt = fieldNumber(p_, "pt", true),
+            fsize = fieldNumber(p_, "size", true),
+            fangle = fieldNumber(p_, "angle", false),
+            fresponse = fieldNumber(p_, "response", false),
+            foctave = fieldNumber(p_, "octave", false),
+            fclass_id = fieldNumber(p_, "class_id", false);
+        v.reserve(n);
         for (mwIndex i = 0; i < n; ++i)
-            v.push_back(toKeyPoint(i));
+            v.push_back(cv::KeyPoint(
+                fieldAt(p_, i, fpt).toPoint2f(),
+                fieldAt(p_, i, fsize).toFloat(),
+                (fangle >= 0)    ? fieldAt(p_, i, fangle).toFloat()    : -1,
+                (fresponse >= 0) ? fieldAt(p_, i, fresponse).toFloat() :  0,
+                (foctave >= 0)   ? fieldAt(p_, i, foctave).toInt()     :  0,
+                (fclass_id >= 0) ? fieldAt(p_, i, fclass_id).toInt()   : -1));
+    }
     else
         mexErrMsgIdAndTxt("mexopencv:error",
             "MxArray unable to convert to std::vector<cv::KeyPoint>");
@@ -1181,15 +1633,510 @@ std::vector<cv::DMatch> MxArray::toVector() const
 {
     const mwSize n = numel();
     std::vector<cv::DMatch> v;
-    v.reserve(n);
-    if (isCell())
+    if (isCell()) {
+        v.reserve(n);
         for (mwIndex i = 0; i < n; ++i)
             v.push_back(at<MxArray>(i).toDMatch());
-    else if (isStruct())
+    }
+    else if (isStruct() && n == 1 && isDMatchSoA(*this)) {
+        // struct-of-arrays: bulk conversion of each column
+        int len = -1;
+        for (int k = 0; k < 4 && len < 0; ++k)
+            if (isField(cv_dmatch_fields[k]))
+                len = static_cast<int>(at(cv_dmatch_fields[k]).numel());
+        const cv::Mat queryIdx(soaColumn(*this, "queryIdx", len, CV_32S, 0)),
+            trainIdx(soaColumn(*this, "trainIdx", len, CV_32S, 0)),
+            imgIdx(soaColumn(*this, "imgIdx", len, CV_32S, 0)),
+            distance(soaColumn(*this, "distance", len, CV_32F, 0));
+        v.resize(len);
+        for (int i = 0; i < len; ++i) {
+            v[i].queryIdx = queryIdx.at<int>(i);
+            v[i].trainIdx = trainIdx.at<int>(i);
+            v[i].imgIdx = imgIdx.at<int>(i);
+            v[i].distance = distance.at<float>(i);
+        }
+    }
+    else if (isStruct()) {
+        // look up field numbers once, rather than per element
+        const int fqueryIdx = fieldNumber(p_, "queryIdx", false),
+            ftrainIdx = fieldNumber(p_, "trainIdx", false),
+            fimgIdx = fieldNumber(p_, "imgIdx", false),
+            fdistance = fieldNumber(p_, "distance", false);
+        v.reserve(n);
         for (mwIndex i = 0; i < n; ++i)
-            v.push_back(toDMatch(i));
+            v.push_back(cv::DMatch(
+                (fqueryIdx >= 0) ? fieldAt(p_, i, fqueryIdx).toInt()   : 0,
+                (ftrainIdx >= 0) ? fieldAt(p_, i, ftrainIdx).toInt()   : 0,
+                (fimgIdx >= 0)   ? fieldAt(p_, i, fimgIdx).toInt()     : 0,
+                (fdistance >= 0) ? fieldAt(p_, i, fdistance).toFloat() : 0));
+    }
     else
         mexErrMsgIdAndTxt("mexopencv:error",
             "MxArray unable to convert to std::vector<cv::DMatch>");
     return v;
 }
+
+namespace {
+/// Allocations smaller than this bypass the buffer pool
+const size_t POOL_MIN_BYTES = 4096;
+
+/// Default capacity of the buffer pool, in bytes
+const size_t POOL_DEFAULT_MAX_RESERVED = static_cast<size_t>(256) << 20;
+
+/** Round a buffer size up to its pool bucket.
+ * @param size requested size in bytes, at least \c POOL_MIN_BYTES.
+ * @return bucket size, the next multiple of a quarter of the largest power
+ *   of two not greater than \p size (so at most 25% overhead).
+ */
+size_t poolBucketSize(size_t size)
+{
+    size_t p = POOL_MIN_BYTES;
+    while (p <= size / 2)
+        p <<= 1;
+    const size_t step = p / 4;
+    return ((size + step - 1) / step) * step;
+}
+
+/// cv::MatAllocator recycling buffers through size buckets
+class PoolMatAllocator : public cv::MatAllocator
+{
+public:
+    PoolMatAllocator()
+    :   maxReserved(POOL_DEFAULT_MAX_RESERVED),
+        enabled(false)
+    {
+        st.hits = st.misses = st.bypassed = st.released = 0;
+        st.bytesInUse = st.bytesReserved = st.maxReservedSize = 0;
+    }
+
+    cv::UMatData* allocate(int dims, const int* sizes, int type,
+        void* data0, size_t* step, int /*flags*/,
+        cv::UMatUsageFlags /*usageFlags*/) const
+    {
+        // same layout computation as the standard allocator
+        size_t total = CV_ELEM_SIZE(type);
+        for (int i = dims-1; i >= 0; i--) {
+            if (step) {
+                if (data0 && step[i] != CV_AUTOSTEP) {
+                    CV_Assert(total <= step[i]);
+                    total = step[i];
+                }
+                else
+                    step[i] = total;
+            }
+            total *= sizes[i];
+        }
+        uchar *data = (data0) ? static_cast<uchar*>(data0) : acquire(total);
+        cv::UMatData *u = new cv::UMatData(this);
+        u->data = u->origdata = data;
+        u->size = total;
+        if (data0)
+            u->flags |= cv::UMatData::USER_ALLOCATED;
+        return u;
+    }
+
+    bool allocate(cv::UMatData* u, int /*accessFlags*/,
+        cv::UMatUsageFlags /*usageFlags*/) const
+    {
+        return (u != NULL);
+    }
+
+    void deallocate(cv::UMatData* u) const
+    {
+        if (!u)
+            return;
+        CV_Assert(u->urefcount == 0 && u->refcount == 0);
+        if (!(u->flags & cv::UMatData::USER_ALLOCATED)) {
+            release(u->origdata, u->size);
+            u->origdata = 0;
+        }
+        delete u;
+    }
+
+    void setEnabled(bool enable)
+    {
+        {
+            cv::AutoLock lock(mtx);
+            enabled = enable;
+        }
+        if (!enable)
+            trim(0);
+    }
+
+    MatBufferPool::Stats stats() const
+    {
+        cv::AutoLock lock(mtx);
+        MatBufferPool::Stats s = st;
+        s.maxReservedSize = maxReserved;
+        return s;
+    }
+
+    void resetStats()
+    {
+        cv::AutoLock lock(mtx);
+        st.hits = st.misses = st.bypassed = st.released = 0;
+    }
+
+    void setMaxReservedSize(size_t size)
+    {
+        {
+            cv::AutoLock lock(mtx);
+            maxReserved = size;
+        }
+        trim(size);
+    }
+
+    /** Free reserved buffers, largest first, until at most \p limit bytes
+     * remain reserved.
+     */
+    void trim(size_t limit)
+    {
+        std::vector<uchar*> garbage;
+        {
+            cv::AutoLock lock(mtx);
+            while (st.bytesReserved > limit && !buckets.empty()) {
+                std::map<size_t, std::vector<uchar*> >::iterator it =
+                    --buckets.end();
+                while (st.bytesReserved > limit && !it->second.empty()) {
+                    garbage.push_back(it->second.back());
+                    it->second.pop_back();
+                    st.bytesReserved -= it->first;
+                }
+                if (it->second.empty())
+                    buckets.erase(it);
+            }
+        }
+        for (size_t i = 0; i < garbage.size(); ++i)
+            cv::fastFree(garbage[i]);
+    }
+
+private:
+    /// Get a buffer of at least \p size bytes, from the pool if possible
+    uchar* acquire(size_t size) const
+    {
+        if (size < POOL_MIN_BYTES) {
+            {
+                cv::AutoLock lock(mtx);
+                ++st.bypassed;
+            }
+            return static_cast<uchar*>(cv::fastMalloc(size));
+        }
+        const size_t bucket = poolBucketSize(size);
+        {
+            cv::AutoLock lock(mtx);
+            std::map<size_t, std::vector<uchar*> >::iterator it =
+                buckets.find(bucket);
+            if (it != buckets.end() && !it->second.empty()) {
+                uchar *data = it->second.back();
+                it->second.pop_back();
+                st.bytesReserved -= bucket;
+                st.bytesInUse += bucket;
+                ++st.hits;
+                return data;
+            }
+        }
+        uchar *data = NULL;
+        try {
+            data = static_cast<uchar*>(cv::fastMalloc(bucket));
+        }
+        catch (const cv::Exception&) {
+            // out of memory: give reserved buffers back and try once more
+            const_cast<PoolMatAllocator*>(this)->trim(0);
+            data = static_cast<uchar*>(cv::fastMalloc(bucket));
+        }
+        cv::AutoLock lock(mtx);
+        st.bytesInUse += bucket;
+        ++st.misses;
+        return data;
+    }
+
+    /// Return a buffer of \p size bytes to the pool, or to the heap
+    void release(uchar* data, size_t size) const
+    {
+        if (size < POOL_MIN_BYTES) {
+            cv::fastFree(data);
+            return;
+        }
+        const size_t bucket = poolBucketSize(size);
+        {
+            cv::AutoLock lock(mtx);
+            st.bytesInUse -= bucket;
+            if (enabled && st.bytesReserved + bucket <= maxReserved) {
+                buckets[bucket].push_back(data);
+                st.bytesReserved += bucket;
+                return;
+            }
+            ++st.released;
+        }
+        cv::fastFree(data);
+    }
+
+    /// free buffers, keyed by bucket size
+    mutable std::map<size_t, std::vector<uchar*> > buckets;
+    /// usage counters
+    mutable MatBufferPool::Stats st;
+    /// capacity of the pool in bytes
+    size_t maxReserved;
+    /// whether released buffers are kept for reuse
+    bool enabled;
+    /// guards all of the above, buffers are released from worker threads
+    mutable cv::Mutex mtx;
+};
+
+/** Process-wide pool instance.
+ * @return reference to the pool allocator.
+ *
+ * The allocator is intentionally never destroyed, as buffers it handed out
+ * may be released at any time later on.
+ */
+PoolMatAllocator& getPoolMatAllocator()
+{
+    static PoolMatAllocator *pool = new PoolMatAllocator();
+    return *pool;
+}
+}  // anonymous namespace
+
+cv::MatAllocator* MatBufferPool::allocator()
+{
+    return &getPoolMatAllocator();
+}
+
+void MatBufferPool::install(bool enable)
+{
+    PoolMatAllocator& pool = getPoolMatAllocator();
+    pool.setEnabled(enable);
+    if (enable)
+        cv::Mat::setDefaultAllocator(&pool);
+    else if (cv::Mat::getDefaultAllocator() == &pool)
+        cv::Mat::setDefaultAllocator(cv::Mat::getStdAllocator());
+}
+
+bool MatBufferPool::installed()
+{
+    return (cv::Mat::getDefaultAllocator() == &getPoolMatAllocator());
+}
+
+MatBufferPool::Stats MatBufferPool::stats()
+{
+    return getPoolMatAllocator().stats();
+}
+
+void MatBufferPool::resetStats()
+{
+    getPoolMatAllocator().resetStats();
+}
+
+void MatBufferPool::setMaxReservedSize(size_t size)
+{
+    getPoolMatAllocator().setMaxReservedSize(size);
+}
+
+void MatBufferPool::freeAllReservedBuffers()
+{
+    getPoolMatAllocator().trim(0);
+}
+
+namespace {
+/// MATLAB global variable holding whether profiling is enabled
+const char *PROFILE_VAR = "MEXOPENCV_PROFILE";
+
+/// MATLAB function collecting the counters recorded by all MEX-files
+const char *PROFILE_COLLECTOR = "cv.Utils.recordProfile";
+
+/// State of the call being profiled in this MEX-file
+struct ProfileCallState
+{
+    size_t id;              ///< identifier of the call, 0 if none
+    std::string name;       ///< name the call is recorded under
+    int phase;              ///< current phase
+    int64_t start;          ///< start of the call, in ticks
+    int64_t phaseStart;     ///< start of the current phase, in ticks
+    int64_t ticks[3];       ///< time of each phase, excluding conversions
+    int64_t input;          ///< time of input conversions, in ticks
+    int64_t output;         ///< time of output conversions, in ticks
+    size_t bytesIn;         ///< bytes of input conversions
+    size_t bytesOut;        ///< bytes of output conversions
+};
+
+/** Profile state of this MEX-file.
+ *
+ * Each MEX-file links its own copy, and only touches it from the MATLAB
+ * thread, so it needs no lock. The counters are only used in the
+ * collector (see Profiler::record), the other MEX-files send theirs to it.
+ */
+struct ProfileTable
+{
+    /// counters, keyed by MEX-function name
+    std::map<std::string, Profiler::Entry> entries;
+    /// identifier of the last call started
+    size_t lastId;
+    /// call in progress
+    ProfileCallState call;
+
+    ProfileTable() : lastId(0) { call.id = 0; }
+};
+
+/// Profile state of this MEX-file
+ProfileTable& getProfileTable()
+{
+    static ProfileTable table;
+    return table;
+}
+
+/// Zero-initialized counters
+Profiler::Entry emptyEntry()
+{
+    Profiler::Entry e;
+    e.calls = e.bytesIn = e.bytesOut = e.maxCallBytes = 0;
+    e.total = e.parse = e.input = e.kernel = e.output = 0;
+    return e;
+}
+
+/** Send counters to the collector.
+ * @param name name of the function the counters belong to.
+ * @param e counters to add to those of the function.
+ *
+ * Errors of the collector (e.g. mexopencv not on the path) are ignored,
+ * since this runs in the destructor of ProfileCall.
+ */
+void sendProfileEntry(const std::string& name, const Profiler::Entry& e)
+{
+    mxArray *args[2];
+    args[0] = mxCreateString(name.c_str());
+    args[1] = mxCreateDoubleMatrix(1, 9, mxREAL);
+    double *v = mxGetPr(args[1]);
+    v[0] = static_cast<double>(e.calls);
+    v[1] = e.total;
+    v[2] = e.parse;
+    v[3] = e.input;
+    v[4] = e.kernel;
+    v[5] = e.output;
+    v[6] = static_cast<double>(e.bytesIn);
+    v[7] = static_cast<double>(e.bytesOut);
+    v[8] = static_cast<double>(e.maxCallBytes);
+    mxArray *ex = mexCallMATLABWithTrap(0, NULL, 2, args, PROFILE_COLLECTOR);
+    if (ex)
+        mxDestroyArray(ex);
+    mxDestroyArray(args[0]);
+    mxDestroyArray(args[1]);
+}
+}  // anonymous namespace
+
+void Profiler::enable(bool enable)
+{
+    mxArray *flag = mxCreateLogicalScalar(enable);
+    const int status = mexPutVariable("global", PROFILE_VAR, flag);
+    mxDestroyArray(flag);
+    if (status != 0)
+        mexErrMsgIdAndTxt("mexopencv:error",
+            "Failed to set global variable %s", PROFILE_VAR);
+}
+
+bool Profiler::enabled()
+{
+    // MEX API is only available on the MATLAB thread
+    if (!equalThreads(currentThread(), matlabThread))
+        return false;
+    const mxArray *flag = mexGetVariablePtr("global", PROFILE_VAR);
+    return (flag && mxIsLogicalScalarTrue(flag));
+}
+
+void Profiler::reset()
+{
+    getProfileTable().entries.clear();
+}
+
+std::map<std::string, Profiler::Entry> Profiler::entries()
+{
+    return getProfileTable().entries;
+}
+
+void Profiler::record(const std::string& name, const Entry& e)
+{
+    std::map<std::string, Entry>& entries = getProfileTable().entries;
+    std::map<std::string, Entry>::iterator it = entries.find(name);
+    if (it == entries.end())
+        it = entries.insert(std::make_pair(name, emptyEntry())).first;
+    Entry& dst = it->second;
+    dst.calls += e.calls;
+    dst.total += e.total;
+    dst.parse += e.parse;
+    dst.input += e.input;
+    dst.kernel += e.kernel;
+    dst.output += e.output;
+    dst.bytesIn += e.bytesIn;
+    dst.bytesOut += e.bytesOut;
+    dst.maxCallBytes = std::max(dst.maxCallBytes, e.maxCallBytes);
+}
+
+bool Profiler::recording()
+{
+    return (equalThreads(currentThread(), matlabThread) &&
+        getProfileTable().call.id != 0);
+}
+
+void Profiler::recordConversion(bool input, size_t bytes, int64_t ticks)
+{
+    if (!recording())
+        return;
+    // moved out of the phase the conversion happened in
+    ProfileCallState& call = getProfileTable().call;
+    call.ticks[call.phase] -= ticks;
+    (input ? call.input : call.output) += ticks;
+    (input ? call.bytesIn : call.bytesOut) += bytes;
+}
+
+ProfileCall::ProfileCall(const char *name)
+:   id_(0)
+{
+    if (!Profiler::enabled())
+        return;
+    ProfileTable& table = getProfileTable();
+    ProfileCallState& call = table.call;
+    id_ = call.id = ++table.lastId;
+    call.name = (name) ? name : mexFunctionName();
+    call.phase = Profiler::PARSE;
+    call.ticks[0] = call.ticks[1] = call.ticks[2] = 0;
+    call.input = call.output = 0;
+    call.bytesIn = call.bytesOut = 0;
+    call.start = call.phaseStart = cv::getTickCount();
+}
+
+ProfileCall::~ProfileCall()
+{
+    if (id_ == 0)
+        return;
+    const int64_t now = cv::getTickCount();
+    ProfileCallState& call = getProfileTable().call;
+    if (call.id != id_)
+        return;  // replaced by another call
+    call.id = 0;
+    if (!Profiler::enabled())
+        return;  // disabled during the call
+    call.ticks[call.phase] += now - call.phaseStart;
+    const double freq = cv::getTickFrequency();
+    Profiler::Entry e;
+    e.calls = 1;
+    e.total = (now - call.start) / freq;
+    e.parse = call.ticks[Profiler::PARSE] / freq;
+    e.input = call.input / freq;
+    e.kernel = call.ticks[Profiler::KERNEL] / freq;
+    e.output = (call.ticks[Profiler::OUTPUT] + call.output) / freq;
+    e.bytesIn = call.bytesIn;
+    e.bytesOut = call.bytesOut;
+    e.maxCallBytes = call.bytesIn + call.bytesOut;
+    sendProfileEntry(call.name, e);
+}
+
+void ProfileCall::phase(Profiler::Phase p)
+{
+    if (id_ == 0)
+        return;
+    const int64_t now = cv::getTickCount();
+    ProfileCallState& call = getProfileTable().call;
+    if (call.id != id_)
+        return;
+    call.ticks[call.phase] += now - call.phaseStart;
+    call.phase = p;
+    call.phaseStart = now;
+}
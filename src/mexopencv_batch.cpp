@@ -0,0 +1,226 @@
+/** Implementation of mexopencv_batch.
+ * @file mexopencv_batch.cpp
+ */
+
+#include "mexopencv_batch.hpp"
+using std::vector;
+using std::string;
+using namespace cv;
+
+namespace {
+/// Amount of memory in bytes that intermediate results of a batch may take
+const size_t BATCH_BYTES = 256 * 1024 * 1024;
+
+/// First error raised by the bodies of a parallel loop
+class LoopError
+{
+  public:
+    /// Record an error message, unless one was already recorded
+    void set(const string& msg)
+    {
+        AutoLock lock(mtx_);
+        if (msg_.empty())
+            msg_ = msg;
+    }
+    /// Recorded error message, empty if none
+    const string& message() const { return msg_; }
+  private:
+    Mutex mtx_;
+    string msg_;
+};
+
+/// Parallel loop body applying an operation to frames of a batch
+class BatchInvoker : public ParallelLoopBody
+{
+  public:
+    /// Constructor
+    BatchInvoker(const BatchOperation& op, int depth, const BatchImage *frames,
+        Mat *outputs, LoopError& err)
+    : op_(op), depth_(depth), frames_(frames), outputs_(outputs), err_(err)
+    {}
+    /// Process a range of frames
+    virtual void operator()(const Range& range) const
+    {
+        try {
+            for (int i = range.start; i < range.end; ++i) {
+                Mat dst;
+                op_(frames_[i].toMat(depth_), dst);
+                // data written in place when outputs_[i] already has the
+                // expected dimensions and depth
+                MxArray::toColumnMajor(dst, outputs_[i]);
+            }
+        }
+        catch (const std::exception& e) {
+            err_.set(e.what());
+        }
+        catch (...) {
+            err_.set("Unknown error in batch operation");
+        }
+    }
+  private:
+    const BatchOperation& op_;
+    int depth_;
+    const BatchImage *frames_;
+    Mat *outputs_;
+    LoopError& err_;
+};
+
+/** Apply an operation to consecutive frames.
+ * @param op operation.
+ * @param depth depth images are converted to.
+ * @param frames first frame.
+ * @param outputs first output, in the memory layout of MATLAB arrays.
+ * @param n number of frames.
+ */
+void runFrames(const BatchOperation& op, int depth, const BatchImage *frames,
+    Mat *outputs, int n)
+{
+    LoopError err;
+    BatchInvoker body(op, depth, frames, outputs, err);
+    {
+        // errors are caught in the bodies, and raised below
+        ErrorCallbackSuspender suspender;
+        if (n >= getNumThreads())
+            parallel_for_(Range(0, n), body);
+        else
+            for (int i = 0; i < n && err.message().empty(); ++i)
+                body(Range(i, i+1));
+    }
+    if (!err.message().empty())
+        mexErrMsgIdAndTxt("mexopencv:error", "%s", err.message().c_str());
+}
+
+/** Describe a numeric array or a slice of one as a batch image.
+ * @param arr numeric array, of at least <tt>(index+1)*rows*cols*cn</tt>
+ *    elements.
+ * @param rows number of rows of the image.
+ * @param cols number of columns of the image.
+ * @param cn number of channels of the image.
+ * @param index index of the image in the array.
+ * @return image description.
+ */
+BatchImage toBatchImage(const MxArray& arr, int rows, int cols, int cn,
+    size_t index)
+{
+    if (!(arr.isNumeric() || arr.isLogical()) || arr.isComplex() ||
+        arr.isSparse())
+        mexErrMsgIdAndTxt("mexopencv:error", "Invalid image in batch");
+    if (rows == 0 || cols == 0 || cn == 0)
+        mexErrMsgIdAndTxt("mexopencv:error", "Empty image in batch");
+    if (cn > CV_CN_MAX)
+        mexErrMsgIdAndTxt("mexopencv:error", "Too many channels");
+    BatchImage f;
+    f.depth = ClassNameMap[arr.className()];
+    f.rows = rows;
+    f.cols = cols;
+    f.cn = cn;
+    f.data = static_cast<const uchar*>(
+        mxGetData(static_cast<const mxArray*>(arr))) +
+        index * rows * cols * cn * CV_ELEM_SIZE1(f.depth);
+    return f;
+}
+}
+
+Mat BatchImage::toMat(int ddepth) const
+{
+    Mat mat(rows, cols, CV_MAKETYPE(
+        (ddepth == CV_USRTYPE1) ? depth : ddepth, cn));
+    MxArray::columnMajorToMat(data, depth, mat);
+    return mat;
+}
+
+bool isBatch(const MxArray& arr)
+{
+    return arr.isCell() || (arr.isNumeric() && arr.ndims() == 4);
+}
+
+vector<BatchImage> batchImages(const MxArray& arr)
+{
+    vector<BatchImage> frames;
+    if (arr.isCell()) {
+        const mwSize n = arr.numel();
+        frames.reserve(n);
+        for (mwIndex i = 0; i < n; ++i) {
+            const MxArray elem(arr.at<MxArray>(i));
+            if (elem.ndims() > 3)
+                mexErrMsgIdAndTxt("mexopencv:error",
+                    "Invalid image in batch");
+            const int cn = (elem.ndims() > 2) ?
+                static_cast<int>(elem.dims()[2]) : 1;
+            frames.push_back(toBatchImage(elem, elem.rows(), elem.cols(), cn,
+                0));
+        }
+    }
+    else if (isBatch(arr)) {
+        const mwSize *d = arr.dims();
+        frames.reserve(d[3]);
+        for (mwIndex i = 0; i < d[3]; ++i)
+            frames.push_back(toBatchImage(arr, static_cast<int>(d[0]),
+                static_cast<int>(d[1]), static_cast<int>(d[2]), i));
+    }
+    else
+        mexErrMsgIdAndTxt("mexopencv:error", "Invalid batch of images");
+    return frames;
+}
+
+MxArray processBatch(const MxArray& arr, const BatchOperation& op,
+    int depth)
+{
+    const vector<BatchImage> frames(batchImages(arr));
+    if (arr.isCell()) {
+        const mwSize n = frames.size();
+        size_t frameBytes = 1;
+        for (mwIndex i = 0; i < n; ++i) {
+            const BatchImage& f = frames[i];
+            frameBytes = std::max(frameBytes,
+                static_cast<size_t>(f.rows) * f.cols * f.cn * CV_ELEM_SIZE1(
+                    (depth == CV_USRTYPE1) ? f.depth : depth));
+        }
+        // results of a chunk of images are turned into MATLAB arrays
+        // before the next chunk is processed
+        const mwSize chunk = std::max<mwSize>(BATCH_BYTES / frameBytes,
+            getNumThreads());
+        MxArray cell(MxArray::Cell(arr.rows(), arr.cols()));
+        vector<Mat> outputs;
+        for (mwIndex i = 0; i < n; i += chunk) {
+            const int m = static_cast<int>(std::min(chunk, n - i));
+            outputs.assign(m, Mat());
+            runFrames(op, depth, &frames[i], &outputs[0], m);
+            for (int j = 0; j < m; ++j) {
+                cell.set(i + j, MxArray::fromColumnMajor(outputs[j]));
+                outputs[j].release();
+            }
+        }
+        return cell;
+    }
+
+    // stack of frames
+    const int n = static_cast<int>(frames.size());
+    if (n == 0)
+        return MxArray(Mat());
+
+    // the first result determines the size of the output stack, the others
+    // are then written directly into their slices
+    vector<Mat> outputs(n);
+    runFrames(op, depth, &frames[0], &outputs[0], 1);
+    const Mat& first = outputs[0];
+    vector<mwSize> odims(first.size.p, first.size.p + first.dims);
+    std::reverse(odims.begin(), odims.end());
+    odims.resize(3, 1);
+    odims.push_back(n);
+    MxArray out(MxArray::Numeric(odims, first.depth()));
+    uchar *data = static_cast<uchar*>(
+        mxGetData(static_cast<const mxArray*>(out)));
+    const size_t frameBytes = first.total() * first.elemSize();
+    std::copy(first.data, first.data + frameBytes, data);
+    for (int i = 1; i < n; ++i)
+        outputs[i] = Mat(first.dims, first.size.p, first.type(),
+            data + i*frameBytes);
+    if (n > 1)
+        runFrames(op, depth, &frames[1], &outputs[1], n - 1);
+    for (int i = 1; i < n; ++i)
+        if (outputs[i].data != data + i*frameBytes)
+            mexErrMsgIdAndTxt("mexopencv:error",
+                "Images of the batch have results of different sizes");
+    return out;
+}
@@ -1092,3 +1092,77 @@ Ptr<DescriptorMatcher> createDescriptorMatcher(
             "Failed to create DescriptorMatcher of type %s", type.c_str());
     return p;
 }
+
+
+/**************************************************************\
+*                        Output Formats                        *
+\**************************************************************/
+
+namespace {
+/** Create a real double matrix
+ * @param m number of rows.
+ * @param n number of columns.
+ * @return pointer to a new MxN double matrix.
+ */
+mxArray* createColumns(mwSize m, mwSize n = 1)
+{
+    mxArray *pm = mxCreateDoubleMatrix(m, n, mxREAL);
+    if (!pm)
+        mexErrMsgIdAndTxt("mexopencv:error", "Allocation error");
+    return pm;
+}
+}
+
+MxArray toStructOfArrays(const vector<KeyPoint>& keypoints)
+{
+    const mwSize n = keypoints.size();
+    mxArray *pt = createColumns(n, 2), *size = createColumns(n),
+        *angle = createColumns(n), *response = createColumns(n),
+        *octave = createColumns(n), *class_id = createColumns(n);
+    double *ppt = mxGetPr(pt), *psize = mxGetPr(size),
+        *pangle = mxGetPr(angle), *presponse = mxGetPr(response),
+        *poctave = mxGetPr(octave), *pclass_id = mxGetPr(class_id);
+    for (mwIndex i = 0; i < n; ++i) {
+        const KeyPoint& kp = keypoints[i];
+        ppt[i]       = kp.pt.x;
+        ppt[i+n]     = kp.pt.y;
+        psize[i]     = kp.size;
+        pangle[i]    = kp.angle;
+        presponse[i] = kp.response;
+        poctave[i]   = kp.octave;
+        pclass_id[i] = kp.class_id;
+    }
+    const char *fields[6] = {"pt", "size", "angle", "response", "octave",
+        "class_id"};
+    MxArray s = MxArray::Struct(fields, 6);
+    s.set(fields[0], MxArray(pt));
+    s.set(fields[1], MxArray(size));
+    s.set(fields[2], MxArray(angle));
+    s.set(fields[3], MxArray(response));
+    s.set(fields[4], MxArray(octave));
+    s.set(fields[5], MxArray(class_id));
+    return s;
+}
+
+MxArray toStructOfArrays(const vector<DMatch>& matches)
+{
+    const mwSize n = matches.size();
+    mxArray *queryIdx = createColumns(n), *trainIdx = createColumns(n),
+        *imgIdx = createColumns(n), *distance = createColumns(n);
+    double *pqueryIdx = mxGetPr(queryIdx), *ptrainIdx = mxGetPr(trainIdx),
+        *pimgIdx = mxGetPr(imgIdx), *pdistance = mxGetPr(distance);
+    for (mwIndex i = 0; i < n; ++i) {
+        const DMatch& m = matches[i];
+        pqueryIdx[i] = m.queryIdx;
+        ptrainIdx[i] = m.trainIdx;
+        pimgIdx[i]   = m.imgIdx;
+        pdistance[i] = m.distance;
+    }
+    const char *fields[4] = {"queryIdx", "trainIdx", "imgIdx", "distance"};
+    MxArray s = MxArray::Struct(fields, 4);
+    s.set(fields[0], MxArray(queryIdx));
+    s.set(fields[1], MxArray(trainIdx));
+    s.set(fields[2], MxArray(imgIdx));
+    s.set(fields[3], MxArray(distance));
+    return s;
+}
@@ -0,0 +1,799 @@
+/** Implementation of mexopencv_imgcodecs.
+ * @file mexopencv_imgcodecs.cpp
+ * @ingroup imgcodecs
+ */
+
+#include "mexopencv_imgcodecs.hpp"
+#include <climits>
+using std::vector;
+using std::string;
+using namespace cv;
+
+
+/**************************************************************\
+*                           Options                            *
+\**************************************************************/
+
+int parseImreadFlags(
+    vector<MxArray>::const_iterator first,
+    vector<MxArray>::const_iterator last,
+    bool& flip, bool file)
+{
+    ptrdiff_t len = std::distance(first, last);
+    nargchk((len % 2) == 0);
+    bool unchanged = false,
+         anydepth = false,
+         anycolor = false,
+         color = true,
+         gdal = false,
+         norotate = false;
+    int scale_denom = 1;
+    int flags = 0;
+    bool override = false;
+    flip = true;
+    for (; first != last; first += 2) {
+        string key(first->toString());
+        const MxArray& val = *(first + 1);
+        if (key == "Flags") {
+            flags = val.toInt();
+            override = true;
+        }
+        else if (key == "Unchanged")
+            unchanged = val.toBool();
+        else if (key == "AnyDepth")
+            anydepth = val.toBool();
+        else if (key == "AnyColor")
+            anycolor = val.toBool();
+        else if (key == "Grayscale") {
+            color = !val.toBool();
+            anycolor = false;
+        }
+        else if (key == "Color") {
+            color = val.toBool();
+            anycolor = false;
+        }
+        else if (key == "GDAL" && file)
+            gdal = val.toBool();
+        else if (key == "ReduceScale") {
+            scale_denom = val.toInt();
+            CV_Assert(scale_denom==1 || scale_denom==2 ||
+                scale_denom==4 || scale_denom==8);
+        }
+        else if (key == "IgnoreOrientation")
+            norotate = val.toBool();
+        else if (key == "FlipChannels")
+            flip = val.toBool();
+        else
+            mexErrMsgIdAndTxt("mexopencv:error",
+                "Unrecognized option %s", key.c_str());
+    }
+
+    // build flag value from options
+    if (!override) {
+        if (unchanged) {
+            // depth and cn as is (as determined by decoder).
+            // This is the only way to load alpha channel if present
+            flags = cv::IMREAD_UNCHANGED;
+        }
+        else if (gdal) {
+            // use GDAL as decoder
+            flags = cv::IMREAD_LOAD_GDAL;
+        }
+        else {
+            // depth as is, otherwise CV_8U
+            flags |= (anydepth ? cv::IMREAD_ANYDEPTH : 0);
+            // channels as is (if gray then cn=1, else cn=3 [BGR])
+            flags |= (anycolor ? cv::IMREAD_ANYCOLOR :
+                // otherwise explicitly either cn = 3 or cn = 1
+                (color ? cv::IMREAD_COLOR : cv::IMREAD_GRAYSCALE));
+
+            // image size reduction (this applies to both grayscale/color)
+            if (scale_denom > 1) {
+                if (scale_denom == 2)
+                    flags |= cv::IMREAD_REDUCED_GRAYSCALE_2;
+                else if (scale_denom == 4)
+                    flags |= cv::IMREAD_REDUCED_GRAYSCALE_4;
+                else if (scale_denom == 8)
+                    flags |= cv::IMREAD_REDUCED_GRAYSCALE_8;
+            }
+
+            // EXIF orientation
+            flags |= (norotate ? cv::IMREAD_IGNORE_ORIENTATION : 0);
+        }
+    }
+
+    return flags;
+}
+
+vector<int> parseImwriteParams(
+    vector<MxArray>::const_iterator first,
+    vector<MxArray>::const_iterator last,
+    bool& flip)
+{
+    ptrdiff_t len = std::distance(first, last);
+    nargchk((len % 2) == 0);
+    vector<int> params;
+    flip = true;
+    for (; first != last; first += 2) {
+        string key(first->toString());
+        const MxArray& val = *(first + 1);
+        if (key == "JpegQuality") {
+            params.push_back(cv::IMWRITE_JPEG_QUALITY);
+            params.push_back(val.toInt());
+        }
+        else if (key == "JpegProgressive") {
+            params.push_back(cv::IMWRITE_JPEG_PROGRESSIVE);
+            params.push_back(val.toBool() ? 1 : 0);
+        }
+        else if (key == "JpegOptimize") {
+            params.push_back(cv::IMWRITE_JPEG_OPTIMIZE);
+            params.push_back(val.toBool() ? 1 : 0);
+        }
+        else if (key == "JpegResetInterval") {
+            params.push_back(cv::IMWRITE_JPEG_RST_INTERVAL);
+            params.push_back(val.toInt());
+        }
+        else if (key == "JpegLumaQuality") {
+            params.push_back(cv::IMWRITE_JPEG_LUMA_QUALITY);
+            params.push_back(val.toInt());
+        }
+        else if (key == "JpegChromaQuality") {
+            params.push_back(cv::IMWRITE_JPEG_CHROMA_QUALITY);
+            params.push_back(val.toInt());
+        }
+        else if (key == "PngCompression") {
+            params.push_back(cv::IMWRITE_PNG_COMPRESSION);
+            params.push_back(val.toInt());
+        }
+        else if (key == "PngStrategy") {
+            params.push_back(cv::IMWRITE_PNG_STRATEGY);
+            params.push_back(PngStrategyMap[val.toString()]);
+        }
+        else if (key == "PngBilevel") {
+            params.push_back(cv::IMWRITE_PNG_BILEVEL);
+            params.push_back(val.toBool() ? 1 : 0);
+        }
+        else if (key == "PxmBinary") {
+            params.push_back(cv::IMWRITE_PXM_BINARY);
+            params.push_back(val.toBool() ? 1 : 0);
+        }
+        else if (key == "ExrType") {
+            params.push_back(cv::IMWRITE_EXR_TYPE);
+            params.push_back(ExrTypeMap[val.toString()]);
+        }
+        else if (key == "WebpQuality") {
+            params.push_back(cv::IMWRITE_WEBP_QUALITY);
+            params.push_back(val.toInt());
+        }
+        else if (key == "PamTupleType") {
+            params.push_back(cv::IMWRITE_PAM_TUPLETYPE);
+            params.push_back(PamFormatMap[val.toString()]);
+        }
+        else if (key == "Params") {
+            // append to parameters by directly passing a vector of integers
+            vector<int> pvec(val.toVector<int>());
+            if ((pvec.size()%2) != 0)
+                mexErrMsgIdAndTxt("mexopencv:error",
+                    "Params vectors must contain pairs of id/value.");
+            params.insert(params.end(), pvec.begin(), pvec.end());
+        }
+        else if (key == "FlipChannels")
+            flip = val.toBool();
+        else
+            mexErrMsgIdAndTxt("mexopencv:error",
+                "Unrecognized option %s", key.c_str());
+    }
+
+    return params;
+}
+
+
+/**************************************************************\
+*                           Batches                            *
+\**************************************************************/
+
+namespace {
+/// Check whether data prepared by MxArray::toColumnMajor fits a slice
+bool fitsSlice(const Mat& img, const Mat& slice)
+{
+    return (slice.dims == 3 && slice.size[0] == img.channels() &&
+        slice.size[1] == img.cols && slice.size[2] == img.rows &&
+        slice.depth() == img.depth());
+}
+
+/// Parallel loop body decoding images
+class DecodeInvoker : public ParallelLoopBody
+{
+  public:
+    /// Constructor
+    DecodeInvoker(const vector<string>& files, const vector<Mat>& buffers,
+        int flags, bool flip, vector<Mat>& outputs, vector<string>& errors)
+    : files_(files), buffers_(buffers), flags_(flags), flip_(flip),
+      outputs_(outputs), errors_(errors)
+    {}
+    /// Decode a range of images
+    virtual void operator()(const Range& range) const
+    {
+        for (int i = range.start; i < range.end; ++i) {
+            // each image has its own output and error slots
+            try {
+                Mat img = files_.empty() ? imdecode(buffers_[i], flags_) :
+                    imread(files_[i], flags_);
+                if (img.empty()) {
+                    errors_[i] = files_.empty() ? "imdecode failed" :
+                        "imread failed: " + files_[i];
+                    continue;
+                }
+                if (flip_)
+                    flipChannels(img);
+                // slices of a stack are preallocated
+                if (!outputs_[i].empty() && !fitsSlice(img, outputs_[i])) {
+                    errors_[i] = "image size or type differs from the "
+                        "first image of the stack";
+                    continue;
+                }
+                MxArray::toColumnMajor(img, outputs_[i]);
+            }
+            catch (const std::exception& e) {
+                errors_[i] = e.what();
+            }
+            catch (...) {
+                errors_[i] = "unknown error";
+            }
+        }
+    }
+  private:
+    const vector<string>& files_;
+    const vector<Mat>& buffers_;
+    int flags_;
+    bool flip_;
+    vector<Mat>& outputs_;
+    vector<string>& errors_;
+};
+
+/// Parallel loop body encoding images
+class EncodeInvoker : public ParallelLoopBody
+{
+  public:
+    /// Constructor
+    EncodeInvoker(const vector<BatchImage>& images,
+        const vector<string>& files, const string& ext,
+        const vector<int>& params, bool flip,
+        vector<vector<uchar> >& buffers, vector<string>& errors)
+    : images_(images), files_(files), ext_(ext), params_(params),
+      flip_(flip), buffers_(buffers), errors_(errors)
+    {}
+    /// Encode a range of images
+    virtual void operator()(const Range& range) const
+    {
+        for (int i = range.start; i < range.end; ++i) {
+            try {
+                Mat img(images_[i].toMat(imwriteDepth(images_[i].depth)));
+                if (flip_)
+                    flipChannels(img);
+                if (files_.empty()) {
+                    if (!imencode(ext_, img, buffers_[i], params_))
+                        errors_[i] = "imencode failed";
+                }
+                else if (!imwrite(files_[i], img, params_))
+                    errors_[i] = "imwrite failed: " + files_[i];
+            }
+            catch (const std::exception& e) {
+                errors_[i] = e.what();
+            }
+            catch (...) {
+                errors_[i] = "unknown error";
+            }
+        }
+    }
+  private:
+    const vector<BatchImage>& images_;
+    const vector<string>& files_;
+    const string& ext_;
+    const vector<int>& params_;
+    bool flip_;
+    vector<vector<uchar> >& buffers_;
+    vector<string>& errors_;
+};
+
+/** Run a loop body with one stripe per image, as their costs vary a lot.
+ * @param range range of images.
+ * @param body loop body, recording the error of each image.
+ *
+ * The error callback is suspended, so that cv::error throws to the bodies
+ * on all threads, the calling one included, instead of raising a MATLAB
+ * error from within the loop.
+ */
+void parallelPerItem(const Range& range, const ParallelLoopBody& body)
+{
+    ErrorCallbackSuspender suspender;
+    if (range.size() > 1)
+        parallel_for_(range, body, range.size());
+    else if (range.size() == 1)
+        body(range);
+}
+}
+
+MxArray decodeBatch(const vector<string>& files, const vector<Mat>& buffers,
+    int flags, bool flip, bool stack, const Size& sz,
+    vector<string>& errors)
+{
+    const int n = static_cast<int>(files.empty() ?
+        buffers.size() : files.size());
+    CV_Assert(sz.area() == n);
+    errors.assign(n, string());
+    vector<Mat> outputs(n);
+    DecodeInvoker body(files, buffers, flags, flip, outputs, errors);
+
+    if (!stack) {
+        // decoded images of a chunk are turned into MATLAB arrays before
+        // the next chunk is decoded
+        const int chunk = 4 * std::max(getNumThreads(), 1);
+        MxArray cell(MxArray::Cell(sz.height, sz.width));
+        for (int i = 0; i < n; i += chunk) {
+            const int end = std::min(i + chunk, n);
+            parallelPerItem(Range(i, end), body);
+            for (int j = i; j < end; ++j) {
+                if (errors[j].empty())
+                    cell.set(j, MxArray::fromColumnMajor(outputs[j]));
+                outputs[j].release();
+            }
+        }
+        return cell;
+    }
+
+    // the first decoded image determines the size of the stack, the others
+    // are then written directly into their slices
+    int k = 0;
+    for (; k < n; ++k) {
+        parallelPerItem(Range(k, k+1), body);
+        if (errors[k].empty())
+            break;
+    }
+    if (k == n)
+        return MxArray(Mat());
+    const Mat first(outputs[k]);
+    vector<mwSize> odims(first.size.p, first.size.p + first.dims);
+    std::reverse(odims.begin(), odims.end());
+    odims.push_back(n);
+    MxArray out(MxArray::Numeric(odims, first.depth()));
+    uchar *data = static_cast<uchar*>(
+        mxGetData(static_cast<const mxArray*>(out)));
+    const size_t frameBytes = first.total() * first.elemSize();
+    std::copy(first.data, first.data + frameBytes, data + k*frameBytes);
+    for (int i = 0; i < n; ++i)
+        outputs[i] = Mat(first.dims, first.size.p, first.type(),
+            data + i*frameBytes);
+    parallelPerItem(Range(k + 1, n), body);
+    return out;
+}
+
+void encodeBatch(const vector<BatchImage>& images,
+    const vector<string>& files, const string& ext,
+    const vector<int>& params, bool flip,
+    vector<vector<uchar> >& buffers, vector<string>& errors)
+{
+    const int n = static_cast<int>(images.size());
+    CV_Assert(files.empty() || files.size() == images.size());
+    errors.assign(n, string());
+    buffers.assign(files.empty() ? n : 0, vector<uchar>());
+    EncodeInvoker body(images, files, ext, params, flip, buffers, errors);
+    parallelPerItem(Range(0, n), body);
+}
+
+vector<bool> batchSuccess(const vector<string>& errors)
+{
+    vector<bool> ok(errors.size());
+    for (size_t i = 0; i < errors.size(); ++i)
+        ok[i] = errors[i].empty();
+    return ok;
+}
+
+void warnBatchErrors(const vector<string>& errors)
+{
+    size_t nfailed = 0, first = errors.size();
+    for (size_t i = 0; i < errors.size(); ++i) {
+        if (!errors[i].empty()) {
+            ++nfailed;
+            first = std::min(first, i);
+        }
+    }
+    if (nfailed > 0)
+        mexWarnMsgIdAndTxt("mexopencv:error",
+            "%d of %d elements of the batch failed, first error: %s",
+            static_cast<int>(nfailed), static_cast<int>(errors.size()),
+            errors[first].c_str());
+}
+
+
+/**************************************************************\
+*                             TIFF                             *
+\**************************************************************/
+
+namespace {
+/// Size in bytes of a value of each TIFF field type, 0 if not supported
+size_t typeSize(uint16_t type)
+{
+    const size_t sizes[] = {0, 1, 1, 2, 4, 8, 1, 1, 2, 4, 8, 4, 8, 4,
+        0, 0, 8, 8, 8};
+    return (type < sizeof(sizes)/sizeof(sizes[0])) ? sizes[type] : 0;
+}
+
+/// Decode an unsigned integer of n bytes in the given byte order
+uint64_t getUInt(const uchar *p, size_t n, bool bigEndian)
+{
+    uint64_t v = 0;
+    for (size_t i = 0; i < n; ++i)
+        v |= static_cast<uint64_t>(p[bigEndian ? i : n-1-i]) << (8*(n-1-i));
+    return v;
+}
+
+/// Encode an unsigned integer of n bytes in the given byte order
+void putUInt(uchar *p, uint64_t v, size_t n, bool bigEndian)
+{
+    for (size_t i = 0; i < n; ++i)
+        p[bigEndian ? n-1-i : i] = static_cast<uchar>(v >> (8*i));
+}
+
+/// First value of a field, or a default if absent, 0 if above INT_MAX
+int intField(const vector<uint64_t>& v, uint64_t def)
+{
+    const uint64_t x = v.empty() ? def : v[0];
+    return (x <= static_cast<uint64_t>(INT_MAX)) ? static_cast<int>(x) : 0;
+}
+
+/// Order of directory entries in a file
+bool entryLess(const TiffFile::Entry& a, const TiffFile::Entry& b)
+{
+    return a.tag < b.tag;
+}
+
+/// Tags describing the layout or location of data, which are not copied
+bool isLayoutTag(uint16_t tag)
+{
+    switch (tag) {
+        case 256:    // ImageWidth
+        case 257:    // ImageLength
+        case 273:    // StripOffsets
+        case 274:    // Orientation (blocks are never rotated)
+        case 278:    // RowsPerStrip
+        case 279:    // StripByteCounts
+        case 324:    // TileOffsets
+        case 325:    // TileByteCounts
+        case 330:    // SubIFDs
+        case 34665:  // ExifIFD
+        case 34853:  // GPSInfo
+        case 40965:  // InteroperabilityIFD
+            return true;
+        default:
+            return false;
+    }
+}
+}
+
+TiffFile::TiffFile(const string& filename)
+:   file_(filename.c_str(), std::ios::in | std::ios::binary),
+    size_(0), bigEndian_(false), big_(false)
+{
+    if (!file_)
+        mexErrMsgIdAndTxt("mexopencv:error", "Failed to open %s",
+            filename.c_str());
+    file_.seekg(0, std::ios::end);
+    size_ = static_cast<uint64_t>(file_.tellg());
+    file_.seekg(0, std::ios::beg);
+    uchar hdr[8] = {0};
+    file_.read(reinterpret_cast<char*>(hdr), sizeof(hdr));
+    if (!file_ || hdr[0] != hdr[1] || (hdr[0] != 'I' && hdr[0] != 'M'))
+        mexErrMsgIdAndTxt("mexopencv:error", "Not a TIFF file: %s",
+            filename.c_str());
+    bigEndian_ = (hdr[0] == 'M');
+    const uint64_t magic = getUInt(hdr + 2, 2, bigEndian_);
+    if (magic != 42 && magic != 43)
+        mexErrMsgIdAndTxt("mexopencv:error", "Not a TIFF file: %s",
+            filename.c_str());
+    big_ = (magic == 43);
+    uint64_t off = big_ ? readUInt(8, 8) : getUInt(hdr + 4, 4, bigEndian_);
+
+    // walk the chain of directories, guarding against cycles
+    const size_t head = big_ ? 8 : 2, esize = big_ ? 20 : 12;
+    while (off != 0 &&
+        std::find(ifds_.begin(), ifds_.end(), off) == ifds_.end()) {
+        ifds_.push_back(off);
+        const uint64_t n = readUInt(off, head);
+        if (!fits(off + head, n, esize))
+            mexErrMsgIdAndTxt("mexopencv:error", "Truncated TIFF file");
+        off = readUInt(off + head + n*esize, big_ ? 8 : 4);
+    }
+}
+
+bool TiffFile::isTiff(const string& filename)
+{
+    std::ifstream f(filename.c_str(), std::ios::in | std::ios::binary);
+    uchar hdr[4] = {0};
+    f.read(reinterpret_cast<char*>(hdr), sizeof(hdr));
+    if (!f || hdr[0] != hdr[1] || (hdr[0] != 'I' && hdr[0] != 'M'))
+        return false;
+    const uint64_t magic = getUInt(hdr + 2, 2, hdr[0] == 'M');
+    return (magic == 42 || magic == 43);
+}
+
+TiffFile::Directory TiffFile::directory(size_t page)
+{
+    if (page >= ifds_.size())
+        mexErrMsgIdAndTxt("mexopencv:error", "Page %d out of range",
+            static_cast<int>(page));
+    const uint64_t off = ifds_[page];
+    const size_t head = big_ ? 8 : 2, esize = big_ ? 20 : 12,
+        vsize = big_ ? 8 : 4;
+    const uint64_t n = readUInt(off, head);
+    if (!fits(off + head, n, esize))
+        mexErrMsgIdAndTxt("mexopencv:error", "Truncated TIFF file");
+    vector<uchar> raw(static_cast<size_t>(n * esize));
+    if (!raw.empty())
+        read(off + head, &raw[0], raw.size());
+
+    Directory dir;
+    for (size_t i = 0; i < n; ++i) {
+        const uchar *p = &raw[i*esize];
+        Entry e;
+        e.tag = static_cast<uint16_t>(getUInt(p, 2, bigEndian_));
+        e.type = static_cast<uint16_t>(getUInt(p + 2, 2, bigEndian_));
+        e.count = getUInt(p + 4, vsize, bigEndian_);
+        const size_t ts = typeSize(e.type);
+        if (ts == 0)
+            continue;  // unknown type
+        if (e.count <= vsize / ts) {
+            e.data.resize(static_cast<size_t>(e.count * ts));
+            std::copy(p + 4 + vsize, p + 4 + vsize + e.data.size(),
+                e.data.begin());
+        }
+        else {
+            // count comes from the file, check it before allocating
+            const uint64_t voff = getUInt(p + 4 + vsize, vsize, bigEndian_);
+            if (!fits(voff, e.count, ts))
+                mexErrMsgIdAndTxt("mexopencv:error", "Truncated TIFF file");
+            e.data.resize(static_cast<size_t>(e.count * ts));
+            read(voff, &e.data[0], e.data.size());
+        }
+        dir.entries.push_back(e);
+    }
+    std::stable_sort(dir.entries.begin(), dir.entries.end(), entryLess);
+
+    // fields describing the layout of the image
+    std::map<uint16_t, vector<uint64_t> > fields;
+    for (size_t i = 0; i < dir.entries.size(); ++i)
+        fields[dir.entries[i].tag] = values(dir.entries[i]);
+    if (fields[256].empty() || fields[257].empty())
+        mexErrMsgIdAndTxt("mexopencv:error", "Invalid TIFF directory");
+    dir.width = intField(fields[256], 0);
+    dir.height = intField(fields[257], 0);
+    dir.samples = intField(fields[277], 1);
+    dir.bits = intField(fields[258], 1);
+    dir.compression = intField(fields[259], 1);
+    dir.planar = intField(fields[284], 1);
+    dir.tiled = !fields[322].empty() && !fields[323].empty();
+    if (dir.tiled) {
+        dir.blockWidth = intField(fields[322], 0);
+        dir.blockHeight = intField(fields[323], 0);
+        dir.offsets = fields[324];
+        dir.byteCounts = fields[325];
+    }
+    else {
+        dir.blockWidth = dir.width;
+        // RowsPerStrip is often 2^32-1, meaning a single strip
+        dir.blockHeight = static_cast<int>(std::min<uint64_t>(
+            fields[278].empty() ? dir.height : fields[278][0], dir.height));
+        dir.offsets = fields[273];
+        dir.byteCounts = fields[279];
+    }
+    // sizes come from the file, check them before dividing by block sizes
+    if (dir.width <= 0 || dir.height <= 0 || dir.samples <= 0 ||
+        dir.blockWidth <= 0 || dir.blockHeight <= 0 ||
+        dir.blockWidth > INT_MAX - dir.width ||
+        dir.blockHeight > INT_MAX - dir.height)
+        mexErrMsgIdAndTxt("mexopencv:error", "Unsupported TIFF layout");
+    const size_t nblocks = static_cast<size_t>(dir.blocksAcross()) *
+        dir.blocksDown() * (dir.planar == 2 ? dir.samples : 1);
+    if (dir.offsets.size() < nblocks ||
+        dir.byteCounts.size() != dir.offsets.size())
+        mexErrMsgIdAndTxt("mexopencv:error", "Unsupported TIFF layout");
+    return dir;
+}
+
+Mat TiffFile::decodeBlock(const Directory& dir, size_t index, int flags)
+{
+    const size_t n = static_cast<size_t>(dir.blocksAcross()) *
+        dir.blocksDown();
+    CV_Assert(index < n);
+    const int bx = static_cast<int>(index % dir.blocksAcross()),
+        by = static_cast<int>(index / dir.blocksAcross());
+
+    // one block per plane when samples are stored separately
+    vector<size_t> indices;
+    for (int p = 0; p < (dir.planar == 2 ? dir.samples : 1); ++p)
+        indices.push_back(index + p*n);
+    readBlocks(dir, indices);
+    const int width = std::min(dir.blockWidth, dir.width - bx*dir.blockWidth),
+        height = std::min(dir.blockHeight,
+            dir.height - by*dir.blockHeight);
+    makeTiff(dir, width, height, buf_);
+    return decode(buf_, flags);
+}
+
+Mat TiffFile::decodeRows(const Directory& dir, const Range& rows, int flags)
+{
+    CV_Assert(!dir.tiled && dir.compression == 1 && dir.planar == 1);
+    CV_Assert(0 <= rows.start && rows.start < rows.end &&
+        rows.end <= dir.height);
+    const size_t rowBytes = dir.rowBytes();
+    const int rps = dir.blockHeight;
+    blocks_.resize(1);
+    blocks_[0].resize(rows.size() * rowBytes);
+    for (int r = rows.start; r < rows.end;) {
+        // consecutive rows of the same strip are read at once
+        const int k = r / rps, last = std::min(rows.end, (k + 1) * rps);
+        read(dir.offsets[k] + static_cast<uint64_t>(r - k*rps) * rowBytes,
+            &blocks_[0][(r - rows.start) * rowBytes], (last - r) * rowBytes);
+        r = last;
+    }
+    Directory band(dir);
+    band.blockHeight = rows.size();
+    makeTiff(band, dir.width, rows.size(), buf_);
+    return decode(buf_, flags);
+}
+
+Mat TiffFile::decodePage(const Directory& dir, int flags)
+{
+    extractPage(dir, buf_);
+    return decode(buf_, flags);
+}
+
+void TiffFile::extractPage(const Directory& dir, vector<uchar>& buf)
+{
+    vector<size_t> indices(static_cast<size_t>(dir.blocksAcross()) *
+        dir.blocksDown() * (dir.planar == 2 ? dir.samples : 1));
+    for (size_t k = 0; k < indices.size(); ++k)
+        indices[k] = k;
+    readBlocks(dir, indices);
+    makeTiff(dir, dir.width, dir.height, buf);
+}
+
+void TiffFile::readBlocks(const Directory& dir, const vector<size_t>& index)
+{
+    blocks_.resize(index.size());
+    for (size_t i = 0; i < index.size(); ++i) {
+        if (!fits(dir.offsets[index[i]], dir.byteCounts[index[i]], 1))
+            mexErrMsgIdAndTxt("mexopencv:error", "Truncated TIFF file");
+        blocks_[i].resize(static_cast<size_t>(dir.byteCounts[index[i]]));
+        if (!blocks_[i].empty())
+            read(dir.offsets[index[i]], &blocks_[i][0], blocks_[i].size());
+    }
+}
+
+bool TiffFile::fits(uint64_t offset, uint64_t count, size_t n) const
+{
+    return (offset <= size_ && count <= (size_ - offset) / n);
+}
+
+void TiffFile::read(uint64_t offset, void *buf, size_t n)
+{
+    file_.clear();
+    file_.seekg(static_cast<std::streamoff>(offset));
+    file_.read(static_cast<char*>(buf), static_cast<std::streamsize>(n));
+    if (!file_)
+        mexErrMsgIdAndTxt("mexopencv:error", "Truncated TIFF file");
+}
+
+uint64_t TiffFile::readUInt(uint64_t offset, size_t n)
+{
+    uchar buf[8];
+    read(offset, buf, n);
+    return getUInt(buf, n, bigEndian_);
+}
+
+vector<uint64_t> TiffFile::values(const Entry& e) const
+{
+    vector<uint64_t> v;
+    const size_t ts = typeSize(e.type);
+    // integer types only: BYTE, SHORT, LONG, SBYTE, SSHORT, SLONG, IFD,
+    // LONG8, SLONG8, IFD8
+    if (e.type == 2 || e.type == 5 || e.type == 7 || e.type == 10 ||
+        e.type == 11 || e.type == 12 || ts == 0)
+        return v;
+    v.reserve(static_cast<size_t>(e.count));
+    for (size_t i = 0; i < e.count; ++i)
+        v.push_back(getUInt(&e.data[i*ts], ts, bigEndian_));
+    return v;
+}
+
+void TiffFile::makeTiff(const Directory& dir, int width, int height,
+    vector<uchar>& buf) const
+{
+    const vector<vector<uchar> >& blocks = blocks_;
+    // entries describing the image, and the layout of the copied blocks
+    vector<Entry> entries;
+    for (size_t i = 0; i < dir.entries.size(); ++i) {
+        const Entry& e = dir.entries[i];
+        if (!isLayoutTag(e.tag) && e.type != 13 && e.type < 16)
+            entries.push_back(e);
+    }
+    const uint16_t offsetsTag = dir.tiled ? 324 : 273,
+        countsTag = dir.tiled ? 325 : 279;
+    vector<uint64_t> fields[5];
+    fields[0].assign(1, width);
+    fields[1].assign(1, height);
+    fields[2].assign(1, dir.blockHeight);
+    fields[3].assign(blocks.size(), 0);  // filled once laid out
+    for (size_t i = 0; i < blocks.size(); ++i)
+        fields[4].push_back(blocks[i].size());
+    const uint16_t tags[5] = {256, 257, 278, offsetsTag, countsTag};
+    for (int f = 0; f < 5; ++f) {
+        if (dir.tiled && tags[f] == 278)
+            continue;
+        Entry e;
+        e.tag = tags[f];
+        e.type = 4;  // LONG
+        e.count = fields[f].size();
+        e.data.resize(4 * fields[f].size());
+        for (size_t i = 0; i < fields[f].size(); ++i)
+            putUInt(&e.data[4*i], fields[f][i], 4, bigEndian_);
+        entries.push_back(e);
+    }
+    std::stable_sort(entries.begin(), entries.end(), entryLess);
+
+    // layout: header, directory, out-of-line values, then blocks
+    const size_t n = entries.size();
+    size_t pos = 8 + 2 + 12*n + 4;
+    vector<size_t> where(n, 0);
+    for (size_t i = 0; i < n; ++i) {
+        if (entries[i].data.size() > 4) {
+            pos += pos % 2;
+            where[i] = pos;
+            pos += entries[i].data.size();
+        }
+    }
+    vector<size_t> starts(blocks.size());
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        pos += pos % 2;
+        starts[i] = pos;
+        pos += blocks[i].size();
+    }
+    if (static_cast<uint64_t>(pos) > 0xFFFFFFFFu)
+        mexErrMsgIdAndTxt("mexopencv:error", "TIFF data too large");
+    for (size_t i = 0; i < n; ++i) {
+        if (entries[i].tag == offsetsTag)
+            for (size_t j = 0; j < starts.size(); ++j)
+                putUInt(&entries[i].data[4*j], starts[j], 4, bigEndian_);
+    }
+
+    // serialize in the byte order of the file, so values are copied as is
+    buf.assign(pos, 0);
+    buf[0] = buf[1] = (bigEndian_ ? 'M' : 'I');
+    putUInt(&buf[2], 42, 2, bigEndian_);
+    putUInt(&buf[4], 8, 4, bigEndian_);
+    putUInt(&buf[8], n, 2, bigEndian_);
+    for (size_t i = 0; i < n; ++i) {
+        const Entry& e = entries[i];
+        uchar *p = &buf[10 + 12*i];
+        putUInt(p, e.tag, 2, bigEndian_);
+        putUInt(p + 2, e.type, 2, bigEndian_);
+        putUInt(p + 4, e.count, 4, bigEndian_);
+        if (e.data.size() <= 4)
+            std::copy(e.data.begin(), e.data.end(), p + 8);
+        else {
+            putUInt(p + 8, where[i], 4, bigEndian_);
+            std::copy(e.data.begin(), e.data.end(), buf.begin() + where[i]);
+        }
+    }
+    for (size_t i = 0; i < blocks.size(); ++i)
+        std::copy(blocks[i].begin(), blocks[i].end(),
+            buf.begin() + starts[i]);
+}
+
+Mat TiffFile::decode(const vector<uchar>& buf, int flags) const
+{
+    Mat img = imdecode(buf, flags);
+    if (img.empty())
+        mexErrMsgIdAndTxt("mexopencv:error", "Failed to decode TIFF data");
+    return img;
+}
@@ -0,0 +1,339 @@
+/** Implementation of mexopencv_persistence.
+ * @file mexopencv_persistence.cpp
+ * @ingroup core
+ */
+
+#include "mexopencv_persistence.hpp"
+#include "opencv2/core/core_c.h"
+#include <cstring>
+#include <sstream>
+using std::vector;
+using std::string;
+using namespace cv;
+
+namespace {
+/// Amount of memory in bytes of the buffer a band of matrix rows goes through
+const size_t BAND_BYTES = 1024 * 1024;
+
+/// Characters of the element types of cv::FileStorage, indexed by depth
+const char DEPTH_CHARS[] = "ucwsifd";
+
+/** Parse the element type of an opencv-matrix node
+ * @param dt element type, e.g. "d" or "3u".
+ * @param depth receives the depth.
+ * @param cn receives the number of channels.
+ * @return false if not a supported element type.
+ */
+bool parseElemType(const string& dt, int& depth, int& cn)
+{
+    size_t i = 0;
+    cn = 0;
+    while (i < dt.size() && dt[i] >= '0' && dt[i] <= '9')
+        cn = cn*10 + (dt[i++] - '0');
+    if (cn == 0)
+        cn = 1;
+    if (i + 1 != dt.size() || cn > CV_CN_MAX)
+        return false;
+    const char *p = std::strchr(DEPTH_CHARS, dt[i]);
+    if (!p || *p == '\0')
+        return false;
+    depth = static_cast<int>(p - DEPTH_CHARS);
+    return true;
+}
+
+/// Copy a band of rows from interleaved row-major to MATLAB layout
+template <typename T>
+void bandToColumnMajor(const uchar *src, uchar *dst, int r0, int nrows,
+    int rows, int cols, int cn)
+{
+    const T *s = reinterpret_cast<const T*>(src);
+    T *d = reinterpret_cast<T*>(dst);
+    for (int r = 0; r < nrows; ++r)
+        for (int c = 0; c < cols; ++c)
+            for (int k = 0; k < cn; ++k)
+                d[(static_cast<size_t>(k)*cols + c)*rows + r0 + r] = *s++;
+}
+
+/// Copy a band of rows from MATLAB layout to interleaved row-major
+template <typename T>
+void bandFromColumnMajor(const uchar *src, uchar *dst, int r0, int nrows,
+    int rows, int cols, int cn)
+{
+    const T *s = reinterpret_cast<const T*>(src);
+    T *d = reinterpret_cast<T*>(dst);
+    for (int r = 0; r < nrows; ++r)
+        for (int c = 0; c < cols; ++c)
+            for (int k = 0; k < cn; ++k)
+                *d++ = s[(static_cast<size_t>(k)*cols + c)*rows + r0 + r];
+}
+
+/// Band copy function, by size of elements
+typedef void (*BandFunc)(const uchar*, uchar*, int, int, int, int, int);
+
+/// Band copy function for elements of a given size in bytes
+BandFunc bandFunc(size_t esz, bool toColumnMajor)
+{
+    switch (esz) {
+        case 1: return toColumnMajor ? bandToColumnMajor<uint8_t> :
+            bandFromColumnMajor<uint8_t>;
+        case 2: return toColumnMajor ? bandToColumnMajor<uint16_t> :
+            bandFromColumnMajor<uint16_t>;
+        case 4: return toColumnMajor ? bandToColumnMajor<uint32_t> :
+            bandFromColumnMajor<uint32_t>;
+        default: return toColumnMajor ? bandToColumnMajor<uint64_t> :
+            bandFromColumnMajor<uint64_t>;
+    }
+}
+
+/** Read a dense matrix node straight into a MATLAB array
+ * @param node opencv-matrix node.
+ * @param x receives the MATLAB array.
+ * @return false if the node is not supported (e.g. empty matrix), in which
+ *    case it is read through a cv::Mat.
+ */
+bool readMatrix(const FileNode& node, MxArray& x)
+{
+    const int rows = static_cast<int>(node["rows"]),
+        cols = static_cast<int>(node["cols"]);
+    const string dt(static_cast<string>(node["dt"]));
+    int depth, cn;
+    if (!parseElemType(dt, depth, cn) || rows <= 0 || cols <= 0)
+        return false;
+    const FileNode data(node["data"]);
+    const size_t rowElems = static_cast<size_t>(cols) * cn;
+    if (data.type() != FileNode::SEQ || data.size() != rows * rowElems)
+        return false;
+
+    vector<mwSize> dims(2);
+    dims[0] = rows;
+    dims[1] = cols;
+    if (cn > 1)
+        dims.push_back(cn);
+    x = MxArray::Numeric(dims, depth);
+    uchar *dst = static_cast<uchar*>(mxGetData(static_cast<mxArray*>(x)));
+
+    // decoded by bands of rows into a small buffer, then scattered
+    const size_t esz = CV_ELEM_SIZE1(depth);
+    const int band = static_cast<int>(std::min<size_t>(rows,
+        std::max<size_t>(1, BAND_BYTES / (rowElems * esz))));
+    vector<uchar> buf(band * rowElems * esz);
+    const BandFunc copy = bandFunc(esz, true);
+    FileNodeIterator it = data.begin();
+    for (int r0 = 0; r0 < rows; r0 += band) {
+        const int n = std::min(band, rows - r0);
+        it.readRaw(dt, &buf[0], static_cast<size_t>(n) * cols);
+        copy(&buf[0], dst, r0, n, rows, cols, cn);
+    }
+    return true;
+}
+
+/** Write a numeric array as a dense matrix node, straight from its memory
+ * @param fs FileStorage object, expecting a value.
+ * @param x numeric array.
+ * @return false if the array is not supported (e.g. empty, more than 3
+ *    dimensions, or a class without equivalent depth), in which case it is
+ *    written through a cv::Mat.
+ */
+bool writeMatrix(FileStorage& fs, const MxArray& x)
+{
+    int depth;
+    switch (x.classID()) {
+        case mxLOGICAL_CLASS:
+        case mxUINT8_CLASS:  depth = CV_8U;  break;
+        case mxINT8_CLASS:   depth = CV_8S;  break;
+        case mxUINT16_CLASS: depth = CV_16U; break;
+        case mxINT16_CLASS:  depth = CV_16S; break;
+        case mxINT32_CLASS:  depth = CV_32S; break;
+        case mxSINGLE_CLASS: depth = CV_32F; break;
+        case mxDOUBLE_CLASS: depth = CV_64F; break;
+        default: return false;
+    }
+    if (x.isComplex() || x.isSparse() || x.numel() == 0 || x.ndims() > 3)
+        return false;
+    const mwSize *d = x.dims();
+    const int rows = static_cast<int>(d[0]), cols = static_cast<int>(d[1]),
+        cn = (x.ndims() > 2) ? static_cast<int>(d[2]) : 1;
+    if (cn > CV_CN_MAX)
+        return false;
+    if (fs.state == FileStorage::NAME_EXPECTED + FileStorage::INSIDE_MAP)
+        mexErrMsgIdAndTxt("mexopencv:error",
+            "No element name has been given");
+
+    // same layout as cv::write for a cv::Mat
+    const string dt((cn > 1) ? format("%d%c", cn, DEPTH_CHARS[depth]) :
+        string(1, DEPTH_CHARS[depth]));
+    CvFileStorage *cfs = *fs;
+    cvStartWriteStruct(cfs, fs.elname.empty() ? 0 : fs.elname.c_str(),
+        CV_NODE_MAP, CV_TYPE_NAME_MAT);
+    cvWriteInt(cfs, "rows", rows);
+    cvWriteInt(cfs, "cols", cols);
+    cvWriteString(cfs, "dt", dt.c_str(), 0);
+    cvStartWriteStruct(cfs, "data", CV_NODE_SEQ + CV_NODE_FLOW);
+    const size_t esz = CV_ELEM_SIZE1(depth),
+        rowElems = static_cast<size_t>(cols) * cn;
+    const int band = static_cast<int>(std::min<size_t>(rows,
+        std::max<size_t>(1, BAND_BYTES / (rowElems * esz))));
+    vector<uchar> buf(band * rowElems * esz);
+    const BandFunc copy = bandFunc(esz, false);
+    const uchar *src = static_cast<const uchar*>(
+        mxGetData(static_cast<const mxArray*>(x)));
+    for (int r0 = 0; r0 < rows; r0 += band) {
+        const int n = std::min(band, rows - r0);
+        copy(src, &buf[0], r0, n, rows, cols, cn);
+        cvWriteRawData(cfs, &buf[0], n * cols, dt.c_str());
+    }
+    cvEndWriteStruct(cfs);
+    cvEndWriteStruct(cfs);
+    if (fs.state & FileStorage::INSIDE_MAP)
+        fs.state = FileStorage::NAME_EXPECTED + FileStorage::INSIDE_MAP;
+    return true;
+}
+}
+
+
+/**************************************************************\
+*                           Reading                            *
+\**************************************************************/
+
+bool isa(const FileNode& node, const string& type_name)
+{
+    const CvFileNode* pnode = (*node);
+    return (pnode && pnode->info && pnode->info->type_name) ?
+        (string(pnode->info->type_name) == type_name) : false;
+}
+
+MxArray readNode(const FileNode& node)
+{
+    switch (node.type()) {
+        case FileNode::INT:
+            return MxArray(static_cast<int>(node));
+        case FileNode::REAL:
+            return MxArray(static_cast<double>(node));
+        case FileNode::STR:
+            return MxArray(static_cast<string>(node));
+        case FileNode::SEQ: {
+            vector<MxArray> v;
+            v.reserve(node.size());
+            for (FileNodeIterator it = node.begin(); it != node.end(); ++it)
+                v.push_back(readNode(*it));
+            return MxArray(v);
+        }
+        case FileNode::MAP: {
+            if (isa(node, "opencv-matrix")) {
+                MxArray x(static_cast<mxArray*>(NULL));
+                if (readMatrix(node, x))
+                    return x;
+                Mat m;
+                node >> m;
+                return MxArray(m);
+            }
+            else if (isa(node, "opencv-nd-matrix")) {
+                MatND m;
+                node >> m;
+                return MxArray(m);
+            }
+            else if (isa(node, "opencv-sparse-matrix")) {
+                SparseMat m;
+                node >> m;
+                return MxArray(m);
+            }
+            MxArray x = MxArray::Struct();
+            int i = 1;
+            for (FileNodeIterator it = node.begin(); it != node.end(); ++it) {
+                const FileNode& elem = (*it);
+                if (elem.type() == FileNode::NONE)
+                    continue;
+                string name(elem.name());
+                if (name.empty()) {
+                    //HACK: create a unique field name for the current struct
+                    std::ostringstream ss;
+                    ss << "x" << (i++);
+                    name = ss.str();
+                }
+                x.set(name, readNode(elem));
+            }
+            return x;
+        }
+        default:
+            return MxArray(Mat());
+    }
+}
+
+string nodeTypeName(const FileNode& node)
+{
+    switch (node.type()) {
+        case FileNode::INT:  return "int";
+        case FileNode::REAL: return "real";
+        case FileNode::STR:  return "str";
+        case FileNode::SEQ:  return "seq";
+        case FileNode::MAP:
+            return isa(node, "opencv-matrix") ? "matrix" :
+                (isa(node, "opencv-nd-matrix") ? "nd-matrix" :
+                (isa(node, "opencv-sparse-matrix") ? "sparse-matrix" :
+                "map"));
+        default:
+            return "none";
+    }
+}
+
+
+/**************************************************************\
+*                           Writing                            *
+\**************************************************************/
+
+void writeNode(FileStorage& fs, const MxArray& x, bool root)
+{
+    mxClassID classid = x.classID();
+    switch (classid) {
+        case mxUNKNOWN_CLASS:
+        case mxFUNCTION_CLASS:
+            mexErrMsgIdAndTxt("mexopencv:error", "Invalid MxArray");
+            break;
+        case mxSTRUCT_CLASS: {
+            mwSize n = x.numel();
+            vector<string> fields(x.fieldnames());
+            if (n > 1) fs << "[";
+            for (mwIndex i=0; i<n; ++i) {
+                if (!root) fs << "{";
+                for (vector<string>::const_iterator it = fields.begin();
+                    it != fields.end(); ++it) {
+                    fs << (*it);
+                    writeNode(fs, MxArray(x.at(*it, i)));
+                }
+                if (!root) fs << "}";
+            }
+            if (n > 1) fs << "]";
+            break;
+        }
+        case mxCELL_CLASS: {
+            vector<MxArray> arr(x.toVector<MxArray>());
+            fs << "[";
+            for (vector<MxArray>::const_iterator it = arr.begin();
+                it != arr.end(); ++it)
+                writeNode(fs, *it);
+            fs << "]";
+            break;
+        }
+        case mxCHAR_CLASS:
+            fs << x.toString();
+            break;
+        default:  // x.isNumeric() or x.isLogical()
+            if (x.numel() == 1) {
+                switch (classid) {
+                    case mxDOUBLE_CLASS:
+                        fs << x.toDouble();
+                        break;
+                    case mxSINGLE_CLASS:
+                        fs << x.toFloat();
+                        break;
+                    default:
+                        fs << x.toInt();
+                        break;
+                }
+            }
+            else if (x.isSparse())
+                fs << x.toSparseMat();
+            else if (!writeMatrix(fs, x))
+                fs << x.toMat();
+    }
+}
@@ -0,0 +1,567 @@
+function varargout = PerfTest(varargin)
+    %PERFTEST  Helper function for mexopencv performance benchmarks
+    %
+    %     [results, passed] = PerfTest()
+    %     [...] = PerfTest('OptionName',optionValue, ...)
+    %
+    % ## Options
+    % * __MatchPattern__ regex pattern to filter benchmark classes. Only
+    %   matched classes are kept. default empty (no filtering)
+    % * __Sizes__ cell array of image sizes `[rows,cols]` each benchmark is
+    %   run with. default `{[240 320], [480 640], [1080 1920]}`
+    % * __Classes__ cell array of image classes. default `{'uint8','single'}`
+    % * __Channels__ vector of channel counts. default `[1 3]`
+    % * __Repeat__ number of timed samples per benchmark and configuration.
+    %   default 10
+    % * __MinTime__ minimum duration (in seconds) of a timed sample, fast
+    %   calls are repeated within a sample to reach it. default 0.001
+    % * __Verbosity__ Verbosity level. default 1:
+    %   * __0__ quiet mode.
+    %   * __1__ dot-matrix output (one character per benchmark, either ".",
+    %     "S", "R", or "F").
+    %   * __2__ verbose output, one line per benchmark (name, configuration,
+    %     median time and comparison against baseline).
+    % * __DryRun__ dont actually run the benchmarks, just print them.
+    %   default false
+    % * __JSONFile__ export results to a JSON file. default is `perf.json`.
+    %   Set to empty string to disable report.
+    % * __Baseline__ JSON file of previous results (as written by the
+    %   `JSONFile` option) to compare against. default empty (no comparison)
+    % * __Tolerance__ relative slowdown of the median time against the
+    %   baseline above which a benchmark is flagged as a regression.
+    %   default 0.2 (20% slower)
+    %
+    % ## Output
+    % * __results__ output structure of results with the following fields:
+    %   * __Duration__ total time elapsed running all benchmarks.
+    %   * __Timestamp__ when benchmark suite was executed (serial date).
+    %   * __Passed__ number of benchmarks run.
+    %   * __Failed__ number of benchmarks that threw an error.
+    %   * __Incomplete__ number of benchmarks skipped.
+    %   * __Regressed__ number of benchmarks slower than the baseline.
+    %   * __Details__ structure array (one struct for each benchmark, kind
+    %     and configuration) with the following fields:
+    %     * __Id__ unique identifier `Name/Kind/RowsxCols/Class/Channels`.
+    %     * __Name__ benchmark name.
+    %     * __Kind__ what is measured, one of:
+    %       * __Conversion__ conversion between MATLAB arrays and `cv::Mat`
+    %         only.
+    %       * __Compute__ computation only, as measured by the profiling
+    %         counters of the function (see cv.Utils.getProfile).
+    %       * __EndToEnd__ complete call from MATLAB arrays to MATLAB arrays.
+    %     * __Size__ image size `[rows,cols]`.
+    %     * __Class__ image class.
+    %     * __Channels__ number of channels.
+    %     * __Samples__ number of timed samples.
+    %     * __Calls__ number of calls per sample.
+    %     * __Median__, __Min__, __Mean__ time per call (msec).
+    %     * __Baseline__ median time per call (msec) of the baseline, NaN if
+    %       not available.
+    %     * __Ratio__ ratio `Median/Baseline`.
+    %     * __Regressed__ boolean indicating a regression.
+    %     * __Status__ one of 'passed', 'failed', or 'skipped'.
+    %     * __Exception__ exception thrown if failed/skipped.
+    % * __passed__ boolean, true if no benchmark failed or regressed.
+    %
+    % ## Usage
+    %
+    %     cd test;
+    %     PerfTest('JSONFile','base.json');          % on a reference build
+    %     [r,pass] = PerfTest('Baseline','base.json');
+    %     t = struct2table(r.Details);
+    %     t(t.Regressed,:)                           % inspect regressions
+    %
+    % Benchmarks are classes named `Perf*` in the `test/perf` directory,
+    % with static methods whose name start with "perf". Each method takes an
+    % input image, and returns a structure whose fields are named after the
+    % kind of measurement (`Conversion`, `Compute`, `EndToEnd`), each holding
+    % a function handle taking no arguments that is timed. Preparation work
+    % done in the method itself is not timed. A method throws an error with
+    % the 'mexopencv:testskip' identifier when the image configuration is
+    % not supported.
+    %
+    % `Compute` handles are not timed with the wall clock, since a call
+    % includes the conversion of its arguments. Instead they return the time
+    % (in seconds) spent in the computation, as recorded by the functions
+    % instrumented for profiling (see cv.Utils.setUseProfile). Other
+    % functions only have `EndToEnd` benchmarks.
+    %
+    % See also: UnitTest, timeit
+    %
+
+    % parse inputs
+    nargoutchk(0,2);
+    opts = parse_options(varargin{:});
+
+    % collect benchmarks
+    addpath(opts.PerfDir);
+    names = perfsuite_fromFolder(opts.PerfDir, opts);
+
+    % load baseline
+    baseline = struct('Id',{{}}, 'Median',[]);
+    if ~isempty(opts.Baseline)
+        baseline = import_json(opts.Baseline);
+    end
+
+    % run suite
+    [results, passed] = perfsuite_run(names, baseline, opts);
+
+    % JSON report
+    if ~isempty(opts.JSONFile) && ~opts.DryRun
+        export_json(results, opts.JSONFile);
+    end
+
+    % output
+    if nargout > 0, varargout{1} = results; end
+    if nargout > 1, varargout{2} = passed; end
+end
+
+function opts = parse_options(varargin)
+    %PARSE_OPTIONS  Help function to parse input arguments
+    %
+    %     opts = parse_options(...)
+    %
+    % ## Output
+    % * __opts__ options structure.
+    %
+    % See also: inputParser
+    %
+
+    % helper function to validate true/false arguments
+    isbool = @(x) isscalar(x) && (islogical(x) || isnumeric(x));
+
+    %HACK: Octave inputParser: 4.0.x has addParamValue, 4.2.0 has addParameter
+    p = inputParser();
+    if mexopencv.isOctave() && compare_versions(version(), '4.2.0', '<')
+        addParam = @(varargin) p.addParamValue(varargin{:}); %#ok<NVREPL>
+    else
+        addParam = @(varargin) p.addParameter(varargin{:});
+    end
+    addParam('MatchPattern', '', @ischar);
+    addParam('Sizes', {[240 320], [480 640], [1080 1920]}, @iscell);
+    addParam('Classes', {'uint8', 'single'}, @iscellstr);
+    addParam('Channels', [1 3], @isnumeric);
+    addParam('Repeat', 10, @isnumeric);
+    addParam('MinTime', 0.001, @isnumeric);
+    addParam('Verbosity', 1, @isnumeric);
+    addParam('DryRun', false, isbool);
+    addParam('JSONFile', 'perf.json', @ischar);
+    addParam('Baseline', '', @ischar);
+    addParam('Tolerance', 0.2, @isnumeric);
+    p.parse(varargin{:});
+    opts = p.Results;
+
+    opts.DryRun = logical(opts.DryRun);
+    assert(opts.Repeat >= 1, 'PerfTest:error', 'Invalid Repeat');
+
+    % directory of benchmark classes
+    opts.PerfDir = fullfile(mexopencv.root(), 'test', 'perf');
+end
+
+function names = perfsuite_fromFolder(dpath, opts)
+    %PERFSUITE_FROMFOLDER  List benchmarks of all classes in a folder
+    %
+    %     names = perfsuite_fromFolder(dpath, opts)
+    %
+    % ## Input
+    % * __dpath__ Folder containing benchmark classes `Perf*.m`.
+    % * __opts__ Options structure.
+    %
+    % ## Output
+    % * __names__ Cell array of benchmark names `Class.method` discovered.
+    %
+
+    % list of all benchmark classes
+    klasses = dir(fullfile(dpath, 'Perf*.m'));
+    klasses = regexprep({klasses.name}, '\.m$', '');
+
+    % keep only classes that match the specified pattern
+    if ~isempty(opts.MatchPattern)
+        idx = ~cellfun(@isempty, regexp(klasses, opts.MatchPattern, 'once'));
+        klasses = klasses(idx);
+    end
+    klasses = sort(klasses(:));
+
+    % static methods starting with the 'perf' prefix
+    names = {};
+    for i=1:numel(klasses)
+        mc = meta.class.fromName(klasses{i});
+        assert(~isempty(mc), 'PerfTest:error', 'Benchmark class not found');
+        if ~mexopencv.isOctave() && isprop(mc, 'MethodList')
+            mt = findobj(mc.MethodList, '-regexp', 'Name','^perf', ...
+                '-and', 'Static',true);
+            m = {mt.Name};
+        else
+            idx = cellfun(@(m) m.Static, mc.Methods);
+            m = cellfun(@(m) m.Name, mc.Methods(idx), 'UniformOutput',false);
+            m = m(strncmp('perf', m, length('perf')));
+        end
+        names = [names; strcat(mc.Name, '.', sort(m(:)))]; %#ok<AGROW>
+    end
+end
+
+function [results, passed] = perfsuite_run(names, baseline, opts)
+    %PERFSUITE_RUN  Execute all benchmarks for all configurations
+    %
+    %     [results, passed] = perfsuite_run(names, baseline, opts)
+    %
+    % ## Input
+    % * __names__ Cell array of benchmark names to run.
+    % * __baseline__ Structure with `Id` and `Median` of baseline results.
+    % * __opts__ Options structure.
+    %
+    % ## Output
+    % * __results__ output structure of results.
+    % * __passed__ boolean, true if no benchmark failed or regressed.
+    %
+
+    if opts.Verbosity > 1
+        fprintf('%-55s %-9s %-10s %-7s %2s %10s %10s %7s\n', 'Benchmark', ...
+            'Kind', 'Size', 'Class', 'cn', 'Med (ms)', 'Base (ms)', 'Ratio');
+    end
+
+    res = struct('Id',{}, 'Name',{}, 'Kind',{}, 'Size',{}, 'Class',{}, ...
+        'Channels',{}, 'Samples',{}, 'Calls',{}, 'Median',{}, 'Min',{}, ...
+        'Mean',{}, 'Baseline',{}, 'Ratio',{}, 'Regressed',{}, ...
+        'Status',{}, 'Exception',{});
+    ts = now();
+    tid = tic();
+    for i=1:numel(opts.Sizes)
+        for j=1:numel(opts.Classes)
+            for k=1:numel(opts.Channels)
+                img = make_image(opts.Sizes{i}, opts.Classes{j}, ...
+                    opts.Channels(k));
+                for n=1:numel(names)
+                    r = perfcase_run(names{n}, img, opts);
+                    for m=1:numel(r)
+                        r(m) = compare_baseline(r(m), baseline, opts);
+                        print_result(r(m), opts);
+                    end
+                    res = [res, r]; %#ok<AGROW>
+                end
+            end
+        end
+    end
+
+    results = struct();
+    results.Duration = toc(tid);
+    results.Timestamp = ts;
+    results.Passed = nnz(strcmp({res.Status}, 'passed'));
+    results.Failed = nnz(strcmp({res.Status}, 'failed'));
+    results.Incomplete = nnz(strcmp({res.Status}, 'skipped'));
+    results.Regressed = nnz([res.Regressed]);
+    results.Details = res;
+    passed = (results.Failed == 0) && (results.Regressed == 0);
+
+    if opts.Verbosity > 0
+        fprintf('\n\nTotals:\n');
+        fprintf('  %d Passed, %d Failed, %d Incomplete, %d Regressed\n', ...
+            results.Passed, results.Failed, results.Incomplete, ...
+            results.Regressed);
+        fprintf('  Elapsed time is %f seconds.\n', results.Duration);
+        for i=1:numel(res)
+            if strcmp(res(i).Status, 'failed')
+                fprintf('\n===== Failure: %s =====\n%s\n', res(i).Id, ...
+                    res(i).Exception.message);
+            elseif res(i).Regressed
+                fprintf('\n===== Regression: %s =====\n', res(i).Id);
+                fprintf('  %.3f ms vs %.3f ms (%.2fx)\n', res(i).Median, ...
+                    res(i).Baseline, res(i).Ratio);
+            end
+        end
+    end
+end
+
+function img = make_image(sz, klass, cn)
+    %MAKE_IMAGE  Create a random image of the given configuration
+    %
+    %     img = make_image(sz, klass, cn)
+    %
+
+    img = randi([0 255], [sz(1) sz(2) cn]);
+    if any(strcmp(klass, {'single', 'double'}))
+        img = cast(img / 255, klass);
+    else
+        img = cast(img, klass);
+    end
+end
+
+function res = perfcase_run(name, img, opts)
+    %PERFCASE_RUN  Run a benchmark for one image configuration
+    %
+    %     res = perfcase_run(name, img, opts)
+    %
+    % ## Input
+    % * __name__ benchmark name to run.
+    % * __img__ input image.
+    % * __opts__ Options structure.
+    %
+    % ## Output
+    % * __res__ structure array of results, one for each kind measured.
+    %
+
+    % template result
+    r = struct('Id','', 'Name',name, 'Kind','', ...
+        'Size',[size(img,1) size(img,2)], 'Class',class(img), ...
+        'Channels',size(img,3), 'Samples',0, 'Calls',0, 'Median',NaN, ...
+        'Min',NaN, 'Mean',NaN, 'Baseline',NaN, 'Ratio',NaN, ...
+        'Regressed',false, 'Status','skipped', 'Exception',[]);
+    res = r([]);
+
+    % prepare function handles
+    try
+        if opts.DryRun
+            fcns = struct('EndToEnd',[]);
+        elseif mexopencv.isOctave()
+            %HACK: Octave errors on feval of a "Class.Method"
+            fcns = eval([name '(img)']);
+        else
+            fcns = feval(name, img);
+        end
+    catch ME
+        r.Id = make_id(r);
+        if ~strcmp(ME.identifier, 'mexopencv:testskip')
+            r.Status = 'failed';
+        end
+        r.Exception = ME;
+        res = r;
+        return;
+    end
+
+    % time each kind
+    kinds = fieldnames(fcns);
+    for i=1:numel(kinds)
+        r.Kind = kinds{i};
+        r.Id = make_id(r);
+        r.Status = 'passed';
+        r.Exception = [];
+        if ~opts.DryRun
+            try
+                [t, calls] = time_function(fcns.(kinds{i}), opts, ...
+                    strcmp(kinds{i}, 'Compute'));
+                r.Samples = numel(t);
+                r.Calls = calls;
+                r.Median = median(t) * 1000;
+                r.Min = min(t) * 1000;
+                r.Mean = mean(t) * 1000;
+            catch ME
+                r.Status = 'failed';
+                r.Exception = ME;
+            end
+        end
+        res(end+1) = r; %#ok<AGROW>
+    end
+end
+
+function id = make_id(r)
+    %MAKE_ID  Unique identifier of a benchmark result
+    id = sprintf('%s/%s/%dx%d/%s/%d', r.Name, r.Kind, r.Size, r.Class, ...
+        r.Channels);
+end
+
+function [t, calls] = time_function(fcn, opts, selfTimed)
+    %TIME_FUNCTION  Time a function handle
+    %
+    %     [t, calls] = time_function(fcn, opts, selfTimed)
+    %
+    % ## Input
+    % * __fcn__ function handle taking no arguments.
+    % * __opts__ Options structure.
+    % * __selfTimed__ if true, `fcn` returns its own time in seconds, which
+    %   is used instead of the wall-clock time.
+    %
+    % ## Output
+    % * __t__ time per call (in seconds) of each sample.
+    % * __calls__ number of calls per sample.
+    %
+    % The first (warm-up) call is not timed, it also determines how many
+    % calls are grouped in a sample to reach the minimum sample duration.
+    %
+    % See also: timeit
+    %
+
+    tid = tic();
+    fcn();
+    t0 = toc(tid);
+    calls = max(1, ceil(opts.MinTime / max(t0, eps)));
+    t = zeros(1, opts.Repeat);
+    for i=1:opts.Repeat
+        if selfTimed
+            for j=1:calls
+                t(i) = t(i) + fcn();
+            end
+        else
+            tid = tic();
+            for j=1:calls
+                fcn();
+            end
+            t(i) = toc(tid);
+        end
+        t(i) = t(i) / calls;
+    end
+end
+
+function r = compare_baseline(r, baseline, opts)
+    %COMPARE_BASELINE  Compare a result against the baseline
+    %
+    %     r = compare_baseline(r, baseline, opts)
+    %
+
+    idx = find(strcmp(baseline.Id, r.Id), 1);
+    if isempty(idx) || ~strcmp(r.Status, 'passed'), return; end
+    r.Baseline = baseline.Median(idx);
+    r.Ratio = r.Median / r.Baseline;
+    r.Regressed = r.Ratio > (1 + opts.Tolerance);
+end
+
+function print_result(r, opts)
+    %PRINT_RESULT  Display progress of a benchmark result
+    %
+    %     print_result(r, opts)
+    %
+
+    persistent n
+    if isempty(n), n = 0; end
+    if opts.Verbosity > 1
+        fprintf('%-55s %-9s %-10s %-7s %2d ', r.Name, r.Kind, ...
+            sprintf('%dx%d', r.Size), r.Class, r.Channels);
+        switch r.Status
+            case 'passed'
+                fprintf('%10.3f %10.3f %6.2fx', r.Median, r.Baseline, ...
+                    r.Ratio);
+                if r.Regressed, fprintf(' REGRESSED'); end
+                fprintf('\n');
+            case 'skipped'
+                fprintf('SKIP\n');
+            otherwise
+                fprintf('FAIL\n');
+        end
+    elseif opts.Verbosity > 0
+        if strcmp(r.Status, 'failed')
+            fprintf('F');
+        elseif strcmp(r.Status, 'skipped')
+            fprintf('S');
+        elseif r.Regressed
+            fprintf('R');
+        else
+            fprintf('.');
+        end
+        n = n + 1;
+        if mod(n, 80) == 0
+            fprintf('\n');
+        end
+    end
+end
+
+function str = json_string(str)
+    %JSON_STRING  Quote and escape a JSON string
+
+    str = strrep(str, '\', '\\');
+    str = strrep(str, '"', '\"');
+    str = ['"' str '"'];
+end
+
+function str = json_number(x)
+    %JSON_NUMBER  Format a JSON number, NaN is written as null
+
+    if isnan(x)
+        str = 'null';
+    else
+        str = sprintf('%.6g', x);
+    end
+end
+
+function export_json(results, fname)
+    %EXPORT_JSON  Save benchmark results in JSON format
+    %
+    %     export_json(results, fname)
+    %
+    % ## Input
+    % * __results__ output structure of results.
+    % * __fname__ name of JSON file.
+    %
+    % Results are written one per line, so that files can be compared with
+    % line-oriented tools as well.
+    %
+    % See also: jsonencode
+    %
+
+    % platform information
+    if mexopencv.isOctave()
+        platform = ['Octave ' version()];
+    else
+        platform = ['MATLAB ' version()];
+    end
+    cvver = cv.Utils.version();
+
+    fid = fopen(fname, 'wt');
+    assert(fid ~= -1, 'PerfTest:error', 'Failed to open %s', fname);
+    cObj = onCleanup(@() fclose(fid));
+    fprintf(fid, '{\n');
+    fprintf(fid, '"timestamp": %s,\n', ...
+        json_string(datestr(results.Timestamp, 'yyyy-mm-ddTHH:MM:SS')));
+    fprintf(fid, '"platform": %s,\n', json_string(platform));
+    fprintf(fid, '"opencv": %s,\n', json_string(cvver));
+    fprintf(fid, '"arch": %s,\n', json_string(computer('arch')));
+    fprintf(fid, '"duration": %s,\n', json_number(results.Duration));
+    fprintf(fid, '"results": [');
+    for i=1:numel(results.Details)
+        r = results.Details(i);
+        if i > 1, fprintf(fid, ','); end
+        fprintf(fid, ['\n{"id": %s, "name": %s, "kind": %s, ' ...
+            '"size": [%d, %d], "class": %s, "channels": %d, ' ...
+            '"status": %s, "samples": %d, "calls": %d, "median": %s, ' ...
+            '"min": %s, "mean": %s, "baseline": %s, "regressed": %s}'], ...
+            json_string(r.Id), json_string(r.Name), json_string(r.Kind), ...
+            r.Size, json_string(r.Class), r.Channels, ...
+            json_string(r.Status), r.Samples, r.Calls, ...
+            json_number(r.Median), json_number(r.Min), ...
+            json_number(r.Mean), json_number(r.Baseline), ...
+            mat2str(logical(r.Regressed)));
+    end
+    fprintf(fid, '\n]\n}\n');
+end
+
+function baseline = import_json(fname)
+    %IMPORT_JSON  Load baseline results from a JSON file
+    %
+    %     baseline = import_json(fname)
+    %
+    % ## Input
+    % * __fname__ name of JSON file written by `export_json`.
+    %
+    % ## Output
+    % * __baseline__ structure with the fields `Id` (cell array) and
+    %   `Median` (vector) of all passed results.
+    %
+    % See also: jsondecode
+    %
+
+    str = fileread(fname);
+    if exist('jsondecode', 'builtin') == 5 || exist('jsondecode', 'file')
+        s = jsondecode(str);
+        r = s.results;
+        if isstruct(r), r = num2cell(r); end
+        ids = cellfun(@(x) x.id, r, 'UniformOutput',false);
+        med = cellfun(@(x) double_or_nan(x.median), r);
+    else
+        % the file is in the format of export_json, one result per line
+        tok = regexp(str, ['"id":\s*"([^"]*)"[^\n]*' ...
+            '"median":\s*([-+.\deE]+|null)'], 'tokens');
+        tok = cat(1, tok{:});
+        ids = tok(:,1);
+        med = str2double(tok(:,2));
+    end
+    idx = ~isnan(med);
+    baseline = struct('Id',{ids(idx)}, 'Median',med(idx));
+end
+
+function x = double_or_nan(x)
+    %DOUBLE_OR_NAN  Convert a decoded JSON number, null decodes to empty
+
+    if isempty(x)
+        x = NaN;
+    else
+        x = double(x);
+    end
+end
@@ -0,0 +1,395 @@
+/**
+ * @file benchMxArray.cpp
+ * @brief Headless micro-benchmarks of MxArray conversions
+ *
+ * Standalone executable linked against MxArray and the stub MEX API of
+ * mxstub.cpp, so that conversion hot paths can be measured and profiled
+ * (perf, valgrind, ...) without MATLAB or Octave. Built with <tt>make
+ * bench</tt>.
+ *
+ * Usage:
+ * @code
+ * benchMxArray [-r repeat] [-s rows cols] [-n count] [-f filter]
+ * @endcode
+ * - \c -r number of timed calls per configuration (default 20).
+ * - \c -s size of the images (default 480 640).
+ * - \c -n number of elements of vectors (default 100000).
+ * - \c -f only run configurations whose name contains this string.
+ *
+ * For each configuration, the median time per call is reported, along with
+ * the throughput (bytes of the source data converted per second), and the
+ * number of MATLAB arrays and of cv::Mat buffers allocated per call.
+ */
+#include "MxArray.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+using namespace std;
+using namespace cv;
+
+namespace {
+/// Classes of numeric arrays, with their names and OpenCV depths
+const struct {
+    mxClassID classid;
+    const char *name;
+    int depth;
+} Classes[] = {
+    {mxLOGICAL_CLASS, "logical", CV_8U},
+    {mxUINT8_CLASS,   "uint8",   CV_8U},
+    {mxINT8_CLASS,    "int8",    CV_8S},
+    {mxUINT16_CLASS,  "uint16",  CV_16U},
+    {mxINT16_CLASS,   "int16",   CV_16S},
+    {mxINT32_CLASS,   "int32",   CV_32S},
+    {mxUINT32_CLASS,  "uint32",  CV_32S},
+    {mxSINGLE_CLASS,  "single",  CV_32F},
+    {mxDOUBLE_CLASS,  "double",  CV_64F}
+};
+/// Number of entries of Classes
+const int NumClasses = sizeof(Classes) / sizeof(Classes[0]);
+
+/// Names of OpenCV depths
+const char *DepthNames[] = {"8U", "8S", "16U", "16S", "32S", "32F", "64F"};
+
+/// Allocator counting the cv::Mat buffers allocated by OpenCV
+class CountingAllocator : public MatAllocator
+{
+  public:
+    /// Constructor
+    CountingAllocator() : count(0) {}
+
+    UMatData* allocate(int dims, const int* sizes, int type, void* data,
+        size_t* step, int flags, UMatUsageFlags usageFlags) const
+    {
+        if (!data)
+            ++count;
+        return Mat::getStdAllocator()->allocate(dims, sizes, type, data,
+            step, flags, usageFlags);
+    }
+
+    bool allocate(UMatData* u, int accessFlags,
+        UMatUsageFlags usageFlags) const
+    {
+        return Mat::getStdAllocator()->allocate(u, accessFlags, usageFlags);
+    }
+
+    void deallocate(UMatData* u) const
+    {
+        Mat::getStdAllocator()->deallocate(u);
+    }
+
+    /// Number of buffers allocated
+    mutable size_t count;
+};
+
+/// Counting allocator installed as default OpenCV allocator
+CountingAllocator countingAllocator;
+
+/// Benchmarked conversion
+class Case
+{
+  public:
+    /// Destructor
+    virtual ~Case() {}
+    /// Timed conversion
+    virtual void run() = 0;
+    /// Release the output of the conversion (not timed)
+    virtual void reset() {}
+};
+
+/// MxArray::toMat of a numeric array
+class ToMat : public Case
+{
+  public:
+    ToMat(const mxArray *arr, int depth) : arr_(arr), depth_(depth) {}
+    void run() { mat_ = MxArray(arr_).toMat(depth_); }
+    void reset() { mat_.release(); }
+  private:
+    const mxArray *arr_;
+    int depth_;
+    Mat mat_;
+};
+
+/// MxArray::toMatND of a numeric array
+class ToMatND : public Case
+{
+  public:
+    ToMatND(const mxArray *arr, int depth) : arr_(arr), depth_(depth) {}
+    void run() { mat_ = MxArray(arr_).toMatND(depth_); }
+    void reset() { mat_.release(); }
+  private:
+    const mxArray *arr_;
+    int depth_;
+    MatND mat_;
+};
+
+/// MxArray constructor from a value (cv::Mat, vector<KeyPoint>, ...)
+template <typename T>
+class FromValue : public Case
+{
+  public:
+    explicit FromValue(const T& value) : value_(value), out_(NULL) {}
+    void run() { out_ = MxArray(value_); }
+    void reset() { mxDestroyArray(out_); out_ = NULL; }
+  private:
+    const T& value_;
+    mxArray *out_;
+};
+
+/// MxArray::toVector<T>
+template <typename T>
+class ToVector : public Case
+{
+  public:
+    explicit ToVector(const mxArray *arr) : arr_(arr) {}
+    void run() { v_ = MxArray(arr_).toVector<T>(); }
+    void reset() { vector<T>().swap(v_); }
+  private:
+    const mxArray *arr_;
+    vector<T> v_;
+};
+
+/// Benchmark options
+struct Options
+{
+    int repeat;         ///< number of timed calls
+    int rows;           ///< rows of images
+    int cols;           ///< columns of images
+    int count;          ///< number of elements of vectors
+    string filter;      ///< substring of configuration names to run
+};
+
+/// Number of configurations that failed
+int failures = 0;
+
+/** Time a conversion and print its statistics.
+ * @param opts options.
+ * @param name name of the conversion.
+ * @param config description of the configuration.
+ * @param bytes size in bytes of the source data.
+ * @param c conversion.
+ */
+void bench(const Options& opts, const string& name, const string& config,
+    size_t bytes, Case& c)
+{
+    const string id(name + " " + config);
+    if (!opts.filter.empty() && id.find(opts.filter) == string::npos)
+        return;
+    try {
+        // warm-up call, not timed
+        c.run();
+        c.reset();
+        vector<double> t(opts.repeat);
+        size_t arrays = 0, buffers = 0;
+        for (int i = 0; i < opts.repeat; ++i) {
+            const size_t a0 = mxStubArraysCreated();
+            const size_t b0 = countingAllocator.count;
+            const int64 t0 = getTickCount();
+            c.run();
+            t[i] = (getTickCount() - t0) / getTickFrequency();
+            arrays += mxStubArraysCreated() - a0;
+            buffers += countingAllocator.count - b0;
+            c.reset();
+        }
+        std::nth_element(t.begin(), t.begin() + t.size()/2, t.end());
+        const double med = t[t.size()/2];
+        printf("%-14s %-28s %10.1f %8.2f %8.1f %8.1f\n", name.c_str(),
+            config.c_str(), med * 1e6, bytes / med / 1e9,
+            static_cast<double>(arrays) / opts.repeat,
+            static_cast<double>(buffers) / opts.repeat);
+    }
+    catch (const std::exception& e) {
+        printf("%-14s %-28s FAILED: %s\n", name.c_str(), config.c_str(),
+            e.what());
+        ++failures;
+    }
+    fflush(stdout);
+}
+
+/// Create a numeric array filled with random values
+mxArray *randomArray(const vector<mwSize>& dims, int k)
+{
+    mxArray *arr = (Classes[k].classid == mxLOGICAL_CLASS) ?
+        mxCreateLogicalArray(dims.size(), &dims[0]) :
+        mxCreateNumericArray(dims.size(), &dims[0], Classes[k].classid,
+            mxREAL);
+    Mat data(1, static_cast<int>(mxGetNumberOfElements(arr)),
+        Classes[k].depth, mxGetData(arr));
+    randu(data, 0, (Classes[k].classid == mxLOGICAL_CLASS) ? 2 : 100);
+    return arr;
+}
+
+/// Conversions of 2-D and 3-D arrays from MATLAB to OpenCV
+void benchToMat(const Options& opts)
+{
+    const int cns[] = {1, 3, 4};
+    for (int k = 0; k < NumClasses; ++k) {
+        for (int c = 0; c < 3; ++c) {
+            vector<mwSize> dims(3);
+            dims[0] = opts.rows; dims[1] = opts.cols; dims[2] = cns[c];
+            mxArray *arr = randomArray(dims, k);
+            const size_t bytes = mxGetNumberOfElements(arr) *
+                mxGetElementSize(arr);
+            // same depth, and conversion to floating-point
+            const int depths[] = {CV_USRTYPE1, CV_32F};
+            for (int d = 0; d < 2; ++d) {
+                ToMat op(arr, depths[d]);
+                bench(opts, "toMat", format("%dx%dx%d %s->%s", opts.rows,
+                    opts.cols, cns[c], Classes[k].name, (d == 0) ?
+                    DepthNames[Classes[k].depth] : "32F"), bytes, op);
+            }
+            mxDestroyArray(arr);
+        }
+    }
+}
+
+/// Conversions of N-D arrays from MATLAB to OpenCV
+void benchToMatND(const Options& opts)
+{
+    for (int k = 0; k < NumClasses; ++k) {
+        for (int nd = 3; nd <= 4; ++nd) {
+            vector<mwSize> dims(nd, 4);
+            dims[0] = opts.rows / 2;
+            dims[1] = opts.cols / 2;
+            mxArray *arr = randomArray(dims, k);
+            const size_t bytes = mxGetNumberOfElements(arr) *
+                mxGetElementSize(arr);
+            ToMatND op(arr, CV_USRTYPE1);
+            bench(opts, "toMatND", format("%dx%dx4%s %s", opts.rows / 2,
+                opts.cols / 2, (nd == 4) ? "x4" : "", Classes[k].name),
+                bytes, op);
+            mxDestroyArray(arr);
+        }
+    }
+}
+
+/// Conversions of 2-D and N-D cv::Mat from OpenCV to MATLAB
+void benchFromMat(const Options& opts)
+{
+    const int cns[] = {1, 3, 4};
+    for (int depth = CV_8U; depth <= CV_64F; ++depth) {
+        for (int c = 0; c < 3; ++c) {
+            Mat mat(opts.rows, opts.cols, CV_MAKETYPE(depth, cns[c]));
+            randu(mat, 0, 100);
+            FromValue<Mat> op(mat);
+            bench(opts, "MxArray(Mat)", format("%dx%dx%d %s", opts.rows,
+                opts.cols, cns[c], DepthNames[depth]),
+                mat.total() * mat.elemSize(), op);
+        }
+        const int sz[] = {opts.rows / 2, opts.cols / 2, 4};
+        Mat mat(3, sz, CV_MAKETYPE(depth, 1));
+        randu(mat, 0, 100);
+        FromValue<Mat> op(mat);
+        bench(opts, "MxArray(Mat)", format("%dx%dx4 (3-D) %s", sz[0], sz[1],
+            DepthNames[depth]), mat.total() * mat.elemSize(), op);
+    }
+}
+
+/// Conversions of keypoints in both directions
+void benchKeyPoints(const Options& opts)
+{
+    RNG rng;
+    vector<KeyPoint> kpts(opts.count);
+    for (size_t i = 0; i < kpts.size(); ++i)
+        kpts[i] = KeyPoint(rng.uniform(0.f, 640.f), rng.uniform(0.f, 480.f),
+            rng.uniform(1.f, 32.f), rng.uniform(0.f, 360.f),
+            rng.uniform(0.f, 1.f), rng.uniform(0, 4));
+    const size_t bytes = kpts.size() * sizeof(KeyPoint);
+
+    FromValue<vector<KeyPoint> > from(kpts);
+    bench(opts, "MxArray(kpts)", format("%d struct array", opts.count),
+        bytes, from);
+
+    mxArray *arr = MxArray(kpts);
+    ToVector<KeyPoint> to(arr);
+    bench(opts, "toVector", format("%d KeyPoint", opts.count), bytes, to);
+    mxDestroyArray(arr);
+}
+
+/// Conversions of numeric arrays and cell arrays to vectors
+void benchToVector(const Options& opts)
+{
+    vector<mwSize> dims(2, 1);
+    dims[0] = opts.count;
+    {
+        mxArray *arr = randomArray(dims, NumClasses - 1);
+        ToVector<double> op(arr);
+        bench(opts, "toVector", format("%d double", opts.count),
+            opts.count * sizeof(double), op);
+        mxDestroyArray(arr);
+    }
+    {
+        mxArray *arr = randomArray(dims, 5);
+        ToVector<int> op(arr);
+        bench(opts, "toVector", format("%d int32->int", opts.count),
+            opts.count * sizeof(int), op);
+        mxDestroyArray(arr);
+    }
+    {
+        dims[1] = 2;
+        mxArray *arr = randomArray(dims, NumClasses - 2);
+        ToVector<Point2f> op(arr);
+        bench(opts, "toVector", format("%dx2 single->Point2f", opts.count),
+            opts.count * sizeof(Point2f), op);
+        mxDestroyArray(arr);
+    }
+    {
+        const int n = std::max(opts.count / 100, 1);
+        mxArray *arr = mxCreateCellMatrix(1, n);
+        for (int i = 0; i < n; ++i)
+            mxSetCell(arr, i, mxCreateDoubleMatrix(2, 1, mxREAL));
+        ToVector<Point2d> op(arr);
+        bench(opts, "toVector", format("%d cell->Point2d", n),
+            n * sizeof(Point2d), op);
+        mxDestroyArray(arr);
+    }
+}
+}
+
+/**
+ * Main entry
+ * @param argc number of command-line arguments
+ * @param argv command-line arguments
+ * @return 0 if all configurations ran, 1 otherwise
+ */
+int main(int argc, char *argv[])
+{
+    Options opts;
+    opts.repeat = 20;
+    opts.rows = 480;
+    opts.cols = 640;
+    opts.count = 100000;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "-r") && i+1 < argc)
+            opts.repeat = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-s") && i+2 < argc) {
+            opts.rows = atoi(argv[++i]);
+            opts.cols = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-n") && i+1 < argc)
+            opts.count = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-f") && i+1 < argc)
+            opts.filter = argv[++i];
+        else {
+            fprintf(stderr, "Usage: %s [-r repeat] [-s rows cols] "
+                "[-n count] [-f filter]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (opts.repeat < 1 || opts.rows < 2 || opts.cols < 2 || opts.count < 1) {
+        fprintf(stderr, "Invalid options\n");
+        return 1;
+    }
+
+    Mat::setDefaultAllocator(&countingAllocator);
+    printf("OpenCV %s, %d threads\n", CV_VERSION, getNumThreads());
+    printf("%-14s %-28s %10s %8s %8s %8s\n", "Conversion", "Configuration",
+        "us/call", "GB/s", "mx/call", "Mat/call");
+    benchToMat(opts);
+    benchToMatND(opts);
+    benchFromMat(opts);
+    benchKeyPoints(opts);
+    benchToVector(opts);
+    Mat::setDefaultAllocator(Mat::getStdAllocator());
+    return (failures == 0) ? 0 : 1;
+}
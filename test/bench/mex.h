@@ -0,0 +1,176 @@
+/**
+ * @file mex.h
+ * @brief Minimal stand-in for the MATLAB MEX and matrix API
+ *
+ * Declares the subset of the \c mx* and \c mex* functions used by MxArray,
+ * so that libMxArray can be compiled and exercised outside of MATLAB or
+ * Octave (see mxstub.cpp for the in-process implementation). Types and
+ * signatures follow those of MATLAB with \c -largeArrayDims.
+ *
+ * This header is only put on the include path of the headless benchmark,
+ * MEX-files are always compiled against the real one.
+ */
+#ifndef MEXOPENCV_STUB_MEX_H
+#define MEXOPENCV_STUB_MEX_H
+
+#include <cstddef>
+
+/// Size of array dimensions
+typedef size_t mwSize;
+/// Index into arrays
+typedef size_t mwIndex;
+/// Signed index into arrays
+typedef ptrdiff_t mwSignedIndex;
+/// Element of char arrays (UTF-16 code unit)
+typedef unsigned short mxChar;
+/// Element of logical arrays
+typedef bool mxLogical;
+
+/// Class of an array
+enum mxClassID {
+    mxUNKNOWN_CLASS = 0,
+    mxCELL_CLASS,
+    mxSTRUCT_CLASS,
+    mxLOGICAL_CLASS,
+    mxCHAR_CLASS,
+    mxVOID_CLASS,
+    mxDOUBLE_CLASS,
+    mxSINGLE_CLASS,
+    mxINT8_CLASS,
+    mxUINT8_CLASS,
+    mxINT16_CLASS,
+    mxUINT16_CLASS,
+    mxINT32_CLASS,
+    mxUINT32_CLASS,
+    mxINT64_CLASS,
+    mxUINT64_CLASS,
+    mxFUNCTION_CLASS
+};
+
+/// Whether numeric arrays have an imaginary part
+enum mxComplexity { mxREAL = 0, mxCOMPLEX };
+
+/// Opaque array type
+typedef struct mxArray_tag mxArray;
+
+extern "C" {
+
+// ==================== Creation ====================
+
+mxArray *mxCreateNumericMatrix(mwSize m, mwSize n, mxClassID classid,
+    mxComplexity flag);
+mxArray *mxCreateNumericArray(mwSize ndim, const mwSize *dims,
+    mxClassID classid, mxComplexity flag);
+mxArray *mxCreateDoubleMatrix(mwSize m, mwSize n, mxComplexity flag);
+mxArray *mxCreateDoubleScalar(double value);
+mxArray *mxCreateLogicalMatrix(mwSize m, mwSize n);
+mxArray *mxCreateLogicalArray(mwSize ndim, const mwSize *dims);
+mxArray *mxCreateLogicalScalar(bool value);
+mxArray *mxCreateCharArray(mwSize ndim, const mwSize *dims);
+mxArray *mxCreateString(const char *str);
+mxArray *mxCreateCellMatrix(mwSize m, mwSize n);
+mxArray *mxCreateCellArray(mwSize ndim, const mwSize *dims);
+mxArray *mxCreateStructMatrix(mwSize m, mwSize n, int nfields,
+    const char **fieldnames);
+mxArray *mxCreateSparse(mwSize m, mwSize n, mwSize nzmax,
+    mxComplexity flag);
+mxArray *mxDuplicateArray(const mxArray *pa);
+void mxDestroyArray(mxArray *pa);
+
+// ==================== Inspection ====================
+
+mxClassID mxGetClassID(const mxArray *pa);
+const char *mxGetClassName(const mxArray *pa);
+bool mxIsClass(const mxArray *pa, const char *name);
+mwSize mxGetNumberOfDimensions(const mxArray *pa);
+const mwSize *mxGetDimensions(const mxArray *pa);
+size_t mxGetM(const mxArray *pa);
+size_t mxGetN(const mxArray *pa);
+size_t mxGetNumberOfElements(const mxArray *pa);
+size_t mxGetElementSize(const mxArray *pa);
+mwIndex mxCalcSingleSubscript(const mxArray *pa, mwSize nsubs,
+    const mwIndex *subs);
+bool mxIsNumeric(const mxArray *pa);
+bool mxIsLogical(const mxArray *pa);
+bool mxIsLogicalScalar(const mxArray *pa);
+bool mxIsLogicalScalarTrue(const mxArray *pa);
+bool mxIsChar(const mxArray *pa);
+bool mxIsCell(const mxArray *pa);
+bool mxIsStruct(const mxArray *pa);
+bool mxIsSparse(const mxArray *pa);
+bool mxIsComplex(const mxArray *pa);
+bool mxIsEmpty(const mxArray *pa);
+bool mxIsDouble(const mxArray *pa);
+bool mxIsSingle(const mxArray *pa);
+bool mxIsInt8(const mxArray *pa);
+bool mxIsUint8(const mxArray *pa);
+bool mxIsInt16(const mxArray *pa);
+bool mxIsUint16(const mxArray *pa);
+bool mxIsInt32(const mxArray *pa);
+bool mxIsUint32(const mxArray *pa);
+bool mxIsInt64(const mxArray *pa);
+bool mxIsUint64(const mxArray *pa);
+bool mxIsFromGlobalWS(const mxArray *pa);
+
+// ==================== Data ====================
+
+void *mxGetData(const mxArray *pa);
+double *mxGetPr(const mxArray *pa);
+mxLogical *mxGetLogicals(const mxArray *pa);
+mxChar *mxGetChars(const mxArray *pa);
+mwIndex *mxGetIr(const mxArray *pa);
+mwIndex *mxGetJc(const mxArray *pa);
+mwSize mxGetNzmax(const mxArray *pa);
+char *mxArrayToString(const mxArray *pa);
+void mxFree(void *ptr);
+
+// ==================== Cells and structs ====================
+
+mxArray *mxGetCell(const mxArray *pa, mwIndex i);
+void mxSetCell(mxArray *pa, mwIndex i, mxArray *value);
+int mxGetNumberOfFields(const mxArray *pa);
+const char *mxGetFieldNameByNumber(const mxArray *pa, int n);
+int mxGetFieldNumber(const mxArray *pa, const char *name);
+mxArray *mxGetField(const mxArray *pa, mwIndex i, const char *name);
+mxArray *mxGetFieldByNumber(const mxArray *pa, mwIndex i, int n);
+void mxSetField(mxArray *pa, mwIndex i, const char *name, mxArray *value);
+void mxSetFieldByNumber(mxArray *pa, mwIndex i, int n, mxArray *value);
+int mxAddField(mxArray *pa, const char *name);
+mxArray *mxGetProperty(const mxArray *pa, mwIndex i, const char *name);
+
+// ==================== Constants ====================
+
+double mxGetNaN(void);
+double mxGetInf(void);
+double mxGetEps(void);
+bool mxIsNaN(double x);
+bool mxIsInf(double x);
+bool mxIsFinite(double x);
+
+// ==================== MEX ====================
+
+void mexErrMsgIdAndTxt(const char *id, const char *fmt, ...);
+void mexWarnMsgIdAndTxt(const char *id, const char *fmt, ...);
+int mexPrintf(const char *fmt, ...);
+int mexCallMATLAB(int nlhs, mxArray *plhs[], int nrhs, mxArray *prhs[],
+    const char *name);
+mxArray *mexCallMATLABWithTrap(int nlhs, mxArray *plhs[], int nrhs,
+    mxArray *prhs[], const char *name);
+const mxArray *mexGetVariablePtr(const char *workspace, const char *name);
+int mexPutVariable(const char *workspace, const char *name,
+    const mxArray *pa);
+void mexLock(void);
+void mexUnlock(void);
+const char *mexFunctionName(void);
+
+// ==================== Stub only ====================
+
+/** Number of arrays created since the start of the process.
+ * @return count of all \c mxCreate* and \c mxDuplicateArray calls,
+ *    including the nested arrays of duplicated cells and structs.
+ */
+size_t mxStubArraysCreated(void);
+
+}
+
+#endif
@@ -0,0 +1,606 @@
+/** Implementation of the stub MEX API.
+ * @file mxstub.cpp
+ *
+ * Arrays are plain heap objects following the memory layout of MATLAB
+ * (column-major data, zero-initialized on creation, one data block per
+ * array). Errors raised with mexErrMsgIdAndTxt are thrown as C++
+ * exceptions instead of unwinding to the MATLAB prompt.
+ */
+
+#include "mex.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/// Array representation
+struct mxArray_tag
+{
+    mxClassID classid;          ///< class of the array
+    bool complex;               ///< whether it has an imaginary part
+    bool sparse;                ///< whether it is a sparse matrix
+    std::vector<mwSize> dims;   ///< dimensions, at least two
+    void *data;                 ///< elements, or nonzeros of sparse matrices
+    void *imag;                 ///< imaginary part of complex arrays
+    mwIndex *ir;                ///< row indices of sparse nonzeros
+    mwIndex *jc;                ///< column offsets of sparse nonzeros
+    mwSize nzmax;               ///< capacity of sparse matrices
+    std::vector<mxArray*> elems;        ///< cells, or struct field values
+    std::vector<std::string> fields;    ///< struct field names
+};
+
+namespace {
+/// Number of arrays created so far
+size_t arraysCreated = 0;
+
+/// Error raised by mexErrMsgIdAndTxt
+class MexError : public std::runtime_error
+{
+  public:
+    /// Constructor
+    MexError(const std::string& id, const std::string& msg)
+    : std::runtime_error(id + ": " + msg)
+    {}
+};
+
+/// Format a printf-style message
+std::string vformat(const char *fmt, va_list args)
+{
+    char buf[1024];
+    vsnprintf(buf, sizeof(buf), fmt, args);
+    return std::string(buf);
+}
+
+/// Size in bytes of the elements of a class
+size_t elementSize(mxClassID classid)
+{
+    switch (classid) {
+        case mxCELL_CLASS:
+        case mxSTRUCT_CLASS:    return sizeof(mxArray*);
+        case mxLOGICAL_CLASS:   return sizeof(mxLogical);
+        case mxCHAR_CLASS:      return sizeof(mxChar);
+        case mxDOUBLE_CLASS:    return 8;
+        case mxSINGLE_CLASS:    return 4;
+        case mxINT8_CLASS:
+        case mxUINT8_CLASS:     return 1;
+        case mxINT16_CLASS:
+        case mxUINT16_CLASS:    return 2;
+        case mxINT32_CLASS:
+        case mxUINT32_CLASS:    return 4;
+        case mxINT64_CLASS:
+        case mxUINT64_CLASS:    return 8;
+        default:                return 0;
+    }
+}
+
+/// Number of elements of an array with the given dimensions
+size_t numel(const std::vector<mwSize>& dims)
+{
+    size_t n = 1;
+    for (size_t i = 0; i < dims.size(); ++i)
+        n *= dims[i];
+    return n;
+}
+
+/** Create an array.
+ * @param ndim number of dimensions.
+ * @param dims dimensions.
+ * @param classid class of the array.
+ * @param flag whether to allocate an imaginary part.
+ * @return new array, with zero-initialized data.
+ *
+ * Trailing singleton dimensions beyond the second are dropped, like MATLAB.
+ */
+mxArray *create(mwSize ndim, const mwSize *dims, mxClassID classid,
+    mxComplexity flag = mxREAL)
+{
+    mxArray *pa = new mxArray;
+    pa->classid = classid;
+    pa->complex = (flag == mxCOMPLEX);
+    pa->sparse = false;
+    pa->dims.assign(dims, dims + ndim);
+    pa->dims.resize(std::max<size_t>(pa->dims.size(), 2), 1);
+    while (pa->dims.size() > 2 && pa->dims.back() == 1)
+        pa->dims.pop_back();
+    pa->data = pa->imag = NULL;
+    pa->ir = pa->jc = NULL;
+    pa->nzmax = 0;
+    const size_t n = numel(pa->dims);
+    if (classid == mxCELL_CLASS || classid == mxSTRUCT_CLASS)
+        pa->elems.assign(n, static_cast<mxArray*>(NULL));
+    else if (n > 0) {
+        pa->data = std::calloc(n, elementSize(classid));
+        if (pa->complex)
+            pa->imag = std::calloc(n, elementSize(classid));
+    }
+    ++arraysCreated;
+    return pa;
+}
+
+/// Create a 2-D array
+mxArray *create2(mwSize m, mwSize n, mxClassID classid,
+    mxComplexity flag = mxREAL)
+{
+    const mwSize dims[2] = {m, n};
+    return create(2, dims, classid, flag);
+}
+
+/// Check the index of a field
+void checkField(const mxArray *pa, int n)
+{
+    if (!mxIsStruct(pa) || n < 0 || n >= static_cast<int>(pa->fields.size()))
+        mexErrMsgIdAndTxt("mxstub:error", "Invalid field number %d", n);
+}
+}
+
+// ==================== Creation ====================
+
+mxArray *mxCreateNumericMatrix(mwSize m, mwSize n, mxClassID classid,
+    mxComplexity flag)
+{
+    return create2(m, n, classid, flag);
+}
+
+mxArray *mxCreateNumericArray(mwSize ndim, const mwSize *dims,
+    mxClassID classid, mxComplexity flag)
+{
+    return create(ndim, dims, classid, flag);
+}
+
+mxArray *mxCreateDoubleMatrix(mwSize m, mwSize n, mxComplexity flag)
+{
+    return create2(m, n, mxDOUBLE_CLASS, flag);
+}
+
+mxArray *mxCreateDoubleScalar(double value)
+{
+    mxArray *pa = create2(1, 1, mxDOUBLE_CLASS);
+    *static_cast<double*>(pa->data) = value;
+    return pa;
+}
+
+mxArray *mxCreateLogicalMatrix(mwSize m, mwSize n)
+{
+    return create2(m, n, mxLOGICAL_CLASS);
+}
+
+mxArray *mxCreateLogicalArray(mwSize ndim, const mwSize *dims)
+{
+    return create(ndim, dims, mxLOGICAL_CLASS);
+}
+
+mxArray *mxCreateLogicalScalar(bool value)
+{
+    mxArray *pa = create2(1, 1, mxLOGICAL_CLASS);
+    *static_cast<mxLogical*>(pa->data) = value;
+    return pa;
+}
+
+mxArray *mxCreateCharArray(mwSize ndim, const mwSize *dims)
+{
+    return create(ndim, dims, mxCHAR_CLASS);
+}
+
+mxArray *mxCreateString(const char *str)
+{
+    const size_t len = std::strlen(str);
+    mxArray *pa = create2((len > 0) ? 1 : 0, len, mxCHAR_CLASS);
+    std::copy(str, str + len, static_cast<mxChar*>(pa->data));
+    return pa;
+}
+
+mxArray *mxCreateCellMatrix(mwSize m, mwSize n)
+{
+    return create2(m, n, mxCELL_CLASS);
+}
+
+mxArray *mxCreateCellArray(mwSize ndim, const mwSize *dims)
+{
+    return create(ndim, dims, mxCELL_CLASS);
+}
+
+mxArray *mxCreateStructMatrix(mwSize m, mwSize n, int nfields,
+    const char **fieldnames)
+{
+    mxArray *pa = create2(m, n, mxSTRUCT_CLASS);
+    pa->fields.assign(fieldnames, fieldnames + nfields);
+    pa->elems.assign(m * n * nfields, static_cast<mxArray*>(NULL));
+    return pa;
+}
+
+mxArray *mxCreateSparse(mwSize m, mwSize n, mwSize nzmax,
+    mxComplexity flag)
+{
+    // created empty, only the nonzeros are allocated
+    mxArray *pa = create2(0, n, mxDOUBLE_CLASS);
+    pa->dims[0] = m;
+    nzmax = std::max<mwSize>(nzmax, 1);
+    pa->sparse = true;
+    pa->complex = (flag == mxCOMPLEX);
+    pa->nzmax = nzmax;
+    pa->data = std::calloc(nzmax, sizeof(double));
+    if (pa->complex)
+        pa->imag = std::calloc(nzmax, sizeof(double));
+    pa->ir = static_cast<mwIndex*>(std::calloc(nzmax, sizeof(mwIndex)));
+    pa->jc = static_cast<mwIndex*>(std::calloc(n + 1, sizeof(mwIndex)));
+    return pa;
+}
+
+mxArray *mxDuplicateArray(const mxArray *pa)
+{
+    if (!pa)
+        return NULL;
+    mxArray *dup = new mxArray(*pa);
+    ++arraysCreated;
+    const size_t n = pa->sparse ? pa->nzmax : numel(pa->dims);
+    const size_t bytes = n * elementSize(pa->classid);
+    if (pa->data) {
+        dup->data = std::malloc(bytes);
+        std::memcpy(dup->data, pa->data, bytes);
+    }
+    if (pa->imag) {
+        dup->imag = std::malloc(bytes);
+        std::memcpy(dup->imag, pa->imag, bytes);
+    }
+    if (pa->sparse) {
+        const mwSize cols = pa->dims[1];
+        dup->ir = static_cast<mwIndex*>(
+            std::malloc(pa->nzmax * sizeof(mwIndex)));
+        dup->jc = static_cast<mwIndex*>(
+            std::malloc((cols + 1) * sizeof(mwIndex)));
+        std::copy(pa->ir, pa->ir + pa->nzmax, dup->ir);
+        std::copy(pa->jc, pa->jc + cols + 1, dup->jc);
+    }
+    for (size_t i = 0; i < dup->elems.size(); ++i)
+        dup->elems[i] = mxDuplicateArray(pa->elems[i]);
+    return dup;
+}
+
+void mxDestroyArray(mxArray *pa)
+{
+    if (!pa)
+        return;
+    for (size_t i = 0; i < pa->elems.size(); ++i)
+        mxDestroyArray(pa->elems[i]);
+    std::free(pa->data);
+    std::free(pa->imag);
+    std::free(pa->ir);
+    std::free(pa->jc);
+    delete pa;
+}
+
+// ==================== Inspection ====================
+
+mxClassID mxGetClassID(const mxArray *pa)
+{
+    return pa->classid;
+}
+
+const char *mxGetClassName(const mxArray *pa)
+{
+    switch (pa->classid) {
+        case mxCELL_CLASS:      return "cell";
+        case mxSTRUCT_CLASS:    return "struct";
+        case mxLOGICAL_CLASS:   return "logical";
+        case mxCHAR_CLASS:      return "char";
+        case mxDOUBLE_CLASS:    return "double";
+        case mxSINGLE_CLASS:    return "single";
+        case mxINT8_CLASS:      return "int8";
+        case mxUINT8_CLASS:     return "uint8";
+        case mxINT16_CLASS:     return "int16";
+        case mxUINT16_CLASS:    return "uint16";
+        case mxINT32_CLASS:     return "int32";
+        case mxUINT32_CLASS:    return "uint32";
+        case mxINT64_CLASS:     return "int64";
+        case mxUINT64_CLASS:    return "uint64";
+        case mxFUNCTION_CLASS:  return "function_handle";
+        default:                return "unknown";
+    }
+}
+
+bool mxIsClass(const mxArray *pa, const char *name)
+{
+    return std::strcmp(mxGetClassName(pa), name) == 0;
+}
+
+mwSize mxGetNumberOfDimensions(const mxArray *pa)
+{
+    return pa->dims.size();
+}
+
+const mwSize *mxGetDimensions(const mxArray *pa)
+{
+    return &pa->dims[0];
+}
+
+size_t mxGetM(const mxArray *pa)
+{
+    return pa->dims[0];
+}
+
+size_t mxGetN(const mxArray *pa)
+{
+    // product of all dimensions but the first, like MATLAB
+    size_t n = 1;
+    for (size_t i = 1; i < pa->dims.size(); ++i)
+        n *= pa->dims[i];
+    return n;
+}
+
+size_t mxGetNumberOfElements(const mxArray *pa)
+{
+    return numel(pa->dims);
+}
+
+size_t mxGetElementSize(const mxArray *pa)
+{
+    return elementSize(pa->classid);
+}
+
+mwIndex mxCalcSingleSubscript(const mxArray *pa, mwSize nsubs,
+    const mwIndex *subs)
+{
+    mwIndex index = 0, stride = 1;
+    for (mwSize i = 0; i < nsubs; ++i) {
+        index += subs[i] * stride;
+        stride *= (i < pa->dims.size()) ? pa->dims[i] : 1;
+    }
+    return index;
+}
+
+bool mxIsNumeric(const mxArray *pa)
+{
+    return pa->classid >= mxDOUBLE_CLASS && pa->classid <= mxUINT64_CLASS;
+}
+
+bool mxIsLogical(const mxArray *pa)
+{
+    return pa->classid == mxLOGICAL_CLASS;
+}
+
+bool mxIsLogicalScalar(const mxArray *pa)
+{
+    return mxIsLogical(pa) && numel(pa->dims) == 1;
+}
+
+bool mxIsLogicalScalarTrue(const mxArray *pa)
+{
+    return mxIsLogicalScalar(pa) && *static_cast<mxLogical*>(pa->data);
+}
+
+bool mxIsChar(const mxArray *pa) { return pa->classid == mxCHAR_CLASS; }
+bool mxIsCell(const mxArray *pa) { return pa->classid == mxCELL_CLASS; }
+bool mxIsStruct(const mxArray *pa) { return pa->classid == mxSTRUCT_CLASS; }
+bool mxIsSparse(const mxArray *pa) { return pa->sparse; }
+bool mxIsComplex(const mxArray *pa) { return pa->complex; }
+bool mxIsEmpty(const mxArray *pa) { return numel(pa->dims) == 0; }
+bool mxIsDouble(const mxArray *pa) { return pa->classid == mxDOUBLE_CLASS; }
+bool mxIsSingle(const mxArray *pa) { return pa->classid == mxSINGLE_CLASS; }
+bool mxIsInt8(const mxArray *pa) { return pa->classid == mxINT8_CLASS; }
+bool mxIsUint8(const mxArray *pa) { return pa->classid == mxUINT8_CLASS; }
+bool mxIsInt16(const mxArray *pa) { return pa->classid == mxINT16_CLASS; }
+bool mxIsUint16(const mxArray *pa) { return pa->classid == mxUINT16_CLASS; }
+bool mxIsInt32(const mxArray *pa) { return pa->classid == mxINT32_CLASS; }
+bool mxIsUint32(const mxArray *pa) { return pa->classid == mxUINT32_CLASS; }
+bool mxIsInt64(const mxArray *pa) { return pa->classid == mxINT64_CLASS; }
+bool mxIsUint64(const mxArray *pa) { return pa->classid == mxUINT64_CLASS; }
+bool mxIsFromGlobalWS(const mxArray *) { return false; }
+
+// ==================== Data ====================
+
+void *mxGetData(const mxArray *pa)
+{
+    return pa->data;
+}
+
+double *mxGetPr(const mxArray *pa)
+{
+    return static_cast<double*>(pa->data);
+}
+
+mxLogical *mxGetLogicals(const mxArray *pa)
+{
+    return static_cast<mxLogical*>(pa->data);
+}
+
+mxChar *mxGetChars(const mxArray *pa)
+{
+    return static_cast<mxChar*>(pa->data);
+}
+
+mwIndex *mxGetIr(const mxArray *pa)
+{
+    return pa->ir;
+}
+
+mwIndex *mxGetJc(const mxArray *pa)
+{
+    return pa->jc;
+}
+
+mwSize mxGetNzmax(const mxArray *pa)
+{
+    return pa->nzmax;
+}
+
+char *mxArrayToString(const mxArray *pa)
+{
+    if (!mxIsChar(pa))
+        return NULL;
+    const size_t n = numel(pa->dims);
+    char *str = static_cast<char*>(std::malloc(n + 1));
+    const mxChar *chars = mxGetChars(pa);
+    for (size_t i = 0; i < n; ++i)
+        str[i] = static_cast<char>(chars[i]);
+    str[n] = '\0';
+    return str;
+}
+
+void mxFree(void *ptr)
+{
+    std::free(ptr);
+}
+
+// ==================== Cells and structs ====================
+
+mxArray *mxGetCell(const mxArray *pa, mwIndex i)
+{
+    return pa->elems[i];
+}
+
+void mxSetCell(mxArray *pa, mwIndex i, mxArray *value)
+{
+    // like MATLAB, a previous value is not freed
+    pa->elems[i] = value;
+}
+
+int mxGetNumberOfFields(const mxArray *pa)
+{
+    return static_cast<int>(pa->fields.size());
+}
+
+const char *mxGetFieldNameByNumber(const mxArray *pa, int n)
+{
+    checkField(pa, n);
+    return pa->fields[n].c_str();
+}
+
+int mxGetFieldNumber(const mxArray *pa, const char *name)
+{
+    for (size_t i = 0; i < pa->fields.size(); ++i)
+        if (pa->fields[i] == name)
+            return static_cast<int>(i);
+    return -1;
+}
+
+mxArray *mxGetField(const mxArray *pa, mwIndex i, const char *name)
+{
+    const int n = mxGetFieldNumber(pa, name);
+    return (n < 0) ? NULL : mxGetFieldByNumber(pa, i, n);
+}
+
+mxArray *mxGetFieldByNumber(const mxArray *pa, mwIndex i, int n)
+{
+    checkField(pa, n);
+    return pa->elems[i * pa->fields.size() + n];
+}
+
+void mxSetField(mxArray *pa, mwIndex i, const char *name, mxArray *value)
+{
+    const int n = mxGetFieldNumber(pa, name);
+    if (n < 0)
+        mexErrMsgIdAndTxt("mxstub:error", "Unknown field %s", name);
+    mxSetFieldByNumber(pa, i, n, value);
+}
+
+void mxSetFieldByNumber(mxArray *pa, mwIndex i, int n, mxArray *value)
+{
+    checkField(pa, n);
+    pa->elems[i * pa->fields.size() + n] = value;
+}
+
+int mxAddField(mxArray *pa, const char *name)
+{
+    if (!mxIsStruct(pa))
+        return -1;
+    const int n = mxGetFieldNumber(pa, name);
+    if (n >= 0)
+        return n;
+    // field values are stored element by element, insert a new slot in each
+    const size_t nfields = pa->fields.size(), count = numel(pa->dims);
+    std::vector<mxArray*> elems(count * (nfields + 1),
+        static_cast<mxArray*>(NULL));
+    for (size_t i = 0; i < count; ++i)
+        std::copy(pa->elems.begin() + i*nfields,
+            pa->elems.begin() + (i+1)*nfields,
+            elems.begin() + i*(nfields+1));
+    pa->elems.swap(elems);
+    pa->fields.push_back(name);
+    return static_cast<int>(nfields);
+}
+
+mxArray *mxGetProperty(const mxArray *, mwIndex, const char *name)
+{
+    mexErrMsgIdAndTxt("mxstub:error",
+        "Objects are not supported, cannot get property %s", name);
+    return NULL;
+}
+
+// ==================== Constants ====================
+
+double mxGetNaN(void) { return std::numeric_limits<double>::quiet_NaN(); }
+double mxGetInf(void) { return std::numeric_limits<double>::infinity(); }
+double mxGetEps(void) { return std::numeric_limits<double>::epsilon(); }
+bool mxIsNaN(double x) { return x != x; }
+bool mxIsInf(double x) { return x == mxGetInf() || x == -mxGetInf(); }
+bool mxIsFinite(double x) { return !mxIsNaN(x) && !mxIsInf(x); }
+
+// ==================== MEX ====================
+
+void mexErrMsgIdAndTxt(const char *id, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    const std::string msg(vformat(fmt, args));
+    va_end(args);
+    throw MexError(id, msg);
+}
+
+void mexWarnMsgIdAndTxt(const char *id, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    const std::string msg(vformat(fmt, args));
+    va_end(args);
+    std::fprintf(stderr, "Warning: %s (%s)\n", msg.c_str(), id);
+}
+
+int mexPrintf(const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    const int n = std::vprintf(fmt, args);
+    va_end(args);
+    return n;
+}
+
+int mexCallMATLAB(int, mxArray *[], int, mxArray *[], const char *name)
+{
+    mexErrMsgIdAndTxt("mxstub:error", "Cannot call MATLAB function %s",
+        name);
+    return 1;
+}
+
+mxArray *mexCallMATLABWithTrap(int, mxArray *[], int, mxArray *[],
+    const char *name)
+{
+    return mxCreateString(name);
+}
+
+// no workspaces: profiling is never enabled in the benchmark
+const mxArray *mexGetVariablePtr(const char *, const char *)
+{
+    return NULL;
+}
+
+int mexPutVariable(const char *, const char *, const mxArray *)
+{
+    return 1;
+}
+
+void mexLock(void) {}
+void mexUnlock(void) {}
+const char *mexFunctionName(void) { return "benchMxArray"; }
+
+// ==================== Stub only ====================
+
+size_t mxStubArraysCreated(void)
+{
+    return arraysCreated;
+}
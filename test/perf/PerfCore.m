@@ -0,0 +1,18 @@
+classdef PerfCore
+    %PerfCore  Element-wise operations of the core module
+
+    methods (Static)
+        function fcns = perf_add(img)
+            fcns.EndToEnd = @() cv.add(img, img);
+        end
+
+        function fcns = perf_convertTo(img)
+            fcns.EndToEnd = @() cv.convertTo(img, 'RType','double');
+        end
+
+        function fcns = perf_flip(img)
+            fcns.EndToEnd = @() cv.flip(img, 1);
+        end
+    end
+
+end
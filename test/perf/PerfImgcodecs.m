@@ -0,0 +1,21 @@
+classdef PerfImgcodecs
+    %PerfImgcodecs  Encoding and decoding of images in memory
+
+    methods (Static)
+        function fcns = perf_imencode(img)
+            if ~isa(img, 'uint8')
+                error('mexopencv:testskip', '8-bit image only');
+            end
+            fcns.EndToEnd = @() cv.imencode('.png', img);
+        end
+
+        function fcns = perf_imdecode(img)
+            if ~isa(img, 'uint8')
+                error('mexopencv:testskip', '8-bit image only');
+            end
+            buf = cv.imencode('.png', img);
+            fcns.EndToEnd = @() cv.imdecode(buf, 'Unchanged',true);
+        end
+    end
+
+end
@@ -0,0 +1,96 @@
+classdef PerfImgproc
+    %PerfImgproc  Image filtering, geometric transformations and conversions
+    %
+    % End-to-end timings include the conversions of the input and output
+    % arrays, compute timings are the kernel time recorded by profiling
+    % (see cv.Utils.getProfile).
+    %
+
+    methods (Static)
+        function fcns = perf_GaussianBlur(img)
+            fcn = @() cv.GaussianBlur(img, 'KSize',[5 5]);
+            fcns.EndToEnd = fcn;
+            fcns.Compute = @() kernel_time('GaussianBlur', fcn);
+        end
+
+        function fcns = perf_blur(img)
+            fcn = @() cv.blur(img, 'KSize',[5 5]);
+            fcns.EndToEnd = fcn;
+            fcns.Compute = @() kernel_time('blur', fcn);
+        end
+
+        function fcns = perf_medianBlur(img)
+            fcn = @() cv.medianBlur(img, 'KSize',5);
+            fcns.EndToEnd = fcn;
+            fcns.Compute = @() kernel_time('medianBlur', fcn);
+        end
+
+        function fcns = perf_resize(img)
+            fcn = @() cv.resize(img, 0.5, 0.5);
+            fcns.EndToEnd = fcn;
+            fcns.Compute = @() kernel_time('resize', fcn);
+        end
+
+        function fcns = perf_cvtColor(img)
+            if size(img,3) ~= 3
+                error('mexopencv:testskip', 'color image only');
+            end
+            fcn = @() cv.cvtColor(img, 'RGB2GRAY');
+            fcns.EndToEnd = fcn;
+            fcns.Compute = @() kernel_time('cvtColor', fcn);
+        end
+
+        function fcns = perf_threshold(img)
+            if isinteger(img)
+                thresh = double(intmax(class(img))) / 2;
+            else
+                thresh = 0.5;
+            end
+            fcn = @() cv.threshold(img, thresh);
+            fcns.EndToEnd = fcn;
+            fcns.Compute = @() kernel_time('threshold', fcn);
+        end
+
+        function fcns = perf_Canny(img)
+            if ~isa(img, 'uint8')
+                error('mexopencv:testskip', '8-bit image only');
+            end
+            fcn = @() cv.Canny(img, [50 150]);
+            fcns.EndToEnd = fcn;
+            fcns.Compute = @() kernel_time('Canny', fcn);
+        end
+    end
+
+end
+
+function t = kernel_time(name, fcn)
+    %KERNEL_TIME  Call a profiled function and return its kernel time
+    %
+    %     t = kernel_time(name, fcn)
+    %
+    % ## Input
+    % * __name__ name of the MEX-function as recorded by profiling.
+    % * __fcn__ function handle taking no arguments calling it once.
+    %
+    % ## Output
+    % * __t__ time spent in the OpenCV computation, in seconds.
+    %
+    % The profiling flag is restored afterwards, and the counters are reset.
+    %
+
+    tf = cv.Utils.useProfile();
+    cv.Utils.setUseProfile(true);
+    cv.Utils.resetProfile();
+    try
+        fcn();
+        s = cv.Utils.getProfile();
+    catch ME
+        cv.Utils.setUseProfile(tf);
+        rethrow(ME);
+    end
+    cv.Utils.setUseProfile(tf);
+    cv.Utils.resetProfile();
+    idx = find(strcmp({s.name}, name), 1);
+    assert(~isempty(idx), 'mexopencv:error', '%s is not profiled', name);
+    t = s(idx).kernel;
+end
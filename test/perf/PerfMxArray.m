@@ -0,0 +1,19 @@
+classdef PerfMxArray
+    %PerfMxArray  Conversions between MATLAB arrays and cv::Mat
+
+    methods (Static)
+        function fcns = perf_toMat(img)
+            fcns.Conversion = @() cv.MatHandle(img);
+        end
+
+        function fcns = perf_fromMat(img)
+            h = cv.MatHandle(img);
+            fcns.Conversion = @() h.toMat();
+        end
+
+        function fcns = perf_roundtrip(img)
+            fcns.Conversion = @() toMat(cv.MatHandle(img));
+        end
+    end
+
+end
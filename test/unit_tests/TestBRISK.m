@@ -73,6 +73,21 @@ function test_detect_mask
             assert(all(xy(:,1) <= ceil(size(img,2)/2)));
         end
 
+        function test_detectAndCompute_soa
+            img = imread(TestBRISK.im);
+            obj = cv.BRISK();
+            [kpts, desc] = obj.detectAndCompute(img, 'OutputFormat','SoA');
+            validateattributes(kpts, {'struct'}, {'scalar'});
+            assert(all(ismember(TestBRISK.kfields, fieldnames(kpts))));
+            validateattributes(kpts.pt, {'double'}, {'size',[NaN 2]});
+            validateattributes(desc, {obj.descriptorType()}, ...
+                {'size',[size(kpts.pt,1) obj.descriptorSize()]});
+
+            % same keypoints as the default format
+            kpts2 = obj.detectAndCompute(img);
+            assert(isequal(kpts.pt, cat(1, kpts2.pt)));
+        end
+
         function test_error_1
             try
                 cv.BRISK('foobar');
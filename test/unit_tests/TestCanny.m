@@ -24,6 +24,15 @@ function test_3
             result = cv.Canny(img, 192, 'ApertureSize',5, 'L2Gradient',true);
         end
 
+        function test_batch
+            img = cv.imread(TestCanny.im, 'Grayscale',true, 'ReduceScale',2);
+            frames = {img, flipud(img), double(img)};
+            out = cv.Canny(frames, [96,192]);
+            ref = cv.Canny(img, [96,192]);
+            assert(isequal(out{1}, ref) && isequal(out{3}, ref));
+            assert(isequal(out{2}, cv.Canny(flipud(img), [96,192])));
+        end
+
         function test_error_argnum
             try
                 cv.Canny();
@@ -37,6 +37,34 @@ function test_4
             end
         end
 
+        function test_batch
+            img = imread(TestCvtColor.im);
+            frames = {img, single(img)/255};
+            out = cv.cvtColor(frames, 'RGB2HSV');
+            assert(iscell(out) && numel(out) == 2);
+            assert(isequal(out{1}, cv.cvtColor(img, 'RGB2HSV')));
+            assert(isequal(out{2}, cv.cvtColor(frames{2}, 'RGB2HSV')));
+
+            out = cv.cvtColor(cat(4, img, img), 'RGB2GRAY');
+            validateattributes(out, {class(img)}, ...
+                {'size',[size(img,1) size(img,2) 1 2]});
+            assert(isequal(out(:,:,1,1), cv.cvtColor(img, 'RGB2GRAY')));
+        end
+
+        function test_batch_invalid_image
+            % enough images to run in parallel, one of them invalid
+            img = imread(TestCvtColor.im);
+            n = max(8, 2*cv.Utils.getNumThreads());
+            frames = repmat({img}, 1, n);
+            frames{ceil(n/2)} = img(:,:,1);
+            try
+                cv.cvtColor(frames, 'RGB2HSV');
+                throw('UnitTest:Fail');
+            catch e
+                assert(strcmp(e.identifier,'mexopencv:error'));
+            end
+        end
+
         function test_error_argnum
             try
                 cv.cvtColor();
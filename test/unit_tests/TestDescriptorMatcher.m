@@ -102,6 +102,24 @@ function test_3
             validateattributes(m, {'cell'}, {'vector', 'numel',size(Y,1)});
         end
 
+        function test_soa
+            X = randn(20,3);
+            Y = randn(5,3);
+            matcher = cv.DescriptorMatcher('BruteForce');
+            m1 = matcher.match(Y, X);
+            m2 = matcher.match(Y, X, 'OutputFormat','SoA');
+            validateattributes(m2, {'struct'}, {'scalar'});
+            assert(all(ismember(TestDescriptorMatcher.fields, fieldnames(m2))));
+            assert(isequal(m2.queryIdx, [m1.queryIdx]'));
+            assert(isequal(m2.trainIdx, [m1.trainIdx]'));
+            assert(isequal(m2.distance, [m1.distance]'));
+
+            m = matcher.knnMatch(Y, X, 3, 'OutputFormat','SoA');
+            validateattributes(m, {'cell'}, {'vector', 'numel',size(Y,1)});
+            cellfun(@(s) validateattributes(s.distance, {'double'}, ...
+                {'size',[3 1]}), m);
+        end
+
         function test_4
             files = dir(fullfile(mexopencv.root(),'test','shape0*.png'));
             if isempty(files)
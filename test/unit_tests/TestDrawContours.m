@@ -43,6 +43,30 @@ function test_2
             validateattributes(im, {class(img)}, {'size',size(img)});
         end
 
+        function test_packed
+            [C, H] = cv.findContours(TestDrawContours.img);
+            [P, H2] = cv.findContours(TestDrawContours.img, ...
+                'OutputFormat','Packed');
+            im1 = cv.drawContours(TestDrawContours.img, C, 'Hierarchy',H);
+            im2 = cv.drawContours(TestDrawContours.img, P, 'Hierarchy',H2);
+            assert(isequal(im1, im2));
+            im1 = cv.fillPoly(TestDrawContours.img, C, 'Color',2);
+            im2 = cv.fillPoly(TestDrawContours.img, P, 'Color',2);
+            assert(isequal(im1, im2));
+        end
+
+        function test_error_packed_offsets
+            % offsets out of range must be rejected before any point is read
+            P = struct('points',zeros(5,2,'int32'), ...
+                'offsets',int32([0 100 5]));
+            try
+                cv.drawContours(TestDrawContours.img, P);
+                throw('UnitTest:Fail');
+            catch e
+                assert(strcmp(e.identifier,'mexopencv:error'));
+            end
+        end
+
         function test_error_argnum
             try
                 cv.drawContours();
@@ -23,6 +23,16 @@ function test_detect_types
             end
         end
 
+        function test_detect_soa
+            img = imread(TestFAST.im);
+            kpts = cv.FAST(img, 'OutputFormat','SoA');
+            validateattributes(kpts, {'struct'}, {'scalar'});
+            assert(all(ismember(TestFAST.kfields, fieldnames(kpts))));
+            kpts2 = cv.FAST(img);
+            assert(isequal(kpts.pt, cat(1, kpts2.pt)));
+            assert(isequal(kpts.response, [kpts2.response]'));
+        end
+
         function test_error_argnum
             try
                 cv.FAST();
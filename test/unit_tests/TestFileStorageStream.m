@@ -0,0 +1,61 @@
+classdef TestFileStorageStream
+    %TestFileStorageStream
+
+    methods (Static)
+        function test_write_read_nodes
+            S = struct('a',magic(4), 'b','hello', 'c',{{1, 'two', [3 4]}}, ...
+                'd',struct('x',pi, 'y',uint8(cat(3, eye(2), 2*eye(2)))));
+            exts = {'.xml', '.yml'};
+            for i=1:numel(exts)
+                fs = cv.FileStorageStream(exts{i}, 'w', 'Memory',true);
+                fn = fieldnames(S);
+                for j=1:numel(fn)
+                    fs.write(fn{j}, S.(fn{j}));
+                end
+                str = fs.release();
+                validateattributes(str, {'char'}, {'row', 'nonempty'});
+
+                fs = cv.FileStorageStream(str, 'r', 'Memory',true);
+                assert(isequal(fs.keys(), fn(:)'));
+                assert(strcmp(fs.type('a'), 'matrix'));
+                assert(isequal(fs.read('a'), S.a));
+                assert(strcmp(fs.read('b'), S.b));
+                assert(fs.count('c') == 3);
+                assert(strcmp(fs.read('c', 2), 'two'));
+                assert(isequal(fs.read({'d', 'y'}), S.d.y));
+                assert(isequal(fs.read('d', 'x'), pi));
+            end
+        end
+
+        function test_base64
+            A = rand(300, 40, 'single');
+            fs = cv.FileStorageStream('.yml', 'w', ...
+                'Memory',true, 'Base64',true);
+            fs.write('A', A);
+            str = fs.release();
+            assert(~isempty(strfind(str, 'binary')));
+            [S,~] = cv.FileStorage(str);
+            assert(isequal(S.A, A));
+        end
+
+        function test_compatible
+            S = struct('field1',randn(20,30), 'field2',int16(1:10));
+            str = cv.FileStorage('.yml', S);
+            fs = cv.FileStorageStream(str, 'r', 'Memory',true);
+            assert(isequal(fs.read('field1'), S.field1));
+            assert(isequal(fs.read('field2'), S.field2));
+        end
+
+        function test_error_missing_node
+            fs = cv.FileStorageStream(cv.FileStorage('.yml', ...
+                struct('a',1)), 'r', 'Memory',true);
+            try
+                fs.read('b');
+                throw('UnitTest:Fail');
+            catch e
+                assert(strcmp(e.identifier,'mexopencv:error'));
+            end
+        end
+    end
+
+end
@@ -54,6 +54,40 @@ function test_3
             [C, H] = cv.findContours(labels, 'Mode','FloodFill');
         end
 
+        function test_packed
+            [C, H] = cv.findContours(TestFindContours.img, 'Mode','Tree');
+            [P, H2] = cv.findContours(TestFindContours.img, 'Mode','Tree', ...
+                'OutputFormat','Packed');
+            validateattributes(P, {'struct'}, {'scalar'});
+            validateattributes(P.points, {'int32'}, {'size',[NaN 2]});
+            validateattributes(P.offsets, {'int32'}, ...
+                {'column', 'numel',numel(C)+1, 'nondecreasing'});
+            assert(P.offsets(1) == 0 && P.offsets(end) == size(P.points,1));
+            for i=1:numel(C)
+                c = P.points(P.offsets(i)+1:P.offsets(i+1),:);
+                assert(isequal(double(c), cat(1, C{i}{:})));
+            end
+            validateattributes(H2, {'int32'}, {'size',[numel(C) 4]});
+            assert(isequal(double(H2), cat(1, H{:})));
+        end
+
+        function test_packed_empty
+            [P, H] = cv.findContours(zeros(10,'uint8'), ...
+                'OutputFormat','Packed');
+            validateattributes(P.points, {'int32'}, {'size',[0 2]});
+            assert(isequal(P.offsets, int32(0)));
+            validateattributes(H, {'int32'}, {'size',[0 4]});
+        end
+
+        function test_error_output_format
+            try
+                cv.findContours(TestFindContours.img, 'OutputFormat','packed');
+                throw('UnitTest:Fail');
+            catch e
+                assert(strcmp(e.identifier,'mexopencv:error'));
+            end
+        end
+
         function test_error_argnum
             try
                 cv.findContours();
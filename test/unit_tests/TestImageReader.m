@@ -0,0 +1,112 @@
+classdef TestImageReader
+    %TestImageReader
+
+    properties (Constant)
+        im = fullfile(mexopencv.root(),'test','HappyFish.jpg');
+    end
+
+    methods (Static)
+        function test_tiff_regions
+            img = cv.imread(TestImageReader.im);
+            filename = [tempname() '.tif'];
+            cObj = onCleanup(@() TestImwrite.deleteFile(filename));
+            cv.imwrite(filename, img);
+
+            r = cv.ImageReader(filename, 'TileSize',[64 64]);
+            assert(isequal([r.Width r.Height], [size(img,2) size(img,1)]));
+            assert(ismember(r.Layout, {'strips', 'rows', 'tiles'}));
+            assert(isequal(r.read(), img));
+            rect = [30 20 100 70];
+            assert(isequal(r.read(rect), ...
+                img(rect(2)+1:rect(2)+rect(4), rect(1)+1:rect(1)+rect(3), :)));
+            clear r
+        end
+
+        function test_levels
+            img = cv.imread(TestImageReader.im, 'Grayscale',true);
+            filename = [tempname() '.tif'];
+            cObj = onCleanup(@() TestImwrite.deleteFile(filename));
+            cv.imwrite(filename, img);
+
+            r = cv.ImageReader(filename, 'Grayscale',true, 'TileSize',[32 32]);
+            assert(r.NumLevels > 1);
+            sz = r.levelSize(1);
+            assert(isequal(sz, ceil([size(img,2) size(img,1)]/2)));
+            out = r.read('Level',1);
+            assert(isequal(size(out), sz([2 1])));
+            last = r.read('Level',r.NumLevels-1);
+            assert(size(last,1) <= 32 && size(last,2) <= 32);
+            clear r
+        end
+
+        function test_cache
+            r = cv.ImageReader(TestImageReader.im, 'TileSize',[32 32]);
+            assert(strcmp(r.Layout, 'image'));
+            r.CacheSize = 0;
+            img = r.read([0 0 50 50]);
+            assert(isequal(size(img), [50 50 3]));
+            assert(r.CacheUsage == 0);
+            r.CacheSize = 64*2^20;
+            img = r.read('Level',1);
+            assert(r.CacheUsage > 0 && r.CacheUsage <= r.CacheSize);
+            r.clearCache();
+            assert(r.CacheUsage == 0);
+        end
+
+        function test_error_corrupt_tiff
+            % directory entry claiming 2^28 values past the end of the file
+            filename = [tempname() '.tif'];
+            cObj = onCleanup(@() TestImwrite.deleteFile(filename));
+            fid = fopen(filename, 'w', 'l');
+            fwrite(fid, 'II', 'char');
+            fwrite(fid, 42, 'uint16');
+            fwrite(fid, 8, 'uint32');
+            fwrite(fid, 1, 'uint16');
+            fwrite(fid, [256 4], 'uint16');
+            fwrite(fid, [2^28 26 0], 'uint32');
+            fclose(fid);
+            try
+                r = cv.ImageReader(filename);
+                throw('UnitTest:Fail');
+            catch e
+                assert(strcmp(e.identifier,'mexopencv:error'));
+            end
+        end
+
+        function test_error_zero_tile_size
+            % tiled image with TileWidth = TileLength = 0
+            filename = [tempname() '.tif'];
+            cObj = onCleanup(@() TestImwrite.deleteFile(filename));
+            tags = [256 257 322 323 324 325];
+            vals = [100 100 0 0 8 0];
+            fid = fopen(filename, 'w', 'l');
+            fwrite(fid, 'II', 'char');
+            fwrite(fid, 42, 'uint16');
+            fwrite(fid, 8, 'uint32');
+            fwrite(fid, numel(tags), 'uint16');
+            for i=1:numel(tags)
+                fwrite(fid, [tags(i) 4], 'uint16');  % LONG
+                fwrite(fid, [1 vals(i)], 'uint32');
+            end
+            fwrite(fid, 0, 'uint32');
+            fclose(fid);
+            try
+                r = cv.ImageReader(filename);
+                throw('UnitTest:Fail');
+            catch e
+                assert(strcmp(e.identifier,'mexopencv:error'));
+            end
+        end
+
+        function test_error_out_of_bounds
+            r = cv.ImageReader(TestImageReader.im);
+            try
+                r.read([r.Width-10 0 20 20]);
+                throw('UnitTest:Fail');
+            catch e
+                assert(strcmp(e.identifier,'mexopencv:error'));
+            end
+        end
+    end
+
+end
@@ -0,0 +1,69 @@
+classdef TestImreadBatch
+    %TestImreadBatch
+
+    properties (Constant)
+        files = fullfile(mexopencv.root(),'test', ...
+            {'RubberWhale1.png', 'RubberWhale2.png', 'HappyFish.jpg'});
+    end
+
+    methods (Static)
+        function test_read
+            imgs = cv.imreadBatch(TestImreadBatch.files);
+            assert(iscell(imgs) && numel(imgs) == 3);
+            for i=1:numel(imgs)
+                assert(isequal(imgs{i}, cv.imread(TestImreadBatch.files{i})));
+            end
+        end
+
+        function test_options
+            imgs = cv.imreadBatch(TestImreadBatch.files(1:2), ...
+                'Grayscale',true, 'ReduceScale',2);
+            img = cv.imread(TestImreadBatch.files{2}, ...
+                'Grayscale',true, 'ReduceScale',2);
+            assert(isequal(imgs{2}, img));
+        end
+
+        function test_stack
+            imgs = cv.imreadBatch(TestImreadBatch.files(1:2), 'Stack',true);
+            img = cv.imread(TestImreadBatch.files{1});
+            assert(isequal(size(imgs), [size(img) 2]));
+            assert(isequal(imgs(:,:,:,1), img));
+        end
+
+        function test_missing_file
+            fnames = [TestImreadBatch.files(1), {'nonexistent.png'}];
+            [imgs, ok, msgs] = cv.imreadBatch(fnames);
+            assert(isequal(ok, [true false]));
+            assert(~isempty(imgs{1}) && isempty(imgs{2}));
+            assert(isempty(msgs{1}) && ~isempty(msgs{2}));
+        end
+
+        function test_encode_decode
+            imgs = cv.imreadBatch(TestImreadBatch.files);
+            [bufs, ok] = cv.imencodeBatch('.png', imgs);
+            assert(all(ok) && iscell(bufs) && numel(bufs) == numel(imgs));
+            assert(isequal(bufs{3}, cv.imencode('.png', imgs{3})));
+            out = cv.imdecodeBatch(bufs);
+            assert(isequal(out, imgs));
+        end
+
+        function test_write
+            imgs = cv.imreadBatch(TestImreadBatch.files(1:2), 'Stack',true);
+            fnames = {[tempname() '.png'], [tempname() '.png']};
+            cObj = onCleanup(@() cellfun(@TestImwrite.deleteFile, fnames));
+            ok = cv.imwriteBatch(fnames, imgs);
+            assert(all(ok));
+            assert(isequal(cv.imread(fnames{2}), imgs(:,:,:,2)));
+        end
+
+        function test_error_argnum
+            try
+                cv.imreadBatch();
+                throw('UnitTest:Fail');
+            catch e
+                assert(strcmp(e.identifier,'mexopencv:error'));
+            end
+        end
+    end
+
+end
@@ -0,0 +1,22 @@
+classdef TestMatHandle
+    %TestMatHandle
+
+    properties (Constant)
+        im = fullfile(mexopencv.root(),'test','img001.jpg');
+    end
+
+    methods (Static)
+        function test_roundtrip
+            img = cv.imread(TestMatHandle.im, 'ReduceScale',2);
+            h = cv.MatHandle(img);
+            assert(isequal(h.Size, [size(img,1) size(img,2)]));
+            assert(h.Channels == 3 && strcmp(h.Class, 'uint8') && ~h.Empty);
+            assert(isequal(h.toMat(), img));
+
+            h2 = h.clone();
+            assert(h2.id ~= h.id);
+            assert(isequal(h2.toMat(), img));
+        end
+    end
+
+end
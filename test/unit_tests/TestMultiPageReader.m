@@ -0,0 +1,50 @@
+classdef TestMultiPageReader
+    %TestMultiPageReader
+
+    properties (Constant)
+        im = fullfile(mexopencv.root(),'test','HappyFish.jpg');
+    end
+
+    methods (Static)
+        function test_pages
+            img = cv.imread(TestMultiPageReader.im);
+            imgs = {img, flipud(img), fliplr(img), 255-img};
+            filename = [tempname() '.tif'];
+            cObj = onCleanup(@() TestImwrite.deleteFile(filename));
+            cv.imwrite(filename, imgs);
+
+            r = cv.MultiPageReader(filename);
+            assert(r.count() == numel(imgs));
+            assert(isequal(r.read(3), imgs{3}));
+            out = r.readRange(2, 4);
+            assert(iscell(out) && isequal(out, imgs(2:4)));
+            out = r.readRange(1, 2, 'Stack',true);
+            assert(isequal(out, cat(4, imgs{1:2})));
+            clear r
+        end
+
+        function test_compare
+            filename = which('mri.tif');
+            if isempty(filename)
+                error('mexopencv:testskip', 'missing data');
+            end
+            imgs = cv.imreadmulti(filename);
+            r = cv.MultiPageReader(filename);
+            assert(r.count() == numel(imgs));
+            assert(isequal(r.read(numel(imgs)), imgs{end}));
+            assert(isequal(r.readRange(1, numel(imgs)), imgs(:)'));
+        end
+
+        function test_error_page_range
+            r = cv.MultiPageReader(TestMultiPageReader.im);
+            assert(r.count() == 1);
+            try
+                r.read(2);
+                throw('UnitTest:Fail');
+            catch e
+                assert(strcmp(e.identifier,'mexopencv:error'));
+            end
+        end
+    end
+
+end
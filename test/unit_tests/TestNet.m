@@ -17,6 +17,36 @@ function test_blobs
             assert(isequal(out, imgs));
         end
 
+        function test_blobs_uint8
+            % fused uint8 path must match the general floating-point path
+            img1 = cv.imread(TestNet.im1, 'FlipChannels',false);
+            img2 = cv.resize(img1, [200 150]);
+            opts = {
+                {}
+                {'Size',[224 224]}
+                {'Size',[224 224], 'Crop',false}
+                {'Size',[100 300], 'SwapRB',false}
+                {'Size',[96 64], 'Mean',[104 117 123], 'ScaleFactor',1/255}
+            };
+            for i=1:numel(opts)
+                blob = cv.Net.blobFromImages(img1, opts{i}{:});
+                ref = cv.Net.blobFromImages(single(img1), opts{i}{:});
+                validateattributes(blob, {'single'}, {'size',size(ref)});
+                assert(max(abs(blob(:) - ref(:))) < 1e-3);
+            end
+
+            % images of different sizes, and grayscale
+            blob = cv.Net.blobFromImages({img1, img2}, 'Size',[64 64]);
+            ref = cv.Net.blobFromImages({single(img1), single(img2)}, ...
+                'Size',[64 64]);
+            validateattributes(blob, {'single'}, {'size',[2 3 64 64]});
+            assert(max(abs(blob(:) - ref(:))) < 1e-3);
+            gray = cv.cvtColor(img1, 'RGB2GRAY');
+            blob = cv.Net.blobFromImages(gray, 'Size',[32 48]);
+            ref = cv.Net.blobFromImages(single(gray), 'Size',[32 48]);
+            assert(max(abs(blob(:) - ref(:))) < 1e-3);
+        end
+
         function test_caffe_googlenet
             % load net and images
             net = load_bvlc_googlenet();
@@ -32,6 +62,11 @@ function test_caffe_googlenet
             [p,idx] = max(prob,[],2);
             %assert(abs(sum(prob) - 1) < 1e-4);
 
+            % same input set directly from the image
+            net.setInputFromImages(img1, 'Size',[224 224], 'Name','data');
+            prob2 = net.forward('prob');
+            assert(max(abs(prob2 - prob)) < 1e-4);
+
             % forward pass (blob from multiple images)
             blob = cv.Net.blobFromImages({img1,img2}, 'Size',[224 224]);
             net.setInput(blob);
@@ -61,6 +96,228 @@ function test_intermediate_blobs
             blobs = net.forwardAndRetrieve('conv1/7x7_s2');
         end
 
+        function test_complexity
+            net = load_bvlc_googlenet();
+            shape = [1 3 224 224];
+
+            [ids, inShapes, outShapes] = net.getLayersShapes(shape);
+            validateattributes(ids, {'numeric'}, {'vector', 'integer'});
+            assert(iscell(inShapes) && iscell(outShapes));
+            assert(numel(inShapes) == numel(ids));
+            assert(numel(outShapes) == numel(ids));
+
+            [in, out] = net.getLayerShapes(shape, 'conv1/7x7_s2');
+            assert(iscell(in) && iscell(out));
+            assert(isequal(double(out{1}), [1 64 112 112]));
+
+            flops = net.getFLOPS(shape);
+            validateattributes(flops, {'int64'}, {'scalar', 'positive'});
+            flops1 = net.getFLOPS(shape, 'LayerId','conv1/7x7_s2');
+            assert(flops1 > 0 && flops1 < flops);
+
+            [w, b] = net.getMemoryConsumption(shape);
+            validateattributes(w, {'numeric'}, {'scalar', 'positive'});
+            validateattributes(b, {'numeric'}, {'scalar', 'positive'});
+
+            img = cv.imread(TestNet.im1, 'FlipChannels',false);
+            blob = cv.Net.blobFromImages(img, 'Size',[224 224]);
+            [layers, totals] = net.profile(blob, 'Name','data', 'Runs',2);
+            validateattributes(layers, {'struct'}, {'vector'});
+            assert(all(ismember({'id', 'name', 'type', 'outputShapes', ...
+                'flops', 'weights', 'blobs', 'time'}, fieldnames(layers))));
+            assert(numel(layers) == nnz(ids > 0));
+            assert(totals.layers == numel(layers) && totals.runs == 2);
+            assert(abs(totals.flops - double(flops)) <= 1e-6*double(flops));
+            assert(all([layers.time] >= 0) && totals.time > 0);
+        end
+
+        function test_forward_async
+            net = load_bvlc_googlenet();
+            img1 = cv.imread(TestNet.im1, 'FlipChannels',false);
+            img2 = cv.imread(TestNet.im2, 'FlipChannels',false);
+            blob = cv.Net.blobFromImages(img1, 'Size',[224 224]);
+            net.setInput(blob);
+            prob = net.forward();
+
+            net.startAsync('Workers',2, 'QueueDepth',2);
+            ids = zeros(1,4);
+            ids(1) = net.forwardAsync(blob);
+            ids(2) = net.forwardAsync({img1}, 'Size',[224 224]);
+            ids(3) = net.forwardAsync({img1,img2}, 'Size',[224 224], ...
+                'OutputName',{'prob'});
+            ids(4) = net.forwardAsync(blob, 'OutputName','nonexistent');
+            res = net.waitAll();
+            [res2, pending] = net.poll();
+            net.stopAsync();
+
+            validateattributes(res, {'struct'}, {'numel',4});
+            assert(isempty(res2) && pending == 0);
+            assert(isequal(sort([res.id]), sort(ids)));
+            for i=1:3
+                r = res([res.id] == ids(i));
+                assert(isempty(r.error));
+                assert(r.latency >= r.computeTime);
+            end
+            r = res([res.id] == ids(1));
+            assert(max(abs(r.output(:) - prob(:))) < 1e-4);
+            r = res([res.id] == ids(3));
+            validateattributes(r.output, {'cell'}, {'numel',1});
+            validateattributes(r.output{1}, {'numeric'}, {'size',[2 1000]});
+            r = res([res.id] == ids(4));
+            assert(~isempty(r.error) && isempty(r.output));
+        end
+
+        function test_forward_async_batching
+            net = load_bvlc_googlenet();
+            img1 = cv.imread(TestNet.im1, 'FlipChannels',false);
+            img2 = cv.imread(TestNet.im2, 'FlipChannels',false);
+            blob = cv.Net.blobFromImages({img1,img2}, 'Size',[224 224]);
+            net.setInput(blob);
+            prob = net.forward();
+
+            net.startAsync('Workers',1, 'MaxBatchSize',4, 'MaxWait',1000);
+            ids = zeros(1,4);
+            for i=1:numel(ids)
+                img = img1;
+                if mod(i,2) == 0, img = img2; end
+                ids(i) = net.forwardAsync({img}, 'Size',[224 224]);
+            end
+            res = net.wait(ids([3 1 4 2]));
+            s = net.getAsyncStats();
+            net.stopAsync();
+
+            validateattributes(res, {'struct'}, {'numel',4});
+            assert(isequal([res.id], ids([3 1 4 2])));
+            assert(all([res.batchSize] == 4));
+            for i=1:numel(res)
+                k = 2 - mod(res(i).id - ids(1) + 1, 2);
+                validateattributes(res(i).output, {'numeric'}, ...
+                    {'size',[1 1000]});
+                assert(max(abs(res(i).output - prob(k,:))) < 1e-4);
+            end
+            assert(s.completed == 4 && s.batches == 1);
+            assert(s.meanBatchSize == 4 && s.throughput > 0);
+        end
+
+        function test_forward_async_requires_files
+            net = cv.Net();
+            try
+                net.startAsync();
+                throw('UnitTest:Fail');
+            catch e
+                assert(strcmp(e.identifier,'mexopencv:error'));
+            end
+        end
+
+        function test_model_cache
+            rootdir = fullfile(mexopencv.root(), 'test', 'dnn', 'GoogLeNet');
+            modelTxt = fullfile(rootdir, 'deploy.prototxt');
+            modelBin = fullfile(rootdir, 'bvlc_googlenet.caffemodel');
+            if exist(modelTxt, 'file') ~= 2 || exist(modelBin, 'file') ~= 2
+                error('mexopencv:testskip', 'missing data');
+            end
+            img = cv.imread(TestNet.im1, 'FlipChannels',false);
+            blob = cv.Net.blobFromImages(img, 'Size',[224 224]);
+
+            net = cv.Net('Caffe', modelTxt, modelBin);
+            net.setInput(blob);
+            prob = net.forward();
+
+            cv.Net.clearModelCache();
+            cv.Net.setUseModelCache(true, 'MemoryMap',true);
+            try
+                net1 = cv.Net('Caffe', modelTxt, modelBin);
+                net2 = cv.Net('Caffe', modelTxt, modelBin);
+                models = cv.Net.getModelCache();
+                assert(isscalar(models) && models.instances == 2);
+
+                % another spelling of the same files hits the same model
+                otherdir = fullfile(rootdir, '..', 'GoogLeNet');
+                net3 = cv.Net('Caffe', ...
+                    fullfile(otherdir, 'deploy.prototxt'), ...
+                    fullfile(otherdir, 'bvlc_googlenet.caffemodel'));
+                models = cv.Net.getModelCache();
+                assert(isscalar(models) && models.instances == 3);
+                clear net3
+                assert(strcmp(models.type, 'Caffe') && numel(models.files) == 2);
+                assert(models.weights > 0);
+
+                net1.setInput(blob);
+                net2.setInput(blob);
+                prob1 = net1.forward();
+                prob2 = net2.forward();
+                assert(norm(prob1(:) - prob(:), Inf) < 1e-4);
+                assert(isequal(prob1, prob2));
+
+                try
+                    net1.enableFusion(true);
+                    throw('UnitTest:Fail');
+                catch e
+                    assert(strcmp(e.identifier,'mexopencv:error'));
+                end
+
+                clear net1
+                models = cv.Net.getModelCache();
+                assert(models.instances == 1);
+            catch e
+                cv.Net.setUseModelCache(false);
+                cv.Net.clearModelCache();
+                rethrow(e);
+            end
+            cv.Net.setUseModelCache(false);
+            cv.Net.clearModelCache();
+            assert(isempty(cv.Net.getModelCache()));
+        end
+
+        function test_model_cache_memory
+            % resident memory is only read from procfs
+            if exist('/proc/self/status', 'file') ~= 2
+                error('mexopencv:testskip', 'procfs only');
+            end
+            rootdir = fullfile(mexopencv.root(), 'test', 'dnn', 'GoogLeNet');
+            modelTxt = fullfile(rootdir, 'deploy.prototxt');
+            modelBin = fullfile(rootdir, 'bvlc_googlenet.caffemodel');
+            if exist(modelTxt, 'file') ~= 2 || exist(modelBin, 'file') ~= 2
+                error('mexopencv:testskip', 'missing data');
+            end
+
+            % memory added by each network after the first one
+            N = 4;
+            cv.Net.clearModelCache();
+            nets = cell(1,N);
+            nets{1} = cv.Net('Caffe', modelTxt, modelBin);
+            rss = resident_bytes();
+            for i=2:N
+                nets{i} = cv.Net('Caffe', modelTxt, modelBin);
+            end
+            unshared = (resident_bytes() - rss) / (N-1);
+            nets = cell(1,N);
+
+            cv.Net.setUseModelCache(true);
+            try
+                nets{1} = cv.Net('Caffe', modelTxt, modelBin);
+                rss = resident_bytes();
+                for i=2:N
+                    nets{i} = cv.Net('Caffe', modelTxt, modelBin);
+                end
+                shared = (resident_bytes() - rss) / (N-1);
+                models = cv.Net.getModelCache();
+                nets = cell(1,N);
+            catch e
+                nets = cell(1,N);
+                cv.Net.setUseModelCache(false);
+                cv.Net.clearModelCache();
+                rethrow(e);
+            end
+            cv.Net.setUseModelCache(false);
+            cv.Net.clearModelCache();
+
+            % GoogLeNet shares all but its fully connected classifier
+            assert(isscalar(models) && models.weights > 0);
+            assert(unshared > models.weights / 2);
+            assert(shared < unshared / 2);
+        end
+
         function test_shrink_caffe_fp16
             model = fullfile(mexopencv.root(), 'test', 'dnn', 'GoogLeNet', ...
                 'bvlc_googlenet.caffemodel');
@@ -186,3 +443,11 @@ function net = load_bvlc_googlenet()
     net = cv.Net('Caffe', modelTxt, modelBin);
     assert(~net.empty());
 end
+
+function bytes = resident_bytes()
+    %RESIDENT_BYTES  Resident set size of the process, read from procfs
+    str = fileread('/proc/self/status');
+    tok = regexp(str, 'VmRSS:\s*(\d+)\s*kB', 'tokens', 'once');
+    assert(~isempty(tok), 'missing VmRSS');
+    bytes = str2double(tok{1}) * 1024;
+end
@@ -74,6 +74,26 @@ function test_detect_mask
             assert(all(xy(:,1) <= ceil(size(img,2)/2)));
         end
 
+        function test_detectAndCompute_soa
+            img = imread(TestORB.im);
+            obj = cv.ORB();
+            [kpts, desc] = obj.detectAndCompute(img, 'OutputFormat','SoA');
+            validateattributes(kpts, {'struct'}, {'scalar'});
+            assert(all(ismember(TestORB.kfields, fieldnames(kpts))));
+            validateattributes(kpts.pt, {'double'}, {'size',[NaN 2]});
+            validateattributes(desc, {obj.descriptorType()}, ...
+                {'size',[size(kpts.pt,1) obj.descriptorSize()]});
+
+            % same keypoints as the default format, and accepted as input
+            kpts2 = obj.detect(img);
+            assert(isequal(kpts.pt, cat(1, kpts2.pt)));
+            assert(isequal(kpts.size, [kpts2.size]'));
+            [desc2, kpts3] = obj.compute(img, kpts);
+            validateattributes(kpts3, {'struct'}, {'vector'});
+            validateattributes(desc2, {obj.descriptorType()}, ...
+                {'size',[numel(kpts3) obj.descriptorSize()]});
+        end
+
         function test_error_1
             try
                 cv.ORB('foobar');
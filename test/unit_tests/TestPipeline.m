@@ -0,0 +1,69 @@
+classdef TestPipeline
+    %TestPipeline
+
+    properties (Constant)
+        im = fullfile(mexopencv.root(),'test','img001.jpg');
+    end
+
+    methods (Static)
+        function test_stages
+            p = cv.Pipeline({{'cvtColor', 'RGB2GRAY'}, {'medianBlur'}});
+            p.add('resize', 0.5, 0.5);
+            assert(p.NumStages == 3);
+            assert(isequal(p.stages(), {'cvtColor', 'medianBlur', 'resize'}));
+            p.clear();
+            assert(p.NumStages == 0);
+        end
+
+        function test_sequential
+            img = cv.imread(TestPipeline.im, 'ReduceScale',2);
+            out = cv.cvtColor(img, 'RGB2GRAY');
+            out = cv.GaussianBlur(out, 'KSize',[5 5]);
+            out = cv.morphologyEx(out, 'Open', 'Iterations',2);
+            out = cv.resize(out, 0.5, 0.5);
+            out = cv.threshold(out, 'Otsu');
+            out = cv.dilate(out);
+
+            p = cv.Pipeline({
+                {'cvtColor', 'RGB2GRAY'}
+                {'GaussianBlur', 'KSize',[5 5]}
+                {'morphologyEx', 'Open', 'Iterations',2}
+                {'resize', 0.5, 0.5}
+                {'threshold', 'Otsu'}
+                {'dilate'}
+            });
+            p.TileRows = 16;
+            assert(p.TileRows == 16);
+            assert(isequal(p.apply(img), out));
+            % buffers reused on the next call
+            assert(isequal(p.apply(img), out));
+        end
+
+        function test_batch
+            img = cv.imread(TestPipeline.im, 'ReduceScale',2);
+            frames = {img, fliplr(img), flipud(img)};
+            p = cv.Pipeline({{'blur', 'KSize',[3 3]}, {'Canny', [50 150]}});
+            expected = cellfun(@(f) p.apply(f), frames, 'UniformOutput',false);
+
+            out = p.apply(frames);
+            assert(iscell(out) && isequal(size(out), size(frames)));
+            assert(isequal(out, expected));
+
+            out = p.apply(cat(4, frames{:}));
+            assert(isequal(size(out), [size(expected{1}) 1 numel(frames)]));
+            for i=1:numel(frames)
+                assert(isequal(out(:,:,1,i), expected{i}));
+            end
+        end
+
+        function test_error_unrecognized_op
+            try
+                cv.Pipeline({{'foo'}});
+                throw('UnitTest:Fail');
+            catch e
+                assert(strcmp(e.identifier,'mexopencv:error'));
+            end
+        end
+    end
+
+end
@@ -27,6 +27,21 @@ function test_3
             end
         end
 
+        function test_batch
+            img = imread(fullfile(mexopencv.root(),'test','img001.jpg'));
+            frames = {img, img(1:100,1:200,:), fliplr(img)};
+            out = cv.resize(frames, 0.5, 0.5);
+            assert(iscell(out) && isequal(size(out), size(frames)));
+            for i=1:numel(frames)
+                assert(isequal(out{i}, cv.resize(frames{i}, 0.5, 0.5)));
+            end
+
+            stack = cat(4, img, fliplr(img));
+            out = cv.resize(stack, [64 48]);
+            validateattributes(out, {class(img)}, {'size',[48 64 3 2]});
+            assert(isequal(out(:,:,:,2), cv.resize(fliplr(img), [64 48])));
+        end
+
         function test_error_argnum
             try
                 cv.resize();
@@ -115,6 +115,94 @@ function test_tega
                 cv.Utils.setUseTegra(b);
             end
         end
+
+        function test_buffer_pool
+            b = cv.Utils.useBufferPool();
+            validateattributes(b, {'logical'}, {'scalar'});
+            cv.Utils.setUseBufferPool(true);
+            cv.Utils.resetBufferPoolStats();
+
+            img = randi([0 255], [480 640 3], 'uint8');
+            for i=1:3
+                out = cv.GaussianBlur(img);
+            end
+            s = cv.Utils.getBufferPoolStats();
+            validateattributes(s, {'struct'}, {'scalar'});
+            assert(s.hits > 0);
+            assert(s.bytesReserved <= s.maxReservedSize);
+
+            cv.Utils.freeAllReservedBuffers();
+            s = cv.Utils.getBufferPoolStats();
+            assert(s.bytesReserved == 0);
+            cv.Utils.setUseBufferPool(b);
+        end
+
+        function test_live_objects
+            obj = cv.StereoBM();
+            id = obj.id;
+            assert(ismember(id, cv.Utils.liveObjects('StereoBM')));
+            clear obj
+            assert(~ismember(id, cv.Utils.liveObjects('StereoBM')));
+        end
+
+        function test_profile
+            b = cv.Utils.useProfile();
+            validateattributes(b, {'logical'}, {'scalar'});
+            cv.Utils.setUseProfile(true);
+            cv.Utils.resetProfile();
+
+            img = randi([0 255], [480 640 3], 'uint8');
+            for i=1:3
+                out = cv.GaussianBlur(img);
+            end
+            s = cv.Utils.getProfile();
+            validateattributes(s, {'struct'}, {'vector'});
+            assert(all(ismember({'name', 'calls', 'total', 'parse', ...
+                'input', 'kernel', 'output', 'bytesIn', 'bytesOut', ...
+                'maxCallBytes'}, fieldnames(s))));
+            % package functions may be reported with their package prefix
+            idx = find(~cellfun(@isempty, ...
+                regexp({s.name}, '(^|\.)GaussianBlur$', 'once')));
+            assert(isscalar(idx));
+            assert(s(idx).calls == 3);
+            assert(s(idx).bytesIn == 3*numel(img));
+            assert(s(idx).bytesOut == 3*numel(img));
+            assert(s(idx).total >= s(idx).kernel);
+
+            cv.Utils.resetProfile();
+            s = cv.Utils.getProfile();
+            assert(isempty(s));
+            cv.Utils.setUseProfile(b);
+        end
+
+        function test_profile_record
+            b = cv.Utils.useProfile();
+            cv.Utils.resetProfile();
+            cv.Utils.recordProfile('foo', [1 0.5 0.1 0.1 0.2 0.1 10 20 30]);
+            cv.Utils.recordProfile('foo', [1 0.5 0.1 0.1 0.2 0.1 10 20 5]);
+            s = cv.Utils.getProfile();
+            assert(isscalar(s) && strcmp(s.name, 'foo'));
+            assert(s.calls == 2 && abs(s.total - 1) < 1e-12);
+            assert(s.bytesIn == 20 && s.bytesOut == 40);
+            assert(s.maxCallBytes == 30);
+            cv.Utils.resetProfile();
+
+            % profiling state is not read from the environment
+            env = getenv('MEXOPENCV_PROFILE');
+            setenv('MEXOPENCV_PROFILE', '0x1');
+            cv.Utils.setUseProfile(true);
+            out = cv.GaussianBlur(zeros(10,'uint8'));
+            setenv('MEXOPENCV_PROFILE', env);
+            cv.Utils.resetProfile();
+            cv.Utils.setUseProfile(b);
+
+            try
+                cv.Utils.recordProfile('foo', [1 2 3]);
+                throw('UnitTest:Fail');
+            catch e
+                assert(strcmp(e.identifier,'mexopencv:error'));
+            end
+        end
     end
 
 end
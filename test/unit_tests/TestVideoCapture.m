@@ -34,6 +34,37 @@ function test_img_sequence
             TestVideoCapture.checkVideoFile(filename);
         end
 
+        function test_prefetch
+            filename = fullfile(mexopencv.root(),'test','left%02d.jpg');
+            cap1 = cv.VideoCapture(filename);
+            cap2 = cv.VideoCapture(filename, 'Prefetch',4);
+            assert(cap1.isOpened() && cap2.isOpened());
+            while true
+                img1 = cap1.read();
+                img2 = cap2.read();
+                assert(isequal(img1, img2));
+                assert(isequal(cap1.PosFrames, cap2.PosFrames));
+                if isempty(img1), break; end
+            end
+            cap1.release();
+            cap2.release();
+        end
+
+        function test_read_batch
+            filename = fullfile(mexopencv.root(),'test','left%02d.jpg');
+            cap = cv.VideoCapture(filename);
+            assert(cap.isOpened());
+            frames = cap.readBatch(3, 'Stride',2, 'Range',[1 6]);
+            validateattributes(frames, {'uint8'}, {'size',[NaN NaN 3 3]});
+            for i=1:3
+                cap.PosFrames = 1 + 2*(i-1);
+                assert(isequal(frames(:,:,:,i), cap.read()));
+            end
+            frames = cap.readBatch(1000);
+            assert(size(frames,4) < 1000);
+            cap.release();
+        end
+
         function test_camera
             %TODO
             if true
@@ -71,6 +71,31 @@ function test_2
                 end
             end
         end
+
+        function test_async
+            fname = [tempname() '.avi'];
+            cObj = onCleanup(@() TestVideoWriter.deleteFile(fname));
+            w = 320; h = 240; n = 10;
+            vid = cv.VideoWriter(fname, [w h], 'FourCC','MJPG', ...
+                'QueueSize',4, 'Backpressure','Block');
+            assert(vid.isOpened());
+            for i=1:n
+                vid.write(randi([0 255], [h w 3], 'uint8'));
+            end
+            vid.flush();
+            s = vid.getQueueStats();
+            validateattributes(s, {'struct'}, {'scalar'});
+            assert(all(isfield(s, {'queued', 'dropped', 'encoded', ...
+                'pending', 'meanEncodeTime', 'meanLatency'})));
+            assert(s.queued == n && s.encoded == n && s.dropped == 0);
+            assert(s.pending == 0);
+            vid.release();
+
+            cap = cv.VideoCapture(fname);
+            assert(cap.isOpened());
+            assert(cap.FrameCount == n);
+            cap.release();
+        end
     end
 
     %% helper functions